@@ -0,0 +1,83 @@
+#ifndef ASSET_IMPORTER_H
+#define ASSET_IMPORTER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Mesh.h"
+#include "MeshCache.h"
+#include "MeshPool.h"
+#include "ThreadPool.h"
+
+// A finished import handed back to the renderer (on the GL thread)
+struct ImportedAsset {
+    uint64_t id = 0;
+    std::string path;
+    bool success = false;
+    std::string error;
+    std::vector<std::unique_ptr<Mesh>> meshes; // One per aiMesh in the scene, fully uploaded
+};
+
+// Background model import. Assimp parsing and vertex conversion run on the thread pool (or, for a file
+// imported before, the cooked copy from MeshCache is memory-mapped instead);
+// GPU uploads run on the GL thread in Update(), limited to a per-frame time budget and
+// split into chunks so even a very large mesh does not stall a frame.
+class AssetImporter {
+public:
+    // Imported meshes are sub-allocated from `meshPool` when given (it must outlive the importer and its meshes)
+    explicit AssetImporter(ThreadPool& pool, MeshPool* meshPool = nullptr);
+    ~AssetImporter(); // Waits for in-flight parse jobs
+
+    AssetImporter(const AssetImporter&) = delete;
+    AssetImporter& operator=(const AssetImporter&) = delete;
+
+    // Starts importing `path`; returns the id reported back by Update()
+    uint64_t Import(const std::string& path);
+
+    // GL thread: uploads parsed meshes for up to budgetMs and returns the imports that completed (or failed)
+    std::vector<ImportedAsset> Update(double budgetMs);
+
+    size_t GetPendingCount() const;
+    const MeshCache& GetMeshCache() const { return m_meshCache; }
+
+    // Imported meshes free their packed data once it is on the GPU (see Mesh::SetReleaseCpuDataAfterUpload).
+    // On by default; applies to meshes created afterwards.
+    void SetReleaseCpuData(bool release) { m_releaseCpuData = release; }
+    bool IsReleaseCpuDataEnabled() const { return m_releaseCpuData; }
+
+private:
+    struct ParsedScene {
+        uint64_t id = 0;
+        std::string path;
+        std::string error;
+        std::vector<MeshData> meshes;
+        std::shared_ptr<MappedFile> mapping; // Cooked file the meshes point into (cache hits only)
+    };
+    struct StagedImport {
+        ImportedAsset asset;
+        std::vector<MeshData> remaining;  // Parsed data; entries are moved into asset.meshes in order
+        size_t uploadingIndex = 0;        // Entry of asset.meshes currently streaming
+        std::shared_ptr<MappedFile> mapping; // Kept alive until every mesh is uploaded
+    };
+
+    ThreadPool& m_pool;
+    MeshPool* m_meshPool;
+    MeshCache m_meshCache;
+    uint64_t m_nextId = 1;
+    bool m_releaseCpuData = true;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_jobsDone;
+    unsigned int m_jobsInFlight = 0;
+    std::deque<ParsedScene> m_parsed; // Filled by workers, drained by Update()
+
+    std::deque<StagedImport> m_staged; // GL thread only
+
+    void parseScene(ParsedScene& scene) const;
+};
+
+#endif // ASSET_IMPORTER_H
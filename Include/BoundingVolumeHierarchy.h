@@ -0,0 +1,40 @@
+#ifndef BOUNDING_VOLUME_HIERARCHY_H
+#define BOUNDING_VOLUME_HIERARCHY_H
+
+#include <cstdint>
+#include <vector>
+#include "Frustum.h"
+
+// Static AABB tree over caller-indexed items, built top-down by splitting at the centroid median of the
+// widest axis. Nodes are stored depth first: a node's left child directly follows it, so queries walk
+// the array nearly linearly. Rebuild it when the items move; it is meant for data that changes rarely.
+class BoundingVolumeHierarchy {
+public:
+    void Build(const std::vector<Aabb>& bounds);
+    void Clear() { m_nodes.clear(); m_items.clear(); m_itemBounds.clear(); }
+
+    // Appends the index (into the Build() array) of every item whose box is not outside the frustum.
+    // Returns the number of box tests done, for the stats.
+    size_t QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& visible) const;
+
+    size_t GetNodeCount() const { return m_nodes.size(); }
+    bool IsEmpty() const { return m_items.empty(); }
+
+private:
+    static const uint32_t MAX_LEAF_ITEMS = 4;
+
+    struct Node {
+        Aabb bounds;
+        uint32_t first = 0;      // Leaf: first entry of m_items. Inner: index of the right child.
+        uint32_t count = 0;      // Leaf: item count; 0 for inner nodes
+    };
+
+    std::vector<Node> m_nodes;
+    std::vector<uint32_t> m_items; // Item indices, grouped by leaf
+    std::vector<Aabb> m_itemBounds; // Boxes in m_items order, for leaves that straddle a plane
+
+    uint32_t buildNode(const std::vector<Aabb>& bounds, uint32_t begin, uint32_t end);
+    void appendAll(uint32_t node, std::vector<uint32_t>& visible) const;
+};
+
+#endif // BOUNDING_VOLUME_HIERARCHY_H
@@ -0,0 +1,65 @@
+#ifndef CLOUD_RENDERER_H
+#define CLOUD_RENDERER_H
+
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+#include "RenderTarget.h"
+#include "Shader.h"
+
+// Volumetric clouds rendered into their own reduced-resolution buffer.
+// The FBM density noise is generated once at startup into a tileable 3D texture; the march samples it
+// (scrolled by u_time) instead of hashing 8 lattice corners per octave per step.
+// The raymarch pass composites the buffer over the sky / terrain using the stored cloud distance.
+//
+// Temporal updates (updateGrid 2 or 4) march one pixel of every 2x2 / 4x4 block per frame, cycling through
+// the block in Bayer order, and reproject the rest from the previous frame's buffer (the buffers ping-pong).
+// Clouds only drift with u_time, so a slowly moving camera sees no difference at 1/4 or 1/16 of the march
+// cost. The history is dropped after a resize, a parameter change (ResetHistory) or a large camera move.
+class CloudRenderer {
+public:
+    CloudRenderer();
+    ~CloudRenderer();
+
+    bool Initialize();
+    bool IsValid() const { return m_cloudShader && m_cloudShader->isValid() && m_noiseTexture != 0; }
+
+    // (Re)creates the cloud buffer at native / scaleDivisor. No-op if nothing changed.
+    void Resize(int nativeWidth, int nativeHeight, int scaleDivisor);
+    // Marches the clouds into the cloud buffer. Leaves the default framebuffer bound (viewport must be restored by the caller).
+    // Cloud and lighting parameters come from the RaymarchParams uniform block; maxSteps bounds the march per ray.
+    // updateGrid: 1 = march every pixel, 2 = a quarter of them, 4 = a sixteenth (the rest are reprojected).
+    void Render(unsigned int quadVAO, float time, const glm::vec3& camPos, const glm::mat4& viewProj, const glm::mat4& invView,
+                const glm::mat4& invProj, int maxSteps, int updateGrid);
+    void ResetHistory() { m_historyValid = false; }
+
+    GLuint GetNoiseTexture() const { return m_noiseTexture; }
+    float GetNoisePeriod() const;
+    int GetNoiseResolution() const;
+    GLuint GetCloudTexture() const { return m_targets[m_current].GetColorTexture(0); }
+    GLuint GetDistanceTexture() const { return m_targets[m_current].GetColorTexture(1); }
+    int GetWidth() const { return m_targets[m_current].GetWidth(); }
+    int GetHeight() const { return m_targets[m_current].GetHeight(); }
+    // Share of the cloud pixels marched by the last Render (1 when the history was rejected)
+    float GetMarchedFraction() const { return m_marchedFraction; }
+
+private:
+    std::unique_ptr<Shader> m_cloudShader;
+    RenderTarget m_targets[2]; // Ping-pong; attachment 0: RGBA16F cloud color, attachment 1: R32F cloud distance
+    int m_current = 0;         // Target written by the last Render
+    GLuint m_noiseTexture = 0;
+    int m_nativeWidth = 0, m_nativeHeight = 0, m_scaleDivisor = 0;
+
+    bool m_historyValid = false;
+    glm::mat4 m_prevViewProj = glm::mat4(1.0f);
+    glm::vec3 m_prevCamPos = glm::vec3(0.0f);
+    glm::vec3 m_prevForward = glm::vec3(0.0f, 0.0f, -1.0f);
+    float m_prevTime = 0.0f;
+    unsigned int m_frameIndex = 0;
+    float m_marchedFraction = 1.0f;
+
+    static void generateNoiseSlices(std::vector<float>& voxels, int zBegin, int zEnd);
+    bool createNoiseTexture();
+};
+
+#endif // CLOUD_RENDERER_H
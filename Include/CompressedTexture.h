@@ -0,0 +1,62 @@
+#ifndef COMPRESSED_TEXTURE_H
+#define COMPRESSED_TEXTURE_H
+
+#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// One mip level inside CompressedImage::data
+struct CompressedMipLevel {
+    size_t offset = 0;
+    size_t size = 0;
+    int width = 0, height = 0;
+};
+
+// A block-compressed image with its full (pre-baked) mip chain, rows bottom-up as GL expects
+struct CompressedImage {
+    GLenum internalFormat = 0; // GL_COMPRESSED_*; sRGB sources map to the UNORM format (the renderer is not sRGB-aware)
+    size_t blockBytes = 0;     // 8 for BC1/BC4, 16 for BC3/BC5/BC7
+    int width = 0, height = 0;
+    std::vector<CompressedMipLevel> levels;
+    std::vector<unsigned char> data;
+
+    size_t BlockRowBytes(const CompressedMipLevel& level) const { return static_cast<size_t>((level.width + 3) / 4) * blockBytes; }
+};
+
+// Which compressed formats the GL context can sample (queried once on the GL thread)
+struct CompressedFormatSupport {
+    bool s3tc = false; // BC1 / BC3
+    bool rgtc = false; // BC4 / BC5 (core since 3.0)
+    bool bptc = false; // BC7
+
+    static CompressedFormatSupport Query();
+    bool Supports(GLenum internalFormat) const;
+};
+
+// DDS (legacy DXT1/DXT5/ATI2 FourCCs and the DX10 extension) and KTX2 (no supercompression) readers,
+// plus a DDS writer for the texture cook cache.
+class CompressedTextureFile {
+public:
+    static bool IsCompressedPath(const std::string& path); // .dds / .ktx2
+
+    // Reads a file of either kind. Authoring tools store rows top-down, so BC1-BC5 blocks are flipped into
+    // GL order on load (BC7 cannot be flipped losslessly and is left as is). Files written by
+    // SaveDDS carry a marker and are already in GL order.
+    static bool Load(const std::string& path, CompressedImage& image, std::string& error);
+
+    // `stamp` words are stored in the header's reserved area (the cook cache keeps the source's size and mtime there)
+    static bool SaveDDS(const std::string& path, const CompressedImage& image, const uint32_t stamp[4]);
+    // Reads back the stamp of a file written by SaveDDS; false for any other file
+    static bool ReadDDSStamp(const std::string& path, uint32_t stamp[4]);
+
+private:
+    static bool loadDDS(const std::vector<unsigned char>& file, CompressedImage& image, bool& glOrder, std::string& error);
+    static bool loadKTX2(const std::vector<unsigned char>& file, CompressedImage& image, std::string& error);
+    // False (image untouched, error set) for BC7, whose blocks can't be flipped in place, and for a base level
+    // whose height is not a multiple of 4; smaller levels with such heights are dropped from the chain
+    static bool flipVertically(CompressedImage& image, std::string& error);
+};
+
+#endif // COMPRESSED_TEXTURE_H
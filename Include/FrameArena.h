@@ -0,0 +1,49 @@
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+// Linear allocator for data that lives for one frame (draw commands, sort keys, transforms).
+// Allocate() bumps a pointer; Reset() at the start of the next frame releases everything at once.
+// When a frame overflows the current block another one is chained on, and the next Reset() replaces
+// them with a single block of the combined size, so after the first frames nothing touches the heap.
+class FrameArena {
+public:
+    explicit FrameArena(size_t initialBytes = 64 * 1024);
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void* Allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+    // Uninitialized storage for `count` trivially destructible objects (never destroyed, only reset)
+    template <typename T>
+    T* AllocateArray(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "FrameArena never runs destructors");
+        return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    // Invalidates every pointer handed out since the last Reset()
+    void Reset();
+
+    size_t GetCapacity() const;
+    size_t GetUsedBytes() const { return m_usedBytes; }
+    size_t GetPeakBytes() const { return m_peakBytes; } // Most bytes used by one frame so far
+
+private:
+    struct Block {
+        std::unique_ptr<unsigned char[]> data;
+        size_t size = 0;
+    };
+    std::vector<Block> m_blocks;
+    size_t m_offset = 0;    // Into m_blocks.back()
+    size_t m_usedBytes = 0; // This frame, including alignment padding
+    size_t m_peakBytes = 0;
+
+    void addBlock(size_t minBytes);
+};
+
+#endif // FRAME_ARENA_H
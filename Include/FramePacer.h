@@ -0,0 +1,87 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <GL/glew.h>
+#include <chrono>
+#include <deque>
+
+struct GLFWwindow;
+
+// ADAPTIVE is swap interval -1 (the swap_control_tear extensions): it syncs when on time and tears when late
+enum class VsyncMode { OFF, ON, ADAPTIVE };
+
+struct FramePacingSettings {
+    VsyncMode vsync = VsyncMode::ON;
+    int maxFramesInFlight = 2; // 1 = lowest latency (no CPU/GPU overlap), 2-3 = more throughput
+    float frameRateCap = 0.0f; // Frames per second, 0 = uncapped
+};
+
+struct FramePacingStats {
+    double fenceWaitMs = 0.0; // Time BeginFrame blocked on the GPU (latency limiter)
+    double capSleepMs = 0.0;  // Time BeginFrame slept to hold the frame-rate cap
+    size_t framesInFlight = 0; // Frames submitted but not yet finished by the GPU, when the last frame started
+};
+
+// Paces the main loop: swap interval, a max-frames-in-flight limiter and an optional frame-rate cap.
+//
+// EndFrame() fences each frame after its swap. BeginFrame(), called before input is sampled, waits
+// until at most maxFramesInFlight - 1 earlier frames are still on the GPU, so the CPU records frame N+1
+// while the GPU draws N but never runs further ahead (drivers otherwise queue several frames, and every
+// queued frame is input latency). Then it sleeps to the cap's next deadline: coarse sleeps while the
+// remaining time exceeds the measured sleep overshoot, then a yield spin for the last stretch.
+//
+// Keep maxFramesInFlight at or below InstanceBuffer::INSTANCE_BUFFER_REGIONS so the streaming buffers
+// never have to wait for a region themselves.
+class FramePacer {
+public:
+    static constexpr int MAX_FRAMES_IN_FLIGHT = 3;
+
+    FramePacer() = default;
+    ~FramePacer();
+
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    // Needs the window's context current
+    void Initialize(GLFWwindow* window, const FramePacingSettings& settings);
+    void Destroy();
+
+    // Returns the seconds since the previous BeginFrame (0 on the first call)
+    double BeginFrame();
+    // Right after the swap
+    void EndFrame();
+
+    void SetVsyncMode(VsyncMode mode);
+    void SetMaxFramesInFlight(int frames);
+    void SetFrameRateCap(float framesPerSecond);
+
+    const FramePacingSettings& GetSettings() const { return m_settings; }
+    const FramePacingStats& GetStats() const { return m_stats; }
+    bool IsAdaptiveVsyncSupported() const { return m_adaptiveSupported; }
+
+    static const char* GetVsyncModeName(VsyncMode mode);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void waitForFence(GLsync fence);
+    void sleepUntil(Clock::time_point deadline);
+
+    GLFWwindow* m_window = nullptr;
+    FramePacingSettings m_settings;
+    FramePacingStats m_stats;
+    bool m_adaptiveSupported = false;
+
+    std::deque<GLsync> m_fences; // Oldest first
+    Clock::time_point m_lastFrameStart;
+    Clock::time_point m_nextDeadline;
+    bool m_started = false;
+    bool m_capScheduled = false;
+
+    // Running mean / variance of what a 1 ms sleep really takes (Welford)
+    double m_sleepMeanMs = 1.0;
+    double m_sleepM2 = 0.0;
+    int m_sleepSamples = 0;
+};
+
+#endif // FRAME_PACER_H
@@ -0,0 +1,33 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <glm/glm.hpp>
+
+// Axis-aligned box in world space
+struct Aabb {
+    glm::vec3 min = glm::vec3(0.0f);
+    glm::vec3 max = glm::vec3(0.0f);
+
+    static Aabb FromSphere(const glm::vec3& center, float radius) { return { center - glm::vec3(radius), center + glm::vec3(radius) }; }
+    // Box around `local` after transforming it by `matrix` (affine)
+    static Aabb Transform(const Aabb& local, const glm::mat4& matrix);
+
+    void Expand(const Aabb& other) { min = glm::min(min, other.min); max = glm::max(max, other.max); }
+    glm::vec3 GetCenter() const { return (min + max) * 0.5f; }
+};
+
+// The six planes of a view-projection matrix, normals pointing inwards
+class Frustum {
+public:
+    enum class Result { OUTSIDE, INTERSECTS, INSIDE };
+
+    explicit Frustum(const glm::mat4& viewProjection);
+
+    Result Classify(const Aabb& box) const;
+    bool IsVisible(const Aabb& box) const { return Classify(box) != Result::OUTSIDE; }
+
+private:
+    glm::vec4 m_planes[6];
+};
+
+#endif // FRUSTUM_H
@@ -0,0 +1,25 @@
+#ifndef GL_DEBUG_OUTPUT_H
+#define GL_DEBUG_OUTPUT_H
+
+#include <GL/glew.h>
+
+// Routes driver messages (errors, undefined behaviour, performance warnings) into the GL log category
+// through KHR_debug's callback, which replaces glGetError polling: the driver reports each problem as it
+// happens, with a description, and the GL thread never waits on the pipeline to ask.
+//
+// Output stays asynchronous (GL_DEBUG_OUTPUT_SYNCHRONOUS is left off), so the callback may run on a
+// driver thread; it only formats into the thread-safe logger. Notifications are filtered out in the driver.
+class GLDebugOutput {
+public:
+    // Installs the callback when the context supports it (GL 4.3 or KHR_debug); false otherwise
+    static bool Enable();
+    static bool IsActive() { return s_active; }
+
+private:
+    static void GLAPIENTRY callback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length,
+                                    const GLchar* message, const void* userParam);
+
+    static bool s_active;
+};
+
+#endif // GL_DEBUG_OUTPUT_H
@@ -0,0 +1,56 @@
+#ifndef INSTANCE_BUFFER_H
+#define INSTANCE_BUFFER_H
+
+#include <GL/glew.h>
+#include <cstddef>
+#include <vector>
+
+// Streaming per-instance vertex buffer, rewritten every frame.
+// With GL_ARB_buffer_storage it is one persistently mapped buffer split into INSTANCE_BUFFER_REGIONS regions
+// (triple buffering): the CPU writes region N while the GPU may still read N-1 / N-2, guarded by fences.
+// Without it, the buffer is orphaned with glBufferData and refilled with glBufferSubData.
+class InstanceBuffer {
+public:
+    static const int INSTANCE_BUFFER_REGIONS = 3;
+
+    InstanceBuffer() = default;
+    ~InstanceBuffer();
+
+    InstanceBuffer(const InstanceBuffer&) = delete;
+    InstanceBuffer& operator=(const InstanceBuffer&) = delete;
+
+    bool Create(size_t elementSize, size_t initialCapacity);
+    void Destroy();
+
+    // Returns space for `count` elements for this frame, growing the buffer if needed.
+    // Waits for the GPU only if it is still reading the region about to be reused.
+    void* BeginWrite(size_t count);
+    // Makes the written elements visible to GL. Returns the byte offset of this frame's data in GetBuffer().
+    size_t EndWrite();
+    // Call once all draws reading this frame's data are issued; fences the region and advances to the next.
+    void EndFrame();
+
+    // Points a mat4 attribute (4 consecutive locations from `location`) of the bound VAO at `byteOffset`, divisor 1.
+    void BindMat4Attribute(GLuint location, size_t byteOffset) const;
+
+    GLuint GetBuffer() const { return m_buffer; }
+    size_t GetCapacity() const { return m_capacity; }
+    bool IsPersistent() const { return m_persistent; }
+    bool IsValid() const { return m_buffer != 0; }
+
+private:
+    GLuint m_buffer = 0;
+    size_t m_elementSize = 0;
+    size_t m_capacity = 0;      // Elements per region
+    size_t m_writeCount = 0;
+    int m_region = 0;
+    bool m_persistent = false;
+    unsigned char* m_mapped = nullptr;
+    GLsync m_fences[INSTANCE_BUFFER_REGIONS] = {};
+    std::vector<unsigned char> m_staging; // CPU copy for the orphaning path
+
+    bool allocate(size_t capacity);
+    void waitForRegion(int region);
+};
+
+#endif // INSTANCE_BUFFER_H
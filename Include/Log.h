@@ -0,0 +1,109 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <streambuf>
+
+// (not DEBUG / ERROR: those are macros on some platforms and build configurations)
+enum class LogLevel : uint8_t { VERBOSE, INFO, WARN, ERR, OFF };
+
+enum class LogCategory : uint8_t { GENERAL, RENDER, GL, SHADER, ASSETS, TEXTURES, PHYSICS, COUNT };
+
+// Longest message kept per line; longer lines are truncated (the ring stores fixed-size slots)
+static const size_t LOG_MESSAGE_BYTES = 240;
+
+// Asynchronous logger. Producers on any thread format into a stack buffer and push it into a bounded
+// lock-free ring; a background thread prefixes time, level and category and writes to stdout
+// (VERBOSE/INFO) or stderr (WARN/ERR). When the ring is full the line is dropped and counted rather
+// than blocking the caller. ERR lines wake the writer immediately, everything else is flushed in batches.
+//
+// The LOG_* macros test the category's level before evaluating any part of the stream expression,
+// so a disabled line costs one relaxed atomic load.
+class Log {
+public:
+    static bool IsEnabled(LogCategory category, LogLevel level) {
+        return static_cast<uint8_t>(level) >= s_levels[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+    }
+
+    // Minimum level printed for a category (OFF silences it); every category starts at INFO
+    static void SetLevel(LogCategory category, LogLevel level);
+    static LogLevel GetLevel(LogCategory category);
+
+    static void Write(LogLevel level, LogCategory category, const char* text, size_t length);
+    // Blocks until every line pushed so far has been written
+    static void Flush();
+
+    static uint64_t GetDroppedCount();
+    static const char* GetLevelName(LogLevel level);
+    static const char* GetCategoryName(LogCategory category);
+
+private:
+    static std::atomic<uint8_t> s_levels[static_cast<size_t>(LogCategory::COUNT)];
+};
+
+// One line under construction. Formats through std::ostream into a fixed buffer (no heap allocation)
+// and hands the result to Log::Write when it goes out of scope at the end of the statement.
+class LogLine {
+public:
+    LogLine(LogLevel level, LogCategory category) : m_level(level), m_category(category), m_stream(&m_buffer) {}
+    ~LogLine() { Log::Write(m_level, m_category, m_buffer.Data(), m_buffer.Size()); }
+
+    LogLine(const LogLine&) = delete;
+    LogLine& operator=(const LogLine&) = delete;
+
+    template <typename T>
+    LogLine& operator<<(const T& value) {
+        m_stream << value;
+        return *this;
+    }
+    LogLine& operator<<(std::ostream& (*manipulator)(std::ostream&)) {
+        m_stream << manipulator;
+        return *this;
+    }
+    LogLine& operator<<(std::ios_base& (*manipulator)(std::ios_base&)) {
+        m_stream << manipulator;
+        return *this;
+    }
+
+private:
+    class Buffer : public std::streambuf {
+    public:
+        Buffer() { setp(m_data, m_data + LOG_MESSAGE_BYTES); }
+        const char* Data() const { return m_data; }
+        size_t Size() const { return static_cast<size_t>(pptr() - pbase()); }
+
+    protected:
+        int_type overflow(int_type ch) override { return traits_type::not_eof(ch); } // Truncate silently
+
+    private:
+        char m_data[LOG_MESSAGE_BYTES];
+    };
+
+    LogLevel m_level;
+    LogCategory m_category;
+    Buffer m_buffer;
+    std::ostream m_stream;
+};
+
+// Gives the conditional in LOG_AT a void second branch; `&` binds looser than `<<`, so the whole stream
+// expression is its operand
+struct LogVoidify {
+    void operator&(const LogLine&) {}
+};
+
+// A single expression (safe as the body of an unbraced if/else); the stream operands are not evaluated
+// when the category is below `level`
+#define LOG_AT(level, category)                                                 \
+    !Log::IsEnabled(LogCategory::category, LogLevel::level)                     \
+        ? (void)0                                                               \
+        : LogVoidify() & LogLine(LogLevel::level, LogCategory::category)
+
+#define LOG_VERBOSE(category) LOG_AT(VERBOSE, category)
+#define LOG_INFO(category) LOG_AT(INFO, category)
+#define LOG_WARN(category) LOG_AT(WARN, category)
+#define LOG_ERROR(category) LOG_AT(ERR, category)
+
+#endif // LOG_H
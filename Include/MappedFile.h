@@ -0,0 +1,40 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <filesystem>
+
+// Read-only memory mapping of a whole file (mmap on POSIX, CreateFileMapping on Windows)
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::filesystem::path& path);
+    void Close();
+    // Hints the OS to start reading the pages in now (call off the GL thread)
+    void Prefetch() const;
+
+    const unsigned char* GetData() const { return m_data; }
+    size_t GetSize() const { return m_size; }
+    bool IsOpen() const { return m_data != nullptr; }
+
+private:
+    const unsigned char* m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    void* m_fileHandle = nullptr;
+    void* m_mappingHandle = nullptr;
+#else
+    int m_fd = -1;
+#endif
+};
+
+// Sibling of target with a name unique to this process and call ("<target>.<pid>.<n>.tmp"), for the
+// write-then-rename pattern when several workers may be cooking the same file at once
+std::filesystem::path MakeTempPath(const std::filesystem::path& target);
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,57 @@
+#ifndef MEMORY_STATS_H
+#define MEMORY_STATS_H
+
+#include <GL/glew.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// GPU categories are GL buffers and textures; the CPU ones are copies kept in system memory
+enum class MemoryCategory : uint8_t {
+    MESH_BUFFERS,      // Mesh VBO / EBO, the mesh pool and the built-in shapes
+    STREAMING_BUFFERS, // Instance buffers, render queue transforms / indirect commands, uniform blocks
+    TEXTURES,          // TextureStreamer images, previews and the placeholder
+    RENDER_TARGETS,    // Framebuffer attachments (scene, clouds, depth pre-pass, terrain cache, upscaler)
+    ENVIRONMENT,       // Terrain max-mip chain and clipmap grid, cloud noise volume
+    MESH_CPU,          // Packed mesh data and authored vertices still held after (or waiting for) upload
+    TEXTURE_CPU,       // Decoded pixels and compressed chains waiting to stream
+    COUNT
+};
+
+// Process-wide memory accounting: bytes and object counts per category.
+//
+// GL objects are tracked by name, so re-specifying a buffer's storage (orphaning with glBufferData, or a
+// resize) replaces its old size instead of adding to it, and untracking a name that was never tracked
+// does nothing (delete paths can call it unconditionally). Sizes are what was requested from GL; drivers
+// pad and may keep shadow copies, so treat the GPU totals as a lower bound on real VRAM use.
+// CPU bytes are plain counters that owners add and remove as their copies come and go.
+// Totals are atomics and can be read from any thread; tracking takes a short lock.
+class MemoryStats {
+public:
+    static void TrackBuffer(GLuint buffer, MemoryCategory category, size_t bytes);
+    static void UntrackBuffer(GLuint buffer);
+    static void TrackTexture(GLuint texture, MemoryCategory category, size_t bytes);
+    static void UntrackTexture(GLuint texture);
+
+    static void AddCpuBytes(MemoryCategory category, size_t bytes);
+    static void RemoveCpuBytes(MemoryCategory category, size_t bytes);
+
+    static size_t GetBytes(MemoryCategory category) {
+        return s_bytes[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+    }
+    // GL objects for the GPU categories; 0 for the CPU ones
+    static size_t GetObjectCount(MemoryCategory category) {
+        return s_objects[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+    }
+    static size_t GetGpuTotal();
+    static size_t GetCpuTotal();
+
+    static bool IsGpuCategory(MemoryCategory category) { return category < MemoryCategory::MESH_CPU; }
+    static const char* GetCategoryName(MemoryCategory category);
+
+private:
+    static std::atomic<size_t> s_bytes[static_cast<size_t>(MemoryCategory::COUNT)];
+    static std::atomic<size_t> s_objects[static_cast<size_t>(MemoryCategory::COUNT)];
+};
+
+#endif // MEMORY_STATS_H
@@ -3,7 +3,9 @@
 
 #include <iostream> // For std::cout in print()
 #include <vector>   // For std::vector
-#include <string>   // Often useful, though not directly used here yet
+#include <string>
+#include <cstdint>
+#include <memory>
 
 // Include GLEW before GLFW (good practice)
 #include <GL/glew.h>
@@ -14,47 +16,189 @@
 #include <glm/gtc/matrix_transform.hpp> // Often used with meshes, though not directly here
 #include <glm/gtc/type_ptr.hpp>         // For passing data to OpenGL
 
+// CPU-side vertex as meshes are authored / imported. The GPU copy is packed according to a VertexLayout.
 struct Vertex {
     glm::vec3 Position;
     glm::vec3 Color;     // Matches shader input `aColor`
     glm::vec2 TexCoords; // Matches shader input `aTexCoord`
+    glm::vec3 Normal;    // Matches shader input `aNormal` (location 3)
 
     // --- ADDED CONSTRUCTOR ---
     // Constructor to initialize all members
-    Vertex(const glm::vec3& pos, const glm::vec3& col, const glm::vec2& uv)
-        : Position(pos), Color(col), TexCoords(uv) {}
+    Vertex(const glm::vec3& pos, const glm::vec3& col, const glm::vec2& uv, const glm::vec3& normal = glm::vec3(0.0f, 1.0f, 0.0f))
+        : Position(pos), Color(col), TexCoords(uv), Normal(normal) {}
     // -------------------------
 
     // Print function for debugging
     void print() const {
         std::cout << "Position: (" << Position.x << ", " << Position.y << ", " << Position.z << "), "
                   << "Color: (" << Color.r << ", " << Color.g << ", " << Color.b << "), "
-                  << "TexCoords: (" << TexCoords.x << ", " << TexCoords.y << ")" << std::endl;
+                  << "TexCoords: (" << TexCoords.x << ", " << TexCoords.y << "), "
+                  << "Normal: (" << Normal.x << ", " << Normal.y << ", " << Normal.z << ")" << std::endl;
     }
 }; // End of Vertex struct
 
+// How a mesh's vertices are packed in its VBO. Position is always 3 floats (location 0); the rest is optional:
+//   normals   (location 3): none, 3 floats, or signed-normalized 10-10-10-2 (4 bytes)
+//   texcoords (location 2): 2 floats or 2 half floats
+//   color     (location 1): RGBA8 unorm; without it the attribute is the constant white the shaders used to get
+// The default is the compact layout: 20 bytes per vertex instead of the 44 of Vertex.
+struct VertexLayout {
+    enum class Normals : uint8_t { NONE, FLOAT3, PACKED_10_10_10_2 };
+    enum class TexCoords : uint8_t { FLOAT2, HALF2 };
+
+    Normals normals = Normals::PACKED_10_10_10_2;
+    TexCoords texCoords = TexCoords::HALF2;
+    bool color = false;
+
+    // Full precision, everything included (the old 32-byte layout plus normals)
+    static VertexLayout Full();
+    // Compact layout for `vertices`: colors kept only if requested, UVs stay float when they tile
+    // far enough out (beyond +-2) that half precision would visibly swim
+    static VertexLayout Choose(const std::vector<Vertex>& vertices, bool keepColor);
+
+    size_t GetStride() const;
+    size_t GetNormalOffset() const;
+    size_t GetTexCoordOffset() const;
+    size_t GetColorOffset() const;
+
+    // Round trip through a small integer, for cooked files
+    uint32_t Encode() const;
+    static bool Decode(uint32_t code, VertexLayout& layout);
+
+    // Writes `count` vertices into `out` (GetStride() * count bytes)
+    void PackVertices(const Vertex* vertices, size_t count, unsigned char* out) const;
+    // Sets up the attribute pointers for the VBO bound to GL_ARRAY_BUFFER (VAO must be bound)
+    void Apply() const;
+    // Current values for the attributes this layout leaves out; call before drawing (they are context state, not VAO state)
+    void ApplyConstants() const;
+
+    bool operator==(const VertexLayout& other) const { return normals == other.normals && texCoords == other.texCoords && color == other.color; }
+};
+
+// 16-bit indices whenever every vertex can be addressed with them
+inline GLenum IndexTypeForVertexCount(size_t vertexCount) { return vertexCount <= 65536 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT; }
+inline size_t IndexSize(GLenum indexType) { return indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t); }
+
+// One level of detail: a range of the mesh's index buffer over the shared vertices
+struct MeshLod {
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    float error = 0.0f; // Object-space deviation from LOD 0 (0 for LOD 0 itself)
+};
+static const size_t MAX_MESH_LODS = 6;
+
+// GPU-ready mesh data (vertices packed by `layout`, indices of `indexType`) as produced by an import.
+// When it comes from the mesh cache the vectors stay empty and the mapped* pointers reference the
+// memory-mapped cooked file instead (see MeshCache).
+struct MeshData {
+    std::string name;
+    VertexLayout layout;
+    GLenum indexType = GL_UNSIGNED_INT;
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+    std::vector<unsigned char> vertexBytes;
+    std::vector<unsigned char> indexBytes;
+    const unsigned char* mappedVertices = nullptr;
+    const unsigned char* mappedIndices = nullptr;
+    std::vector<MeshLod> lods;      // At least LOD 0; finer first
+    glm::vec3 boundsCenter = glm::vec3(0.0f);
+    float boundsRadius = 0.0f;
+
+    // Fills vertexBytes / indexBytes from authored data, the bounds, and a single LOD covering every index
+    void Pack(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, const VertexLayout& packLayout);
+
+    const unsigned char* GetVertexBytes() const { return mappedVertices ? mappedVertices : vertexBytes.data(); }
+    const unsigned char* GetIndexBytes() const { return mappedIndices ? mappedIndices : indexBytes.data(); }
+    size_t GetVertexByteSize() const { return vertexCount * layout.GetStride(); }
+    size_t GetIndexByteSize() const { return indexCount * IndexSize(indexType); }
+};
+
+class MeshPool;
+struct MeshAllocation;
+
 class Mesh {
 public:
-    // Mesh data (public for easy access, consider getters if needed)
+    // Mesh data (public for easy access, consider getters if needed). Only filled by the authored-data constructor,
+    // and emptied with the packed copy when the mesh releases its CPU data.
     std::vector<Vertex>       vertices;
     std::vector<unsigned int> indices;
     unsigned int              VAO; // Keep VAO public if Renderer needs to bind it directly
 
-    // Constructor: Takes vertex and index data, then calls setupMesh
-    Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices);
+    // Constructor: Takes vertex and index data, packs them with `layout`, then calls setupMesh
+    Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, const VertexLayout& layout = VertexLayout());
+
+    // Constructor for streamed uploads: takes ownership of packed data and only allocates GPU storage.
+    // The data is then copied over several frames with UploadChunk() (see AssetImporter). If `data` points into
+    // external memory (a memory-mapped cooked mesh) nothing is copied on the CPU; the memory must stay valid
+    // until IsUploaded() returns true.
+    // With a `pool` the mesh is sub-allocated from the pool's shared buffers (VAO is then the pool's); it falls
+    // back to its own buffers if the pool cannot take it. The pool must outlive the mesh.
+    Mesh(MeshData&& data, bool deferUpload, MeshPool* pool = nullptr);
+
+    // Owns GL objects and may point into its own vectors, so it is not copyable
+    Mesh(const Mesh&) = delete;
+    Mesh& operator=(const Mesh&) = delete;
 
     // Destructor (important for cleaning up OpenGL objects)
     ~Mesh(); // Added destructor declaration
 
-    // Render the mesh (binds VAO and calls glDrawElements)
-    void Draw();
+    // Render the mesh (binds VAO and calls glDrawElements). Does nothing until the upload is complete.
+    void Draw(size_t lod = 0);
+
+    // Coarsest LOD whose error, seen from `distance`, stays within maxErrorPixels.
+    // pixelsPerUnit is the viewport height over 2*tan(fovY/2), i.e. pixels covered by one unit at distance 1.
+    size_t SelectLod(float distance, float pixelsPerUnit, float maxErrorPixels) const;
+    size_t GetLodCount() const { return m_data.lods.size(); }
+    const MeshLod& GetLod(size_t lod) const { return m_data.lods[lod]; }
+    const glm::vec3& GetBoundsCenter() const { return m_data.boundsCenter; }
+    float GetBoundsRadius() const { return m_data.boundsRadius; }
+
+    // Uploads up to maxBytes of the remaining vertex/index data. Returns true once everything is on the GPU.
+    bool UploadChunk(size_t maxBytes);
+    bool IsUploaded() const { return m_uploaded; }
+    // Frees the authored vectors and the packed copy once everything is on the GPU (at once if it already is).
+    // Drawing only needs the GPU buffers; keep the data for meshes whose vertices are read back on the CPU.
+    void SetReleaseCpuDataAfterUpload(bool release);
+    bool HasCpuData() const { return m_cpuBytes > 0; }
+    size_t GetCpuSizeBytes() const { return m_cpuBytes; }
+    size_t GetGpuSizeBytes() const { return m_data.GetVertexByteSize() + m_data.GetIndexByteSize(); }
+    size_t GetIndexCount() const { return m_data.indexCount; }
+    const VertexLayout& GetLayout() const { return m_data.layout; }
+    GLenum GetIndexType() const { return m_data.indexType; }
+    // Draw parameters including the mesh's place in its pool (0 / the LOD's own range when not pooled)
+    bool IsPooled() const { return m_pool != nullptr; }
+    int32_t GetBaseVertex() const { return m_baseVertex; }
+    uint32_t GetFirstIndex(size_t lod) const { return m_data.lods[lod].firstIndex + m_poolFirstIndex; }
 
 private:
     // Render data - VBO (Vertex Buffer Object), EBO (Element Buffer Object)
     unsigned int VBO, EBO;
 
-    // Initializes VAO, VBO, EBO, and sets up vertex attribute pointers
-    void setupMesh();
+    // Upload source: packed bytes owned here, or external memory
+    MeshData m_data;
+
+    // Shared-buffer placement (VBO / EBO stay 0 while pooled)
+    MeshPool* m_pool = nullptr;
+    std::unique_ptr<MeshAllocation> m_allocation;
+    int32_t m_baseVertex = 0;
+    uint32_t m_poolFirstIndex = 0;
+
+    // Streamed upload progress (bytes already copied into VBO / EBO)
+    size_t m_uploadedVertexBytes = 0;
+    size_t m_uploadedIndexBytes = 0;
+    bool m_uploaded = false;
+
+    bool m_releaseCpuData = false;
+    size_t m_cpuBytes = 0; // What this mesh reports to MemoryStats as MESH_CPU
+
+    // Initializes VAO, VBO, EBO, and sets up vertex attribute pointers.
+    // With uploadData == false the buffers are only allocated.
+    void setupMesh(bool uploadData = true);
+
+    void releaseCpuData();
+    // Reports the current size of the vectors to MemoryStats
+    void updateCpuBytes();
 
     // Helper to delete OpenGL buffers (called by destructor)
     void cleanupMesh(); // Added cleanup helper declaration
@@ -0,0 +1,40 @@
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Mesh.h"
+#include "MappedFile.h"
+
+// Cooked mesh files, so a model opened again skips Assimp entirely.
+//
+// Layout (little endian, native struct layout):
+//   CookedMeshHeader
+//   CookedMeshEntry[meshCount]
+//   per mesh, each array aligned to COOKED_MESH_ALIGNMENT:
+//     vertexCount packed vertices, in the entry's VertexLayout, exactly as Mesh::setupMesh uploads them
+//     indexCount 16- or 32-bit indices (every LOD back to back; the entry holds the LOD table)
+//
+// Files live in the cache directory, named after a hash of the absolute source path; the header records the
+// source's size and mtime, so an edited source is re-cooked (overwriting the stale file) on its next import.
+class MeshCache {
+public:
+    static const uint32_t VERSION = 3; // 2: per-mesh vertex layouts and 16-bit indices, 3: LOD tables and bounds
+
+    explicit MeshCache(std::filesystem::path cacheDirectory = "cache/meshes");
+
+    // Maps the cooked file for `sourcePath` if it is valid for the current source. On success `meshes` point into `mapping`.
+    bool Load(const std::string& sourcePath, std::shared_ptr<MappedFile>& mapping, std::vector<MeshData>& meshes) const;
+    // Writes the cooked file for `sourcePath` (to a temp file, then renamed into place)
+    bool Store(const std::string& sourcePath, const std::vector<MeshData>& meshes) const;
+
+    std::filesystem::path GetCachePath(const std::string& sourcePath) const;
+
+private:
+    std::filesystem::path m_directory;
+};
+
+#endif // MESH_CACHE_H
@@ -0,0 +1,21 @@
+#ifndef MESH_LOD_BUILDER_H
+#define MESH_LOD_BUILDER_H
+
+#include <vector>
+#include "Mesh.h"
+
+// Import-time mesh processing on top of meshoptimizer (runs on the importer's worker threads).
+//
+// Optimize() reorders triangles for the post-transform vertex cache, then for overdraw, then reorders
+// the vertices themselves so fetches walk the VBO front to back.
+// BuildLods() appends progressively simplified index sets over the same vertices; each LOD is a range of
+// the one index buffer, with the object-space error the renderer turns into a screen-space size.
+class MeshLodBuilder {
+public:
+    static void Optimize(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+
+    // `indices` holds LOD 0 on entry and every LOD, back to back, on return. The table starts with LOD 0.
+    static std::vector<MeshLod> BuildLods(const std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+};
+
+#endif // MESH_LOD_BUILDER_H
@@ -0,0 +1,73 @@
+#ifndef MESH_POOL_H
+#define MESH_POOL_H
+
+#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Mesh.h"
+
+// Where one mesh lives inside a MeshPool. Offsets are in vertices / indices of the bucket, so they are
+// directly the baseVertex / firstIndex of a draw.
+struct MeshAllocation {
+    int bucket = -1;
+    size_t firstVertex = 0, vertexCount = 0;
+    size_t firstIndex = 0, indexCount = 0;
+
+    bool IsValid() const { return bucket >= 0; }
+};
+
+// Static geometry sub-allocated from a few large buffers instead of one VBO/EBO/VAO per mesh.
+// Meshes are grouped into buckets by (VertexLayout, index type), each with one VBO, one EBO and one VAO,
+// so every mesh of a bucket draws with the same VAO and can be merged into one multi-draw.
+// Freed ranges go back to first-fit free lists (neighbours coalesced); a full bucket grows by doubling,
+// copying its contents on the GPU, without moving existing allocations.
+class MeshPool {
+public:
+    MeshPool() = default;
+    ~MeshPool();
+
+    MeshPool(const MeshPool&) = delete;
+    MeshPool& operator=(const MeshPool&) = delete;
+
+    bool Allocate(const VertexLayout& layout, GLenum indexType, size_t vertexCount, size_t indexCount, MeshAllocation& allocation);
+    void Free(MeshAllocation& allocation);
+    void Destroy(); // Outstanding allocations become invalid
+
+    // `byteOffset` is relative to the allocation's start
+    void UploadVertices(const MeshAllocation& allocation, size_t byteOffset, const void* data, size_t bytes);
+    void UploadIndices(const MeshAllocation& allocation, size_t byteOffset, const void* data, size_t bytes);
+
+    GLuint GetVAO(const MeshAllocation& allocation) const { return m_buckets[allocation.bucket].vao; }
+    size_t GetBucketCount() const { return m_buckets.size(); }
+    size_t GetUsedBytes() const;
+    size_t GetCapacityBytes() const;
+
+private:
+    struct Range {
+        size_t offset = 0, size = 0;
+    };
+    // First-fit free list over [0, capacity), sorted by offset
+    struct RangeAllocator {
+        std::vector<Range> freeRanges;
+        size_t capacity = 0;
+        size_t used = 0;
+
+        bool Allocate(size_t size, size_t& offset);
+        void Release(size_t offset, size_t size);
+        void Grow(size_t newCapacity);
+    };
+    struct Bucket {
+        VertexLayout layout;
+        GLenum indexType = GL_UNSIGNED_INT;
+        GLuint vao = 0, vbo = 0, ebo = 0;
+        RangeAllocator vertices, indices;
+    };
+    std::vector<Bucket> m_buckets;
+
+    int findBucket(const VertexLayout& layout, GLenum indexType);
+    bool growBuffer(GLuint& buffer, size_t oldBytes, size_t newBytes);
+    void bindBuffers(Bucket& bucket);
+};
+
+#endif // MESH_POOL_H
@@ -0,0 +1,42 @@
+#ifndef PHYSICS_TASK_SCHEDULER_H
+#define PHYSICS_TASK_SCHEDULER_H
+
+#include <LinearMath/btThreads.h>
+#include <atomic>
+#include "ThreadPool.h"
+
+// Bullet task scheduler over a dedicated ThreadPool, for btDiscreteDynamicsWorldMt and friends.
+// parallelFor / parallelSum split the range into grainSize chunks handed out through an atomic cursor;
+// the calling (physics) thread works through chunks alongside the workers and returns once all are done.
+//
+// Bullet keeps per-thread data indexed by btGetCurrentThreadIndex(), which it hands out on each
+// thread's first call; getNumThreads() has to cover every index that can run a chunk. The main thread
+// holds 0 (btSetTaskScheduler asserts that), ClaimThreadIndices() gives the workers 1..N, and the
+// physics thread that steps the world takes N + 1 on its first step.
+class PhysicsTaskScheduler : public btITaskScheduler {
+public:
+    // workerThreads == 0 picks hardware_concurrency() - 2 (the GL and physics threads keep a core each), at least 1
+    explicit PhysicsTaskScheduler(unsigned int workerThreads = 0);
+    ~PhysicsTaskScheduler() override = default;
+
+    // Main thread, straight after btSetTaskScheduler(this)
+    void ClaimThreadIndices();
+
+    int getMaxNumThreads() const override { return m_threadIndexCount; }
+    int getNumThreads() const override { return m_threadIndexCount; }
+    void setNumThreads(int) override {} // Fixed by the pool size
+    void parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body) override;
+    btScalar parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body) override;
+
+    unsigned int GetWorkerCount() const { return m_pool.GetThreadCount(); }
+
+private:
+    ThreadPool m_pool;
+    int m_threadIndexCount;
+    std::atomic<bool> m_running{false}; // A loop is in flight; nested loops run inline
+
+    template <typename ChunkFn>
+    void run(int iBegin, int iEnd, int grainSize, const ChunkFn& chunk);
+};
+
+#endif // PHYSICS_TASK_SCHEDULER_H
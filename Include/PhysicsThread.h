@@ -0,0 +1,96 @@
+#ifndef PHYSICS_THREAD_H
+#define PHYSICS_THREAD_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include "PhysicsWorld.h"
+
+enum class PhysicsShape { BOX, SPHERE, OTHER };
+
+// Render-side copy of one dynamic body for the last two ticks
+struct PhysicsBodyState {
+    const btRigidBody* body = nullptr; // Identity only; never dereferenced outside the world lock
+    PhysicsShape shape = PhysicsShape::OTHER;
+    glm::vec3 scale = glm::vec3(1.0f);  // Applied to the unit render mesh (sphere diameter, box extents)
+    glm::vec3 prevPosition = glm::vec3(0.0f), position = glm::vec3(0.0f);
+    glm::quat prevRotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f), rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+};
+
+struct PhysicsSnapshot {
+    std::vector<PhysicsBodyState> bodies;
+    std::chrono::steady_clock::time_point tickTime; // When `position` / `rotation` became current
+    uint64_t tick = 0;
+};
+
+// Steps the Bullet world on its own thread at a fixed rate and publishes body transforms through a
+// lock-free triple buffer. The renderer draws one tick behind, interpolating prev -> current by
+// GetInterpolationAlpha(), so render FPS and simulation cost no longer affect each other.
+// Anything else touching the world (UI, editing) must hold LockWorld().
+class PhysicsThread {
+public:
+    explicit PhysicsThread(btDiscreteDynamicsWorld* world, float fixedTimeStep = 1.0f / 60.0f);
+    ~PhysicsThread();
+
+    PhysicsThread(const PhysicsThread&) = delete;
+    PhysicsThread& operator=(const PhysicsThread&) = delete;
+
+    void Start();
+    void Stop();
+
+    // Stepping only happens while simulating (PLAYING); snapshots keep being available either way
+    void SetSimulating(bool simulating);
+    bool IsSimulating() const { return m_simulating.load(); }
+
+    // Render thread: returns the newest published snapshot. Valid until the next call.
+    const PhysicsSnapshot& AcquireSnapshot();
+    // 0 = snapshot's previous tick, 1 = its current tick
+    float GetInterpolationAlpha(const PhysicsSnapshot& snapshot) const;
+
+    std::unique_lock<std::mutex> LockWorld() { return std::unique_lock<std::mutex>(m_worldMutex); }
+    // Re-publishes the world state (e.g. after bodies were added while paused)
+    void RequestSnapshot() { m_snapshotRequested = true; m_wake.notify_one(); }
+
+    btDiscreteDynamicsWorld* GetWorld() const { return m_world; }
+    float GetFixedTimeStep() const { return m_fixedTimeStep; }
+    float GetLastStepMs() const { return m_lastStepMs.load(); }
+    uint64_t GetTickCount() const { return m_tickCount.load(); }
+    // Counters and Bullet profile of the latest step (stepSimulation alone, without publishing)
+    void CopyStepStats(PhysicsStepStats& stats) const;
+
+private:
+    static const int SNAPSHOT_FRESH_BIT = 4; // Set on m_latest when the writer published since the last acquire
+
+    btDiscreteDynamicsWorld* m_world;
+    float m_fixedTimeStep;
+    std::thread m_thread;
+    std::mutex m_worldMutex;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_simulating{false};
+    std::atomic<bool> m_snapshotRequested{true};
+    std::atomic<float> m_lastStepMs{0.0f};
+    std::atomic<uint64_t> m_tickCount{0};
+    mutable std::mutex m_statsMutex;
+    PhysicsStepStats m_stepStats; // Guarded by m_statsMutex
+    PhysicsStepStats m_stepStatsScratch; // Thread-only; swapped into m_stepStats after each step
+
+    // Triple buffer: the writer owns m_back, the reader owns m_front, m_latest holds the third (+ fresh bit)
+    PhysicsSnapshot m_snapshots[3];
+    int m_back = 0;
+    int m_front = 1;
+    std::atomic<int> m_latest{2};
+    std::vector<PhysicsBodyState> m_lastPublished; // Writer-only copy of the previous tick
+
+    void threadLoop();
+    void publishSnapshot(uint64_t tick);
+};
+
+#endif // PHYSICS_THREAD_H
@@ -0,0 +1,128 @@
+#ifndef PHYSICS_WORLD_H
+#define PHYSICS_WORLD_H
+
+#include <btBulletDynamicsCommon.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "TerrainCollider.h"
+
+class PhysicsTaskScheduler;
+class btConstraintSolverPoolMt;
+struct SceneBodyRecord;
+
+// Chosen at startup (command line); the world cannot switch configuration once built
+struct PhysicsThreadingSettings {
+    bool multithreaded = false;    // btDiscreteDynamicsWorldMt + parallel dispatcher / solver
+    unsigned int workerThreads = 0; // Scheduler pool size, 0 = hardware_concurrency() - 2
+};
+
+// Stress scenes for measuring how broadphase, narrowphase and solver scale with body count
+enum class StressLayout { STACKS, RAIN, PILE };
+
+struct StressSceneSettings {
+    StressLayout layout = StressLayout::PILE;
+    int bodyCount = 1000;
+    float sphereFraction = 0.5f; // Share of spheres (stacks are always boxes)
+    unsigned int seed = 1;
+};
+
+// One node of Bullet's CProfileManager tree for a single step, flattened depth first
+struct PhysicsProfileNode {
+    std::string name;
+    int depth = 0;
+    float totalMs = 0.0f;
+    int calls = 0;
+};
+
+// What one stepSimulation call cost and what it worked on
+struct PhysicsStepStats {
+    float stepMs = 0.0f;
+    int overlappingPairs = 0; // Broadphase pairs
+    int contactManifolds = 0; // Narrowphase manifolds
+    int collisionObjects = 0;
+    std::vector<PhysicsProfileNode> profile;
+};
+
+// Owns the Bullet world and the demo scene (ground plane, falling cube, bouncing sphere) plus the
+// heightfield collider for the noise terrain (on by default; the plane stays as a floor under it).
+// Shared by the editor and the benchmark so both simulate exactly the same setup.
+class PhysicsWorld {
+public:
+    PhysicsWorld();
+    ~PhysicsWorld();
+
+    PhysicsWorld(const PhysicsWorld&) = delete;
+    PhysicsWorld& operator=(const PhysicsWorld&) = delete;
+
+    // Builds the world and the scene. `seed` drives the solver's constraint-order randomisation,
+    // so two single-threaded runs with the same seed and the same fixed steps produce identical results
+    // (the multi-threaded world solves islands in whatever order the workers pick them up).
+    // Must be called on the main thread: Bullet requires it to install the task scheduler.
+    bool Initialize(unsigned long seed = 0, const PhysicsThreadingSettings& threading = PhysicsThreadingSettings());
+    void Shutdown();
+
+    btDiscreteDynamicsWorld* GetWorld() const { return m_dynamicsWorld.get(); }
+    const std::vector<btRigidBody*>& GetBodies() const { return m_bodies; }
+    bool IsMultithreaded() const { return m_taskScheduler != nullptr; }
+
+    // Adds settings.bodyCount unit boxes / spheres (shared shapes) in the given layout; returns how many.
+    // While a PhysicsThread runs the world, hold its LockWorld() around these.
+    size_t SpawnStressBodies(const StressSceneSettings& settings);
+    void ClearStressBodies();
+    size_t GetStressBodyCount() const { return m_stressBodies.size(); }
+    static const char* GetStressLayoutName(StressLayout layout);
+
+    // Scene files. Capture lists every dynamic body (demo scene and stress set) with a box or sphere shape;
+    // Clear removes them all (the ground plane and terrain tiles stay). Add creates bodies from the records,
+    // SCENE_BODY_STRESS ones into the stress set, and returns how many it created (records with non-finite values,
+    // a zero rotation or a degenerate shape are skipped; rotations are normalised). Bodies of equal shape and
+    // size share one btCollisionShape. While a PhysicsThread runs the world, hold its LockWorld() around these.
+    void CaptureSceneBodies(std::vector<SceneBodyRecord>& records) const;
+    void ClearSceneBodies();
+    size_t AddSceneBodies(const SceneBodyRecord* records, size_t count);
+
+    // Call on the thread that just stepped: Bullet's profiler keeps one tree per thread and
+    // stepSimulation resets it, so it holds exactly the last step.
+    static void CaptureStepStats(btDiscreteDynamicsWorld* world, float stepMs, PhysicsStepStats& stats);
+    unsigned int GetWorkerThreadCount() const; // 0 when single-threaded
+
+    // Terrain collision. Safe from any thread: the change is picked up by the next tick's pre-tick callback,
+    // where the collider streams its tiles.
+    void SetTerrainParams(const TerrainParams& params);
+    void SetTerrainCollisionEnabled(bool enabled);
+    bool IsTerrainCollisionEnabled() const;
+    TerrainColliderStats GetTerrainStats() const;
+
+private:
+    std::unique_ptr<btDefaultCollisionConfiguration> m_collisionConfiguration;
+    std::unique_ptr<btCollisionDispatcher> m_dispatcher;
+    std::unique_ptr<btBroadphaseInterface> m_overlappingPairCache;
+    std::unique_ptr<btSequentialImpulseConstraintSolver> m_solver; // btSequentialImpulseConstraintSolverMt when multithreaded
+    std::unique_ptr<btConstraintSolverPoolMt> m_solverPool;         // Multithreaded only: per-island solvers
+    std::unique_ptr<PhysicsTaskScheduler> m_taskScheduler;
+    std::unique_ptr<btDiscreteDynamicsWorld> m_dynamicsWorld;
+    std::vector<std::unique_ptr<btCollisionShape>> m_collisionShapes;
+    std::vector<btRigidBody*> m_bodies; // Dynamic bodies of the demo scene (the ground plane is not listed)
+    std::vector<btRigidBody*> m_stressBodies;
+    // Box / sphere shapes shared by stress and scene bodies, keyed by (SceneBodyShape, size); owned by m_collisionShapes
+    std::map<std::tuple<uint32_t, float, float, float>, btCollisionShape*> m_sharedShapes;
+
+    // Written by the setters above, applied on the stepping thread
+    std::unique_ptr<TerrainCollider> m_terrainCollider;
+    mutable std::mutex m_terrainMutex;
+    TerrainParams m_terrainParams;
+    bool m_terrainEnabled = true;
+    TerrainColliderStats m_terrainStats;
+
+    void createScene();
+    void updateTerrain(float timeStep);
+    static void preTickCallback(btDynamicsWorld* world, btScalar timeStep);
+    btRigidBody* addStressBody(bool sphere, const btTransform& transform);
+    btCollisionShape* getSharedShape(uint32_t shape, const btVector3& size); // size: half extents, or radius in x
+};
+
+#endif // PHYSICS_WORLD_H
@@ -0,0 +1,141 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <GL/glew.h>
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Rolling statistics over the recent samples of one section, in milliseconds
+struct ProfileStats {
+    float lastMs = 0.0f;
+    float averageMs = 0.0f;
+    float p95Ms = 0.0f;
+    float p99Ms = 0.0f;
+    size_t sampleCount = 0;
+};
+
+// Fixed-size ring of per-frame timings
+class SampleHistory {
+public:
+    explicit SampleHistory(size_t capacity);
+
+    void Push(float value);
+    ProfileStats ComputeStats() const;
+    // Raw ring for ImGui::PlotLines: `offset` is the index of the oldest sample
+    const float* GetData() const { return m_samples.data(); }
+    int GetSize() const { return static_cast<int>(m_samples.size()); }
+    int GetOffset() const { return static_cast<int>(m_head); }
+    size_t GetCount() const { return m_count; }
+    // Samples pushed since construction (keeps counting after the ring wraps), for polling new samples
+    size_t GetPushCount() const { return m_pushCount; }
+    float GetLast() const { return m_count ? m_samples[(m_head + m_samples.size() - 1) % m_samples.size()] : 0.0f; }
+
+private:
+    std::vector<float> m_samples;
+    size_t m_head = 0;  // Next slot to write
+    size_t m_count = 0; // Valid samples (<= capacity)
+    size_t m_pushCount = 0;
+};
+
+// Per-pass CPU and GPU timings for the render thread.
+// CPU time is measured with steady_clock around each section. GPU time uses a pair of GL_TIMESTAMP
+// queries per section (timestamps nest, GL_TIME_ELAPSED does not); the queries of a frame are only
+// read back PROFILER_QUERY_FRAMES frames later, when they are normally long finished, so profiling
+// never stalls the pipeline. Results that are still not available are dropped instead of waited on.
+// Everything runs on the GL thread; timings taken on other threads are handed in with AddCpuSample.
+class Profiler {
+public:
+    // historyFrames = samples kept per section, 0 = PROFILER_HISTORY_FRAMES
+    explicit Profiler(size_t historyFrames = 0);
+    ~Profiler();
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    // Reads back the oldest frame's GPU queries and records the frame-to-frame interval
+    void BeginFrame();
+    void EndFrame();
+    // Drops all samples and any queries still in flight (e.g. after warmup frames)
+    void Reset();
+    // Waits for the GPU and collects every outstanding query. Stalls; only for the end of a run.
+    void Flush();
+
+    // Sections are keyed by name (string literals; the pointer is compared first).
+    // Returns a handle for EndSection. gpu = false skips the timer queries (pure CPU work).
+    int BeginSection(const char* name, bool gpu = true);
+    void EndSection(int section);
+    // Timing measured elsewhere, e.g. the physics thread's step time
+    void AddCpuSample(const char* name, float ms);
+
+    void SetEnabled(bool enabled) { m_enabled = enabled; }
+    bool IsEnabled() const { return m_enabled; }
+
+    size_t GetSectionCount() const { return m_sections.size(); }
+    // -1 if no section of that name has been recorded yet
+    int FindSection(const char* name) const;
+    const std::string& GetSectionName(size_t section) const { return m_sections[section].name; }
+    bool HasGpuTiming(size_t section) const { return m_sections[section].hasGpu; }
+    ProfileStats GetCpuStats(size_t section) const { return m_sections[section].cpu.ComputeStats(); }
+    ProfileStats GetGpuStats(size_t section) const { return m_sections[section].gpu.ComputeStats(); }
+    const SampleHistory& GetGpuHistory(size_t section) const { return m_sections[section].gpu; }
+    const SampleHistory& GetFrameHistory() const { return m_frameHistory; }
+    unsigned int GetDroppedQueryCount() const { return m_droppedQueries; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Section {
+        const char* key = nullptr;
+        std::string name;
+        bool hasGpu = false;
+        SampleHistory cpu, gpu;
+        Clock::time_point cpuStart;
+        int openQuery = -1; // Index into the current frame's query list while the section is open
+        Section(const char* sectionName, size_t historyFrames);
+    };
+
+    struct TimerQuery {
+        GLuint begin = 0, end = 0;
+        int section = -1;
+    };
+
+    // Queries recorded during one frame; the objects are reused when the slot comes round again
+    struct FrameQueries {
+        std::vector<TimerQuery> queries;
+        size_t used = 0;
+    };
+
+    static const size_t PROFILER_QUERY_FRAMES = 4;
+
+    size_t m_historyFrames;
+    std::vector<Section> m_sections;
+    std::array<FrameQueries, PROFILER_QUERY_FRAMES> m_frames;
+    size_t m_frameSlot = 0;
+    SampleHistory m_frameHistory;
+    Clock::time_point m_lastFrameStart;
+    bool m_hasLastFrame = false;
+    bool m_enabled = true;
+    unsigned int m_droppedQueries = 0;
+
+    int findSection(const char* name);
+    void readBack(FrameQueries& frame);
+};
+
+// Times the enclosing scope as one profiler section. Does nothing when profiler is null.
+class ProfileScope {
+public:
+    ProfileScope(Profiler* profiler, const char* name, bool gpu = true)
+        : m_profiler(profiler), m_section(profiler ? profiler->BeginSection(name, gpu) : -1) {}
+    ~ProfileScope() { if (m_profiler) m_profiler->EndSection(m_section); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    Profiler* m_profiler;
+    int m_section;
+};
+
+#endif // PROFILER_H
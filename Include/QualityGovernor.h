@@ -0,0 +1,65 @@
+#ifndef QUALITY_GOVERNOR_H
+#define QUALITY_GOVERNOR_H
+
+#include <cstddef>
+
+// The raymarch knobs the governor trades for frame time
+struct QualitySettings {
+    int raymarchScaleDivisor = 1; // 1 = native, 2 / 4 = temporal upsample
+    int maxTerrainOctaves = 8;    // Cap on u_terrain_octaves (the Terrain panel value still applies below it)
+    int terrainSteps = 100;
+    int cloudSteps = 80;
+    int shadowSteps = 32;
+    int cloudUpdateGrid = 2;      // Clouds marched in one pixel of each N x N block per frame, the rest reprojected
+
+    bool operator==(const QualitySettings& other) const {
+        return raymarchScaleDivisor == other.raymarchScaleDivisor && maxTerrainOctaves == other.maxTerrainOctaves &&
+               terrainSteps == other.terrainSteps && cloudSteps == other.cloudSteps && shadowSteps == other.shadowSteps &&
+               cloudUpdateGrid == other.cloudUpdateGrid;
+    }
+    bool operator!=(const QualitySettings& other) const { return !(*this == other); }
+};
+
+// Holds a GPU frame-time budget by moving along a fixed ladder of quality tiers (0 = best).
+// Samples are averaged over a window; a window over budget drops one tier, and only several
+// consecutive windows well under budget raise one. Every change is followed by a settle window
+// (GPU timings arrive a few frames late and the upsampler rebuilds its history), and a tier that is
+// left again right after being entered makes the next step up wait longer, so the governor does not
+// oscillate between two tiers that straddle the budget.
+class QualityGovernor {
+public:
+    QualityGovernor();
+
+    void SetEnabled(bool enabled);
+    bool IsEnabled() const { return m_enabled; }
+    void SetBudgetMs(float budgetMs) { m_budgetMs = budgetMs; }
+    float GetBudgetMs() const { return m_budgetMs; }
+
+    // One GPU frame time (ms). Returns true if the tier changed.
+    bool AddFrameSample(float gpuMs);
+
+    size_t GetTier() const { return m_tier; }
+    static size_t GetTierCount();
+    static const char* GetTierName(size_t tier);
+    const QualitySettings& GetSettings() const;
+    // Average of the last complete window (0 until one has been measured)
+    float GetMeasuredMs() const { return m_measuredMs; }
+
+private:
+    bool m_enabled = false;
+    float m_budgetMs = 8.3f;
+    size_t m_tier = 0;
+
+    double m_windowSum = 0.0;
+    size_t m_windowSamples = 0;
+    float m_measuredMs = 0.0f;
+    size_t m_settleWindows = 0;      // Windows still ignored after the last change
+    size_t m_underBudgetWindows = 0; // Consecutive windows with headroom
+    size_t m_upgradeWindows = 0;     // Windows of headroom required before the next step up
+    size_t m_windowsInTier = 0;
+    bool m_enteredByUpgrade = false;
+
+    void setTier(size_t tier, bool upgrade);
+};
+
+#endif // QUALITY_GOVERNOR_H
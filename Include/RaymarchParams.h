@@ -0,0 +1,58 @@
+#ifndef RAYMARCH_PARAMS_H
+#define RAYMARCH_PARAMS_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+// Uniform buffer binding point of the RaymarchParams block (shaders/raymarch_params.glsl)
+static const GLuint RAYMARCH_PARAMS_BINDING = 0;
+static const char* const RAYMARCH_PARAMS_BLOCK_NAME = "RaymarchParams";
+
+// CPU mirror of the std140 RaymarchParams block. Each vec3 is followed by a float so it fills its 16-byte slot.
+struct RaymarchParamsBlock {
+    glm::vec3 lightDir;
+    float ambientStrength;
+    glm::vec3 lightColor;
+    float terrainBaseFreq;
+    float terrainBaseAmp;
+    float terrainPersistence;
+    float terrainFlattenPower;
+    float terrainFinalScale;
+    int   terrainOctaves;
+    float cloudBaseHeight;
+    float cloudThickness;
+    float cloudNoiseScale;
+    float cloudCoverageMin;
+    float cloudCoverageMax;
+    float cloudDensityFactor;
+    float cloudNoisePeriod;
+};
+static_assert(sizeof(RaymarchParamsBlock) == 80, "RaymarchParamsBlock must match the std140 layout of RaymarchParams");
+
+// The uniform buffer behind RaymarchParams. Update() compares against the last uploaded copy and only
+// touches the buffer when a value actually changed (i.e. when a slider moved).
+class RaymarchParamsBuffer {
+public:
+    RaymarchParamsBuffer() = default;
+    ~RaymarchParamsBuffer();
+
+    RaymarchParamsBuffer(const RaymarchParamsBuffer&) = delete;
+    RaymarchParamsBuffer& operator=(const RaymarchParamsBuffer&) = delete;
+
+    // Creates the buffer and binds it to RAYMARCH_PARAMS_BINDING
+    bool Create();
+    void Destroy();
+    // Returns true if the block was re-uploaded
+    bool Update(const RaymarchParamsBlock& params);
+
+    bool IsValid() const { return m_ubo != 0; }
+    unsigned int GetUploadCount() const { return m_uploadCount; }
+
+private:
+    GLuint m_ubo = 0;
+    RaymarchParamsBlock m_uploaded = {};
+    bool m_hasData = false;
+    unsigned int m_uploadCount = 0;
+};
+
+#endif // RAYMARCH_PARAMS_H
@@ -0,0 +1,114 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include "FrameArena.h"
+#include "Mesh.h"
+
+class Shader;
+class InstanceBuffer;
+
+// One indexed draw of the raster passes. Instanced draws take their model matrices from `instances`
+// (at instanceOffset, bound to attributes instanceAttribute..+3); the others use `model`.
+struct DrawCommand {
+    Shader* shader = nullptr;    // Must use the "view" / "projection" / "model" / "useTexture" / "texture1" uniforms
+    GLuint texture = 0;          // GL_TEXTURE_2D on unit 0, 0 = untextured
+    GLuint vao = 0;
+    VertexLayout layout;         // For the constant attributes the VAO leaves out
+    GLenum indexType = GL_UNSIGNED_INT;
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    int32_t baseVertex = 0;      // Non-zero for meshes in a MeshPool
+    glm::mat4 model = glm::mat4(1.0f);
+    const InstanceBuffer* instances = nullptr;
+    size_t instanceOffset = 0;
+    GLuint instanceAttribute = 0;
+    uint32_t instanceCount = 0;
+};
+
+// State changes the last Flush() calls actually made, to compare against the draw count
+struct RenderQueueStats {
+    size_t commands = 0;
+    size_t draws = 0;            // GL draw calls; a multi-draw counts once
+    size_t multiDraws = 0;
+    size_t programBinds = 0;
+    size_t textureBinds = 0;
+    size_t vaoBinds = 0;
+};
+
+// Collects the draws of a pass in the frame arena, sorts them by a packed state key
+// (program, then texture, then VAO; submission order breaks ties) and issues them with every
+// redundant program / texture / VAO / shared-uniform change skipped.
+// With multi-draw enabled, each run of non-instanced commands that share all of that state (in practice:
+// the meshes of one MeshPool bucket) becomes a single glMultiDrawElementsIndirect. Their model matrices go
+// to a per-draw buffer read as an instanced attribute, indexed through each indirect command's baseInstance.
+class RenderQueue {
+public:
+    explicit RenderQueue(FrameArena& arena) : m_arena(arena) {}
+    ~RenderQueue();
+
+    RenderQueue(const RenderQueue&) = delete;
+    RenderQueue& operator=(const RenderQueue&) = delete;
+
+    // glMultiDrawElementsIndirect with baseInstance (GL 4.3, or ARB_multi_draw_indirect + ARB_base_instance)
+    static bool SupportsMultiDraw();
+    // Draws runs of `shader` commands with `instancedVariant`, which must read the model matrix from
+    // instanceAttribute..+3 instead of the "model" uniform. Returns false if unsupported.
+    bool EnableMultiDraw(Shader* shader, Shader* instancedVariant, GLuint instanceAttribute);
+    void SetMultiDrawActive(bool active) { m_multiDrawActive = active; }
+    bool IsMultiDrawAvailable() const { return m_indirectBuffer != 0; }
+    bool IsMultiDrawActive() const { return m_multiDrawActive && m_indirectBuffer != 0; }
+    void Destroy(); // GL objects; call while the context is alive
+
+    // After the arena was reset: forgets the commands, whose storage is gone
+    void BeginFrame();
+
+    void Submit(const DrawCommand& command);
+    size_t GetCommandCount() const { return m_count; }
+
+    // Sorts and draws everything submitted since the last flush with the given camera, then empties the queue.
+    // Leaves program, VAO and texture unit 0 unbound.
+    void Flush(const glm::mat4& view, const glm::mat4& projection);
+
+    // Accumulated since the last ResetStats()
+    const RenderQueueStats& GetStats() const { return m_stats; }
+    void ResetStats() { m_stats = RenderQueueStats(); }
+
+private:
+    struct SortEntry {
+        uint64_t key;
+        uint32_t index;
+    };
+    static const size_t MAX_KEYED_SHADERS = 255; // Program slot is 8 bits of the key
+    // Layout of GL's DrawElementsIndirectCommand
+    struct IndirectCommand {
+        GLuint count, instanceCount, firstIndex;
+        GLint baseVertex;
+        GLuint baseInstance;
+    };
+
+    FrameArena& m_arena;
+    DrawCommand* m_commands = nullptr; // Arena storage, regrown by doubling
+    size_t m_count = 0;
+    size_t m_capacity = 0;
+    Shader* m_shaderSlots[MAX_KEYED_SHADERS] = {}; // Program -> key slot, stable for the queue's lifetime
+    size_t m_shaderSlotCount = 0;
+    RenderQueueStats m_stats;
+
+    Shader* m_multiDrawShader = nullptr;
+    Shader* m_multiDrawVariant = nullptr;
+    GLuint m_multiDrawAttribute = 0;
+    GLuint m_indirectBuffer = 0;
+    GLuint m_transformBuffer = 0;
+    bool m_multiDrawActive = true;
+
+    uint64_t makeKey(const DrawCommand& command);
+    // Number of entries from `first` that can go into one multi-draw (1 = draw on its own)
+    size_t multiDrawRun(const SortEntry* entries, size_t first) const;
+    void multiDraw(const SortEntry* entries, size_t first, size_t count);
+};
+
+#endif // RENDER_QUEUE_H
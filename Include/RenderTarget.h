@@ -0,0 +1,49 @@
+#ifndef RENDER_TARGET_H
+#define RENDER_TARGET_H
+
+#include <GL/glew.h>
+#include <vector>
+#include <cstddef>
+
+// Describes one color attachment of a RenderTarget (texture format + sampling filter)
+struct RenderTargetAttachment {
+    GLenum internalFormat; // e.g. GL_RGBA16F
+    GLenum format;         // e.g. GL_RGBA
+    GLenum type;           // e.g. GL_FLOAT
+    GLenum filter;         // GL_LINEAR or GL_NEAREST, used for both min and mag
+};
+
+// Small wrapper around an FBO with texture attachments.
+// Used for the offscreen passes (reduced-resolution raymarch, history buffers, ...).
+class RenderTarget {
+public:
+    RenderTarget() = default;
+    ~RenderTarget();
+
+    RenderTarget(const RenderTarget&) = delete;
+    RenderTarget& operator=(const RenderTarget&) = delete;
+
+    // (Re)creates the framebuffer. Returns false if the FBO is incomplete.
+    bool Create(int width, int height, const std::vector<RenderTargetAttachment>& colorAttachments, bool withDepth = false);
+    void Destroy();
+
+    // Binds the FBO for drawing and sets the viewport to its size
+    void Bind() const;
+    // Binds the default framebuffer and restores the given viewport
+    static void BindDefault(int width, int height);
+
+    GLuint GetFBO() const { return m_fbo; }
+    GLuint GetColorTexture(size_t index) const { return index < m_colorTextures.size() ? m_colorTextures[index] : 0; }
+    GLuint GetDepthTexture() const { return m_depthTexture; }
+    int GetWidth() const { return m_width; }
+    int GetHeight() const { return m_height; }
+    bool IsValid() const { return m_fbo != 0; }
+
+private:
+    GLuint m_fbo = 0;
+    std::vector<GLuint> m_colorTextures;
+    GLuint m_depthTexture = 0;
+    int m_width = 0, m_height = 0;
+};
+
+#endif // RENDER_TARGET_H
@@ -9,6 +9,24 @@
 #include <memory>
 #include "Shader.h"
 #include "Mesh.h"
+#include "TemporalUpscaler.h"
+#include "TerrainCache.h"
+#include "TerrainClipmap.h"
+#include "CloudRenderer.h"
+#include "InstanceBuffer.h"
+#include "RaymarchParams.h"
+#include "ThreadPool.h"
+#include "AssetImporter.h"
+#include "TextureStreamer.h"
+#include "PhysicsThread.h"
+#include "Profiler.h"
+#include "BoundingVolumeHierarchy.h"
+#include "QualityGovernor.h"
+#include "FrameArena.h"
+#include "RenderQueue.h"
+#include "MeshPool.h"
+#include "FramePacer.h"
+#include "SceneFile.h"
 #include <assimp/scene.h>
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
@@ -22,11 +40,34 @@ class btDiscreteDynamicsWorld;
 
 enum class EditorState { EDITING, PLAYING };
 
+// Resolution the raymarch pass runs at; reduced modes are upsampled with temporal accumulation
+enum class RaymarchResolution { NATIVE, HALF, QUARTER };
+
+// How rays find the terrain: sphere tracing everywhere, or walking the baked max-height pyramid inside the cache
+enum class TerrainTraversal { SPHERE_TRACE, MAX_MIP };
+
+// How the terrain is drawn: per-pixel raymarch, or a displaced clipmap mesh (the raymarch pass then draws only sky and clouds)
+enum class TerrainRenderMode { RAYMARCH, CLIPMAP };
+
+enum class AssetState { LOADING, READY, FAILED };
+
+// Window / presentation options, fixed at Initialize()
+struct RendererSettings {
+    bool visible = true;              // false creates a hidden window (benchmark runs)
+    FramePacingSettings pacing;       // Vsync mode, frames in flight, frame-rate cap
+    bool showUI = true;               // ImGui editor panels
+    size_t profilerHistoryFrames = 0; // Samples kept per profiler section, 0 = profiler default
+    bool shaderHotReload = true;      // Rebuild shaders when their files under shaders/ change
+    bool shaderBinaryCache = true;    // Load / store linked programs in the program binary cache
+};
+
 // --- NEW: SceneAsset struct ---
 struct SceneAsset {
     std::string name;
     glm::vec3 position;
-    std::unique_ptr<Mesh> mesh; // Store the loaded mesh
+    std::vector<std::unique_ptr<Mesh>> meshes; // One per aiMesh, filled in when the import finishes; each holds its LOD chain
+    AssetState state = AssetState::LOADING;     // A placeholder cube is drawn while LOADING
+    uint64_t importId = 0;
 };
 
 class Renderer {
@@ -34,7 +75,7 @@ public:
     Renderer(int width, int height, const char* title);
     ~Renderer();
 
-    bool Initialize();
+    bool Initialize(const RendererSettings& settings = RendererSettings());
     void ProcessInput();
     void Update(float dt);
     void Render(btDiscreteDynamicsWorld* dynamicsWorld);
@@ -42,6 +83,21 @@ public:
     GLFWwindow* getWindow() const { return window; }
     float getDeltaTime() const { return deltaTime; }
     EditorState GetEditorState() const { return m_editorState; }
+    Camera& GetCamera() { return camera; }
+    Profiler* GetProfiler() const { return m_profiler.get(); }
+    // The main loop calls BeginFrame() before sampling input; Render() ends the frame after its swap
+    FramePacer& GetFramePacer() { return m_framePacer; }
+    // Drive u_time from the caller instead of the wall clock (deterministic benchmark frames)
+    void SetSceneTime(float seconds) { m_sceneTime = seconds; m_useSceneTime = true; }
+    // When set, physics bodies are drawn from its interpolated snapshots instead of reading the world directly
+    void SetPhysicsThread(PhysicsThread* physicsThread) { m_physicsThread = physicsThread; }
+    // Enables the Physics panel's stress scene controls (bodies are spawned into this world)
+    void SetPhysicsWorld(PhysicsWorld* physicsWorld) { m_physicsWorld = physicsWorld; }
+    // Scene files: the imported assets, the physics world's bodies, the light / terrain / cloud values and the camera.
+    // OpenScene replaces all of them; it returns once the file is mapped, imports start right away and the bodies
+    // are instantiated from the mapping over the next frames.
+    bool SaveScene(const std::string& path);
+    bool OpenScene(const std::string& path);
 
     bool isPaused = false;
 
@@ -69,14 +125,21 @@ private:
     bool needToRebindTexture;
 
     std::unique_ptr<Shader> m_raymarchShader;
+    std::unique_ptr<Shader> m_skyShader;          // RAYMARCH_SKY_ONLY variant of the raymarch program (clipmap mode)
+    Shader* m_raymarchUniformsProgram = nullptr;  // Which of the two the m_raymarch_*Loc locations belong to
     std::unique_ptr<Shader> m_rasterShader;
+    std::unique_ptr<Shader> m_instancedShader;
 
-    GLint m_raymarch_timeLoc, m_raymarch_camPosLoc, m_raymarch_invViewLoc, m_raymarch_invProjLoc;
-    GLint m_raymarch_lightDirLoc, m_raymarch_lightColorLoc, m_raymarch_ambientLoc;
-    GLint m_raymarch_terrain_base_freqLoc, m_raymarch_terrain_base_ampLoc, m_raymarch_terrain_persistenceLoc;
-    GLint m_raymarch_terrain_flatten_powerLoc, m_raymarch_terrain_final_scaleLoc, m_raymarch_terrain_octavesLoc;
-    GLint m_raymarch_cloud_base_heightLoc, m_raymarch_cloud_thicknessLoc, m_raymarch_cloud_noise_scaleLoc;
-    GLint m_raymarch_cloud_coverage_minLoc, m_raymarch_cloud_coverage_maxLoc, m_raymarch_cloud_density_factorLoc;
+    GLint m_raymarch_timeLoc, m_raymarch_camPosLoc, m_raymarch_invViewLoc, m_raymarch_invProjLoc, m_raymarch_jitterLoc;
+    GLint m_raymarch_terrainCacheLoc, m_raymarch_terrainCacheRectLoc, m_raymarch_terrainCacheTexelLoc, m_raymarch_useTerrainCacheLoc;
+    GLint m_raymarch_cloudNoiseLoc, m_raymarch_cloudsEnabledLoc, m_raymarch_cloudBufferLoc, m_raymarch_cloudDistanceLoc;
+    GLint m_raymarch_hybridDepthLoc, m_raymarch_sceneDepthLoc, m_raymarch_viewProjLoc;
+    GLint m_raymarch_terrainMaxMipLoc, m_raymarch_terrainMaxMipLevelsLoc, m_raymarch_terrainTraversalLoc;
+    GLint m_raymarch_terrainMaxStepsLoc, m_raymarch_terrainStepViewLoc, m_raymarch_shadowStepsLoc;
+
+    // Hybrid rendering: opaque raster depth is drawn first and bounds every terrain ray (native resolution only)
+    bool m_hybridDepth = true;
+    RenderTarget m_depthPrepass;
 
     glm::vec3 m_lightDirection;
     glm::vec3 m_lightColor;
@@ -86,32 +149,134 @@ private:
     int   m_terrain_octaves;
     float m_cloud_base_height, m_cloud_thickness, m_cloud_noise_scale, m_cloud_coverage_min, m_cloud_coverage_max, m_cloud_density_factor;
 
+    // Lighting / terrain / cloud values above, as the std140 block shared by the raymarch, bake and cloud shaders
+    RaymarchParamsBuffer m_raymarchParams;
+    RaymarchParamsBlock getRaymarchParams() const;
+
+    // Reduced-resolution raymarching + temporal upsampling
+    std::unique_ptr<TemporalUpscaler> m_temporalUpscaler;
+    RaymarchResolution m_raymarchResolution = RaymarchResolution::NATIVE;
+    bool m_temporalAccumulation = true;
+    glm::mat4 m_prevViewProj = glm::mat4(1.0f);
+    int getRaymarchScaleDivisor() const;
+
+    // Holds a GPU frame budget by trading the knobs below (off by default: the panel values apply)
+    QualityGovernor m_qualityGovernor;
+    size_t m_governorSamplesSeen = 0; // Push count of the profiler's "Frame" GPU history already fed in
+    int m_cloudMaxSteps = 80;
+    int m_cloudUpdateGrid = 2; // 1 = every cloud pixel marched each frame, 2 / 4 = temporal updates
+    int m_shadowSteps = 32;
+    QualitySettings getQualitySettings() const;
+    void updateQualityGovernor();
+
+    // Baked heightfield sampled by the raymarcher instead of evaluating the FBM per step
+    std::unique_ptr<TerrainCache> m_terrainCache;
+    bool m_useTerrainCache = true;
+    TerrainParams getTerrainParams() const;
+    TerrainTraversal m_terrainTraversal = TerrainTraversal::MAX_MIP;
+    int m_terrainMaxSteps = 100; // Per-ray step budget (quality vs. cost)
+    bool m_terrainStepView = false;
+    // Rasterised alternative to the terrain march; the physics world collides with the same heights
+    std::unique_ptr<TerrainClipmap> m_terrainClipmap;
+    TerrainRenderMode m_terrainRenderMode = TerrainRenderMode::RAYMARCH;
+    TerrainParams m_physicsTerrainParams; // Last parameters handed to m_physicsWorld
+    bool m_physicsTerrainParamsSent = false;
+    void updatePhysicsTerrain();
+
+    // Clouds marched into their own reduced-resolution buffer from a precomputed noise volume
+    std::unique_ptr<CloudRenderer> m_cloudRenderer;
+    bool m_cloudsEnabled = true;
+    int m_cloudScaleDivisor = 2;
+
     unsigned int m_cubeVAO, m_cubeVBO, m_cubeEBO;
     size_t m_cubeIndexCount;
+    GLenum m_cubeIndexType;
+    unsigned int m_sphereVAO, m_sphereVBO, m_sphereEBO;
+    size_t m_sphereIndexCount;
+    GLenum m_sphereIndexType;
+
+    // Instanced physics rendering: one draw per shape type, transforms streamed through m_physicsInstances
+    InstanceBuffer m_physicsInstances;
+    // Raster passes submit into the queue, which sorts and draws each pass with redundant state skipped
+    FrameArena m_frameArena;
+    RenderQueue m_renderQueue{m_frameArena};
+    std::unique_ptr<MeshPool> m_meshPool; // Shared buffers of every imported mesh; outlives the importer and assets
+    bool m_multiDraw = true;
+    FramePacer m_framePacer;
+    PhysicsThread* m_physicsThread = nullptr;
+    PhysicsWorld* m_physicsWorld = nullptr;
+    StressSceneSettings m_stressSettings;
+    PhysicsStepStats m_physicsStats; // Copied from the physics thread while the Physics panel is drawn
+    std::vector<glm::mat4> m_boxInstances, m_sphereInstances; // Per-frame scratch, capacity kept between frames
+    size_t m_physicsDrawCalls = 0;
+    size_t m_physicsInstanceCount = 0;
+    size_t m_physicsInstanceOffset = 0;     // Byte offset of this frame's matrices in m_physicsInstances
+    bool m_physicsInstancesWritten = false; // Instanced path: matrices uploaded this frame, EndFrame() pending
 
     std::vector<SceneAsset> m_sceneAssets;
+    // Per-mesh LOD picked each frame from the projected simplification error
+    bool m_meshLodsEnabled = true;
+    float m_lodErrorPixels = 1.0f;
+    size_t m_assetTriangles = 0;
+    // Frustum culling: assets through a BVH (static), physics bodies tested individually (they move every tick)
+    bool m_frustumCulling = true;
+    BoundingVolumeHierarchy m_assetBvh;
+    bool m_assetBvhDirty = true;
+    std::vector<uint32_t> m_visibleAssets;
+    size_t m_assetCulledCount = 0;
+    size_t m_physicsCulledCount = 0;
+
+    // Per-pass CPU/GPU timings shown in the Stats panel
+    std::unique_ptr<Profiler> m_profiler;
+    uint64_t m_profiledPhysicsTick = 0;
+
+    bool m_showUI = true;
+    bool m_useSceneTime = false;
+    float m_sceneTime = 0.0f;
+
+    // Background asset import (parse on the pool, budgeted upload on the GL thread)
+    std::unique_ptr<ThreadPool> m_threadPool;
+    std::unique_ptr<AssetImporter> m_assetImporter;
+    // Background texture decode + PBO streaming; `texture` is a handle into its cache
+    std::unique_ptr<TextureStreamer> m_textureStreamer;
+    void updateAssetImports();
     int m_selectedAsset = -1;
+    // Scene being opened; its bodies are added to m_physicsWorld in batches within a per-frame budget
+    std::unique_ptr<SceneFile> m_loadingScene;
+    size_t m_sceneBodiesLoaded = 0;
+    double m_sceneLoadStart = 0.0; // glfwGetTime() when OpenScene was called
+    void updateSceneLoad();
 
     void InitImGui();
     void ShutdownImGui();
     bool LoadTextureFromDirectories();
     void setupScreenQuad();
     void setupRasterShader();
+    void setupRaymarchUniforms(Shader& program);
     void setupPhysicsMeshes();
 
     void RenderUI();
     void RenderUIToolbar();
     void RenderUIStats();
+    void RenderUIProfiler();
+    void RenderUIMemory();
     void RenderUISceneControls();
 
     void RenderUIHierarchy(btDiscreteDynamicsWorld *world);
 
     void RenderUIInspector();
-    void renderPhysicsObjects(btDiscreteDynamicsWorld* world, const glm::mat4& view, const glm::mat4& projection);
+    void RenderUIPhysics();
+    void preparePhysicsObjects(btDiscreteDynamicsWorld* world, const Frustum& frustum);
+    void submitPhysicsObjects(bool depthOnly);
+    void submitSceneAssets(const Frustum& frustum, float pixelsPerUnit, bool depthOnly);
+    void gatherPhysicsInstances(btDiscreteDynamicsWorld* world, const Frustum& frustum);
+    Aabb getAssetBounds(const SceneAsset& asset) const;
+    void cullSceneAssets(const Frustum& frustum); // Fills m_visibleAssets
+    void uploadPhysicsMesh(const Mesh& mesh, unsigned int& vao, unsigned int& vbo, unsigned int& ebo, GLenum& indexType);
     glm::mat4 convertBtTransformToGlm(const class btTransform& trans);
     Mesh CreateCube();
+    Mesh CreateSphere(int latitudeSegments, int longitudeSegments);
 
-    std::unique_ptr<Mesh> LoadMeshFromFile(const std::string& path);
 
     static void framebuffer_size_callback(GLFWwindow* window, int width, int height);
     static void mouse_callback(GLFWwindow* window, double xpos, double ypos);
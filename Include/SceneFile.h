@@ -0,0 +1,97 @@
+#ifndef SCENE_FILE_H
+#define SCENE_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "MappedFile.h"
+#include "RaymarchParams.h"
+
+enum class SceneBodyShape : uint32_t { BOX, SPHERE };
+
+// Set on bodies of the stress set, so they come back as stress bodies (the Physics panel's Clear removes them)
+static const uint32_t SCENE_BODY_STRESS = 1u << 0;
+
+// One rigid body as stored in the file. Loading hands these to PhysicsWorld straight from the mapping.
+struct SceneBodyRecord {
+    uint32_t shape;           // SceneBodyShape
+    uint32_t flags;           // SCENE_BODY_*
+    float shapeSize[3];       // Box half extents, or the sphere radius in [0]
+    float mass;               // 0 = static
+    float position[3];
+    float rotation[4];        // x, y, z, w
+    float linearVelocity[3];
+    float angularVelocity[3];
+    float restitution;
+    float friction;
+};
+static_assert(sizeof(SceneBodyRecord) == 84, "SceneBodyRecord is part of the scene file layout");
+
+// Everything in a scene that is not an asset or a body
+struct SceneEnvironment {
+    RaymarchParamsBlock params; // Light, terrain and cloud values (terrainOctaves is the panel value, not the governor's)
+    float cameraPosition[3];
+    float cameraYaw;
+    float cameraPitch;
+};
+
+// An imported model placed in the scene. The cooked file is the MeshCache copy the import will map, recorded so
+// a scene can be checked (and shipped) together with its cache; the source path is what gets re-imported.
+struct SceneFileAsset {
+    std::string sourcePath;
+    std::string cookedPath;
+    glm::vec3 position = glm::vec3(0.0f);
+};
+
+// What Save() writes, gathered from the renderer and the physics world
+struct SceneDescription {
+    SceneEnvironment environment = {};
+    std::vector<SceneFileAsset> assets;
+    std::vector<SceneBodyRecord> bodies;
+};
+
+// Binary scene files.
+//
+// Layout (little endian, native struct layout):
+//   SceneFileHeader
+//   SceneEnvironment
+//   SceneAssetRecord[assetCount]    (offsets into the string table)
+//   SceneBodyRecord[bodyCount]      (aligned to SCENE_FILE_ALIGNMENT)
+//   string table                    (UTF-8 paths, not terminated)
+//
+// Open() maps the file and validates the header and table bounds only; bodies stay in the mapping and are
+// instantiated from it in batches (see PhysicsWorld::AddSceneBodies), so opening costs the same for ten bodies
+// or a hundred thousand.
+class SceneFile {
+public:
+    static const uint32_t VERSION = 1;
+
+    SceneFile() = default;
+
+    SceneFile(const SceneFile&) = delete;
+    SceneFile& operator=(const SceneFile&) = delete;
+
+    bool Open(const std::filesystem::path& path);
+    void Close();
+    bool IsOpen() const { return m_file.IsOpen(); }
+
+    const SceneEnvironment& GetEnvironment() const { return m_environment; }
+    const std::vector<SceneFileAsset>& GetAssets() const { return m_assets; }
+    const SceneBodyRecord* GetBodies() const { return m_bodies; }
+    size_t GetBodyCount() const { return m_bodyCount; }
+
+    // Writes to a temp file next to `path`, then renames it into place
+    static bool Save(const std::filesystem::path& path, const SceneDescription& scene);
+
+private:
+    MappedFile m_file;
+    SceneEnvironment m_environment = {};
+    std::vector<SceneFileAsset> m_assets; // A few hundred paths at most, copied out at Open()
+    const SceneBodyRecord* m_bodies = nullptr; // Points into m_file
+    size_t m_bodyCount = 0;
+};
+
+#endif // SCENE_FILE_H
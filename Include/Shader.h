@@ -5,24 +5,118 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <string>
+#include <filesystem>
 #include <memory> // Needed if Shader uses unique_ptr internally
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
 
+// FNV-1a hash of a uniform name (constexpr, so literal names hash at compile time)
+constexpr uint32_t UniformHash(const char* name, uint32_t hash = 2166136261u) {
+    return *name ? UniformHash(name + 1, (hash ^ static_cast<uint32_t>(static_cast<unsigned char>(*name))) * 16777619u) : hash;
+}
+
+// Uniform name + its hash, the key of Shader's location cache. Implicitly built from literals and std::string.
+struct UniformName {
+    const char* name;
+    uint32_t hash;
+    constexpr UniformName(const char* n) : name(n), hash(UniformHash(n)) {}
+    UniformName(const std::string& n) : name(n.c_str()), hash(UniformHash(n.c_str())) {}
+};
+
+// Startup / reload counters over all shaders
+struct ShaderStats {
+    unsigned int binaryHits = 0;   // Programs loaded from the binary cache
+    unsigned int compiles = 0;     // Programs compiled from source
+    unsigned int reloads = 0;      // Successful hot reloads
+    unsigned int reloadFailures = 0;
+};
+
+// A vertex + fragment program built from files under shaders/ (with #include expansion).
+//
+// Building goes through the program binary cache first. On a miss the sources are compiled and linked
+// without waiting for the result: with GL_KHR_parallel_shader_compile the driver builds on its own threads
+// and the status is only queried when the program is first needed (isValid(), use(), uniform access),
+// so a slow program can be created early and compile while the rest of startup runs.
+//
+// Hot reload: pollHotReload() watches every live shader's files. A changed shader is rebuilt in the
+// background; the old program stays in use until the new one links, then the IDs are swapped and the
+// reload callback re-applies whatever state the owner set once (uniform blocks, sampler units, cached locations).
 class Shader {
 public:
     unsigned int ID;
-    Shader(const char* vertexPath, const char* fragmentPath);
+    // `defines` (e.g. "#define SKY_ONLY\n") is inserted after the #version line of both stages, so one
+    // set of files can build several program variants
+    Shader(const char* vertexPath, const char* fragmentPath, const char* defines = nullptr);
     ~Shader();
+
+    Shader(const Shader&) = delete;
+    Shader& operator=(const Shader&) = delete;
+
     void use();
-    bool isValid() const;
-    void setBool(const std::string &name, bool value) const;
-    void setInt(const std::string &name, int value) const;
-    void setFloat(const std::string &name, float value) const;
-    void setVec3(const std::string &name, const glm::vec3 &value) const;
-    void setMat4(const std::string &name, const glm::mat4 &value) const;
+    bool isValid() const; // Waits for a pending build
+    void setBool(UniformName name, bool value) const;
+    void setInt(UniformName name, int value) const;
+    void setFloat(UniformName name, float value) const;
+    void setVec2(UniformName name, const glm::vec2 &value) const;
+    void setVec3(UniformName name, const glm::vec3 &value) const;
+    void setMat4(UniformName name, const glm::mat4 &value) const;
+    // Cached glGetUniformLocation; only the first lookup of each name reaches the driver
+    GLint getUniformLocation(UniformName name) const;
+    // Attaches the named uniform block to a binding point. Returns false if the program has no such block.
+    bool bindUniformBlock(const char* blockName, GLuint binding) const;
+
+    // Called on the GL thread after each successful hot reload, with the new program
+    void setReloadCallback(std::function<void(Shader&)> callback) { m_onReload = std::move(callback); }
+
+    // GL thread, once per frame: finishes running rebuilds and starts new ones for edited files
+    static void pollHotReload();
+    static void setHotReloadEnabled(bool enabled);
+    static bool isHotReloadEnabled();
+    static void setBinaryCacheEnabled(bool enabled); // Before the first shader is created
+    static const ShaderStats& getStats();
+
 private:
-    bool m_isValid = false;
-    bool checkCompileErrors(GLuint shader, std::string type);
-    bool checkLinkErrors(GLuint program);
+    // One compile + link in flight (or a program straight from the binary cache)
+    struct Build {
+        GLuint program = 0, vertex = 0, fragment = 0;
+        uint64_t key = 0;
+        bool fromBinary = false;
+        std::chrono::steady_clock::time_point start;
+    };
+    struct SourceFile {
+        std::filesystem::path path;
+        std::filesystem::file_time_type writeTime;
+    };
+
+    std::string m_vertexPath, m_fragmentPath;
+    std::string m_defines;
+    std::vector<SourceFile> m_sources; // Both stages and everything they include
+    mutable Build m_build;             // First build, until resolved
+    mutable bool m_buildPending = false;
+    mutable bool m_isValid = false;
+    Build m_reload;                    // Hot reload in flight (program 0 when idle)
+    std::function<void(Shader&)> m_onReload;
+    struct CachedUniform {
+        std::string name; // Compared on lookup, so two names sharing a hash each get their own location
+        GLint location;
+    };
+    mutable std::unordered_multimap<uint32_t, CachedUniform> m_uniformLocations;
+
+    void resolve() const;
+    bool loadSources(std::string& vertexCode, std::string& fragmentCode, std::vector<SourceFile>& sources) const;
+    bool sourcesChanged() const;
+    void pollReload();
+
+    static bool startBuild(const std::string& vertexCode, const std::string& fragmentCode, Build& build);
+    static bool isBuildDone(const Build& build);
+    static bool finishBuild(Build& build, const std::string& name);
+    static void destroyBuild(Build& build);
+    static bool checkCompileErrors(GLuint shader, const std::string& type);
+    static bool checkLinkErrors(GLuint program);
+    static bool loadShaderSource(const std::filesystem::path& path, std::string& source, int depth, std::vector<SourceFile>* sources);
 };
 
 #endif // SHADER_H
\ No newline at end of file
@@ -0,0 +1,33 @@
+#ifndef SHADER_BINARY_CACHE_H
+#define SHADER_BINARY_CACHE_H
+
+#include <GL/glew.h>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Linked program binaries (glGetProgramBinary), so a program seen before skips compiling and linking.
+//
+// The key hashes both expanded sources together with GL_VENDOR / GL_RENDERER / GL_VERSION: an edited shader
+// or a driver update simply misses and the program is compiled again (and re-stored). Files are named after
+// the key and carry it in their header as well, next to the binary format.
+class ShaderBinaryCache {
+public:
+    explicit ShaderBinaryCache(std::filesystem::path cacheDirectory = "cache/shaders");
+
+    // Needs GL 4.1 / ARB_get_program_binary and at least one binary format (queried on the GL thread)
+    static bool IsSupported();
+    static uint64_t MakeKey(const std::string& vertexSource, const std::string& fragmentSource);
+
+    bool Load(uint64_t key, GLenum& format, std::vector<unsigned char>& binary) const;
+    // Writes to a temp file, then renames it into place
+    bool Store(uint64_t key, GLenum format, const std::vector<unsigned char>& binary) const;
+
+    std::filesystem::path GetCachePath(uint64_t key) const;
+
+private:
+    std::filesystem::path m_directory;
+};
+
+#endif // SHADER_BINARY_CACHE_H
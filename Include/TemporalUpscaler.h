@@ -0,0 +1,53 @@
+#ifndef TEMPORAL_UPSCALER_H
+#define TEMPORAL_UPSCALER_H
+
+#include <glm/glm.hpp>
+#include <memory>
+#include "RenderTarget.h"
+#include "Shader.h"
+
+// Renders the raymarch pass at a reduced resolution and reconstructs a native-resolution image
+// by accumulating jittered frames over time (reprojected with the previous frame's view/projection).
+//
+// Per frame:
+//   Resize(...)          - keeps targets in sync with the window size / scale
+//   BeginRaymarch()      - binds the low-res target, returns the ray jitter for this frame (UV units)
+//   <draw raymarch quad>   (location 0 = color, location 1 = hit distance)
+//   Resolve(...)         - accumulates into the history buffer and copies it to the backbuffer
+class TemporalUpscaler {
+public:
+    TemporalUpscaler();
+    ~TemporalUpscaler();
+
+    bool Initialize();
+    bool IsValid() const { return m_resolveShader && m_resolveShader->isValid(); }
+
+    // scaleDivisor: 2 = half resolution, 4 = quarter resolution
+    void Resize(int nativeWidth, int nativeHeight, int scaleDivisor);
+    glm::vec2 BeginRaymarch();
+    void Resolve(unsigned int quadVAO, const glm::mat4& invView, const glm::mat4& invProj,
+                 const glm::vec3& camPos, const glm::mat4& prevViewProj);
+
+    void ResetHistory() { m_historyValid = false; }
+    void SetTemporalEnabled(bool enabled);
+    bool IsTemporalEnabled() const { return m_temporalEnabled; }
+
+    int GetLowResWidth() const { return m_lowRes.GetWidth(); }
+    int GetLowResHeight() const { return m_lowRes.GetHeight(); }
+
+private:
+    std::unique_ptr<Shader> m_resolveShader;
+    RenderTarget m_lowRes;      // attachment 0: RGBA16F color, attachment 1: R32F hit distance
+    RenderTarget m_history[2];  // ping-pong native resolution accumulation buffers
+    int m_historyIndex = 0;
+    bool m_historyValid = false;
+    bool m_temporalEnabled = true;
+
+    int m_nativeWidth = 0, m_nativeHeight = 0, m_scaleDivisor = 0;
+    unsigned int m_frameIndex = 0;
+    glm::vec2 m_jitter = glm::vec2(0.0f); // jitter of the current frame, UV units
+
+    static float halton(unsigned int index, unsigned int base);
+};
+
+#endif // TEMPORAL_UPSCALER_H
@@ -0,0 +1,61 @@
+#ifndef TERRAIN_CACHE_H
+#define TERRAIN_CACHE_H
+
+#include <glm/glm.hpp>
+#include <memory>
+#include "RenderTarget.h"
+#include "Shader.h"
+#include "TerrainNoise.h"
+
+// Bakes terrainHeight() (plus normals) for a square region around the camera into an RGBA32F texture,
+// so the raymarcher can replace the per-step FBM evaluation with a texture fetch.
+// The bake only re-runs when the terrain parameters change or the camera drifts too far from the
+// region centre; rays leaving the region fall back to the analytic noise in the shader.
+//
+// Each bake also rebuilds a max-height pyramid (R32F, one texel per bilinear patch at level 0, full mip
+// chain down to 1x1) so the raymarcher can skip whole quadtree cells the ray passes above.
+//
+// The bake reads the TerrainParams from the RaymarchParams uniform block, so it must be up to date before Update().
+class TerrainCache {
+public:
+    TerrainCache();
+    ~TerrainCache();
+
+    bool Initialize();
+    bool IsValid() const { return m_bakeShader && m_bakeShader->isValid() && m_target.IsValid(); }
+
+    // Rebakes if needed. Leaves the default framebuffer bound (viewport must be restored by the caller).
+    // Returns true if a bake happened this call.
+    bool Update(const TerrainParams& params, const glm::vec3& cameraPos, unsigned int quadVAO);
+    void Invalidate() { m_valid = false; }
+
+    GLuint GetTexture() const { return m_target.GetColorTexture(0); }
+    GLuint GetMaxMipTexture() const { return m_maxMipTexture; }
+    int GetMaxMipLevels() const { return m_maxMipLevels; } // 0 if the pyramid could not be created
+    glm::vec2 GetOrigin() const { return m_origin; }
+    float GetExtent() const;
+    int GetResolution() const;
+    unsigned int GetBakeCount() const { return m_bakeCount; }
+
+private:
+    std::unique_ptr<Shader> m_bakeShader;
+    RenderTarget m_target;
+    TerrainParams m_bakedParams;
+    glm::vec2 m_center = glm::vec2(0.0f); // World XZ the region is centred on
+    glm::vec2 m_origin = glm::vec2(0.0f); // World XZ of the (0,0) corner
+    bool m_valid = false;
+    unsigned int m_bakeCount = 0;
+
+    // Max-height pyramid, rebuilt after every bake
+    std::unique_ptr<Shader> m_maxMipShader;
+    GLuint m_maxMipTexture = 0;
+    GLuint m_maxMipFBO = 0;
+    int m_maxMipLevels = 0;
+
+    void bake(const TerrainParams& params, unsigned int quadVAO);
+    bool createMaxMips();
+    void destroyMaxMips();
+    void buildMaxMips(unsigned int quadVAO);
+};
+
+#endif // TERRAIN_CACHE_H
@@ -0,0 +1,76 @@
+#ifndef TERRAIN_CLIPMAP_H
+#define TERRAIN_CLIPMAP_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <memory>
+#include "Shader.h"
+
+// Texture units the clipmap fragment shader reads the cloud noise volume and cloud buffer from
+struct TerrainClipmapTextureUnits {
+    int cloudNoise = 0;
+    int cloudBuffer = 0;
+    int cloudDistance = 0;
+};
+
+struct TerrainClipmapStats {
+    int levelsDrawn = 0;
+    size_t triangles = 0;
+    float extent = 0.0f; // World size of the outermost level
+};
+
+// Rasterised terrain: a geometry clipmap of nested square grids centred on the camera, displaced in the
+// vertex shader by the same FBM the raymarcher evaluates (terrain_noise.glsl, fed from the RaymarchParams block).
+//
+// All levels draw the one (GRID_QUADS + 1)^2 vertex grid with integer coordinates; level l scales it by
+// baseSpacing * 2^l and snaps its origin to twice its own spacing, so vertices never swim as the camera moves.
+// Level 0 is the full grid; every coarser level draws a ring with a hole where the next finer level lies.
+// Because of the snapping the hole sits one quad off centre on either axis, which gives four ring index
+// ranges. The vertex shader pulls the odd vertices on a level's outer edge onto the coarser level's
+// edges, so neighbouring levels meet without cracks.
+//
+// Cost is a fixed vertex workload (about 14k triangles per level at the default grid) instead of a
+// per-pixel march; shading matches the raymarched terrain (terrain_shading.glsl).
+class TerrainClipmap {
+public:
+    static constexpr int GRID_QUADS = 96; // Per side; a multiple of 4 so the ring holes fall on whole quads
+    static constexpr int MAX_LEVELS = 8;
+
+    TerrainClipmap();
+    ~TerrainClipmap();
+
+    TerrainClipmap(const TerrainClipmap&) = delete;
+    TerrainClipmap& operator=(const TerrainClipmap&) = delete;
+
+    bool Initialize(const TerrainClipmapTextureUnits& units);
+    bool IsValid() const { return m_shader && m_shader->isValid() && m_vao != 0; }
+
+    // Draws every level with depth testing; the cloud textures must be bound to the units given to Initialize()
+    void Render(const glm::mat4& viewProj, const glm::vec3& camPos, float time, const glm::vec2& screenSize,
+                int shadowSteps, bool cloudsEnabled);
+
+    void SetLevels(int levels);
+    void SetBaseSpacing(float spacing);
+    int GetLevels() const { return m_levels; }
+    float GetBaseSpacing() const { return m_baseSpacing; }
+    const TerrainClipmapStats& GetStats() const { return m_stats; }
+
+private:
+    struct IndexRange {
+        size_t offset = 0; // Bytes into the index buffer
+        GLsizei count = 0;
+    };
+
+    std::unique_ptr<Shader> m_shader;
+    TerrainClipmapTextureUnits m_units;
+    GLuint m_vao = 0, m_vbo = 0, m_ebo = 0;
+    IndexRange m_fullGrid;
+    IndexRange m_rings[4]; // Indexed by holeOffsetX + 2 * holeOffsetZ
+    int m_levels = 5;
+    float m_baseSpacing = 0.125f;
+    TerrainClipmapStats m_stats;
+
+    void setSamplerUnits();
+};
+
+#endif // TERRAIN_CLIPMAP_H
@@ -0,0 +1,72 @@
+#ifndef TERRAIN_COLLIDER_H
+#define TERRAIN_COLLIDER_H
+
+#include <btBulletDynamicsCommon.h>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "TerrainNoise.h"
+
+class btHeightfieldTerrainShape;
+
+struct TerrainColliderStats {
+    size_t tilesLoaded = 0;
+    uint64_t tilesBuilt = 0;   // Since startup (parameter changes rebuild every tile)
+    uint64_t tilesEvicted = 0;
+    float lastUpdateMs = 0.0f; // Streaming pass of the latest tick, including tile builds
+};
+
+// Collision for the noise terrain: static btHeightfieldTerrainShape tiles sampled from TerrainNoise, so
+// bodies rest on the same surface the raymarcher and the clipmap draw.
+//
+// Tiles are streamed around the dynamic bodies: each tick every body near the ground requests the tiles
+// its AABB overlaps, swept by its velocity over a short lookahead for active bodies, so a tile exists
+// before anything reaches it. Tiles nobody requested for a while are removed. Update() adds and removes rigid bodies, so it
+// runs on the stepping thread inside the world's pre-tick callback (see PhysicsWorld).
+class TerrainCollider {
+public:
+    static constexpr int TILE_SAMPLES = 65; // Height samples per tile side (64 quads, neighbours share the edge row)
+    static constexpr float TILE_SPACING = 0.25f; // World distance between samples
+
+    explicit TerrainCollider(btDiscreteDynamicsWorld* world);
+    ~TerrainCollider();
+
+    TerrainCollider(const TerrainCollider&) = delete;
+    TerrainCollider& operator=(const TerrainCollider&) = delete;
+
+    // Drops every tile and wakes the bodies if the parameters changed; the next Update() rebuilds what is needed
+    void SetParams(const TerrainParams& params);
+    const TerrainParams& GetParams() const { return m_params; }
+
+    void Update(float timeStep);
+    void Clear();
+
+    const TerrainColliderStats& GetStats() const { return m_stats; }
+    static float GetTileSize() { return (TILE_SAMPLES - 1) * TILE_SPACING; }
+
+private:
+    struct Tile {
+        int tileX = 0, tileZ = 0;
+        std::vector<float> heights; // Referenced by the shape, not copied
+        std::unique_ptr<btHeightfieldTerrainShape> shape;
+        std::unique_ptr<btRigidBody> body;
+        uint64_t lastUsedTick = 0;
+    };
+
+    btDiscreteDynamicsWorld* m_world;
+    TerrainParams m_params;
+    std::unordered_map<uint64_t, std::unique_ptr<Tile>> m_tiles; // Keyed by packed tile coordinates
+    std::vector<Tile*> m_pendingTiles; // Requested this tick, not sampled yet
+    uint64_t m_tick = 0;
+    TerrainColliderStats m_stats;
+
+    static uint64_t tileKey(int tileX, int tileZ);
+    void requestTiles(const btVector3& aabbMin, const btVector3& aabbMax);
+    void sampleTile(Tile& tile) const;
+    void addTile(Tile& tile);
+    void buildPendingTiles();
+    void removeTile(Tile& tile);
+};
+
+#endif // TERRAIN_COLLIDER_H
@@ -0,0 +1,59 @@
+#ifndef TERRAIN_NOISE_H
+#define TERRAIN_NOISE_H
+
+#include <cstddef>
+#include <cstdint>
+
+// The m_terrain_* values edited in the Scene Controls panel (defaults are the renderer's startup values).
+// Any change triggers a rebake of the terrain cache and a rebuild of the physics heightfield tiles.
+struct TerrainParams {
+    float baseFreq = 0.2f;
+    float baseAmp = 1.5f;
+    float persistence = 0.45f;
+    float flattenPower = 1.8f;
+    float finalScale = 2.5f;
+    int   octaves = 5;
+
+    bool operator==(const TerrainParams& other) const {
+        return baseFreq == other.baseFreq && baseAmp == other.baseAmp && persistence == other.persistence &&
+               flattenPower == other.flattenPower && finalScale == other.finalScale && octaves == other.octaves;
+    }
+    bool operator!=(const TerrainParams& other) const { return !(*this == other); }
+};
+
+// Kernels behind the batch queries. AUTO picks the widest one the build and the CPU support.
+enum class TerrainNoiseKernel { AUTO, SCALAR, SSE2, AVX2, NEON };
+
+// CPU port of shaders/terrain_noise.glsl (hash / valueNoise / fbm_raw / terrainHeightNoise / terrainNormalNoise),
+// in the same float operations and order. The lattice hash is integer-only, so lattice values match the GPU
+// bit for bit and heights agree to float rounding.
+//
+// The batch queries run the FBM through SSE2 / AVX2 / NEON kernels (4 or 8 points per instruction) and
+// return the same bits as the scalar Height(): every lane op is the scalar op, and pow() is applied per
+// point afterwards. Batches are stateless, so callers split large ones into ranges across threads.
+class TerrainNoise {
+public:
+    static float Hash(int32_t x, int32_t z);
+    static float ValueNoise(float x, float z);
+    static float Height(const TerrainParams& params, float x, float z);
+
+    // heights[i] = Height(xs[i], zs[i]). normals (3 floats per point, may be null) are terrainNormalNoise():
+    // central differences over NORMAL_EPSILON, four more heights per point.
+    static void HeightBatch(const TerrainParams& params, const float* xs, const float* zs, size_t count, float* heights,
+                            float* normals = nullptr);
+    // Heights of a cols x rows grid (x fastest) with vertex (0, 0) at (originX, originZ)
+    static void HeightGrid(const TerrainParams& params, float originX, float originZ, float spacing, int cols, int rows, float* heights);
+
+    // Upper bound of Height() (the normalised FBM lies in [0, 1])
+    static float MaxHeight(const TerrainParams& params) { return params.finalScale; }
+
+    // Kernel selection (process wide). Requesting one the build or CPU lacks falls back to AUTO.
+    static void SetKernel(TerrainNoiseKernel kernel);
+    static TerrainNoiseKernel GetKernel(); // The one in use, never AUTO
+    static bool IsKernelSupported(TerrainNoiseKernel kernel);
+    static const char* GetKernelName(TerrainNoiseKernel kernel);
+
+    static constexpr float NORMAL_EPSILON = 0.01f;
+};
+
+#endif // TERRAIN_NOISE_H
@@ -0,0 +1,72 @@
+#ifndef TERRAIN_NOISE_KERNEL_H
+#define TERRAIN_NOISE_KERNEL_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Internal to TerrainNoise.cpp / TerrainNoiseAvx2.cpp: the vector FBM loop shared by every SIMD kernel.
+//
+// Everything here lives in an anonymous namespace on purpose. The AVX2 translation unit is compiled with
+// AVX2 enabled, and a shared inline definition could be merged by the linker into the baseline kernels,
+// which would then fault on CPUs without AVX2. Keep std:: templates out of the kernel for the same reason.
+//
+// V supplies WIDTH, the register types F (float lanes) and I (32-bit integer lanes) and the operations below.
+// Each one maps to a single instruction, or a short fixed sequence, with the same IEEE result as the scalar
+// code in TerrainNoise.cpp, so every kernel returns the same bits as TerrainNoise::Height().
+namespace {
+
+template <typename V>
+inline typename V::F terrainHashLanes(typename V::I x, typename V::I z) {
+    typename V::I h = V::Xor(V::MulLo(x, V::SetI(0x8da6b343u)), V::MulLo(z, V::SetI(0xd8163841u)));
+    h = V::Xor(h, V::ShiftRight(h, 16)); h = V::MulLo(h, V::SetI(0x7feb352du));
+    h = V::Xor(h, V::ShiftRight(h, 15)); h = V::MulLo(h, V::SetI(0x846ca68bu));
+    h = V::Xor(h, V::ShiftRight(h, 16));
+    return V::Mul(V::ToFloat(V::ShiftRight(h, 8)), V::Set(1.0f / 16777216.0f));
+}
+
+// GLSL mix(): x * (1 - a) + y * a
+template <typename V>
+inline typename V::F terrainMixLanes(typename V::F x, typename V::F y, typename V::F a) {
+    return V::Add(V::Mul(x, V::Sub(V::Set(1.0f), a)), V::Mul(y, a));
+}
+
+template <typename V>
+inline typename V::F terrainValueNoiseLanes(typename V::F x, typename V::F z) {
+    typename V::F ix = V::Floor(x), iz = V::Floor(z);
+    typename V::F fx = V::Sub(x, ix), fz = V::Sub(z, iz);
+    typename V::F ux = V::Mul(V::Mul(fx, fx), V::Sub(V::Set(3.0f), V::Mul(V::Set(2.0f), fx)));
+    typename V::F uz = V::Mul(V::Mul(fz, fz), V::Sub(V::Set(3.0f), V::Mul(V::Set(2.0f), fz)));
+    typename V::I cx = V::ToInt(ix), cz = V::ToInt(iz);
+    typename V::I cx1 = V::AddI(cx, V::SetI(1u)), cz1 = V::AddI(cz, V::SetI(1u));
+    return terrainMixLanes<V>(terrainMixLanes<V>(terrainHashLanes<V>(cx, cz), terrainHashLanes<V>(cx1, cz), ux),
+                              terrainMixLanes<V>(terrainHashLanes<V>(cx, cz1), terrainHashLanes<V>(cx1, cz1), ux), uz);
+}
+
+// Un-normalised FBM (fbm_raw) of count points; count must be a multiple of V::WIDTH
+template <typename V>
+void terrainFbmKernel(const float* xs, const float* zs, size_t count, float baseFreq, float baseAmp, float persistence,
+                      int octaves, float* out) {
+    for (size_t i = 0; i < count; i += V::WIDTH) {
+        typename V::F x = V::Load(xs + i), z = V::Load(zs + i);
+        typename V::F value = V::Set(0.0f);
+        float freq = baseFreq, amp = baseAmp;
+        for (int octave = 0; octave < octaves; octave++) {
+            if (amp < 0.01f) break;
+            typename V::F noise = terrainValueNoiseLanes<V>(V::Mul(x, V::Set(freq)), V::Mul(z, V::Set(freq)));
+            value = V::Add(value, V::Mul(noise, V::Set(amp)));
+            freq *= 2.0f;
+            amp *= persistence;
+        }
+        V::Store(out + i, value);
+    }
+}
+
+} // namespace
+
+// Defined in TerrainNoiseAvx2.cpp. Returns false (and writes nothing) when that file was built without AVX2,
+// so a call with count 0 reports whether the kernel exists; the caller checks the CPU before real calls.
+// count must be a multiple of 8.
+bool terrainFbmAvx2(const float* xs, const float* zs, size_t count, float baseFreq, float baseAmp, float persistence,
+                    int octaves, float* out);
+
+#endif // TERRAIN_NOISE_KERNEL_H
@@ -0,0 +1,33 @@
+#ifndef TEXTURE_COOK_CACHE_H
+#define TEXTURE_COOK_CACHE_H
+
+#include <filesystem>
+#include <string>
+#include "CompressedTexture.h"
+
+// Block-compressed copies of stb-loaded sources, so a texture loaded again skips both the PNG/JPEG decode
+// and the driver-side uncompressed storage.
+//
+// Cook() builds the whole mip chain on the CPU (2x2 box filter) and encodes every level:
+//   1 channel -> BC4, 2 channels -> BC5, 3 channels -> BC1, 4 channels -> BC3
+// Files are DDS, named after a hash of the absolute source path like MeshCache's; the source's size and
+// mtime are stored in the header, so an edited source is re-cooked on its next load.
+class TextureCookCache {
+public:
+    explicit TextureCookCache(std::filesystem::path cacheDirectory = "cache/textures");
+
+    // Loads the cooked file for `sourcePath` if it is valid for the current source
+    bool Load(const std::string& sourcePath, CompressedImage& image) const;
+    // Writes the cooked file for `sourcePath` (to a temp file, then renamed into place)
+    bool Store(const std::string& sourcePath, const CompressedImage& image) const;
+
+    // Encodes tightly packed 8-bit pixels (rows bottom-up, as stb loads them flipped) with a full mip chain
+    static bool Cook(const unsigned char* pixels, int width, int height, int channels, CompressedImage& image);
+
+    std::filesystem::path GetCachePath(const std::string& sourcePath) const;
+
+private:
+    std::filesystem::path m_directory;
+};
+
+#endif // TEXTURE_COOK_CACHE_H
@@ -0,0 +1,158 @@
+#ifndef TEXTURE_STREAMER_H
+#define TEXTURE_STREAMER_H
+
+#include <GL/glew.h>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "CompressedTexture.h"
+#include "TextureCookCache.h"
+#include "ThreadPool.h"
+
+// Index into TextureStreamer's cache; 0 is never a valid texture
+using TextureHandle = uint32_t;
+static const TextureHandle INVALID_TEXTURE_HANDLE = 0;
+
+// LOADING: decoding on the pool (placeholder bound). PREVIEW: low-res copy bound while the full image
+// streams in. READY: full image with mipmaps. FAILED: decode failed, placeholder stays bound.
+enum class TextureState { LOADING, PREVIEW, READY, FAILED };
+
+// Handle-based texture cache with background loading.
+// stb_image decodes on the thread pool, which also box-filters a small preview; the GL thread uploads
+// the preview at once and then streams the full image through mapped pixel buffer objects in row
+// chunks, within a per-frame time and byte budget. Until a texture is READY its handle resolves to
+// the preview (or to a shared checker placeholder), so callers can bind it from the first frame.
+// .dds / .ktx2 files load their BCn mip chain as is (the smallest levels serve as the preview). With
+// cooking enabled (off by default), other sources are encoded to BCn once and then come from TextureCookCache.
+//
+// Handles are reference counted: every Request() takes a reference and Release() drops one. Textures
+// nobody references stay cached (so a re-request is free) until their combined size exceeds the unused
+// budget; Update() then evicts the longest-unused ones and their slots are reused for new paths.
+class TextureStreamer {
+public:
+    explicit TextureStreamer(ThreadPool& pool);
+    ~TextureStreamer(); // Waits for running decodes, then deletes every GL texture
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    // Creates the placeholder texture and the upload PBOs (GL thread)
+    bool Initialize();
+
+    // Returns the cached handle for `path`, starting a load if it is new or the file changed on disk.
+    // forceReload re-decodes even if the timestamp is unchanged. Takes a reference on the handle.
+    TextureHandle Request(const std::string& path, bool forceReload = false);
+    // Drops a reference taken by Request(); the handle must not be used afterwards
+    void Release(TextureHandle handle);
+
+    // GL thread: takes finished decodes and streams pixel data for up to budgetMs, then evicts unused textures over the budget
+    void Update(double budgetMs);
+
+    // GL name to bind for `handle` right now (placeholder, preview or full texture)
+    GLuint GetTextureId(TextureHandle handle) const;
+    TextureState GetState(TextureHandle handle) const;
+    const std::string& GetPath(TextureHandle handle) const;
+
+    size_t GetTextureCount() const { return m_entries.size() - m_freeSlots.size(); }
+    size_t GetPendingCount() const;
+    size_t GetGpuBytes() const; // Approximate VRAM of all sampled textures (mip chains included)
+    size_t GetUnusedBytes() const; // Part of GetGpuBytes() held by textures with no references
+    size_t GetEvictedCount() const { return m_evictedCount; }
+
+    // VRAM unreferenced textures may keep before eviction; 0 evicts them at the next Update()
+    void SetUnusedBudget(size_t bytes) { m_unusedBudget = bytes; }
+    size_t GetUnusedBudget() const { return m_unusedBudget; }
+
+    // Applies to loads started afterwards
+    void SetCookingEnabled(bool enabled) { m_cookingEnabled = enabled; }
+    bool IsCookingEnabled() const { return m_cookingEnabled; }
+
+    // Deletes every texture; outstanding handles resolve to the placeholder afterwards
+    void Clear();
+
+private:
+    struct Entry {
+        std::string path;
+        std::filesystem::file_time_type timestamp;
+        TextureState state = TextureState::LOADING;
+        GLuint texture = 0;      // Sampled texture (preview or full); 0 = placeholder
+        uint32_t generation = 0; // Changes on every (re)load so results of an older decode are dropped
+        size_t gpuBytes = 0;
+        uint32_t refCount = 0;
+        uint64_t releasedAt = 0; // Release tick of the last reference dropped, orders eviction
+        bool live = true;        // false: evicted, the slot is in m_freeSlots
+    };
+
+    using PixelBuffer = std::unique_ptr<unsigned char, void (*)(void*)>; // Freed with stbi_image_free
+
+    // Worker output; pixels are tightly packed rows, bottom row first (flipped for GL)
+    struct DecodedImage {
+        TextureHandle handle = INVALID_TEXTURE_HANDLE;
+        uint32_t generation = 0;
+        std::string error;
+        int width = 0, height = 0, channels = 0;
+        PixelBuffer pixels{ nullptr, nullptr };
+        int previewWidth = 0, previewHeight = 0;
+        std::vector<unsigned char> preview;
+        bool compressed = false;   // true: `compressedImage` holds the data instead of `pixels`
+        CompressedImage compressedImage;
+    };
+
+    struct StagedUpload {
+        DecodedImage image;
+        GLuint texture = 0; // Full-resolution texture being filled, swapped in when complete
+        size_t nextLevel = 0; // Compressed only: mip level being streamed
+        int nextRow = 0;      // Pixel row, or block row of nextLevel when compressed
+        size_t cpuBytes = 0;  // Reported to MemoryStats as TEXTURE_CPU while staged
+    };
+
+    static const int UPLOAD_PBO_COUNT = 3;
+
+    ThreadPool& m_pool;
+    std::vector<Entry> m_entries; // m_entries[handle - 1]
+    std::unordered_map<std::string, TextureHandle> m_handles;
+    std::vector<TextureHandle> m_freeSlots; // Evicted entries, reused by Request()
+    size_t m_unusedBudget;
+    uint64_t m_releaseTick = 0;
+    size_t m_evictedCount = 0;
+    GLuint m_placeholder = 0;
+    GLuint m_pbos[UPLOAD_PBO_COUNT] = {};
+    int m_nextPbo = 0;
+    uint32_t m_nextGeneration = 1;
+    TextureCookCache m_cookCache;
+    CompressedFormatSupport m_formatSupport; // Queried in Initialize(), read by decode jobs
+    bool m_cookingEnabled = false; // Opt-in: BCn is lossy, and wrong for normal maps and other linear data
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_jobsDone;
+    unsigned int m_jobsInFlight = 0;
+    std::deque<DecodedImage> m_decoded; // Filled by workers, drained by Update()
+
+    std::deque<StagedUpload> m_staged; // GL thread only
+
+    void startDecode(TextureHandle handle);
+    void decodeImage(const std::string& path, bool cook, DecodedImage& image) const;
+    static void buildPreview(DecodedImage& image);
+    void beginUpload(DecodedImage& image);
+    void beginCompressedUpload(DecodedImage& image);
+    // Streams rows of the front upload; returns the bytes submitted
+    size_t uploadRows(StagedUpload& upload, size_t maxBytes);
+    size_t uploadCompressedRows(StagedUpload& upload, size_t maxBytes);
+    // Orphans and maps the next PBO, copies `bytes` from `source` into it and leaves it bound.
+    // Returns the pointer to pass to glTex*SubImage2D: 0 (PBO offset), or `source` if mapping failed.
+    const void* stageThroughPbo(const unsigned char* source, size_t bytes);
+    void finishUpload(StagedUpload& upload);
+    void pushStaged(StagedUpload&& upload);
+    void popStaged(); // Front upload, with its texture if it was not swapped in
+    void evictUnused();
+    static void deleteTexture(GLuint& texture);
+    Entry* findEntry(TextureHandle handle, uint32_t generation);
+};
+
+#endif // TEXTURE_STREAMER_H
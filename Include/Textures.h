@@ -4,52 +4,49 @@
 
 #include <GL/glew.h>
 #include <string>
-#include <unordered_map>
 #include <iostream>
 #include <filesystem>
+#include "TextureStreamer.h"
 
+// A texture file from the streamer's handle cache. Construction only queues the load; until the
+// image has been decoded and uploaded, Bind() binds the preview or the placeholder instead.
+// Holds one reference on its handle, dropped on destruction (the streamer evicts unreferenced textures).
 class Texture {
 public:
-    // Constructor with option to disable caching
-    Texture(const char* path, bool useCache = true);
+    // Throws if the file does not exist
+    Texture(TextureStreamer& streamer, const char* path);
     ~Texture();
 
+    Texture(const Texture&) = delete;
+    Texture& operator=(const Texture&) = delete;
+
     void Bind(unsigned int slot) const;
     void Unbind() const;
 
     // Add reload method
     bool Reload(const char* path);
 
+    TextureHandle GetHandle() const { return handle; }
+    TextureState GetState() const { return streamer.GetState(handle); }
+    // GL name currently bound by Bind() (changes as the texture streams in)
+    GLuint GetID() const { return streamer.GetTextureId(handle); }
+
     // Static methods for debugging
     static void EnableDebug(bool enable);
     static void PrintBindStats();
 
-    // Static method to clear texture cache
-    static void ClearCache();
-
-    // Static method to force reload all textures
-    static void ForceReloadAll();
-
     // Static variables for tracking
     static int totalBindCalls;
     static int activeBindings;
-    unsigned int ID;
-    // Static texture cache
-    static std::unordered_map<std::string, unsigned int> textureCache;
-
-    // Static timestamp cache for file modification tracking
-    static std::unordered_map<std::string, std::filesystem::file_time_type> textureTimestamps;
 
 private:
-
+    TextureStreamer& streamer;
+    TextureHandle handle;
     std::string texturePath;
     mutable bool isBound;
     mutable unsigned int lastBoundSlot;
 
     static bool debugEnabled;
-
-    // Helper method to load texture data
-    bool LoadTextureData(const char* path, bool addToCache);
 };
 
-#endif // TEXTURES_H
\ No newline at end of file
+#endif // TEXTURES_H
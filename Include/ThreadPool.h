@@ -0,0 +1,55 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Fixed set of worker threads consuming a FIFO task queue.
+// Tasks must not touch GL; results that need the GL thread are handed back through the caller's own queue.
+class ThreadPool {
+public:
+    // threadCount == 0 picks hardware_concurrency() - 1 (the main/GL thread keeps a core), at least 1
+    explicit ThreadPool(unsigned int threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void Enqueue(std::function<void()> task);
+
+    // Enqueues a callable and returns a future for its result (exceptions are forwarded through the future)
+    template <typename F>
+    auto Submit(F&& func) -> std::future<typename std::invoke_result<F>::type> {
+        using Result = typename std::invoke_result<F>::type;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(func));
+        std::future<Result> future = task->get_future();
+        Enqueue([task]() { (*task)(); });
+        return future;
+    }
+
+    // Blocks until the queue is empty and no task is running
+    void WaitIdle();
+
+    unsigned int GetThreadCount() const { return static_cast<unsigned int>(m_workers.size()); }
+    size_t GetQueuedCount() const;
+
+private:
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_tasks;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_taskAvailable;
+    std::condition_variable m_idle;
+    unsigned int m_activeTasks = 0;
+    bool m_stopping = false;
+
+    void workerLoop();
+};
+
+#endif // THREAD_POOL_H
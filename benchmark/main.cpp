@@ -0,0 +1,303 @@
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Renderer.h"
+#include "PhysicsWorld.h"
+#include "Profiler.h"
+#include "Log.h"
+
+// Deterministic benchmark: same renderer and physics scene as the editor, hidden window, vsync off,
+// fixed timestep and a camera path that depends only on the frame index.
+// Run from the build directory (shaders/ and textures/ are resolved relative to it).
+
+struct BenchmarkOptions {
+    int width = 1280;
+    int height = 720;
+    int warmupFrames = 120;
+    int measuredFrames = 600;
+    unsigned long seed = 1;
+    PhysicsThreadingSettings physicsThreading; // --physics-threads N|auto, 0 = single-threaded
+    StressSceneSettings stress;                // Layout / seed of the stress bodies (bodyCount = --stress-bodies)
+    int stressBodies = 0;                      // Added to the demo scene before the rendered run
+    std::vector<int> sweepBodyCounts;          // --physics-sweep: physics-only run, one row per body count
+    int physicsSteps = 600;                    // Steps measured per sweep entry
+    std::string sweepCsvPath = "physics_sweep.csv";
+    std::string csvPath = "benchmark.csv";
+    std::string jsonPath = "benchmark.json";
+    int framesInFlight = 2;                    // Frame pacer latency limit (vsync is always off here)
+};
+
+// Simulation / scene time advanced per frame, independent of how long the frame took
+static const float BENCHMARK_TIME_STEP = 1.0f / 60.0f;
+// Untimed steps per sweep point before measuring: the first steps build the broadphase pairs and
+// contact manifolds and touch the fresh bodies' memory for the first time
+static const int PHYSICS_SWEEP_WARMUP_STEPS = 30;
+// Camera orbit: one full revolution every 600 frames around the scene origin
+static const float CAMERA_ORBIT_RADIUS = 14.0f;
+static const float CAMERA_ORBIT_FRAMES = 600.0f;
+
+static void printUsage() {
+    std::cout << "Usage: OpenGLCubeBenchmark [--width N] [--height N] [--warmup N] [--frames N] [--seed N]"
+                 " [--csv path] [--json path] [--physics-threads N|auto] [--frames-in-flight N]\n"
+                 "       [--stress-layout pile|stacks|rain] [--stress-bodies N] [--stress-spheres F]\n"
+                 "       [--physics-sweep N1,N2,...] [--physics-steps N] [--sweep-csv path]" << std::endl;
+}
+
+static bool parseStressLayout(const std::string& value, StressLayout& layout) {
+    if (value == "pile") layout = StressLayout::PILE;
+    else if (value == "stacks") layout = StressLayout::STACKS;
+    else if (value == "rain") layout = StressLayout::RAIN;
+    else return false;
+    return true;
+}
+
+static bool parseBodyCounts(const std::string& value, std::vector<int>& counts) {
+    std::stringstream stream(value);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        int count = std::atoi(item.c_str());
+        if (count <= 0) return false;
+        counts.push_back(count);
+    }
+    return !counts.empty();
+}
+
+static bool parseArguments(int argc, char** argv, BenchmarkOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") { printUsage(); return false; }
+        if (i + 1 >= argc) { std::cerr << "Missing value for " << arg << std::endl; printUsage(); return false; }
+        const char* value = argv[++i];
+        if (arg == "--width") options.width = std::atoi(value);
+        else if (arg == "--height") options.height = std::atoi(value);
+        else if (arg == "--warmup") options.warmupFrames = std::atoi(value);
+        else if (arg == "--frames") options.measuredFrames = std::atoi(value);
+        else if (arg == "--seed") options.seed = std::strtoul(value, nullptr, 10);
+        else if (arg == "--csv") options.csvPath = value;
+        else if (arg == "--json") options.jsonPath = value;
+        else if (arg == "--physics-threads") {
+            bool automatic = std::strcmp(value, "auto") == 0;
+            options.physicsThreading.multithreaded = automatic || std::atoi(value) > 0;
+            options.physicsThreading.workerThreads = automatic ? 0u : static_cast<unsigned int>(std::max(std::atoi(value), 0));
+        }
+        else if (arg == "--stress-layout") {
+            if (!parseStressLayout(value, options.stress.layout)) { std::cerr << "Unknown stress layout " << value << std::endl; return false; }
+        }
+        else if (arg == "--stress-bodies") options.stressBodies = std::max(std::atoi(value), 0);
+        else if (arg == "--stress-spheres") options.stress.sphereFraction = static_cast<float>(std::atof(value));
+        else if (arg == "--physics-sweep") {
+            if (!parseBodyCounts(value, options.sweepBodyCounts)) { std::cerr << "Invalid body count list " << value << std::endl; return false; }
+        }
+        else if (arg == "--physics-steps") options.physicsSteps = std::atoi(value);
+        else if (arg == "--sweep-csv") options.sweepCsvPath = value;
+        else if (arg == "--frames-in-flight") options.framesInFlight = std::atoi(value);
+        else { std::cerr << "Unknown argument " << arg << std::endl; printUsage(); return false; }
+    }
+    if (options.width <= 0 || options.height <= 0 || options.warmupFrames < 0 || options.measuredFrames <= 0) {
+        std::cerr << "Resolution and measured frame count must be positive" << std::endl;
+        return false;
+    }
+    if (options.physicsSteps <= 0) { std::cerr << "Physics step count must be positive" << std::endl; return false; }
+    options.stress.seed = static_cast<unsigned int>(options.seed);
+    return true;
+}
+
+// Orbit around the origin with a slow height bob, always looking at the scene centre
+static void updateCamera(Camera& camera, int frame) {
+    float angle = glm::radians(360.0f) * static_cast<float>(frame) / CAMERA_ORBIT_FRAMES;
+    camera.Position = glm::vec3(std::cos(angle) * CAMERA_ORBIT_RADIUS,
+                                6.0f + 3.0f * std::sin(angle * 2.0f),
+                                std::sin(angle) * CAMERA_ORBIT_RADIUS);
+    glm::vec3 direction = glm::normalize(glm::vec3(0.0f, 2.0f, 0.0f) - camera.Position);
+    camera.Yaw = glm::degrees(std::atan2(direction.z, direction.x));
+    camera.Pitch = glm::degrees(std::asin(direction.y));
+    camera.updateCameraVectors();
+}
+
+static std::string jsonEscape(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+static void writeJsonStats(std::ofstream& out, const ProfileStats& stats) {
+    out << "{ \"avg_ms\": " << stats.averageMs << ", \"p95_ms\": " << stats.p95Ms
+        << ", \"p99_ms\": " << stats.p99Ms << ", \"samples\": " << stats.sampleCount << " }";
+}
+
+static bool writeCsv(const std::string& path, const Profiler& profiler) {
+    std::ofstream out(path);
+    if (!out) { std::cerr << "ERROR: Cannot write " << path << std::endl; return false; }
+    out << "section,cpu_avg_ms,cpu_p95_ms,cpu_p99_ms,gpu_avg_ms,gpu_p95_ms,gpu_p99_ms,samples\n";
+    ProfileStats frame = profiler.GetFrameHistory().ComputeStats();
+    out << "Frame Interval," << frame.averageMs << "," << frame.p95Ms << "," << frame.p99Ms << ",,,," << frame.sampleCount << "\n";
+    for (size_t i = 0; i < profiler.GetSectionCount(); ++i) {
+        ProfileStats cpu = profiler.GetCpuStats(i);
+        out << profiler.GetSectionName(i) << "," << cpu.averageMs << "," << cpu.p95Ms << "," << cpu.p99Ms << ",";
+        if (profiler.HasGpuTiming(i)) {
+            ProfileStats gpu = profiler.GetGpuStats(i);
+            out << gpu.averageMs << "," << gpu.p95Ms << "," << gpu.p99Ms;
+        } else {
+            out << ",,";
+        }
+        out << "," << cpu.sampleCount << "\n";
+    }
+    return true;
+}
+
+static bool writeJson(const std::string& path, const Profiler& profiler, const BenchmarkOptions& options, const PhysicsWorld& physics) {
+    std::ofstream out(path);
+    if (!out) { std::cerr << "ERROR: Cannot write " << path << std::endl; return false; }
+    const char* glRenderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+    const char* glVersion = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+    out << "{\n";
+    out << "  \"gl_renderer\": \"" << jsonEscape(glRenderer ? glRenderer : "") << "\",\n";
+    out << "  \"gl_version\": \"" << jsonEscape(glVersion ? glVersion : "") << "\",\n";
+    out << "  \"width\": " << options.width << ", \"height\": " << options.height << ",\n";
+    out << "  \"warmup_frames\": " << options.warmupFrames << ", \"measured_frames\": " << options.measuredFrames << ",\n";
+    out << "  \"seed\": " << options.seed << ",\n";
+    out << "  \"physics_worker_threads\": " << physics.GetWorkerThreadCount() << ",\n";
+    out << "  \"frames_in_flight\": " << options.framesInFlight << ",\n";
+    out << "  \"stress_bodies\": " << physics.GetStressBodyCount() << ", \"stress_layout\": \""
+        << PhysicsWorld::GetStressLayoutName(options.stress.layout) << "\",\n";
+    out << "  \"dropped_gpu_queries\": " << profiler.GetDroppedQueryCount() << ",\n";
+    out << "  \"frame_interval\": "; writeJsonStats(out, profiler.GetFrameHistory().ComputeStats()); out << ",\n";
+    out << "  \"sections\": [\n";
+    for (size_t i = 0; i < profiler.GetSectionCount(); ++i) {
+        out << "    { \"name\": \"" << jsonEscape(profiler.GetSectionName(i)) << "\", \"cpu\": ";
+        writeJsonStats(out, profiler.GetCpuStats(i));
+        out << ", \"gpu\": ";
+        if (profiler.HasGpuTiming(i)) writeJsonStats(out, profiler.GetGpuStats(i));
+        else out << "null";
+        out << " }" << (i + 1 < profiler.GetSectionCount() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    return true;
+}
+
+// Physics-only scaling run: for each body count, spawn a fresh stress scene and time stepSimulation alone.
+// One world serves every entry (stress bodies are cleared in between): Bullet hands out thread indices
+// for the process lifetime, so a new Mt world per entry would run out of them.
+static bool runPhysicsSweep(const BenchmarkOptions& options) {
+    std::ofstream out(options.sweepCsvPath);
+    if (!out) { std::cerr << "ERROR: Cannot write " << options.sweepCsvPath << std::endl; return false; }
+    out << "bodies,layout,worker_threads,step_avg_ms,step_p95_ms,step_p99_ms,avg_pairs,avg_manifolds,steps\n";
+
+    PhysicsWorld physics;
+    physics.Initialize(options.seed, options.physicsThreading);
+    PhysicsStepStats stats;
+    for (int bodyCount : options.sweepBodyCounts) {
+        StressSceneSettings stress = options.stress;
+        stress.bodyCount = bodyCount;
+        physics.ClearStressBodies();
+        physics.SpawnStressBodies(stress);
+        for (int step = 0; step < PHYSICS_SWEEP_WARMUP_STEPS; ++step) {
+            physics.GetWorld()->stepSimulation(BENCHMARK_TIME_STEP, 1, BENCHMARK_TIME_STEP);
+        }
+
+        SampleHistory stepHistory(static_cast<size_t>(options.physicsSteps));
+        double pairSum = 0.0, manifoldSum = 0.0;
+        for (int step = 0; step < options.physicsSteps; ++step) {
+            auto start = std::chrono::steady_clock::now();
+            physics.GetWorld()->stepSimulation(BENCHMARK_TIME_STEP, 1, BENCHMARK_TIME_STEP);
+            float stepMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+            PhysicsWorld::CaptureStepStats(physics.GetWorld(), stepMs, stats);
+            stepHistory.Push(stepMs);
+            pairSum += stats.overlappingPairs;
+            manifoldSum += stats.contactManifolds;
+        }
+        ProfileStats stepStats = stepHistory.ComputeStats();
+        double avgPairs = pairSum / options.physicsSteps, avgManifolds = manifoldSum / options.physicsSteps;
+        out << bodyCount << "," << PhysicsWorld::GetStressLayoutName(stress.layout) << "," << physics.GetWorkerThreadCount() << ","
+            << stepStats.averageMs << "," << stepStats.p95Ms << "," << stepStats.p99Ms << ","
+            << avgPairs << "," << avgManifolds << "," << stepStats.sampleCount << "\n";
+        Log::Flush();
+        std::cout << bodyCount << " bodies: step avg " << stepStats.averageMs << " ms, p99 " << stepStats.p99Ms
+                  << " ms, " << avgPairs << " pairs, " << avgManifolds << " manifolds" << std::endl;
+    }
+    physics.Shutdown();
+    std::cout << "Physics sweep written to " << options.sweepCsvPath << std::endl;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    BenchmarkOptions options;
+    if (!parseArguments(argc, argv, options)) return 1;
+    if (!options.sweepBodyCounts.empty()) return runPhysicsSweep(options) ? 0 : 1;
+
+    PhysicsWorld physics;
+    physics.Initialize(options.seed, options.physicsThreading);
+    if (options.stressBodies > 0) {
+        StressSceneSettings stress = options.stress;
+        stress.bodyCount = options.stressBodies;
+        physics.SpawnStressBodies(stress);
+    }
+
+    RendererSettings settings;
+    settings.visible = false;
+    settings.pacing.vsync = VsyncMode::OFF;
+    settings.pacing.maxFramesInFlight = options.framesInFlight;
+    settings.showUI = false;
+    settings.shaderHotReload = false;
+    settings.profilerHistoryFrames = static_cast<size_t>(options.measuredFrames);
+
+    Renderer renderer(options.width, options.height, "Raymarching Benchmark");
+    if (!renderer.Initialize(settings)) {
+        std::cerr << "Failed to initialize renderer!" << std::endl;
+        physics.Shutdown();
+        glfwTerminate();
+        return 1;
+    }
+    Profiler* profiler = renderer.GetProfiler();
+
+    Log::Flush(); // Engine log lines first, so the report is not interleaved with them
+    std::cout << "Benchmark: " << options.warmupFrames << " warmup + " << options.measuredFrames << " measured frames at "
+              << options.width << "x" << options.height << ", seed " << options.seed << std::endl;
+
+    // Physics is stepped inline (no PhysicsThread) so frame N always renders the same simulation state
+    int totalFrames = options.warmupFrames + options.measuredFrames;
+    for (int frame = 0; frame < totalFrames; ++frame) {
+        if (frame == options.warmupFrames && profiler) profiler->Reset();
+
+        renderer.GetFramePacer().BeginFrame(); // Fixed time step; only the frames-in-flight limit applies
+        glfwPollEvents();
+        {
+            ProfileScope scope(profiler, "Physics Step", false);
+            physics.GetWorld()->stepSimulation(BENCHMARK_TIME_STEP, 1, BENCHMARK_TIME_STEP);
+        }
+        updateCamera(renderer.GetCamera(), frame);
+        renderer.SetSceneTime(static_cast<float>(frame) * BENCHMARK_TIME_STEP);
+        renderer.Update(BENCHMARK_TIME_STEP);
+        renderer.Render(physics.GetWorld());
+    }
+
+    bool ok = profiler != nullptr;
+    if (profiler) {
+        profiler->Flush(); // Collect the GPU timings of the last few frames
+        ProfileStats frameStats = profiler->GetFrameHistory().ComputeStats();
+        Log::Flush();
+        std::cout << "Frame time: avg " << frameStats.averageMs << " ms, p95 " << frameStats.p95Ms
+                  << " ms, p99 " << frameStats.p99Ms << " ms" << std::endl;
+        ok = writeCsv(options.csvPath, *profiler) && ok;
+        ok = writeJson(options.jsonPath, *profiler, options, physics) && ok;
+        if (ok) std::cout << "Results written to " << options.csvPath << " and " << options.jsonPath << std::endl;
+    }
+
+    physics.Shutdown();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,26 @@
+// Shared cloud definition: the density field, sampled from the precomputed 3D noise volume.
+// Included by clouds_fragment.glsl (cloud buffer) and terrain_shading.glsl (cloud shadows on the terrain).
+#ifndef CLOUD_DENSITY_GLSL
+#define CLOUD_DENSITY_GLSL
+
+// Cloud parameters (u_cloud_*, u_cloudNoisePeriod) live in the RaymarchParams block
+#include "raymarch_params.glsl"
+uniform float u_time;      // Time for animation (scrolls the noise volume)
+uniform sampler3D u_cloudNoise;   // Tileable 4-octave FBM volume generated once by CloudRenderer
+uniform bool u_cloudsEnabled;
+
+const vec3 CLOUD_WIND = vec3(0.05, 0.0, 0.02); // Noise-space scroll per second of u_time
+
+// --- Cloud Density Function ---
+float mapClouds(vec3 p) {
+    float y_norm = (p.y - u_cloud_base_height) / u_cloud_thickness;
+    float verticalFalloff = smoothstep(0.0, 0.1, y_norm) * (1.0 - smoothstep(0.9, 1.0, y_norm));
+    if (verticalFalloff <= 0.0) return 0.0;
+    vec3 noiseSamplePos = p * u_cloud_noise_scale + CLOUD_WIND * u_time;
+    float baseNoise = textureLod(u_cloudNoise, noiseSamplePos / u_cloudNoisePeriod, 0.0).r;
+    float density = smoothstep(u_cloud_coverage_min, u_cloud_coverage_max, baseNoise);
+    return density * verticalFalloff * u_cloud_density_factor;
+}
+// --- End Clouds ---
+
+#endif // CLOUD_DENSITY_GLSL
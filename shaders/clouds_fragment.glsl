@@ -0,0 +1,94 @@
+#version 330 core
+layout(location = 0) out vec4 FragColor;      // rgb = accumulated cloud color, a = opacity
+layout(location = 1) out float FragDistance;  // Distance to the first visible cloud density (MAX_TRACE_DISTANCE if none)
+
+in vec2 TexCoords; // UV coordinates from vertex shader (0.0 to 1.0)
+
+// --- Uniforms ---
+uniform vec3 u_camPos;        // Camera position in world space
+uniform mat4 u_invViewMatrix; // Inverse of the view matrix
+uniform mat4 u_invProjMatrix; // Inverse of the projection matrix
+uniform int u_cloudSteps;     // Step budget per ray
+// Temporal updates: only pixels on this frame's cell of the update grid are marched, the rest are reprojected
+uniform sampler2D u_historyColor;    // Last frame's cloud buffer
+uniform sampler2D u_historyDistance; // Last frame's cloud distance
+uniform mat4 u_prevViewProj;         // Previous frame's projection * view
+uniform bool u_historyValid;         // False: march every pixel
+uniform int u_updateGrid;            // 1 = every pixel, 2 = one pixel per 2x2 block, 4 = one per 4x4 block
+uniform vec2 u_updateOffset;         // Pixel of each block marched this frame
+uniform float u_timeDelta;           // u_time elapsed since the history was written
+// --- End Uniforms ---
+
+#include "cloud_density.glsl"
+
+// Constants...
+const float MAX_TRACE_DISTANCE = 100.0;
+const float CLOUD_STEP_SIZE = 0.8; // Minimum step; lengthened when the slab needs more than u_cloudSteps of them
+const float CLOUD_DENSITY_MULTIPLIER = 1.5;
+
+// --- Generate Ray Direction ---
+vec3 getRayDirection(vec2 uv, vec3 camPos) {
+    vec2 ndc = uv * 2.0 - 1.0; vec4 clipPos = vec4(ndc.x, ndc.y, -1.0, 1.0);
+    vec4 viewPos = u_invProjMatrix * clipPos; viewPos /= viewPos.w;
+    vec4 worldPos = u_invViewMatrix * vec4(viewPos.xyz, 1.0);
+    return normalize(worldPos.xyz - camPos);
+}
+
+// --- Volumetric Cloud Ray Marching ---
+// The ray is clipped to the cloud slab [base, base + thickness] first, so steps are only spent where density can exist.
+vec4 marchClouds(vec3 ro, vec3 rd, out float firstHit) {
+    firstHit = MAX_TRACE_DISTANCE;
+    float slabBottom = u_cloud_base_height; float slabTop = u_cloud_base_height + u_cloud_thickness;
+    float tEnter = 0.0; float tExit = MAX_TRACE_DISTANCE;
+    if (abs(rd.y) > 1e-4) {
+        float t0 = (slabBottom - ro.y) / rd.y; float t1 = (slabTop - ro.y) / rd.y;
+        tEnter = max(min(t0, t1), 0.0); tExit = min(max(t0, t1), MAX_TRACE_DISTANCE);
+    } else if (ro.y < slabBottom || ro.y > slabTop) {
+        return vec4(0.0); // Horizontal ray outside the slab
+    }
+    if (tExit <= tEnter) return vec4(0.0);
+
+    float stepSize = max(CLOUD_STEP_SIZE, (tExit - tEnter) / float(max(u_cloudSteps, 1)));
+    float t = tEnter; vec4 accumulatedColor = vec4(0.0);
+    vec3 cloudColor = vec3(1.0);
+    float lightPhase = pow(max(dot(rd, -u_lightDir), 0.0), 2.0) * 0.5 + 0.5;
+    for(int i = 0; i < u_cloudSteps; ++i) {
+        if (accumulatedColor.a > 0.99) break;
+        vec3 currentPos = ro + rd * t;
+        float density = mapClouds(currentPos);
+        if (density > 0.01) {
+            if (accumulatedColor.a == 0.0) firstHit = t;
+            vec3 litCloudColor = cloudColor * lightPhase;
+            float alpha = (1.0 - exp(-density * stepSize * CLOUD_DENSITY_MULTIPLIER));
+            vec4 stepColor = vec4(litCloudColor, alpha);
+            accumulatedColor.rgb += (1.0 - accumulatedColor.a) * stepColor.rgb * stepColor.a;
+            accumulatedColor.a += (1.0 - accumulatedColor.a) * stepColor.a;
+        }
+        t += stepSize;
+        if (t >= tExit) break;
+    } return accumulatedColor;
+}
+
+// Last frame's value for this pixel: the ray is followed to the distance stored here last frame, moved back by
+// the wind scrolled since, and projected with last frame's matrices. False when that lands off-screen.
+bool reprojectHistory(vec3 rd, out vec4 color, out float firstHit) {
+    float dist = texelFetch(u_historyDistance, ivec2(gl_FragCoord.xy), 0).r;
+    vec3 worldPos = u_camPos + rd * dist + CLOUD_WIND * (u_timeDelta / u_cloud_noise_scale);
+    vec4 prevClip = u_prevViewProj * vec4(worldPos, 1.0);
+    if (prevClip.w <= 0.0) return false;
+    vec2 prevUV = (prevClip.xy / prevClip.w) * 0.5 + 0.5;
+    if (any(lessThan(prevUV, vec2(0.0))) || any(greaterThan(prevUV, vec2(1.0)))) return false;
+    color = texture(u_historyColor, prevUV);
+    firstHit = texture(u_historyDistance, prevUV).r;
+    return true;
+}
+
+void main()
+{
+    vec3 rayDirection = getRayDirection(TexCoords, u_camPos);
+    bool scheduled = !u_historyValid || all(equal(ivec2(gl_FragCoord.xy) % u_updateGrid, ivec2(u_updateOffset)));
+    if (u_cloudsEnabled && !scheduled && reprojectHistory(rayDirection, FragColor, FragDistance)) return;
+    float firstHit;
+    FragColor = u_cloudsEnabled ? marchClouds(u_camPos, rayDirection, firstHit) : vec4(0.0);
+    FragDistance = u_cloudsEnabled ? firstHit : MAX_TRACE_DISTANCE;
+}
@@ -1,155 +1,168 @@
 #version 330 core
-out vec4 FragColor;
+layout(location = 0) out vec4 FragColor;
+layout(location = 1) out float FragDistance; // Hit distance along the ray (used for temporal reprojection, ignored on the backbuffer)
 
 in vec2 TexCoords; // UV coordinates from vertex shader (0.0 to 1.0)
 
+// RAYMARCH_SKY_ONLY (clipmap mode variant): the terrain is a raster mesh, this pass draws sky and clouds only
+#ifdef RAYMARCH_SKY_ONLY
+const bool SKY_ONLY = true;
+#else
+const bool SKY_ONLY = false;
+#endif
+
 // --- Uniforms ---
-uniform float u_time;      // Time for animation (clouds will move)
 uniform vec3 u_camPos;     // Camera position in world space
 uniform mat4 u_invViewMatrix; // Inverse of the view matrix
 uniform mat4 u_invProjMatrix; // Inverse of the projection matrix
-uniform vec3 u_lightDir;     // Direction TO the light source
-uniform vec3 u_lightColor;
-uniform float u_ambientStrength;
-// Terrain
-uniform float u_terrain_base_freq;
-uniform float u_terrain_base_amp;
-uniform float u_terrain_persistence;
-uniform float u_terrain_flatten_power;
-uniform float u_terrain_final_scale;
-uniform int   u_terrain_octaves;
-// Clouds
-uniform float u_cloud_base_height;
-uniform float u_cloud_thickness;
-uniform float u_cloud_noise_scale;
-uniform float u_cloud_coverage_min;
-uniform float u_cloud_coverage_max;
-uniform float u_cloud_density_factor;
+uniform vec2 u_jitter;       // Sub-pixel ray offset in UV units (zero at native resolution)
+// Low-resolution cloud buffer (see CloudRenderer)
+uniform sampler2D u_cloudBuffer;   // rgb = cloud color, a = opacity
+uniform sampler2D u_cloudDistance; // Distance to the first cloud density along the ray
+// Baked heightfield cache (see TerrainCache)
+uniform sampler2D u_terrainCache;  // r = height, gba = normal
+uniform vec4 u_terrainCacheRect;   // xy = world XZ of the cache origin, zw = 1 / extent
+uniform vec2 u_terrainCacheTexel;  // half a texel in UV units, keeps lookups inside the baked area
+uniform bool u_useTerrainCache;
+uniform sampler2D u_terrainMaxMip; // Max-height pyramid over the cache's bilinear patches (see TerrainCache)
+uniform int u_terrainMaxMipLevels;
+// Terrain traversal quality
+uniform int u_terrainTraversal;    // 0 = sphere trace, 1 = max-mip hierarchy inside the cache
+uniform int u_terrainMaxSteps;     // Step budget per ray (shared by both traversals)
+uniform bool u_terrainStepView;    // Debug: shade by steps taken instead of lighting
+// Hybrid mode: opaque raster geometry was drawn into a depth pre-pass first
+uniform bool u_hybridDepth;
+uniform sampler2D u_sceneDepth;    // Pre-pass depth (native resolution, 1.0 = nothing drawn)
+uniform mat4 u_viewProjMatrix;     // For gl_FragDepth of terrain hits
 // --- End Uniforms ---
 
+// --- Lighting / terrain / cloud parameters (std140 block, re-uploaded only when a value changes) ---
+#include "raymarch_params.glsl"
+// --- Shared terrain noise, cloud density, material and lighting (also used by the clipmap terrain) ---
+#include "terrain_shading.glsl"
+
 // Constants...
-const int MAX_TERRAIN_STEPS = 100;
 const float MIN_HIT_DISTANCE = 0.001;
 const float MAX_TRACE_DISTANCE = 100.0;
-const int MAX_SHADOW_STEPS = 32;
-const float SHADOW_MAX_DISTANCE = 50.0;
-const float SHADOW_DENSITY_MULTIPLIER = 0.4;
-const int MAX_CLOUD_STEPS = 80;
-const float CLOUD_STEP_SIZE = 0.8;
-const float CLOUD_DENSITY_MULTIPLIER = 1.5;
-// const float cloudBaseHeight = 10.0; // Now uniform u_cloud_base_height
-// const float cloudThickness = 12.0; // Now uniform u_cloud_thickness
-
-// --- Noise Functions (2D and 3D) ---
-float hash(vec2 p) { return fract(sin(dot(p, vec2(12.9898, 78.233))) * 43758.5453); }
-float hash3(vec3 p) { p = fract(p * 0.1031); p += dot(p, p.yzx + 33.33); return fract((p.x + p.y) * p.z); }
-float valueNoise(vec2 p) { vec2 i=floor(p); vec2 f=fract(p); vec2 u=f*f*(3.0-2.0*f); return mix(mix(hash(i+vec2(0,0)), hash(i+vec2(1,0)), u.x), mix(hash(i+vec2(0,1)), hash(i+vec2(1,1)), u.x), u.y); }
-float valueNoise3D(vec3 p) { vec3 i=floor(p); vec3 f=fract(p); vec3 u=f*f*(3.0-2.0*f); return mix(mix(mix(hash3(i+vec3(0,0,0)), hash3(i+vec3(1,0,0)), u.x), mix(hash3(i+vec3(0,1,0)), hash3(i+vec3(1,1,0)), u.x), u.y), mix(mix(hash3(i+vec3(0,0,1)), hash3(i+vec3(1,0,1)), u.x), mix(hash3(i+vec3(0,1,1)), hash3(i+vec3(1,1,1)), u.x), u.y), u.z); }
-// --- FBM Functions ---
-float fbm_raw(vec2 p, out float maxAmp) {
-    float freq = u_terrain_base_freq; float amp = u_terrain_base_amp; float persistence = u_terrain_persistence; int octaves = u_terrain_octaves;
-    float value = 0.0; maxAmp = 0.0;
-    for(int i=0; i<octaves; i++) { if (amp < 0.01) break; value += valueNoise(p*freq)*amp; maxAmp += amp; freq *= 2.0; amp *= persistence; }
-    return value;
-}
-float fbm3D(vec3 p, int octaves, float persistence) {
-    float freq = 1.0; float amp = 0.5; float value = 0.0;
-    for(int i=0; i<octaves; i++) { value += valueNoise3D(p * freq) * amp; freq *= 2.0; amp *= persistence; }
-    return value;
-}
-// --- End Noise ---
+const float SKY_REPROJECTION_DISTANCE = 1000.0; // Distance reported for sky pixels (reprojects as ~rotation only)
 
 // --- Terrain Height & SDF ---
+// Returns true (and the cache UV) when p lies inside the baked heightfield
+bool terrainCacheUV(vec2 p, out vec2 uv) {
+    uv = (p - u_terrainCacheRect.xy) * u_terrainCacheRect.zw;
+    return u_useTerrainCache && all(greaterThanEqual(uv, u_terrainCacheTexel)) && all(lessThanEqual(uv, 1.0 - u_terrainCacheTexel));
+}
 float terrainHeight(vec2 p) {
-    float maxPossibleAmplitude; float raw_fbm = fbm_raw(p, maxPossibleAmplitude);
-    float normalized_fbm = (maxPossibleAmplitude > 0.0) ? (raw_fbm / maxPossibleAmplitude) : 0.0;
-    float flattened_fbm = pow(normalized_fbm, u_terrain_flatten_power);
-    return flattened_fbm * u_terrain_final_scale;
+    vec2 uv;
+    if (terrainCacheUV(p, uv)) return textureLod(u_terrainCache, uv, 0.0).r;
+    return terrainHeightNoise(p);
 }
 float mapScene(vec3 p) { return p.y - terrainHeight(p.xz); }
 // --- End Terrain ---
 
-// --- Cloud Density Function ---
-float mapClouds(vec3 p) {
-    float y_norm = (p.y - u_cloud_base_height) / u_cloud_thickness;
-    float verticalFalloff = smoothstep(0.0, 0.1, y_norm) * (1.0 - smoothstep(0.9, 1.0, y_norm));
-    if (verticalFalloff <= 0.0) return 0.0;
-    vec3 noiseSamplePos = p * u_cloud_noise_scale + vec3(u_time * 0.05, 0.0, u_time * 0.02);
-    float baseNoise = fbm3D(noiseSamplePos, 4, 0.5);
-    float density = smoothstep(u_cloud_coverage_min, u_cloud_coverage_max, baseNoise);
-    return density * verticalFalloff * u_cloud_density_factor;
-}
-// --- End Clouds ---
-
-
 // --- Calculate Normal ---
-vec3 calcNormal(vec3 p) { vec2 e=vec2(0.01,0.0); return normalize(vec3(mapScene(p+e.xyy)-mapScene(p-e.xyy), mapScene(p+e.yxy)-mapScene(p-e.yxy), mapScene(p+e.yyx)-mapScene(p-e.yyx))); }
+vec3 calcNormal(vec3 p) {
+    vec2 uv;
+    if (terrainCacheUV(p.xz, uv)) return normalize(textureLod(u_terrainCache, uv, 0.0).gba); // Baked with the same central differences
+    vec2 e=vec2(0.01,0.0); return normalize(vec3(mapScene(p+e.xyy)-mapScene(p-e.xyy), mapScene(p+e.yxy)-mapScene(p-e.yxy), mapScene(p+e.yyx)-mapScene(p-e.yyx)));
+}
 
 // --- Terrain Ray Marching ---
-float rayMarchTerrain(vec3 ro, vec3 rd, out vec3 hitPos) {
-    float t = 0.0;
-    for(int i = 0; i < MAX_TERRAIN_STEPS; i++) {
+int g_terrainSteps = 0; // Steps taken by the current ray (step-count view)
+
+// Sphere trace from t; the height is not a true distance bound, the small minimum step keeps it moving
+float sphereTraceTerrain(vec3 ro, vec3 rd, float t, float maxDistance, out vec3 hitPos) {
+    while (g_terrainSteps < u_terrainMaxSteps) {
+        g_terrainSteps++;
         hitPos = ro + rd * t; float dist = mapScene(hitPos);
         if(dist < MIN_HIT_DISTANCE) { return t; } // Hit
         t += max(dist, MIN_HIT_DISTANCE * 0.5);
-        if(t >= MAX_TRACE_DISTANCE) { return -1.0; } // Miss (too far)
+        if(t >= maxDistance) { return -1.0; } // Miss (too far, or behind raster geometry)
     }
-    return -1.0; // <<<< ENSURE THIS RETURN IS PRESENT
+    return -1.0;
 }
 
-// --- Cloud Shadow Ray Marching ---
-float marchShadowRay(vec3 ro, vec3 rd) { // rd should be light direction
-    float t = 0.01; float accumulatedDensity = 0.0; float shadowFactor = 1.0;
-    for(int i = 0; i < MAX_SHADOW_STEPS; i++) {
-        vec3 currentPos = ro + rd * t; float density = mapClouds(currentPos);
-        if (density > 0.01) {
-            float stepSize = SHADOW_MAX_DISTANCE / float(MAX_SHADOW_STEPS);
-            accumulatedDensity += density * stepSize;
-            shadowFactor = exp(-accumulatedDensity * SHADOW_DENSITY_MULTIPLIER);
-        }
-        t += SHADOW_MAX_DISTANCE / float(MAX_SHADOW_STEPS);
-        if(t >= SHADOW_MAX_DISTANCE) { break; }
-    } return clamp(shadowFactor, 0.0, 1.0);
+// Ray segment [t0, t1] inside one level-0 cell: the cached surface there is a single bilinear patch, so
+// the height along the ray is quadratic. Checking the midpoint as well catches rays that dip in and out
+// again; the crossing is then refined with a few secant steps.
+bool intersectHeightPatch(vec3 ro, vec3 rd, float t0, float t1, out float tHit) {
+    float f0 = mapScene(ro + rd * t0);
+    if (f0 < MIN_HIT_DISTANCE) { tHit = t0; return true; }
+    float tm = 0.5 * (t0 + t1);
+    float fm = mapScene(ro + rd * tm);
+    if (fm >= 0.0) {
+        float f1 = mapScene(ro + rd * t1);
+        if (f1 >= 0.0) return false;
+        t0 = tm; f0 = fm;
+        tm = t1; fm = f1;
+    }
+    float a = t0, fa = f0, b = tm, fb = fm;
+    for (int i = 0; i < 4; i++) {
+        float t = a + (b - a) * fa / (fa - fb);
+        float f = mapScene(ro + rd * t);
+        if (f >= 0.0) { a = t; fa = f; } else { b = t; fb = f; }
+    }
+    tHit = b; // Just below the surface, like a sphere-trace hit
+    return true;
 }
 
-// --- Volumetric Cloud Ray Marching ---
-vec4 marchClouds(vec3 ro, vec3 rd) {
-    float t = 0.0; vec4 accumulatedColor = vec4(0.0);
-    vec3 cloudColor = vec3(1.0);
-    for(int i = 0; i < MAX_CLOUD_STEPS; ++i) {
-        if (accumulatedColor.a > 0.99) break;
-        vec3 currentPos = ro + rd * t;
-        if (currentPos.y < u_cloud_base_height - 1.0) break;
-        float density = mapClouds(currentPos);
-        if (density > 0.01) {
-            float lightPhase = pow(max(dot(rd, -u_lightDir), 0.0), 2.0) * 0.5 + 0.5;
-            vec3 litCloudColor = cloudColor * lightPhase;
-            float alpha = (1.0 - exp(-density * CLOUD_STEP_SIZE * CLOUD_DENSITY_MULTIPLIER));
-            vec4 stepColor = vec4(litCloudColor, alpha);
-            accumulatedColor.rgb += (1.0 - accumulatedColor.a) * stepColor.rgb * stepColor.a;
-            accumulatedColor.a += (1.0 - accumulatedColor.a) * stepColor.a;
+// Quadtree traversal of the max-height pyramid (cells in level-0 patch units, level n cells are 2^n wide).
+// A cell whose max lies below the ray over its whole span is skipped and the walk climbs a level; otherwise
+// the ray is clipped down to the cell's max and the walk descends. Returns the hit distance, -1.0 on a miss,
+// or -2.0 once the ray leaves the cached area (t is where it left, for the sphere-trace fallback).
+float traverseMaxMip(vec3 ro, vec3 rd, float maxDistance, inout float t) {
+    float cells = float(textureSize(u_terrainMaxMip, 0).x);
+    float scale = cells * u_terrainCacheRect.z;
+    vec2 g0 = (ro.xz - u_terrainCacheRect.xy) * scale - 0.5; // Texel centres sit on whole patch coordinates
+    vec2 dg = rd.xz * scale;
+    vec2 invDg = vec2(abs(dg.x) > 1e-8 ? 1.0 / dg.x : 1e30, abs(dg.y) > 1e-8 ? 1.0 / dg.y : 1e30);
+    vec2 ahead = step(0.0, dg);
+    vec2 nudge = sign(dg) * 1e-3; // Picks the cell the ray is entering when it sits on a boundary
+    int topLevel = u_terrainMaxMipLevels - 1;
+    int level = topLevel;
+
+    while (g_terrainSteps < u_terrainMaxSteps) {
+        g_terrainSteps++;
+        vec2 g = g0 + dg * t;
+        if (any(lessThan(g, vec2(0.0))) || any(greaterThan(g, vec2(cells - 1.0)))) return -2.0;
+
+        float cellSize = exp2(float(level));
+        vec2 cell = floor((g + nudge) / cellSize);
+        vec2 tAxis = ((cell + ahead) * cellSize - g0) * invDg;
+        float tExit = min(min(tAxis.x, tAxis.y), maxDistance);
+        float hMax = texelFetch(u_terrainMaxMip, ivec2(cell), level).r;
+        float yEnter = ro.y + rd.y * t;
+        float yExit = ro.y + rd.y * tExit;
+
+        if (min(yEnter, yExit) > hMax) {
+            t = tExit;
+            level = min(level + 1, topLevel);
+        } else if (level > 0) {
+            if (yEnter > hMax) t = (hMax - ro.y) / rd.y; // yExit <= hMax < yEnter, so the ray descends
+            level--;
+        } else {
+            float tHit;
+            if (intersectHeightPatch(ro, rd, t, tExit, tHit)) return tHit;
+            t = tExit;
         }
-        t += CLOUD_STEP_SIZE;
-        if (t >= MAX_TRACE_DISTANCE) break;
-    } return accumulatedColor;
+        if (t >= maxDistance) return -1.0;
+    }
+    return -1.0;
 }
 
-
-// --- Blinn-Phong Lighting Calculation ---
-vec3 calculateLighting(vec3 fragPos, vec3 normal, vec3 viewDir,
-vec3 lightDir, vec3 lightColor, float ambientStrength,
-vec3 surfaceColor, float shadowFactor)
-{
-    float diffuseStrength = 0.8; float specularStrength = 0.03; float shininess = 32.0;
-    float skyOcclusion = smoothstep(0.0, 0.5, normal.y);
-    vec3 ambient = ambientStrength * skyOcclusion * lightColor;
-    float diff = max(dot(normal, lightDir), 0.0);
-    vec3 diffuse = diffuseStrength * skyOcclusion * diff * lightColor;
-    vec3 halfwayDir = normalize(lightDir + viewDir);
-    float spec = pow(max(dot(normal, halfwayDir), 0.0), shininess);
-    vec3 specular = specularStrength * spec * lightColor;
-    vec3 result = ambient * surfaceColor + (diffuse * surfaceColor + specular) * shadowFactor;
-    return result;
+// maxDistance is MAX_TRACE_DISTANCE, or the raster surface in front of the terrain in hybrid mode
+float rayMarchTerrain(vec3 ro, vec3 rd, float maxDistance, out vec3 hitPos) {
+    float t = 0.0;
+    vec2 uv;
+    if (u_terrainTraversal == 1 && u_terrainMaxMipLevels > 0 && terrainCacheUV(ro.xz, uv)) {
+        float tHit = traverseMaxMip(ro, rd, maxDistance, t);
+        if (tHit != -2.0) {
+            hitPos = ro + rd * max(tHit, 0.0);
+            return tHit;
+        }
+        // Left the cached area: continue on the analytic noise
+    }
+    return sphereTraceTerrain(ro, rd, t, maxDistance, hitPos);
 }
 
 // --- Generate Ray Direction ---
@@ -160,47 +173,69 @@ vec3 getRayDirection(vec2 uv, vec3 camPos) {
     return normalize(worldPos.xyz - camPos);
 }
 
+// --- Distance along the ray to the pre-pass surface at this pixel (view space is rigid, so it is the world distance) ---
+float sceneDepthDistance(vec2 uv, float depth) {
+    vec4 viewPos = u_invProjMatrix * vec4(uv * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+    return length(viewPos.xyz / viewPos.w);
+}
+
 // --- Main Fragment Shader Entry Point ---
 void main()
 {
-    vec2 uv = TexCoords; vec3 rayOrigin = u_camPos;
+    vec2 uv = TexCoords + u_jitter; vec3 rayOrigin = u_camPos;
     vec3 rayDirection = getRayDirection(uv, rayOrigin);
 
+    float maxDistance = MAX_TRACE_DISTANCE;
+    bool rasterCovered = false;
+    if (u_hybridDepth) {
+        float sceneDepth = texelFetch(u_sceneDepth, ivec2(gl_FragCoord.xy), 0).r;
+        if (sceneDepth < 1.0) {
+            rasterCovered = true;
+            maxDistance = min(maxDistance, sceneDepthDistance(uv, sceneDepth));
+        }
+    }
+
     vec3 hitPosition;
-    float distanceTraveled = rayMarchTerrain(rayOrigin, rayDirection, hitPosition);
+    float distanceTraveled = SKY_ONLY ? -1.0 : rayMarchTerrain(rayOrigin, rayDirection, maxDistance, hitPosition);
+    // No terrain in front of the raster surface: the mesh pass colors this pixel
+    if (rasterCovered && distanceTraveled <= 0.0) discard;
 
-    vec3 skyColor = vec3(0.5, 0.7, 1.0);
-    vec3 finalColor = skyColor;
+    vec3 finalColor = SKY_COLOR;
 
     if (distanceTraveled > 0.0) { // Hit terrain
-        // --- Terrain shading ---
-        vec3 normal = calcNormal(hitPosition); float altitude = hitPosition.y; float slope = 1.0 - normal.y;
-        vec3 grassColor=vec3(0.2,0.5,0.1); vec3 rockColor=vec3(0.5,0.45,0.4); vec3 dirtColor=vec3(0.6,0.4,0.2); vec3 snowColor=vec3(0.9,0.9,0.95);
-        float rockFactor=smoothstep(0.2, 1.0, altitude); vec3 baseColor=mix(grassColor,rockColor,rockFactor);
-        float grassSlopeFactor=smoothstep(0.4,0.7,slope); baseColor=mix(baseColor,rockColor,grassSlopeFactor);
-        float patchNoiseFreq=1.5; float patchNoise=valueNoise(hitPosition.xz*patchNoiseFreq); float patchBlend=smoothstep(0.3,0.6,patchNoise); float patchSlopeFactor=1.0-smoothstep(0.3,0.6,slope); float patchAltitudeFactor=1.0-smoothstep(0.5, 1.5, altitude);
-        patchBlend*=patchSlopeFactor*patchAltitudeFactor*0.5; baseColor=mix(baseColor,dirtColor,patchBlend);
-        float snowFactor=smoothstep(1.8, 2.2, altitude); vec3 surfaceColor=mix(baseColor,snowColor,snowFactor);
-        // Use uniforms for light properties
-        float shadowFactor = marchShadowRay(hitPosition, u_lightDir);
-        vec3 viewDir = normalize(u_camPos - hitPosition);
-        // Pass uniforms explicitly to lighting function
-        finalColor = calculateLighting(hitPosition, normal, viewDir,
-        u_lightDir, u_lightColor, u_ambientStrength, // Pass uniforms
-        surfaceColor, shadowFactor);
-        // --- End Terrain Shading ---
-
-    } else { // Missed terrain -> Render Clouds
-        // --- Render Clouds ---
-        vec4 cloudColor = marchClouds(rayOrigin, rayDirection);
-        finalColor = mix(skyColor, cloudColor.rgb, cloudColor.a);
-        // --- End Render Clouds ---
+        finalColor = shadeTerrain(hitPosition, calcNormal(hitPosition), u_camPos);
     }
 
-    // --- Fog (Apply AFTER terrain/cloud calculation) ---
-    float fogDistance = (distanceTraveled > 0.0) ? distanceTraveled : MAX_TRACE_DISTANCE;
-    float fogAmount = smoothstep(10.0, MAX_TRACE_DISTANCE * 0.8, fogDistance);
-    finalColor = mix(finalColor, skyColor, fogAmount);
+    // --- Fog (Apply AFTER terrain calculation) ---
+    finalColor = applyFog(finalColor, (distanceTraveled > 0.0) ? distanceTraveled : MAX_TRACE_DISTANCE);
+
+    // --- Clouds: composite the low-res cloud buffer over the sky and over terrain that lies behind them ---
+    if (u_cloudsEnabled) {
+        vec4 cloudColor = texture(u_cloudBuffer, uv);
+        float cloudDistance = texture(u_cloudDistance, uv).r;
+        if (distanceTraveled <= 0.0 || cloudDistance < distanceTraveled) {
+            finalColor = mix(finalColor, cloudColor.rgb, cloudColor.a);
+        }
+    }
+
+    if (u_terrainStepView) {
+        float load = float(g_terrainSteps) / float(max(u_terrainMaxSteps, 1));
+        finalColor = mix(vec3(0.0, 0.1, 0.6), vec3(1.0, 0.9, 0.0), clamp(load * 2.0, 0.0, 1.0));
+        finalColor = mix(finalColor, vec3(1.0, 0.0, 0.0), clamp(load * 2.0 - 1.0, 0.0, 1.0));
+    }
 
     FragColor = vec4(finalColor, 1.0);
+    FragDistance = (distanceTraveled > 0.0) ? distanceTraveled : SKY_REPROJECTION_DISTANCE;
+
+    // Terrain depth for the mesh pass to test against; sky stays at the far plane. Only the hybrid mode
+    // depth tests this depth (the plain mode draws with depth testing off). The sky-only variant must not
+    // write gl_FragDepth at all: any write disables early depth testing, and the quad already sits on
+    // the far plane, so pixels the clipmap covered are rejected before this shader runs.
+#ifndef RAYMARCH_SKY_ONLY
+    gl_FragDepth = 1.0;
+    if (u_hybridDepth && distanceTraveled > 0.0) {
+        vec4 clipPos = u_viewProjMatrix * vec4(hitPosition, 1.0);
+        gl_FragDepth = clipPos.z / clipPos.w * 0.5 + 0.5;
+    }
+#endif
 }
\ No newline at end of file
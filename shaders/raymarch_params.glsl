@@ -0,0 +1,25 @@
+// Scene parameters shared by the raymarch, terrain bake and cloud passes.
+// std140 block backed by RaymarchParamsBuffer (Include/RaymarchParams.h); the member order and padding must match RaymarchParamsBlock.
+#ifndef RAYMARCH_PARAMS_GLSL
+#define RAYMARCH_PARAMS_GLSL
+
+layout(std140) uniform RaymarchParams {
+    vec3  u_lightDir;            // Direction TO the light source
+    float u_ambientStrength;
+    vec3  u_lightColor;
+    float u_terrain_base_freq;
+    float u_terrain_base_amp;
+    float u_terrain_persistence;
+    float u_terrain_flatten_power;
+    float u_terrain_final_scale;
+    int   u_terrain_octaves;
+    float u_cloud_base_height;
+    float u_cloud_thickness;
+    float u_cloud_noise_scale;
+    float u_cloud_coverage_min;
+    float u_cloud_coverage_max;
+    float u_cloud_density_factor;
+    float u_cloudNoisePeriod;    // Noise-space size of one tile of the cloud noise volume
+};
+
+#endif // RAYMARCH_PARAMS_GLSL
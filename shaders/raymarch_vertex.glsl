@@ -6,7 +6,12 @@ out vec2 TexCoords; // Pass texture coordinates (or screen coords) to fragment s
 void main()
 {
     // Output vertex position directly in Normalized Device Coordinates (NDC)
+#ifdef RAYMARCH_SKY_ONLY
+    // On the far plane, so the depth test against the clipmap runs before the fragment shader
+    gl_Position = vec4(aPos.x, aPos.y, 1.0, 1.0);
+#else
     gl_Position = vec4(aPos.x, aPos.y, 0.0, 1.0);
+#endif
 
     // Calculate UV coordinates (0.0 to 1.0) based on NDC position
     TexCoords = aPos * 0.5 + 0.5;
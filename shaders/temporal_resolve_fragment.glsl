@@ -0,0 +1,64 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoords; // Native resolution UV (0.0 to 1.0)
+
+// --- Uniforms ---
+uniform sampler2D u_currentColor;    // Reduced-resolution raymarch color (this frame, jittered)
+uniform sampler2D u_currentDistance; // Reduced-resolution hit distance along each ray
+uniform sampler2D u_history;         // Native-resolution accumulated result of the previous frame
+uniform mat4 u_invViewMatrix;        // Current (unjittered) inverse view matrix
+uniform mat4 u_invProjMatrix;        // Current inverse projection matrix
+uniform mat4 u_prevViewProj;         // Previous frame's projection * view
+uniform vec3 u_camPos;
+uniform vec2 u_jitter;               // Jitter applied to this frame's rays, UV units
+uniform vec2 u_lowResSize;
+uniform vec2 u_nativeSize;
+uniform bool u_historyValid;
+uniform float u_feedback;            // Weight of a new sample centred exactly on this pixel
+// --- End Uniforms ---
+
+vec3 getRayDirection(vec2 uv) {
+    vec2 ndc = uv * 2.0 - 1.0; vec4 clipPos = vec4(ndc.x, ndc.y, -1.0, 1.0);
+    vec4 viewPos = u_invProjMatrix * clipPos; viewPos /= viewPos.w;
+    vec4 worldPos = u_invViewMatrix * vec4(viewPos.xyz, 1.0);
+    return normalize(worldPos.xyz - u_camPos);
+}
+
+void main()
+{
+    vec2 uv = TexCoords;
+
+    // Low-res sample whose (jittered) centre is nearest to this output pixel
+    ivec2 maxTexel = ivec2(u_lowResSize) - 1;
+    ivec2 texel = clamp(ivec2(floor((uv - u_jitter) * u_lowResSize)), ivec2(0), maxTexel);
+    vec2 sampleUV = (vec2(texel) + 0.5) / u_lowResSize + u_jitter;
+    vec3 current = texelFetch(u_currentColor, texel, 0).rgb;
+    vec3 upsampled = texture(u_currentColor, uv - u_jitter).rgb;
+
+    if (!u_historyValid) { FragColor = vec4(upsampled, 1.0); return; }
+
+    // --- Reprojection: rebuild the world position from the ray distance, project with last frame's matrices ---
+    float dist = texelFetch(u_currentDistance, texel, 0).r;
+    vec3 worldPos = u_camPos + getRayDirection(uv) * dist;
+    vec4 prevClip = u_prevViewProj * vec4(worldPos, 1.0);
+    vec2 prevUV = (prevClip.xy / prevClip.w) * 0.5 + 0.5;
+    if (prevClip.w <= 0.0 || any(lessThan(prevUV, vec2(0.0))) || any(greaterThan(prevUV, vec2(1.0)))) {
+        FragColor = vec4(upsampled, 1.0); return; // Disoccluded / off-screen last frame
+    }
+
+    // --- Neighbourhood clamp to reject stale history ---
+    vec3 minColor = current; vec3 maxColor = current;
+    for (int y = -1; y <= 1; ++y) {
+        for (int x = -1; x <= 1; ++x) {
+            vec3 c = texelFetch(u_currentColor, clamp(texel + ivec2(x, y), ivec2(0), maxTexel), 0).rgb;
+            minColor = min(minColor, c); maxColor = max(maxColor, c);
+        }
+    }
+    vec3 history = clamp(texture(u_history, prevUV).rgb, minColor, maxColor);
+
+    // --- Accumulate: new samples count more the closer their centre lands to this pixel ---
+    vec2 offsetPixels = (sampleUV - uv) * u_nativeSize;
+    float weight = exp(-2.0 * dot(offsetPixels, offsetPixels)); // Gaussian, sigma = 0.5 native pixels
+    FragColor = vec4(mix(history, current, u_feedback * weight), 1.0);
+}
@@ -0,0 +1,19 @@
+#version 330 core
+out vec4 FragColor; // r = height, gba = normal
+
+in vec2 TexCoords; // Position inside the cached region (0.0 to 1.0)
+
+// --- Uniforms ---
+uniform vec2 u_cacheOrigin; // World XZ of the region's (0,0) corner
+uniform float u_cacheExtent; // World size of the region
+// --- End Uniforms ---
+
+#include "terrain_noise.glsl"
+
+void main()
+{
+    vec2 p = u_cacheOrigin + TexCoords * u_cacheExtent;
+    float h = terrainHeightNoise(p);
+    vec3 normal = terrainNormalNoise(p);
+    FragColor = vec4(h, normal);
+}
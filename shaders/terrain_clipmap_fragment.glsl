@@ -0,0 +1,31 @@
+#version 330 core
+layout(location = 0) out vec4 FragColor;
+
+in vec3 vWorldPos;
+
+// --- Uniforms ---
+uniform vec3 u_camPos;
+uniform vec2 u_screenSize;         // Framebuffer size, for the cloud buffer lookup
+uniform sampler2D u_cloudBuffer;   // rgb = cloud color, a = opacity (see CloudRenderer)
+uniform sampler2D u_cloudDistance; // Distance to the first cloud density along the view ray
+// --- End Uniforms ---
+
+// --- Same material, cloud shadows, lighting and fog as the raymarched terrain ---
+#include "terrain_shading.glsl"
+
+void main()
+{
+    // Per-pixel normal from the analytic height, as the raymarcher does, so coarse levels keep their detail
+    vec3 normal = terrainNormalNoise(vWorldPos.xz);
+    float distanceToCamera = length(vWorldPos - u_camPos);
+    vec3 finalColor = applyFog(shadeTerrain(vWorldPos, normal, u_camPos), distanceToCamera);
+
+    if (u_cloudsEnabled) {
+        vec2 uv = gl_FragCoord.xy / u_screenSize;
+        if (texture(u_cloudDistance, uv).r < distanceToCamera) {
+            vec4 cloudColor = texture(u_cloudBuffer, uv);
+            finalColor = mix(finalColor, cloudColor.rgb, cloudColor.a);
+        }
+    }
+    FragColor = vec4(finalColor, 1.0);
+}
@@ -0,0 +1,36 @@
+#version 330 core
+layout(location = 0) in vec2 aGrid; // Integer grid coordinates, 0..u_gridQuads on each axis
+
+// --- Uniforms (one level per draw, see TerrainClipmap) ---
+uniform vec2 u_levelOrigin;  // World XZ of grid vertex (0, 0)
+uniform float u_levelSpacing; // World distance between neighbouring vertices
+uniform float u_gridQuads;    // Quads per side of the level grid
+uniform bool u_stitchEdges;   // Every level but the outermost meets a level of twice its spacing
+uniform mat4 u_viewProj;
+// --- End Uniforms ---
+
+out vec3 vWorldPos;
+
+#include "terrain_noise.glsl"
+
+void main()
+{
+    vec2 p = u_levelOrigin + aGrid * u_levelSpacing;
+    float h = terrainHeightNoise(p);
+
+    // Odd vertices on the outer edge lie halfway along an edge of the coarser level outside. Taking the
+    // mean of their even neighbours puts them on that edge, so the two levels meet without cracks.
+    if (u_stitchEdges) {
+        bool oddX = mod(aGrid.x, 2.0) > 0.5, oddZ = mod(aGrid.y, 2.0) > 0.5;
+        bool edgeX = aGrid.y < 0.5 || aGrid.y > u_gridQuads - 0.5; // Edges running along X
+        bool edgeZ = aGrid.x < 0.5 || aGrid.x > u_gridQuads - 0.5;
+        if (edgeX && oddX) {
+            h = 0.5 * (terrainHeightNoise(p - vec2(u_levelSpacing, 0.0)) + terrainHeightNoise(p + vec2(u_levelSpacing, 0.0)));
+        } else if (edgeZ && oddZ) {
+            h = 0.5 * (terrainHeightNoise(p - vec2(0.0, u_levelSpacing)) + terrainHeightNoise(p + vec2(0.0, u_levelSpacing)));
+        }
+    }
+
+    vWorldPos = vec3(p.x, h, p.y);
+    gl_Position = u_viewProj * vec4(vWorldPos, 1.0);
+}
@@ -0,0 +1,23 @@
+#version 330 core
+out float FragMaxHeight;
+
+in vec2 TexCoords; // Unused, the pass works in whole texels
+
+// --- Uniforms ---
+uniform sampler2D u_source; // Level 0: the heightfield cache (r = height). Otherwise: the previous max level.
+uniform bool u_fromHeights;
+// --- End Uniforms ---
+
+// Level 0 texel i bounds the bilinear patch between height texels i and i + 1 (so the pyramid stays
+// conservative for the filtered lookups the raymarcher makes); level n texel i bounds children 2i and 2i + 1.
+void main()
+{
+    ivec2 texel = ivec2(gl_FragCoord.xy);
+    ivec2 base = u_fromHeights ? texel : texel * 2;
+    ivec2 last = textureSize(u_source, 0) - 1;
+    float h = texelFetch(u_source, min(base, last), 0).r;
+    h = max(h, texelFetch(u_source, min(base + ivec2(1, 0), last), 0).r);
+    h = max(h, texelFetch(u_source, min(base + ivec2(0, 1), last), 0).r);
+    h = max(h, texelFetch(u_source, min(base + ivec2(1, 1), last), 0).r);
+    FragMaxHeight = h;
+}
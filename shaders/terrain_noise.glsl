@@ -0,0 +1,43 @@
+// Shared terrain definition: 2D value noise and the FBM heightfield.
+// Included by raymarch_fragment.glsl, terrain_bake_fragment.glsl and the clipmap shaders (see Shader's
+// #include handling). TerrainNoise (src/TerrainNoise.cpp) is the CPU port used for the physics
+// heightfield; keep the two in step.
+#ifndef TERRAIN_NOISE_GLSL
+#define TERRAIN_NOISE_GLSL
+
+// Terrain parameters (u_terrain_*) live in the RaymarchParams block
+#include "raymarch_params.glsl"
+
+// --- Noise Functions (2D) ---
+// Integer lattice hash (p is always a lattice point). Unlike a sin() hash it gives the same bits on every
+// GPU and on the CPU, so the physics heightfield sees exactly the lattice values drawn here.
+float hash(vec2 p) {
+    uvec2 q = uvec2(ivec2(p));
+    uint h = (q.x * 0x8da6b343u) ^ (q.y * 0xd8163841u);
+    h ^= h >> 16; h *= 0x7feb352du; h ^= h >> 15; h *= 0x846ca68bu; h ^= h >> 16;
+    return float(h >> 8) * (1.0 / 16777216.0);
+}
+float valueNoise(vec2 p) { vec2 i=floor(p); vec2 f=fract(p); vec2 u=f*f*(3.0-2.0*f); return mix(mix(hash(i+vec2(0,0)), hash(i+vec2(1,0)), u.x), mix(hash(i+vec2(0,1)), hash(i+vec2(1,1)), u.x), u.y); }
+// --- FBM Functions ---
+float fbm_raw(vec2 p, out float maxAmp) {
+    float freq = u_terrain_base_freq; float amp = u_terrain_base_amp; float persistence = u_terrain_persistence; int octaves = u_terrain_octaves;
+    float value = 0.0; maxAmp = 0.0;
+    for(int i=0; i<octaves; i++) { if (amp < 0.01) break; value += valueNoise(p*freq)*amp; maxAmp += amp; freq *= 2.0; amp *= persistence; }
+    return value;
+}
+// --- Terrain Height (analytic, evaluates every octave) ---
+float terrainHeightNoise(vec2 p) {
+    float maxPossibleAmplitude; float raw_fbm = fbm_raw(p, maxPossibleAmplitude);
+    float normalized_fbm = (maxPossibleAmplitude > 0.0) ? (raw_fbm / maxPossibleAmplitude) : 0.0;
+    float flattened_fbm = pow(normalized_fbm, u_terrain_flatten_power);
+    return flattened_fbm * u_terrain_final_scale;
+}
+// Central differences of y - height (the same offsets as calcNormal() in raymarch_fragment.glsl)
+vec3 terrainNormalNoise(vec2 p) {
+    vec2 e = vec2(0.01, 0.0);
+    return normalize(vec3(terrainHeightNoise(p - e.xy) - terrainHeightNoise(p + e.xy),
+                          2.0 * e.x,
+                          terrainHeightNoise(p - e.yx) - terrainHeightNoise(p + e.yx)));
+}
+
+#endif // TERRAIN_NOISE_GLSL
@@ -0,0 +1,70 @@
+// Terrain surface shading shared by the raymarched terrain (raymarch_fragment.glsl) and the clipmap mesh
+// (terrain_clipmap_fragment.glsl): height/slope material, cloud shadows, Blinn-Phong and distance fog.
+#ifndef TERRAIN_SHADING_GLSL
+#define TERRAIN_SHADING_GLSL
+
+#include "raymarch_params.glsl"
+#include "terrain_noise.glsl"
+#include "cloud_density.glsl"
+
+uniform int u_shadowSteps; // Cloud shadow samples per terrain point
+
+const float SHADOW_MAX_DISTANCE = 50.0;
+const float SHADOW_DENSITY_MULTIPLIER = 0.4;
+const vec3 SKY_COLOR = vec3(0.5, 0.7, 1.0);
+const float FOG_START = 10.0;
+const float FOG_END = 80.0;
+
+// --- Cloud Shadow Ray Marching ---
+float marchShadowRay(vec3 ro, vec3 rd) { // rd should be light direction
+    if (!u_cloudsEnabled) return 1.0;
+    float t = 0.01; float accumulatedDensity = 0.0; float shadowFactor = 1.0;
+    float stepSize = SHADOW_MAX_DISTANCE / float(max(u_shadowSteps, 1)); // Fewer steps cover the same distance
+    for(int i = 0; i < u_shadowSteps; i++) {
+        vec3 currentPos = ro + rd * t; float density = mapClouds(currentPos);
+        if (density > 0.01) {
+            accumulatedDensity += density * stepSize;
+            shadowFactor = exp(-accumulatedDensity * SHADOW_DENSITY_MULTIPLIER);
+        }
+        t += stepSize;
+        if(t >= SHADOW_MAX_DISTANCE) { break; }
+    } return clamp(shadowFactor, 0.0, 1.0);
+}
+
+// --- Blinn-Phong Lighting Calculation ---
+vec3 calculateLighting(vec3 fragPos, vec3 normal, vec3 viewDir,
+vec3 lightDir, vec3 lightColor, float ambientStrength,
+vec3 surfaceColor, float shadowFactor)
+{
+    float diffuseStrength = 0.8; float specularStrength = 0.03; float shininess = 32.0;
+    float skyOcclusion = smoothstep(0.0, 0.5, normal.y);
+    vec3 ambient = ambientStrength * skyOcclusion * lightColor;
+    float diff = max(dot(normal, lightDir), 0.0);
+    vec3 diffuse = diffuseStrength * skyOcclusion * diff * lightColor;
+    vec3 halfwayDir = normalize(lightDir + viewDir);
+    float spec = pow(max(dot(normal, halfwayDir), 0.0), shininess);
+    vec3 specular = specularStrength * spec * lightColor;
+    vec3 result = ambient * surfaceColor + (diffuse * surfaceColor + specular) * shadowFactor;
+    return result;
+}
+
+// --- Terrain shading: material by altitude / slope, lit with cloud shadows ---
+vec3 shadeTerrain(vec3 hitPosition, vec3 normal, vec3 camPos) {
+    float altitude = hitPosition.y; float slope = 1.0 - normal.y;
+    vec3 grassColor=vec3(0.2,0.5,0.1); vec3 rockColor=vec3(0.5,0.45,0.4); vec3 dirtColor=vec3(0.6,0.4,0.2); vec3 snowColor=vec3(0.9,0.9,0.95);
+    float rockFactor=smoothstep(0.2, 1.0, altitude); vec3 baseColor=mix(grassColor,rockColor,rockFactor);
+    float grassSlopeFactor=smoothstep(0.4,0.7,slope); baseColor=mix(baseColor,rockColor,grassSlopeFactor);
+    float patchNoiseFreq=1.5; float patchNoise=valueNoise(hitPosition.xz*patchNoiseFreq); float patchBlend=smoothstep(0.3,0.6,patchNoise); float patchSlopeFactor=1.0-smoothstep(0.3,0.6,slope); float patchAltitudeFactor=1.0-smoothstep(0.5, 1.5, altitude);
+    patchBlend*=patchSlopeFactor*patchAltitudeFactor*0.5; baseColor=mix(baseColor,dirtColor,patchBlend);
+    float snowFactor=smoothstep(1.8, 2.2, altitude); vec3 surfaceColor=mix(baseColor,snowColor,snowFactor);
+    float shadowFactor = marchShadowRay(hitPosition, u_lightDir);
+    vec3 viewDir = normalize(camPos - hitPosition);
+    return calculateLighting(hitPosition, normal, viewDir, u_lightDir, u_lightColor, u_ambientStrength, surfaceColor, shadowFactor);
+}
+
+// --- Fog towards the sky color ---
+vec3 applyFog(vec3 color, float distance) {
+    return mix(color, SKY_COLOR, smoothstep(FOG_START, FOG_END, distance));
+}
+
+#endif // TERRAIN_SHADING_GLSL
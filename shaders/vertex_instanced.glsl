@@ -0,0 +1,17 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aColor;
+layout (location = 2) in vec2 aTexCoord;
+layout (location = 4) in mat4 aInstanceModel; // Per-instance model matrix (locations 4-7)
+
+out vec3 vertexColor;
+out vec2 TexCoord;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+void main() {
+    gl_Position = projection * view * aInstanceModel * vec4(aPos, 1.0);
+    vertexColor = aColor;
+    TexCoord = aTexCoord;
+}
@@ -0,0 +1,175 @@
+#include "AssetImporter.h"
+#include "Log.h"
+#include "MeshLodBuilder.h"
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+#include <chrono>
+
+// Largest single glBufferSubData issued while streaming a mesh
+static const size_t ASSET_UPLOAD_CHUNK_BYTES = 4 * 1024 * 1024;
+
+AssetImporter::AssetImporter(ThreadPool& pool, MeshPool* meshPool) : m_pool(pool), m_meshPool(meshPool) {}
+
+AssetImporter::~AssetImporter() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_jobsDone.wait(lock, [this]() { return m_jobsInFlight == 0; });
+}
+
+uint64_t AssetImporter::Import(const std::string& path) {
+    uint64_t id = m_nextId++;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobsInFlight++;
+    }
+    m_pool.Enqueue([this, id, path]() {
+        ParsedScene scene;
+        scene.id = id;
+        scene.path = path;
+        // Anything thrown here (bad_alloc on a huge file, filesystem errors while cooking) becomes a failed import,
+        // so the job is still reported and counted off
+        try {
+            parseScene(scene);
+        } catch (const std::exception& e) {
+            scene.error = e.what();
+        } catch (...) {
+            scene.error = "unknown exception while parsing";
+        }
+        if (!scene.error.empty()) {
+            scene.meshes.clear();
+            scene.mapping.reset();
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobsInFlight--; // Before the push, which can throw too
+        m_jobsDone.notify_all();
+        m_parsed.push_back(std::move(scene));
+    });
+    LOG_INFO(ASSETS) << "Import queued (" << id << "): " << path;
+    return id;
+}
+
+// Worker thread: map the cooked file if there is a valid one, otherwise read the file with Assimp,
+// convert every aiMesh into pre-sized vertex / index arrays and cook it for next time
+void AssetImporter::parseScene(ParsedScene& scene) const {
+    auto start = std::chrono::high_resolution_clock::now();
+    if (m_meshCache.Load(scene.path, scene.mapping, scene.meshes)) {
+        auto end = std::chrono::high_resolution_clock::now();
+        LOG_INFO(ASSETS) << "Mesh cache hit for " << scene.path << ": " << scene.meshes.size() << " meshes mapped in "
+                         << std::chrono::duration<double, std::milli>(end - start).count() << " ms";
+        return;
+    }
+
+    Assimp::Importer importer; // One importer per job; Assimp importers are not shared across threads
+    const aiScene* aiscene = importer.ReadFile(scene.path, aiProcess_Triangulate | aiProcess_GenNormals |
+                                                           aiProcess_JoinIdenticalVertices | aiProcess_PreTransformVertices);
+    if (!aiscene || !aiscene->HasMeshes()) {
+        const char* reason = importer.GetErrorString();
+        scene.error = (reason && *reason) ? reason : "no meshes in file";
+        return;
+    }
+
+    scene.meshes.resize(aiscene->mNumMeshes);
+    for (unsigned int m = 0; m < aiscene->mNumMeshes; ++m) {
+        const aiMesh* mesh = aiscene->mMeshes[m];
+        MeshData& data = scene.meshes[m];
+        data.name = mesh->mName.C_Str();
+
+        std::vector<Vertex> vertices;
+        vertices.reserve(mesh->mNumVertices);
+        bool hasUVs = mesh->HasTextureCoords(0);
+        bool hasNormals = mesh->HasNormals();
+        bool hasColors = mesh->HasVertexColors(0);
+        for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
+            glm::vec3 pos(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z);
+            glm::vec2 uv = hasUVs ? glm::vec2(mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y) : glm::vec2(0.0f);
+            glm::vec3 normal = hasNormals ? glm::vec3(mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z) : glm::vec3(0.0f, 1.0f, 0.0f);
+            glm::vec3 color = hasColors ? glm::vec3(mesh->mColors[0][i].r, mesh->mColors[0][i].g, mesh->mColors[0][i].b) : glm::vec3(1.0f);
+            vertices.emplace_back(pos, color, uv, normal);
+        }
+
+        size_t indexCount = 0;
+        for (unsigned int i = 0; i < mesh->mNumFaces; ++i) indexCount += mesh->mFaces[i].mNumIndices;
+        std::vector<unsigned int> indices(indexCount);
+        unsigned int* out = indices.data();
+        for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
+            const aiFace& face = mesh->mFaces[i];
+            for (unsigned int j = 0; j < face.mNumIndices; ++j) *out++ = face.mIndices[j];
+        }
+
+        // Cache/overdraw/fetch order and the LOD chain, then pack into the compact GPU layout here on the worker;
+        // only files that carry colors keep them
+        MeshLodBuilder::Optimize(vertices, indices);
+        std::vector<MeshLod> lods = MeshLodBuilder::BuildLods(vertices, indices);
+        data.Pack(vertices, indices, VertexLayout::Choose(vertices, hasColors));
+        data.lods = std::move(lods);
+    }
+
+    m_meshCache.Store(scene.path, scene.meshes); // Failure only costs the next load another parse
+
+    auto end = std::chrono::high_resolution_clock::now();
+    size_t lodCount = 0;
+    for (const MeshData& data : scene.meshes) lodCount += data.lods.size();
+    LOG_INFO(ASSETS) << "Parsed " << scene.path << ": " << scene.meshes.size() << " meshes, " << lodCount << " LODs in "
+                     << std::chrono::duration<double, std::milli>(end - start).count() << " ms";
+}
+
+std::vector<ImportedAsset> AssetImporter::Update(double budgetMs) {
+    std::vector<ImportedAsset> finished;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        while (!m_parsed.empty()) {
+            ParsedScene scene = std::move(m_parsed.front());
+            m_parsed.pop_front();
+            StagedImport staged;
+            staged.asset.id = scene.id;
+            staged.asset.path = std::move(scene.path);
+            staged.asset.error = std::move(scene.error);
+            staged.remaining = std::move(scene.meshes);
+            staged.mapping = std::move(scene.mapping);
+            m_staged.push_back(std::move(staged));
+        }
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto elapsedMs = [&start]() {
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    };
+
+    while (!m_staged.empty()) {
+        StagedImport& staged = m_staged.front();
+        if (!staged.asset.error.empty()) {
+            LOG_ERROR(ASSETS) << "Failed to import " << staged.asset.path << ": " << staged.asset.error;
+            finished.push_back(std::move(staged.asset));
+            m_staged.pop_front();
+            continue;
+        }
+        if (elapsedMs() >= budgetMs) break;
+
+        // Allocate GPU storage for the next mesh once the current one is done streaming
+        if (staged.uploadingIndex == staged.asset.meshes.size()) {
+            if (staged.asset.meshes.size() == staged.remaining.size()) {
+                staged.asset.success = true;
+                LOG_INFO(ASSETS) << "Imported " << staged.asset.path << " (" << staged.asset.meshes.size() << " meshes)";
+                finished.push_back(std::move(staged.asset));
+                m_staged.pop_front();
+                continue;
+            }
+            MeshData& data = staged.remaining[staged.asset.meshes.size()];
+            // Cooked data goes from the mapping straight into the GL buffer
+            staged.asset.meshes.push_back(std::make_unique<Mesh>(std::move(data), true, m_meshPool));
+            staged.asset.meshes.back()->SetReleaseCpuDataAfterUpload(m_releaseCpuData);
+        }
+
+        Mesh& mesh = *staged.asset.meshes[staged.uploadingIndex];
+        while (!mesh.UploadChunk(ASSET_UPLOAD_CHUNK_BYTES)) {
+            if (elapsedMs() >= budgetMs) break;
+        }
+        if (mesh.IsUploaded()) staged.uploadingIndex++;
+    }
+    return finished;
+}
+
+size_t AssetImporter::GetPendingCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_jobsInFlight + m_parsed.size() + m_staged.size();
+}
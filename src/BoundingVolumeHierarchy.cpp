@@ -0,0 +1,79 @@
+#include "BoundingVolumeHierarchy.h"
+#include <algorithm>
+
+void BoundingVolumeHierarchy::Build(const std::vector<Aabb>& bounds) {
+    Clear();
+    if (bounds.empty()) return;
+    m_items.resize(bounds.size());
+    for (uint32_t i = 0; i < m_items.size(); ++i) m_items[i] = i;
+    m_nodes.reserve(bounds.size() * 2);
+    buildNode(bounds, 0, static_cast<uint32_t>(m_items.size()));
+    m_itemBounds.resize(m_items.size());
+    for (size_t i = 0; i < m_items.size(); ++i) m_itemBounds[i] = bounds[m_items[i]];
+}
+
+uint32_t BoundingVolumeHierarchy::buildNode(const std::vector<Aabb>& bounds, uint32_t begin, uint32_t end) {
+    uint32_t index = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.emplace_back();
+    Aabb box = bounds[m_items[begin]];
+    Aabb centroids = { box.GetCenter(), box.GetCenter() };
+    for (uint32_t i = begin + 1; i < end; ++i) {
+        const Aabb& item = bounds[m_items[i]];
+        box.Expand(item);
+        centroids.Expand({ item.GetCenter(), item.GetCenter() });
+    }
+    m_nodes[index].bounds = box;
+
+    if (end - begin <= MAX_LEAF_ITEMS) {
+        m_nodes[index].first = begin;
+        m_nodes[index].count = end - begin;
+        return index;
+    }
+
+    glm::vec3 extent = centroids.max - centroids.min;
+    int axis = (extent.x >= extent.y && extent.x >= extent.z) ? 0 : (extent.y >= extent.z ? 1 : 2);
+    uint32_t middle = begin + (end - begin) / 2;
+    std::nth_element(m_items.begin() + begin, m_items.begin() + middle, m_items.begin() + end,
+                     [&bounds, axis](uint32_t a, uint32_t b) { return bounds[a].GetCenter()[axis] < bounds[b].GetCenter()[axis]; });
+
+    buildNode(bounds, begin, middle); // Left child is index + 1
+    uint32_t right = buildNode(bounds, middle, end);
+    m_nodes[index].first = right;
+    return index;
+}
+
+size_t BoundingVolumeHierarchy::QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& visible) const {
+    if (m_nodes.empty()) return 0;
+    size_t tests = 0;
+    uint32_t stack[64];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize > 0) {
+        uint32_t index = stack[--stackSize];
+        const Node& node = m_nodes[index];
+        tests++;
+        Frustum::Result result = frustum.Classify(node.bounds);
+        if (result == Frustum::Result::OUTSIDE) continue;
+        if (result == Frustum::Result::INSIDE) { appendAll(index, visible); continue; } // No more tests below
+        if (node.count > 0) {
+            // Leaf straddling a plane: test its items one by one
+            for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+                tests++;
+                if (frustum.IsVisible(m_itemBounds[i])) visible.push_back(m_items[i]);
+            }
+            continue;
+        }
+        // Median splits keep the depth at log2(n / MAX_LEAF_ITEMS), far below the stack size
+        stack[stackSize++] = node.first;
+        stack[stackSize++] = index + 1;
+    }
+    return tests;
+}
+
+void BoundingVolumeHierarchy::appendAll(uint32_t node, std::vector<uint32_t>& visible) const {
+    // Depth-first layout: a subtree's leaves cover one contiguous run of m_items
+    uint32_t first = node, last = node;
+    while (m_nodes[first].count == 0) first = first + 1;
+    while (m_nodes[last].count == 0) last = m_nodes[last].first;
+    visible.insert(visible.end(), m_items.begin() + m_nodes[first].first, m_items.begin() + m_nodes[last].first + m_nodes[last].count);
+}
@@ -0,0 +1,234 @@
+#include "CloudRenderer.h"
+#include "Log.h"
+#include "MemoryStats.h"
+#include "RaymarchParams.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <thread>
+
+// Voxels per side of the noise volume
+static const int CLOUD_NOISE_RESOLUTION = 128;
+// Size of one tile in noise space (the lattice of the first octave wraps every CLOUD_NOISE_PERIOD cells)
+static const int CLOUD_NOISE_PERIOD = 8;
+// Same FBM the shader used to evaluate per step: 4 octaves, persistence 0.5
+static const int CLOUD_NOISE_OCTAVES = 4;
+static const float CLOUD_NOISE_PERSISTENCE = 0.5f;
+// Camera motion in one frame beyond which reprojected clouds would smear: the history is dropped instead
+static const float CLOUD_HISTORY_MAX_MOVE = 1.0f;          // World units
+static const float CLOUD_HISTORY_MIN_FORWARD_DOT = 0.985f; // About 10 degrees of rotation
+// Larger time steps (a scene-time jump, a stall) let the clouds change too much to reuse
+static const float CLOUD_HISTORY_MAX_TIME_DELTA = 0.25f; // Seconds of u_time
+
+// Bayer orders for the temporal update grid: the pixel of each block marched on frame i is the cell holding
+// i % (n * n), so every pixel is refreshed once per cycle and consecutive frames are spread across the block
+static const int CLOUD_BAYER_2[2][2] = { { 0, 2 }, { 3, 1 } };
+static const int CLOUD_BAYER_4[4][4] = { { 0, 8, 2, 10 }, { 12, 4, 14, 6 }, { 3, 11, 1, 9 }, { 15, 7, 13, 5 } };
+
+// --- CPU port of the shader noise (hash3 / valueNoise3D / fbm3D), with the lattice wrapped per octave ---
+static float fract(float x) { return x - std::floor(x); }
+
+static float hash3(float x, float y, float z) {
+    x = fract(x * 0.1031f); y = fract(y * 0.1031f); z = fract(z * 0.1031f);
+    float d = x * (y + 33.33f) + y * (z + 33.33f) + z * (x + 33.33f);
+    x += d; y += d; z += d;
+    return fract((x + y) * z);
+}
+
+static float latticeHash(int x, int y, int z, int period) {
+    auto wrap = [period](int v) { return ((v % period) + period) % period; };
+    return hash3(static_cast<float>(wrap(x)), static_cast<float>(wrap(y)), static_cast<float>(wrap(z)));
+}
+
+static float tiledValueNoise(float px, float py, float pz, int period) {
+    int ix = static_cast<int>(std::floor(px)), iy = static_cast<int>(std::floor(py)), iz = static_cast<int>(std::floor(pz));
+    float fx = px - ix, fy = py - iy, fz = pz - iz;
+    float ux = fx * fx * (3.0f - 2.0f * fx), uy = fy * fy * (3.0f - 2.0f * fy), uz = fz * fz * (3.0f - 2.0f * fz);
+    auto lerp = [](float a, float b, float t) { return a + (b - a) * t; };
+    float x00 = lerp(latticeHash(ix, iy,     iz,     period), latticeHash(ix + 1, iy,     iz,     period), ux);
+    float x10 = lerp(latticeHash(ix, iy + 1, iz,     period), latticeHash(ix + 1, iy + 1, iz,     period), ux);
+    float x01 = lerp(latticeHash(ix, iy,     iz + 1, period), latticeHash(ix + 1, iy,     iz + 1, period), ux);
+    float x11 = lerp(latticeHash(ix, iy + 1, iz + 1, period), latticeHash(ix + 1, iy + 1, iz + 1, period), ux);
+    return lerp(lerp(x00, x10, uy), lerp(x01, x11, uy), uz);
+}
+// --- End Noise ---
+
+CloudRenderer::CloudRenderer() = default;
+
+CloudRenderer::~CloudRenderer() {
+    if (m_noiseTexture != 0) { MemoryStats::UntrackTexture(m_noiseTexture); glDeleteTextures(1, &m_noiseTexture); }
+}
+
+float CloudRenderer::GetNoisePeriod() const { return static_cast<float>(CLOUD_NOISE_PERIOD); }
+
+int CloudRenderer::GetNoiseResolution() const { return CLOUD_NOISE_RESOLUTION; }
+
+bool CloudRenderer::Initialize() {
+    m_cloudShader = std::make_unique<Shader>("shaders/raymarch_vertex.glsl", "shaders/clouds_fragment.glsl");
+    if (!m_cloudShader->isValid()) {
+        LOG_ERROR(RENDER) << "Cloud shader failed to load, clouds disabled.";
+        m_cloudShader = nullptr;
+        return false;
+    }
+    auto setupUniforms = [](Shader& shader) {
+        shader.bindUniformBlock(RAYMARCH_PARAMS_BLOCK_NAME, RAYMARCH_PARAMS_BINDING);
+        shader.use();
+        shader.setInt("u_cloudNoise", 0);
+        shader.setInt("u_historyColor", 1);
+        shader.setInt("u_historyDistance", 2);
+        glUseProgram(0);
+    };
+    setupUniforms(*m_cloudShader);
+    m_cloudShader->setReloadCallback(setupUniforms);
+
+    if (!createNoiseTexture()) {
+        LOG_ERROR(RENDER) << "Failed to create cloud noise volume, clouds disabled.";
+        m_cloudShader = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void CloudRenderer::generateNoiseSlices(std::vector<float>& voxels, int zBegin, int zEnd) {
+    const int res = CLOUD_NOISE_RESOLUTION;
+    const float voxelToNoise = static_cast<float>(CLOUD_NOISE_PERIOD) / static_cast<float>(res);
+    for (int z = zBegin; z < zEnd; ++z) {
+        for (int y = 0; y < res; ++y) {
+            for (int x = 0; x < res; ++x) {
+                // Voxel centres, so GL_LINEAR lookups at (p / period) reproduce the continuous noise
+                float px = (x + 0.5f) * voxelToNoise, py = (y + 0.5f) * voxelToNoise, pz = (z + 0.5f) * voxelToNoise;
+                float freq = 1.0f, amp = 0.5f, value = 0.0f;
+                int period = CLOUD_NOISE_PERIOD;
+                for (int o = 0; o < CLOUD_NOISE_OCTAVES; ++o) {
+                    value += tiledValueNoise(px * freq, py * freq, pz * freq, period) * amp;
+                    freq *= 2.0f; amp *= CLOUD_NOISE_PERSISTENCE; period *= 2;
+                }
+                voxels[(static_cast<size_t>(z) * res + y) * res + x] = value;
+            }
+        }
+    }
+}
+
+bool CloudRenderer::createNoiseTexture() {
+    const int res = CLOUD_NOISE_RESOLUTION;
+    auto start = std::chrono::high_resolution_clock::now();
+
+    // Generate on the CPU, split into z-slabs across the available cores
+    std::vector<float> voxels(static_cast<size_t>(res) * res * res);
+    unsigned int threadCount = std::max(1u, std::min(std::thread::hardware_concurrency(), 16u));
+    std::vector<std::thread> workers;
+    int slicesPerThread = (res + static_cast<int>(threadCount) - 1) / static_cast<int>(threadCount);
+    for (int zBegin = 0; zBegin < res; zBegin += slicesPerThread) {
+        int zEnd = std::min(res, zBegin + slicesPerThread);
+        workers.emplace_back(generateNoiseSlices, std::ref(voxels), zBegin, zEnd);
+    }
+    for (std::thread& worker : workers) worker.join();
+
+    glGenTextures(1, &m_noiseTexture);
+    glBindTexture(GL_TEXTURE_3D, m_noiseTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexImage3D(GL_TEXTURE_3D, 0, GL_R16F, res, res, res, 0, GL_RED, GL_FLOAT, voxels.data());
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_3D, 0);
+
+    if (glGetError() != GL_NO_ERROR) {
+        glDeleteTextures(1, &m_noiseTexture);
+        m_noiseTexture = 0;
+        return false;
+    }
+    MemoryStats::TrackTexture(m_noiseTexture, MemoryCategory::ENVIRONMENT, static_cast<size_t>(res) * res * res * 2); // R16F
+
+    auto end = std::chrono::high_resolution_clock::now();
+    LOG_INFO(RENDER) << "Cloud noise volume generated (" << res << "^3, " << workers.size() << " threads) in "
+                     << std::chrono::duration<double, std::milli>(end - start).count() << " ms";
+    return true;
+}
+
+void CloudRenderer::Resize(int nativeWidth, int nativeHeight, int scaleDivisor) {
+    if (scaleDivisor < 1) scaleDivisor = 1;
+    if (nativeWidth == m_nativeWidth && nativeHeight == m_nativeHeight && scaleDivisor == m_scaleDivisor && m_targets[0].IsValid()) return;
+
+    m_nativeWidth = nativeWidth;
+    m_nativeHeight = nativeHeight;
+    m_scaleDivisor = scaleDivisor;
+
+    int lowWidth = (nativeWidth + scaleDivisor - 1) / scaleDivisor;
+    int lowHeight = (nativeHeight + scaleDivisor - 1) / scaleDivisor;
+    for (RenderTarget& target : m_targets) {
+        target.Create(lowWidth, lowHeight, {
+            { GL_RGBA16F, GL_RGBA, GL_FLOAT, GL_LINEAR },
+            { GL_R32F,    GL_RED,  GL_FLOAT, GL_NEAREST }
+        });
+    }
+    m_historyValid = false;
+    LOG_INFO(RENDER) << "Cloud buffer: " << lowWidth << "x" << lowHeight;
+}
+
+void CloudRenderer::Render(unsigned int quadVAO, float time, const glm::vec3& camPos, const glm::mat4& viewProj, const glm::mat4& invView,
+                           const glm::mat4& invProj, int maxSteps, int updateGrid) {
+    const RenderTarget& previous = m_targets[m_current];
+    const RenderTarget& target = m_targets[m_current ^ 1];
+    if (!IsValid() || !target.IsValid()) return;
+
+    updateGrid = (updateGrid >= 4) ? 4 : (updateGrid >= 2) ? 2 : 1;
+    glm::vec3 forward = -glm::vec3(invView[2]);
+    float timeDelta = time - m_prevTime;
+    bool historyValid = m_historyValid && updateGrid > 1 && glm::length(camPos - m_prevCamPos) <= CLOUD_HISTORY_MAX_MOVE &&
+                        glm::dot(forward, m_prevForward) >= CLOUD_HISTORY_MIN_FORWARD_DOT &&
+                        timeDelta >= 0.0f && timeDelta <= CLOUD_HISTORY_MAX_TIME_DELTA;
+    // Cell of each block marched this frame
+    int cycle = static_cast<int>(m_frameIndex % static_cast<unsigned int>(updateGrid * updateGrid));
+    glm::vec2 updateOffset(0.0f);
+    for (int y = 0; y < updateGrid; ++y) {
+        for (int x = 0; x < updateGrid; ++x) {
+            int order = (updateGrid == 4) ? CLOUD_BAYER_4[y][x] : (updateGrid == 2) ? CLOUD_BAYER_2[y][x] : 0;
+            if (order == cycle) updateOffset = glm::vec2(static_cast<float>(x), static_cast<float>(y));
+        }
+    }
+    m_marchedFraction = historyValid ? 1.0f / static_cast<float>(updateGrid * updateGrid) : 1.0f;
+
+    target.Bind();
+    glDisable(GL_DEPTH_TEST);
+
+    m_cloudShader->use();
+    m_cloudShader->setVec3("u_camPos", camPos);
+    m_cloudShader->setMat4("u_invViewMatrix", invView);
+    m_cloudShader->setMat4("u_invProjMatrix", invProj);
+    m_cloudShader->setFloat("u_time", time);
+    m_cloudShader->setBool("u_cloudsEnabled", true);
+    m_cloudShader->setInt("u_cloudSteps", maxSteps);
+    m_cloudShader->setMat4("u_prevViewProj", m_prevViewProj);
+    m_cloudShader->setBool("u_historyValid", historyValid);
+    m_cloudShader->setInt("u_updateGrid", updateGrid);
+    m_cloudShader->setVec2("u_updateOffset", updateOffset);
+    m_cloudShader->setFloat("u_timeDelta", timeDelta);
+
+    glActiveTexture(GL_TEXTURE0); glBindTexture(GL_TEXTURE_3D, m_noiseTexture);
+    glActiveTexture(GL_TEXTURE1); glBindTexture(GL_TEXTURE_2D, previous.GetColorTexture(0));
+    glActiveTexture(GL_TEXTURE2); glBindTexture(GL_TEXTURE_2D, previous.GetColorTexture(1));
+
+    glBindVertexArray(quadVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    glBindVertexArray(0);
+
+    glActiveTexture(GL_TEXTURE2); glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE1); glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0); glBindTexture(GL_TEXTURE_3D, 0);
+    glUseProgram(0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glEnable(GL_DEPTH_TEST);
+
+    m_current ^= 1;
+    m_historyValid = true;
+    m_prevViewProj = viewProj;
+    m_prevCamPos = camPos;
+    m_prevForward = forward;
+    m_prevTime = time;
+    m_frameIndex++;
+}
@@ -0,0 +1,404 @@
+#include "CompressedTexture.h"
+#include "Log.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+// --- Container constants ---
+
+static uint32_t makeFourCC(char a, char b, char c, char d) {
+    return static_cast<uint32_t>(static_cast<unsigned char>(a)) | (static_cast<uint32_t>(static_cast<unsigned char>(b)) << 8) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(c)) << 16) | (static_cast<uint32_t>(static_cast<unsigned char>(d)) << 24);
+}
+
+static const uint32_t DDS_MAGIC = makeFourCC('D', 'D', 'S', ' ');
+static const uint32_t DDS_FOURCC_DXT1 = makeFourCC('D', 'X', 'T', '1');
+static const uint32_t DDS_FOURCC_DXT5 = makeFourCC('D', 'X', 'T', '5');
+static const uint32_t DDS_FOURCC_ATI1 = makeFourCC('A', 'T', 'I', '1');
+static const uint32_t DDS_FOURCC_BC4U = makeFourCC('B', 'C', '4', 'U');
+static const uint32_t DDS_FOURCC_ATI2 = makeFourCC('A', 'T', 'I', '2');
+static const uint32_t DDS_FOURCC_BC5U = makeFourCC('B', 'C', '5', 'U');
+static const uint32_t DDS_FOURCC_DX10 = makeFourCC('D', 'X', '1', '0');
+// Written into dwReserved1[0] by SaveDDS: data is already bottom-up and dwReserved1[2..5] hold the cook stamp
+static const uint32_t DDS_COOKED_MARKER = makeFourCC('O', 'G', 'C', 'K');
+
+static const uint32_t DDSD_CAPS = 0x1, DDSD_HEIGHT = 0x2, DDSD_WIDTH = 0x4, DDSD_PIXELFORMAT = 0x1000;
+static const uint32_t DDSD_MIPMAPCOUNT = 0x20000, DDSD_LINEARSIZE = 0x80000;
+static const uint32_t DDPF_FOURCC = 0x4;
+static const uint32_t DDSCAPS_COMPLEX = 0x8, DDSCAPS_TEXTURE = 0x1000, DDSCAPS_MIPMAP = 0x400000;
+static const uint32_t DDS_DIMENSION_TEXTURE2D = 3;
+
+// DXGI_FORMAT values of the block-compressed formats we accept
+enum : uint32_t {
+    DXGI_BC1_UNORM = 71, DXGI_BC1_UNORM_SRGB = 72, DXGI_BC3_UNORM = 77, DXGI_BC3_UNORM_SRGB = 78,
+    DXGI_BC4_UNORM = 80, DXGI_BC5_UNORM = 83, DXGI_BC7_UNORM = 98, DXGI_BC7_UNORM_SRGB = 99
+};
+
+// VkFormat values used by KTX2
+enum : uint32_t {
+    VK_BC1_RGB_UNORM = 131, VK_BC1_RGB_SRGB = 132, VK_BC1_RGBA_UNORM = 133, VK_BC1_RGBA_SRGB = 134,
+    VK_BC3_UNORM = 137, VK_BC3_SRGB = 138, VK_BC4_UNORM = 139, VK_BC5_UNORM = 141, VK_BC7_UNORM = 145, VK_BC7_SRGB = 146
+};
+
+static const unsigned char KTX2_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+struct DDSPixelFormat {
+    uint32_t size, flags, fourCC, rgbBitCount, rMask, gMask, bMask, aMask;
+};
+
+struct DDSHeader {
+    uint32_t size, flags, height, width, pitchOrLinearSize, depth, mipMapCount;
+    uint32_t reserved1[11];
+    DDSPixelFormat pixelFormat;
+    uint32_t caps, caps2, caps3, caps4, reserved2;
+};
+static_assert(sizeof(DDSHeader) == 124, "DDS header must match the file layout");
+
+struct DDSHeaderDX10 {
+    uint32_t dxgiFormat, resourceDimension, miscFlag, arraySize, miscFlags2;
+};
+
+struct KTX2Header {
+    unsigned char identifier[12];
+    uint32_t vkFormat, typeSize, pixelWidth, pixelHeight, pixelDepth, layerCount, faceCount, levelCount, supercompressionScheme;
+    uint32_t dfdByteOffset, dfdByteLength, kvdByteOffset, kvdByteLength;
+    uint64_t sgdByteOffset, sgdByteLength;
+};
+static_assert(sizeof(KTX2Header) == 80, "KTX2 header must match the file layout");
+
+struct KTX2LevelIndex {
+    uint64_t byteOffset, byteLength, uncompressedByteLength;
+};
+
+// --- Format helpers ---
+
+static size_t blockBytesFor(GLenum internalFormat) {
+    switch (internalFormat) {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RED_RGTC1: return 8;
+        default: return 16;
+    }
+}
+
+static GLenum formatFromDXGI(uint32_t dxgi) {
+    switch (dxgi) {
+        case DXGI_BC1_UNORM: case DXGI_BC1_UNORM_SRGB: return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+        case DXGI_BC3_UNORM: case DXGI_BC3_UNORM_SRGB: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case DXGI_BC4_UNORM: return GL_COMPRESSED_RED_RGTC1;
+        case DXGI_BC5_UNORM: return GL_COMPRESSED_RG_RGTC2;
+        case DXGI_BC7_UNORM: case DXGI_BC7_UNORM_SRGB: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+        default: return 0;
+    }
+}
+
+static GLenum formatFromVk(uint32_t vk) {
+    switch (vk) {
+        case VK_BC1_RGB_UNORM: case VK_BC1_RGB_SRGB: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        case VK_BC1_RGBA_UNORM: case VK_BC1_RGBA_SRGB: return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+        case VK_BC3_UNORM: case VK_BC3_SRGB: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case VK_BC4_UNORM: return GL_COMPRESSED_RED_RGTC1;
+        case VK_BC5_UNORM: return GL_COMPRESSED_RG_RGTC2;
+        case VK_BC7_UNORM: case VK_BC7_SRGB: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+        default: return 0;
+    }
+}
+
+static size_t levelSize(int width, int height, size_t blockBytes) {
+    return static_cast<size_t>(std::max(1, (width + 3) / 4)) * static_cast<size_t>(std::max(1, (height + 3) / 4)) * blockBytes;
+}
+
+static bool readFile(const std::string& path, std::vector<unsigned char>& data) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) return false;
+    std::streamsize size = file.tellg();
+    if (size <= 0) return false;
+    data.resize(static_cast<size_t>(size));
+    file.seekg(0);
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(data.data()), size));
+}
+
+CompressedFormatSupport CompressedFormatSupport::Query() {
+    CompressedFormatSupport support;
+    support.s3tc = GLEW_EXT_texture_compression_s3tc != 0;
+    support.rgtc = true;
+    support.bptc = GLEW_ARB_texture_compression_bptc || GLEW_VERSION_4_2;
+    return support;
+}
+
+bool CompressedFormatSupport::Supports(GLenum internalFormat) const {
+    switch (internalFormat) {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT: return s3tc;
+        case GL_COMPRESSED_RED_RGTC1:
+        case GL_COMPRESSED_RG_RGTC2: return rgtc;
+        case GL_COMPRESSED_RGBA_BPTC_UNORM: return bptc;
+        default: return false;
+    }
+}
+
+// --- Loading ---
+
+bool CompressedTextureFile::IsCompressedPath(const std::string& path) {
+    std::string extension = std::filesystem::path(path).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+    return extension == ".dds" || extension == ".ktx2";
+}
+
+bool CompressedTextureFile::Load(const std::string& path, CompressedImage& image, std::string& error) {
+    std::vector<unsigned char> file;
+    if (!readFile(path, file)) { error = "cannot read file"; return false; }
+
+    bool glOrder = false;
+    bool ok = false;
+    if (file.size() >= sizeof(KTX2_IDENTIFIER) && std::memcmp(file.data(), KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) == 0) {
+        ok = loadKTX2(file, image, error);
+    } else {
+        ok = loadDDS(file, image, glOrder, error);
+    }
+    if (!ok) return false;
+    // Refused rather than shown upside down (or shifted) when the blocks can't be flipped in place
+    if (!glOrder && !flipVertically(image, error)) return false;
+    return true;
+}
+
+bool CompressedTextureFile::loadDDS(const std::vector<unsigned char>& file, CompressedImage& image, bool& glOrder, std::string& error) {
+    uint32_t magic = 0;
+    if (file.size() < sizeof(magic) + sizeof(DDSHeader)) { error = "truncated DDS header"; return false; }
+    std::memcpy(&magic, file.data(), sizeof(magic));
+    if (magic != DDS_MAGIC) { error = "not a DDS or KTX2 file"; return false; }
+    DDSHeader header;
+    std::memcpy(&header, file.data() + sizeof(magic), sizeof(header));
+    size_t offset = sizeof(magic) + sizeof(header);
+
+    if (!(header.pixelFormat.flags & DDPF_FOURCC)) { error = "uncompressed DDS files are not supported"; return false; }
+    GLenum format = 0;
+    uint32_t fourCC = header.pixelFormat.fourCC;
+    if (fourCC == DDS_FOURCC_DXT1) format = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+    else if (fourCC == DDS_FOURCC_DXT5) format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    else if (fourCC == DDS_FOURCC_ATI1 || fourCC == DDS_FOURCC_BC4U) format = GL_COMPRESSED_RED_RGTC1;
+    else if (fourCC == DDS_FOURCC_ATI2 || fourCC == DDS_FOURCC_BC5U) format = GL_COMPRESSED_RG_RGTC2;
+    else if (fourCC == DDS_FOURCC_DX10) {
+        if (file.size() < offset + sizeof(DDSHeaderDX10)) { error = "truncated DX10 header"; return false; }
+        DDSHeaderDX10 dx10;
+        std::memcpy(&dx10, file.data() + offset, sizeof(dx10));
+        offset += sizeof(dx10);
+        if (dx10.resourceDimension != DDS_DIMENSION_TEXTURE2D || dx10.arraySize > 1) { error = "only single 2D DDS textures are supported"; return false; }
+        format = formatFromDXGI(dx10.dxgiFormat);
+    }
+    if (format == 0) { error = "unsupported DDS pixel format"; return false; }
+
+    image.internalFormat = format;
+    image.blockBytes = blockBytesFor(format);
+    image.width = static_cast<int>(header.width);
+    image.height = static_cast<int>(header.height);
+    uint32_t levelCount = (header.flags & DDSD_MIPMAPCOUNT) ? std::max<uint32_t>(1, header.mipMapCount) : 1;
+
+    // Levels follow each other tightly, largest first
+    image.data.assign(file.begin() + static_cast<std::ptrdiff_t>(offset), file.end());
+    size_t cursor = 0;
+    int width = image.width, height = image.height;
+    for (uint32_t i = 0; i < levelCount; ++i) {
+        CompressedMipLevel level;
+        level.offset = cursor;
+        level.size = levelSize(width, height, image.blockBytes);
+        level.width = width;
+        level.height = height;
+        if (cursor + level.size > image.data.size()) { error = "truncated DDS mip chain"; return false; }
+        image.levels.push_back(level);
+        cursor += level.size;
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+    }
+    glOrder = header.reserved1[0] == DDS_COOKED_MARKER;
+    return true;
+}
+
+bool CompressedTextureFile::loadKTX2(const std::vector<unsigned char>& file, CompressedImage& image, std::string& error) {
+    if (file.size() < sizeof(KTX2Header)) { error = "truncated KTX2 header"; return false; }
+    KTX2Header header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (header.supercompressionScheme != 0) { error = "supercompressed KTX2 files are not supported"; return false; }
+    if (header.pixelDepth > 1 || header.layerCount > 1 || header.faceCount != 1) { error = "only single 2D KTX2 textures are supported"; return false; }
+    GLenum format = formatFromVk(header.vkFormat);
+    if (format == 0) { error = "unsupported KTX2 vkFormat " + std::to_string(header.vkFormat); return false; }
+
+    uint32_t levelCount = std::max<uint32_t>(1, header.levelCount);
+    if (file.size() < sizeof(KTX2Header) + levelCount * sizeof(KTX2LevelIndex)) { error = "truncated KTX2 level index"; return false; }
+
+    image.internalFormat = format;
+    image.blockBytes = blockBytesFor(format);
+    image.width = static_cast<int>(header.pixelWidth);
+    image.height = static_cast<int>(header.pixelHeight);
+
+    // KTX2 stores the smallest level first in the file; repack largest-first like DDS
+    size_t total = 0;
+    std::vector<KTX2LevelIndex> index(levelCount);
+    std::memcpy(index.data(), file.data() + sizeof(KTX2Header), levelCount * sizeof(KTX2LevelIndex));
+    for (const KTX2LevelIndex& entry : index) {
+        // Checked before the sum so a corrupt index can neither wrap it nor size the allocation
+        if (entry.byteOffset > file.size() || entry.byteLength > file.size() - entry.byteOffset) {
+            error = "truncated KTX2 mip level"; return false;
+        }
+        total += static_cast<size_t>(entry.byteLength);
+    }
+    image.data.resize(total);
+    size_t cursor = 0;
+    int width = image.width, height = image.height;
+    for (uint32_t i = 0; i < levelCount; ++i) {
+        const KTX2LevelIndex& entry = index[i];
+        CompressedMipLevel level;
+        level.offset = cursor;
+        level.size = static_cast<size_t>(entry.byteLength);
+        level.width = width;
+        level.height = height;
+        if (level.size < levelSize(width, height, image.blockBytes)) {
+            error = "truncated KTX2 mip level"; return false;
+        }
+        std::memcpy(image.data.data() + cursor, file.data() + entry.byteOffset, level.size);
+        image.levels.push_back(level);
+        cursor += level.size;
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+    }
+    return true;
+}
+
+// --- Vertical flip of block-compressed data ---
+
+// Color part of a BC1 block: one byte of 2-bit indices per row
+static void flipColorBlock(unsigned char* block, int rows) {
+    for (int i = 0; i < rows / 2; ++i) std::swap(block[4 + i], block[4 + rows - 1 - i]);
+}
+
+// BC4 block (also BC3 alpha and each BC5 channel): 48 bits of 3-bit indices, 12 bits per row
+static void flipAlphaBlock(unsigned char* block, int rows) {
+    uint64_t bits = 0;
+    for (int i = 0; i < 6; ++i) bits |= static_cast<uint64_t>(block[2 + i]) << (8 * i);
+    uint64_t row[4];
+    for (int r = 0; r < 4; ++r) row[r] = (bits >> (12 * r)) & 0xFFF;
+    for (int i = 0; i < rows / 2; ++i) std::swap(row[i], row[rows - 1 - i]);
+    bits = 0;
+    for (int r = 0; r < 4; ++r) bits |= row[r] << (12 * r);
+    for (int i = 0; i < 6; ++i) block[2 + i] = static_cast<unsigned char>(bits >> (8 * i));
+}
+
+bool CompressedTextureFile::flipVertically(CompressedImage& image, std::string& error) {
+    if (image.internalFormat == GL_COMPRESSED_RGBA_BPTC_UNORM) {
+        // BC7 partitions don't survive a row flip
+        error = "BC7 data stored top-down cannot be flipped; re-export it bottom-up"; return false;
+    }
+    // Flipping in place needs the pixel rows to fill every block row. A taller level that isn't a multiple
+    // of 4 would have to move rows across blocks (which have their own endpoints), so the chain ends
+    // before the first such level; the streamer caps GL_TEXTURE_MAX_LEVEL at the levels that remain.
+    size_t flippable = 0;
+    while (flippable < image.levels.size() && (image.levels[flippable].height <= 4 || image.levels[flippable].height % 4 == 0)) {
+        flippable++;
+    }
+    if (flippable == 0) {
+        error = "top-down block-compressed data with a height that is not a multiple of 4 cannot be flipped"; return false;
+    }
+    if (flippable < image.levels.size()) {
+        LOG_WARN(TEXTURES) << "Top-down compressed texture: dropping " << image.levels.size() - flippable
+                           << " mip levels from " << image.levels[flippable].width << "x" << image.levels[flippable].height
+                           << " down, whose rows don't fill whole blocks";
+        image.levels.resize(flippable);
+        image.data.resize(image.levels.back().offset + image.levels.back().size);
+    }
+    std::vector<unsigned char> rowBuffer;
+    for (const CompressedMipLevel& level : image.levels) {
+        size_t rowBytes = image.BlockRowBytes(level);
+        int blockRows = std::max(1, (level.height + 3) / 4);
+        int rowsInBlock = std::min(4, level.height); // Levels smaller than a block only hold `height` rows (see above)
+        unsigned char* base = image.data.data() + level.offset;
+
+        // Reverse the order of the block rows
+        rowBuffer.resize(rowBytes);
+        for (int i = 0; i < blockRows / 2; ++i) {
+            unsigned char* a = base + rowBytes * i;
+            unsigned char* b = base + rowBytes * (blockRows - 1 - i);
+            std::memcpy(rowBuffer.data(), a, rowBytes);
+            std::memcpy(a, b, rowBytes);
+            std::memcpy(b, rowBuffer.data(), rowBytes);
+        }
+        // Reverse the pixel rows inside every block
+        for (size_t offset = 0; offset + image.blockBytes <= level.size; offset += image.blockBytes) {
+            unsigned char* block = base + offset;
+            switch (image.internalFormat) {
+                case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+                case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT: flipColorBlock(block, rowsInBlock); break;
+                case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT: flipAlphaBlock(block, rowsInBlock); flipColorBlock(block + 8, rowsInBlock); break;
+                case GL_COMPRESSED_RED_RGTC1: flipAlphaBlock(block, rowsInBlock); break;
+                case GL_COMPRESSED_RG_RGTC2: flipAlphaBlock(block, rowsInBlock); flipAlphaBlock(block + 8, rowsInBlock); break;
+                default: break;
+            }
+        }
+    }
+    return true;
+}
+
+// --- Writing (cook cache) ---
+
+bool CompressedTextureFile::SaveDDS(const std::string& path, const CompressedImage& image, const uint32_t stamp[4]) {
+    DDSHeader header = {};
+    header.size = sizeof(DDSHeader);
+    header.flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE;
+    header.height = static_cast<uint32_t>(image.height);
+    header.width = static_cast<uint32_t>(image.width);
+    header.pitchOrLinearSize = image.levels.empty() ? 0 : static_cast<uint32_t>(image.levels[0].size);
+    header.mipMapCount = static_cast<uint32_t>(image.levels.size());
+    header.reserved1[0] = DDS_COOKED_MARKER;
+    for (int i = 0; i < 4; ++i) header.reserved1[2 + i] = stamp[i];
+    header.pixelFormat.size = sizeof(DDSPixelFormat);
+    header.pixelFormat.flags = DDPF_FOURCC;
+    header.caps = DDSCAPS_TEXTURE | (image.levels.size() > 1 ? (DDSCAPS_MIPMAP | DDSCAPS_COMPLEX) : 0);
+
+    DDSHeaderDX10 dx10 = {};
+    bool useDX10 = false;
+    switch (image.internalFormat) {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT: header.pixelFormat.fourCC = DDS_FOURCC_DXT1; break;
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT: header.pixelFormat.fourCC = DDS_FOURCC_DXT5; break;
+        case GL_COMPRESSED_RED_RGTC1: header.pixelFormat.fourCC = DDS_FOURCC_ATI1; break;
+        case GL_COMPRESSED_RG_RGTC2: header.pixelFormat.fourCC = DDS_FOURCC_ATI2; break;
+        case GL_COMPRESSED_RGBA_BPTC_UNORM:
+            header.pixelFormat.fourCC = DDS_FOURCC_DX10;
+            dx10.dxgiFormat = DXGI_BC7_UNORM; dx10.resourceDimension = DDS_DIMENSION_TEXTURE2D; dx10.arraySize = 1;
+            useDX10 = true;
+            break;
+        default: return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+    std::filesystem::path tempPath = MakeTempPath(path);
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out.write(reinterpret_cast<const char*>(&DDS_MAGIC), sizeof(DDS_MAGIC));
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        if (useDX10) out.write(reinterpret_cast<const char*>(&dx10), sizeof(dx10));
+        for (const CompressedMipLevel& level : image.levels) {
+            out.write(reinterpret_cast<const char*>(image.data.data() + level.offset), static_cast<std::streamsize>(level.size));
+        }
+        if (!out) { out.close(); std::filesystem::remove(tempPath, ec); return false; }
+    }
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) { std::filesystem::remove(tempPath, ec); return false; }
+    return true;
+}
+
+bool CompressedTextureFile::ReadDDSStamp(const std::string& path, uint32_t stamp[4]) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    uint32_t magic = 0;
+    DDSHeader header;
+    if (!file.read(reinterpret_cast<char*>(&magic), sizeof(magic)) || magic != DDS_MAGIC) return false;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.reserved1[0] != DDS_COOKED_MARKER) return false;
+    for (int i = 0; i < 4; ++i) stamp[i] = header.reserved1[2 + i];
+    return true;
+}
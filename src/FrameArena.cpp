@@ -0,0 +1,48 @@
+#include "FrameArena.h"
+#include <algorithm>
+#include <cstdint>
+
+FrameArena::FrameArena(size_t initialBytes) {
+    addBlock(initialBytes);
+}
+
+void FrameArena::addBlock(size_t minBytes) {
+    Block block;
+    block.size = std::max(minBytes, m_blocks.empty() ? minBytes : m_blocks.back().size * 2);
+    block.data.reset(new unsigned char[block.size]);
+    m_blocks.push_back(std::move(block));
+    m_offset = 0;
+}
+
+void* FrameArena::Allocate(size_t bytes, size_t alignment) {
+    Block* block = &m_blocks.back();
+    uintptr_t base = reinterpret_cast<uintptr_t>(block->data.get());
+    size_t aligned = ((base + m_offset + alignment - 1) & ~(uintptr_t)(alignment - 1)) - base;
+    if (aligned + bytes > block->size) {
+        addBlock(bytes + alignment);
+        block = &m_blocks.back();
+        base = reinterpret_cast<uintptr_t>(block->data.get());
+        aligned = ((base + alignment - 1) & ~(uintptr_t)(alignment - 1)) - base;
+    }
+    m_usedBytes += aligned - m_offset + bytes;
+    m_offset = aligned + bytes;
+    return block->data.get() + aligned;
+}
+
+void FrameArena::Reset() {
+    m_peakBytes = std::max(m_peakBytes, m_usedBytes);
+    if (m_blocks.size() > 1) {
+        // Last frame needed more than one block: next time it all fits in one
+        size_t total = GetCapacity();
+        m_blocks.clear();
+        addBlock(total);
+    }
+    m_offset = 0;
+    m_usedBytes = 0;
+}
+
+size_t FrameArena::GetCapacity() const {
+    size_t total = 0;
+    for (const Block& block : m_blocks) total += block.size;
+    return total;
+}
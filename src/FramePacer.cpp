@@ -0,0 +1,137 @@
+#include "FramePacer.h"
+#include "Log.h"
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+// Fence waits are issued in slices so a lost context cannot hang the loop in one call
+static const GLuint64 PACER_FENCE_TIMEOUT_NS = 100000000; // 100 ms
+// Sleep samples kept at full weight; older ones fade so the estimate follows the OS timer
+static const int PACER_SLEEP_SAMPLE_LIMIT = 256;
+// A cap deadline missed by more than this many periods restarts the schedule instead of bursting to catch up
+static const int PACER_MAX_BEHIND_PERIODS = 2;
+
+static double elapsedMs(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+FramePacer::~FramePacer() {
+    Destroy();
+}
+
+void FramePacer::Initialize(GLFWwindow* window, const FramePacingSettings& settings) {
+    m_window = window;
+    m_adaptiveSupported = glfwExtensionSupported("WGL_EXT_swap_control_tear") || glfwExtensionSupported("GLX_EXT_swap_control_tear");
+    m_settings.maxFramesInFlight = std::clamp(settings.maxFramesInFlight, 1, MAX_FRAMES_IN_FLIGHT);
+    m_settings.frameRateCap = std::max(settings.frameRateCap, 0.0f);
+    SetVsyncMode(settings.vsync);
+    LOG_INFO(RENDER) << "Frame pacing: vsync " << GetVsyncModeName(m_settings.vsync) << ", " << m_settings.maxFramesInFlight
+                     << " frames in flight, cap " << m_settings.frameRateCap << " fps (0 = off)";
+}
+
+void FramePacer::Destroy() {
+    for (GLsync fence : m_fences) glDeleteSync(fence);
+    m_fences.clear();
+    m_started = false;
+    m_capScheduled = false;
+}
+
+double FramePacer::BeginFrame() {
+    Clock::time_point start = Clock::now();
+    m_stats.framesInFlight = m_fences.size();
+
+    // Latency limiter: frame N may start once frame N - maxFramesInFlight has left the GPU
+    while (static_cast<int>(m_fences.size()) >= m_settings.maxFramesInFlight) {
+        waitForFence(m_fences.front());
+        glDeleteSync(m_fences.front());
+        m_fences.pop_front();
+    }
+    // Drop fences that have already signalled, so framesInFlight stays current
+    while (!m_fences.empty() && glClientWaitSync(m_fences.front(), 0, 0) != GL_TIMEOUT_EXPIRED) {
+        glDeleteSync(m_fences.front());
+        m_fences.pop_front();
+    }
+    Clock::time_point fenced = Clock::now();
+    m_stats.fenceWaitMs = elapsedMs(start, fenced);
+
+    m_stats.capSleepMs = 0.0;
+    if (m_settings.frameRateCap > 0.0f) {
+        auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_settings.frameRateCap));
+        if (!m_capScheduled || fenced > m_nextDeadline + period * PACER_MAX_BEHIND_PERIODS) m_nextDeadline = fenced;
+        else m_nextDeadline += period;
+        m_capScheduled = true;
+        if (m_nextDeadline > fenced) {
+            sleepUntil(m_nextDeadline);
+            m_stats.capSleepMs = elapsedMs(fenced, Clock::now());
+        }
+    }
+
+    Clock::time_point frameStart = Clock::now();
+    double seconds = m_started ? std::chrono::duration<double>(frameStart - m_lastFrameStart).count() : 0.0;
+    m_lastFrameStart = frameStart;
+    m_started = true;
+    return seconds;
+}
+
+void FramePacer::EndFrame() {
+    m_fences.push_back(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    // Callers that never reach BeginFrame (the benchmark's fixed-step loop) still keep a bounded list
+    while (static_cast<int>(m_fences.size()) > MAX_FRAMES_IN_FLIGHT) {
+        glDeleteSync(m_fences.front());
+        m_fences.pop_front();
+    }
+}
+
+void FramePacer::SetVsyncMode(VsyncMode mode) {
+    if (mode == VsyncMode::ADAPTIVE && !m_adaptiveSupported) mode = VsyncMode::ON;
+    m_settings.vsync = mode;
+    glfwSwapInterval(mode == VsyncMode::OFF ? 0 : mode == VsyncMode::ON ? 1 : -1);
+}
+
+void FramePacer::SetMaxFramesInFlight(int frames) {
+    m_settings.maxFramesInFlight = std::clamp(frames, 1, MAX_FRAMES_IN_FLIGHT);
+}
+
+void FramePacer::SetFrameRateCap(float framesPerSecond) {
+    m_settings.frameRateCap = std::max(framesPerSecond, 0.0f);
+    m_capScheduled = false; // A new cap starts its schedule from the next frame
+}
+
+const char* FramePacer::GetVsyncModeName(VsyncMode mode) {
+    switch (mode) {
+        case VsyncMode::OFF:      return "off";
+        case VsyncMode::ON:       return "on";
+        case VsyncMode::ADAPTIVE: return "adaptive";
+    }
+    return "?";
+}
+
+void FramePacer::waitForFence(GLsync fence) {
+    // The swap already flushed the frame, but the flush bit is cheap and covers a caller that did not swap
+    GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, PACER_FENCE_TIMEOUT_NS);
+    while (result == GL_TIMEOUT_EXPIRED) {
+        result = glClientWaitSync(fence, 0, PACER_FENCE_TIMEOUT_NS);
+    }
+    if (result == GL_WAIT_FAILED) LOG_WARN(GL) << "glClientWaitSync failed in the frame pacer";
+}
+
+void FramePacer::sleepUntil(Clock::time_point deadline) {
+    // Sleep in 1 ms requests while more time remains than a request is expected to take (mean + one
+    // standard deviation of past requests); OS timers overshoot by anything from microseconds to a few ms
+    for (;;) {
+        Clock::time_point now = Clock::now();
+        double remainingMs = elapsedMs(now, deadline);
+        double estimateMs = m_sleepMeanMs + (m_sleepSamples > 1 ? std::sqrt(m_sleepM2 / (m_sleepSamples - 1)) : 0.0);
+        if (remainingMs <= estimateMs) break;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        double observedMs = elapsedMs(now, Clock::now());
+        if (m_sleepSamples < PACER_SLEEP_SAMPLE_LIMIT) m_sleepSamples++;
+        double delta = observedMs - m_sleepMeanMs;
+        m_sleepMeanMs += delta / m_sleepSamples;
+        m_sleepM2 += delta * (observedMs - m_sleepMeanMs);
+        if (m_sleepSamples == PACER_SLEEP_SAMPLE_LIMIT) m_sleepM2 *= 1.0 - 1.0 / PACER_SLEEP_SAMPLE_LIMIT;
+    }
+    while (Clock::now() < deadline) std::this_thread::yield();
+}
@@ -0,0 +1,45 @@
+#include "Frustum.h"
+#include <cmath>
+
+Aabb Aabb::Transform(const Aabb& local, const glm::mat4& matrix) {
+    // Arvo: per output axis, the extremes come from picking min or max of each input axis by the sign of its weight
+    Aabb result;
+    for (int axis = 0; axis < 3; ++axis) {
+        result.min[axis] = result.max[axis] = matrix[3][axis];
+        for (int input = 0; input < 3; ++input) {
+            float a = matrix[input][axis] * local.min[input];
+            float b = matrix[input][axis] * local.max[input];
+            result.min[axis] += std::fmin(a, b);
+            result.max[axis] += std::fmax(a, b);
+        }
+    }
+    return result;
+}
+
+// Gribb-Hartmann: each plane is the last row of the matrix plus or minus one of the others
+Frustum::Frustum(const glm::mat4& viewProjection) {
+    glm::vec4 rows[4];
+    for (int i = 0; i < 4; ++i) rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+    m_planes[0] = rows[3] + rows[0]; // Left
+    m_planes[1] = rows[3] - rows[0]; // Right
+    m_planes[2] = rows[3] + rows[1]; // Bottom
+    m_planes[3] = rows[3] - rows[1]; // Top
+    m_planes[4] = rows[3] + rows[2]; // Near
+    m_planes[5] = rows[3] - rows[2]; // Far
+    for (glm::vec4& plane : m_planes) {
+        float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+        if (length > 0.0f) plane /= length;
+    }
+}
+
+Frustum::Result Frustum::Classify(const Aabb& box) const {
+    Result result = Result::INSIDE;
+    for (const glm::vec4& plane : m_planes) {
+        // Corner furthest along the plane normal, and the one opposite it
+        glm::vec3 positive(plane.x >= 0.0f ? box.max.x : box.min.x, plane.y >= 0.0f ? box.max.y : box.min.y, plane.z >= 0.0f ? box.max.z : box.min.z);
+        glm::vec3 negative(plane.x >= 0.0f ? box.min.x : box.max.x, plane.y >= 0.0f ? box.min.y : box.max.y, plane.z >= 0.0f ? box.min.z : box.max.z);
+        if (plane.x * positive.x + plane.y * positive.y + plane.z * positive.z + plane.w < 0.0f) return Result::OUTSIDE;
+        if (plane.x * negative.x + plane.y * negative.y + plane.z * negative.z + plane.w < 0.0f) result = Result::INTERSECTS;
+    }
+    return result;
+}
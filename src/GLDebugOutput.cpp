@@ -0,0 +1,76 @@
+#include "GLDebugOutput.h"
+#include "Log.h"
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Repeats of one message (source, type, id) logged before it is muted (a per-frame error would otherwise fill the log ring)
+static const int GL_DEBUG_REPEAT_LIMIT = 16;
+
+bool GLDebugOutput::s_active = false;
+
+static const char* sourceName(GLenum source) {
+    switch (source) {
+        case GL_DEBUG_SOURCE_API:             return "api";
+        case GL_DEBUG_SOURCE_WINDOW_SYSTEM:   return "window system";
+        case GL_DEBUG_SOURCE_SHADER_COMPILER: return "shader compiler";
+        case GL_DEBUG_SOURCE_THIRD_PARTY:     return "third party";
+        case GL_DEBUG_SOURCE_APPLICATION:     return "application";
+        default:                              return "other";
+    }
+}
+
+static const char* typeName(GLenum type) {
+    switch (type) {
+        case GL_DEBUG_TYPE_ERROR:               return "error";
+        case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: return "deprecated";
+        case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:  return "undefined behaviour";
+        case GL_DEBUG_TYPE_PORTABILITY:         return "portability";
+        case GL_DEBUG_TYPE_PERFORMANCE:         return "performance";
+        default:                                return "other";
+    }
+}
+
+bool GLDebugOutput::Enable() {
+    if (!GLEW_VERSION_4_3 && !GLEW_KHR_debug) {
+        LOG_INFO(GL) << "Debug output unavailable, GL errors checked by polling";
+        return false;
+    }
+
+    glEnable(GL_DEBUG_OUTPUT);
+    glDebugMessageCallback(callback, nullptr);
+    glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, nullptr, GL_FALSE);
+    s_active = true;
+
+    GLint flags = 0;
+    glGetIntegerv(GL_CONTEXT_FLAGS, &flags);
+    LOG_INFO(GL) << "Debug output enabled" << ((flags & GL_CONTEXT_FLAG_DEBUG_BIT) ? " (debug context)" : "");
+    return true;
+}
+
+void GLAPIENTRY GLDebugOutput::callback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length,
+                                        const GLchar* message, const void*) {
+    LogLevel level = severity == GL_DEBUG_SEVERITY_HIGH ? LogLevel::ERR
+                   : severity == GL_DEBUG_SEVERITY_MEDIUM ? LogLevel::WARN
+                   : LogLevel::INFO;
+    if (type == GL_DEBUG_TYPE_ERROR) level = LogLevel::ERR;
+    if (!Log::IsEnabled(LogCategory::GL, level)) return;
+
+    static std::mutex mutex;
+    static std::unordered_map<uint64_t, int> repeats;
+    // Ids are only unique per source and type; the debug source / type enums all fit in 16 bits
+    uint64_t key = (static_cast<uint64_t>(source & 0xFFFFu) << 48) | (static_cast<uint64_t>(type & 0xFFFFu) << 32) | id;
+    int count;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        count = ++repeats[key];
+    }
+    if (count > GL_DEBUG_REPEAT_LIMIT) return;
+
+    LogLine line(level, LogCategory::GL);
+    line << sourceName(source) << " " << typeName(type) << " 0x" << std::hex << id << std::dec << ": ";
+    if (length >= 0) line << std::string(message, static_cast<size_t>(length));
+    else line << message;
+    if (count == GL_DEBUG_REPEAT_LIMIT) line << " (repeated, further reports muted)";
+}
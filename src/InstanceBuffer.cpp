@@ -0,0 +1,125 @@
+#include "InstanceBuffer.h"
+#include "Log.h"
+#include "MemoryStats.h"
+
+// glClientWaitSync timeout per attempt (1 ms); the wait loops until the fence signals
+static const GLuint64 FENCE_WAIT_TIMEOUT_NS = 1000000;
+
+InstanceBuffer::~InstanceBuffer() {
+    Destroy();
+}
+
+bool InstanceBuffer::Create(size_t elementSize, size_t initialCapacity) {
+    Destroy();
+    m_elementSize = elementSize;
+    m_persistent = GLEW_ARB_buffer_storage || GLEW_VERSION_4_4;
+    if (!allocate(initialCapacity > 0 ? initialCapacity : 1)) return false;
+    LOG_INFO(RENDER) << "Instance buffer created (" << (m_persistent ? "persistent mapped, triple buffered" : "orphaning fallback")
+                     << ", " << m_capacity << " instances)";
+    return true;
+}
+
+void InstanceBuffer::Destroy() {
+    for (GLsync& fence : m_fences) {
+        if (fence) { glDeleteSync(fence); fence = nullptr; }
+    }
+    if (m_buffer != 0) {
+        if (m_mapped) {
+            glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            m_mapped = nullptr;
+        }
+        MemoryStats::UntrackBuffer(m_buffer);
+        glDeleteBuffers(1, &m_buffer);
+        m_buffer = 0;
+    }
+    m_capacity = 0;
+    m_region = 0;
+}
+
+bool InstanceBuffer::allocate(size_t capacity) {
+    glGenBuffers(1, &m_buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+    if (m_persistent) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        GLsizeiptr totalSize = static_cast<GLsizeiptr>(capacity * m_elementSize * INSTANCE_BUFFER_REGIONS);
+        glBufferStorage(GL_ARRAY_BUFFER, totalSize, nullptr, flags);
+        m_mapped = static_cast<unsigned char*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, totalSize, flags));
+        if (!m_mapped) {
+            LOG_ERROR(RENDER) << "Failed to persistently map instance buffer, falling back to orphaning.";
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            glDeleteBuffers(1, &m_buffer);
+            m_persistent = false;
+            return allocate(capacity);
+        }
+    } else {
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(capacity * m_elementSize), nullptr, GL_STREAM_DRAW);
+        m_staging.resize(capacity * m_elementSize);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    m_capacity = capacity;
+    MemoryStats::TrackBuffer(m_buffer, MemoryCategory::STREAMING_BUFFERS,
+                             capacity * m_elementSize * (m_persistent ? INSTANCE_BUFFER_REGIONS : 1));
+    return glGetError() == GL_NO_ERROR;
+}
+
+void InstanceBuffer::waitForRegion(int region) {
+    GLsync& fence = m_fences[region];
+    if (!fence) return;
+    GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_WAIT_TIMEOUT_NS);
+    while (result == GL_TIMEOUT_EXPIRED) {
+        result = glClientWaitSync(fence, 0, FENCE_WAIT_TIMEOUT_NS);
+    }
+    if (result == GL_WAIT_FAILED) LOG_WARN(RENDER) << "glClientWaitSync failed on instance buffer region " << region;
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+void* InstanceBuffer::BeginWrite(size_t count) {
+    if (!IsValid()) return nullptr;
+    if (count > m_capacity) {
+        size_t newCapacity = m_capacity;
+        while (newCapacity < count) newCapacity *= 2;
+        // The GPU may still read any region of the old buffer; let it finish before replacing storage
+        for (int i = 0; i < INSTANCE_BUFFER_REGIONS; ++i) waitForRegion(i);
+        bool persistent = m_persistent;
+        Destroy();
+        m_persistent = persistent;
+        if (!allocate(newCapacity)) return nullptr;
+        LOG_INFO(RENDER) << "Instance buffer grown to " << m_capacity << " instances";
+    }
+    m_writeCount = count;
+    if (m_persistent) {
+        waitForRegion(m_region);
+        return m_mapped + static_cast<size_t>(m_region) * m_capacity * m_elementSize;
+    }
+    return m_staging.data();
+}
+
+size_t InstanceBuffer::EndWrite() {
+    if (m_persistent) return static_cast<size_t>(m_region) * m_capacity * m_elementSize; // Coherent mapping, nothing to flush
+    glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(m_capacity * m_elementSize), nullptr, GL_STREAM_DRAW); // Orphan
+    if (m_writeCount > 0) glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(m_writeCount * m_elementSize), m_staging.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return 0;
+}
+
+void InstanceBuffer::EndFrame() {
+    if (!m_persistent) return;
+    if (m_fences[m_region]) glDeleteSync(m_fences[m_region]);
+    m_fences[m_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_region = (m_region + 1) % INSTANCE_BUFFER_REGIONS;
+}
+
+void InstanceBuffer::BindMat4Attribute(GLuint location, size_t byteOffset) const {
+    glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+    for (GLuint column = 0; column < 4; ++column) {
+        glEnableVertexAttribArray(location + column);
+        glVertexAttribPointer(location + column, 4, GL_FLOAT, GL_FALSE, static_cast<GLsizei>(m_elementSize),
+                              reinterpret_cast<void*>(byteOffset + column * 4 * sizeof(float)));
+        glVertexAttribDivisor(location + column, 1);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
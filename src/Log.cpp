@@ -0,0 +1,190 @@
+#include "Log.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// Lines the ring holds before producers start dropping (power of two)
+static const size_t LOG_RING_SLOTS = 4096;
+// How long the writer sleeps between batches when nothing urgent arrives
+static const std::chrono::milliseconds LOG_FLUSH_INTERVAL(5);
+
+std::atomic<uint8_t> Log::s_levels[static_cast<size_t>(LogCategory::COUNT)] = {
+    {static_cast<uint8_t>(LogLevel::INFO)}, {static_cast<uint8_t>(LogLevel::INFO)}, {static_cast<uint8_t>(LogLevel::INFO)},
+    {static_cast<uint8_t>(LogLevel::INFO)}, {static_cast<uint8_t>(LogLevel::INFO)}, {static_cast<uint8_t>(LogLevel::INFO)},
+    {static_cast<uint8_t>(LogLevel::INFO)},
+};
+
+namespace {
+
+struct LogSlot {
+    std::atomic<size_t> sequence{0};
+    LogLevel level = LogLevel::INFO;
+    LogCategory category = LogCategory::GENERAL;
+    uint16_t length = 0;
+    double time = 0.0;
+    char text[LOG_MESSAGE_BYTES];
+};
+
+// Bounded multi-producer ring (each slot carries a sequence number: a producer claims a slot whose sequence
+// equals its ticket, and the single consumer reads it once the producer has published ticket + 1),
+// plus the thread that drains it.
+class LogWriter {
+public:
+    LogWriter() : m_slots(new LogSlot[LOG_RING_SLOTS]), m_start(std::chrono::steady_clock::now()) {
+        for (size_t i = 0; i < LOG_RING_SLOTS; i++) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        m_thread = std::thread(&LogWriter::run, this);
+    }
+
+    ~LogWriter() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_one();
+        m_thread.join();
+        drain(); // Anything pushed while the thread was exiting
+    }
+
+    void Push(LogLevel level, LogCategory category, const char* text, size_t length) {
+        size_t ticket = m_enqueuePos.load(std::memory_order_relaxed);
+        LogSlot* slot = nullptr;
+        for (;;) {
+            slot = &m_slots[ticket & (LOG_RING_SLOTS - 1)];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(ticket);
+            if (diff == 0) {
+                if (m_enqueuePos.compare_exchange_weak(ticket, ticket + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed); // Full: the writer is a whole ring behind
+                return;
+            } else {
+                ticket = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->level = level;
+        slot->category = category;
+        slot->length = static_cast<uint16_t>(length < LOG_MESSAGE_BYTES ? length : LOG_MESSAGE_BYTES);
+        slot->time = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+        std::memcpy(slot->text, text, slot->length);
+        slot->sequence.store(ticket + 1, std::memory_order_release);
+
+        if (level >= LogLevel::ERR) m_wake.notify_one();
+    }
+
+    void Flush() {
+        size_t target = m_enqueuePos.load(std::memory_order_acquire);
+        if (std::this_thread::get_id() == m_thread.get_id()) return;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_flushRequested = true;
+        m_wake.notify_one();
+        m_flushed.wait(lock, [&]() { return m_stop || m_written.load(std::memory_order_acquire) >= target; });
+    }
+
+    uint64_t GetDropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_stop) {
+            m_flushRequested = false;
+            lock.unlock();
+            drain();
+            lock.lock();
+            m_flushed.notify_all();
+            m_wake.wait_for(lock, LOG_FLUSH_INTERVAL, [&]() { return m_stop || m_flushRequested; });
+        }
+    }
+
+    // Writes every published line in ticket order; stops at the first slot still being filled
+    void drain() {
+        bool wroteOut = false, wroteErr = false;
+        for (;;) {
+            LogSlot& slot = m_slots[m_dequeuePos & (LOG_RING_SLOTS - 1)];
+            if (slot.sequence.load(std::memory_order_acquire) != m_dequeuePos + 1) break;
+
+            FILE* stream = slot.level >= LogLevel::WARN ? stderr : stdout;
+            std::fprintf(stream, "[%9.3f] %-5s %-8s %.*s\n", slot.time, Log::GetLevelName(slot.level),
+                         Log::GetCategoryName(slot.category), static_cast<int>(slot.length), slot.text);
+            (stream == stderr ? wroteErr : wroteOut) = true;
+
+            slot.sequence.store(m_dequeuePos + LOG_RING_SLOTS, std::memory_order_release);
+            m_dequeuePos++;
+        }
+        if (wroteOut) std::fflush(stdout);
+        if (wroteErr) std::fflush(stderr);
+        m_written.store(m_dequeuePos, std::memory_order_release);
+    }
+
+    std::unique_ptr<LogSlot[]> m_slots;
+    std::chrono::steady_clock::time_point m_start;
+    std::atomic<size_t> m_enqueuePos{0};
+    size_t m_dequeuePos = 0; // Writer thread only
+    std::atomic<size_t> m_written{0};
+    std::atomic<uint64_t> m_dropped{0};
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_flushed;
+    bool m_stop = false;
+    bool m_flushRequested = false;
+    std::thread m_thread;
+};
+
+LogWriter& getWriter() {
+    static LogWriter writer;
+    return writer;
+}
+
+} // namespace
+
+void Log::SetLevel(LogCategory category, LogLevel level) {
+    s_levels[static_cast<size_t>(category)].store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+}
+
+LogLevel Log::GetLevel(LogCategory category) {
+    return static_cast<LogLevel>(s_levels[static_cast<size_t>(category)].load(std::memory_order_relaxed));
+}
+
+void Log::Write(LogLevel level, LogCategory category, const char* text, size_t length) {
+    getWriter().Push(level, category, text, length);
+}
+
+void Log::Flush() {
+    getWriter().Flush();
+}
+
+uint64_t Log::GetDroppedCount() {
+    return getWriter().GetDropped();
+}
+
+const char* Log::GetLevelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::VERBOSE: return "VERB";
+        case LogLevel::INFO:    return "INFO";
+        case LogLevel::WARN:    return "WARN";
+        case LogLevel::ERR:     return "ERROR";
+        case LogLevel::OFF:     return "OFF";
+    }
+    return "?";
+}
+
+const char* Log::GetCategoryName(LogCategory category) {
+    switch (category) {
+        case LogCategory::GENERAL:  return "general";
+        case LogCategory::RENDER:   return "render";
+        case LogCategory::GL:       return "gl";
+        case LogCategory::SHADER:   return "shader";
+        case LogCategory::ASSETS:   return "assets";
+        case LogCategory::TEXTURES: return "textures";
+        case LogCategory::PHYSICS:  return "physics";
+        case LogCategory::COUNT:    break;
+    }
+    return "?";
+}
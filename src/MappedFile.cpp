@@ -0,0 +1,89 @@
+#include "MappedFile.h"
+#include <atomic>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+#ifdef _WIN32
+bool MappedFile::Open(const std::filesystem::path& path) {
+    Close();
+    HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) { CloseHandle(file); return false; }
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) { CloseHandle(file); return false; }
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) { CloseHandle(mapping); CloseHandle(file); return false; }
+    m_fileHandle = file;
+    m_mappingHandle = mapping;
+    m_data = static_cast<const unsigned char*>(view);
+    m_size = static_cast<size_t>(size.QuadPart);
+    return true;
+}
+
+void MappedFile::Close() {
+    if (m_data) UnmapViewOfFile(m_data);
+    if (m_mappingHandle) CloseHandle(static_cast<HANDLE>(m_mappingHandle));
+    if (m_fileHandle) CloseHandle(static_cast<HANDLE>(m_fileHandle));
+    m_data = nullptr; m_size = 0;
+    m_mappingHandle = nullptr; m_fileHandle = nullptr;
+}
+
+void MappedFile::Prefetch() const {
+    if (!m_data) return;
+    WIN32_MEMORY_RANGE_ENTRY range = { const_cast<unsigned char*>(m_data), m_size };
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+}
+#else
+bool MappedFile::Open(const std::filesystem::path& path) {
+    Close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) { ::close(fd); return false; }
+    void* data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) { ::close(fd); return false; }
+    m_fd = fd;
+    m_data = static_cast<const unsigned char*>(data);
+    m_size = static_cast<size_t>(st.st_size);
+    return true;
+}
+
+void MappedFile::Close() {
+    if (m_data) munmap(const_cast<unsigned char*>(m_data), m_size);
+    if (m_fd >= 0) ::close(m_fd);
+    m_data = nullptr; m_size = 0; m_fd = -1;
+}
+
+void MappedFile::Prefetch() const {
+    if (m_data) madvise(const_cast<unsigned char*>(m_data), m_size, MADV_WILLNEED);
+}
+#endif
+
+std::filesystem::path MakeTempPath(const std::filesystem::path& target) {
+    static std::atomic<unsigned long long> counter{ 0 };
+#ifdef _WIN32
+    unsigned long long pid = GetCurrentProcessId();
+#else
+    unsigned long long pid = static_cast<unsigned long long>(getpid());
+#endif
+    std::filesystem::path temp = target;
+    temp += "." + std::to_string(pid) + "." + std::to_string(counter.fetch_add(1, std::memory_order_relaxed)) + ".tmp";
+    return temp;
+}
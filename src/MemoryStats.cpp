@@ -0,0 +1,112 @@
+#include "MemoryStats.h"
+#include <mutex>
+#include <unordered_map>
+
+std::atomic<size_t> MemoryStats::s_bytes[static_cast<size_t>(MemoryCategory::COUNT)] = {};
+std::atomic<size_t> MemoryStats::s_objects[static_cast<size_t>(MemoryCategory::COUNT)] = {};
+
+namespace {
+
+struct TrackedObject {
+    MemoryCategory category;
+    size_t bytes;
+};
+
+// Buffer and texture names come from separate GL namespaces, so each gets its own table
+struct ObjectTable {
+    std::mutex mutex;
+    std::unordered_map<GLuint, TrackedObject> objects;
+};
+
+ObjectTable& bufferTable() {
+    static ObjectTable table;
+    return table;
+}
+
+ObjectTable& textureTable() {
+    static ObjectTable table;
+    return table;
+}
+
+std::atomic<size_t>& slot(std::atomic<size_t>* counters, MemoryCategory category) {
+    return counters[static_cast<size_t>(category)];
+}
+
+void track(ObjectTable& table, std::atomic<size_t>* bytes, std::atomic<size_t>* objects, GLuint name,
+           MemoryCategory category, size_t size) {
+    if (name == 0) return;
+    std::lock_guard<std::mutex> lock(table.mutex);
+    auto inserted = table.objects.emplace(name, TrackedObject{ category, size });
+    if (!inserted.second) {
+        TrackedObject& old = inserted.first->second;
+        slot(bytes, old.category).fetch_sub(old.bytes, std::memory_order_relaxed);
+        slot(objects, old.category).fetch_sub(1, std::memory_order_relaxed);
+        old = TrackedObject{ category, size };
+    }
+    slot(bytes, category).fetch_add(size, std::memory_order_relaxed);
+    slot(objects, category).fetch_add(1, std::memory_order_relaxed);
+}
+
+void untrack(ObjectTable& table, std::atomic<size_t>* bytes, std::atomic<size_t>* objects, GLuint name) {
+    if (name == 0) return;
+    std::lock_guard<std::mutex> lock(table.mutex);
+    auto it = table.objects.find(name);
+    if (it == table.objects.end()) return;
+    slot(bytes, it->second.category).fetch_sub(it->second.bytes, std::memory_order_relaxed);
+    slot(objects, it->second.category).fetch_sub(1, std::memory_order_relaxed);
+    table.objects.erase(it);
+}
+
+} // namespace
+
+void MemoryStats::TrackBuffer(GLuint buffer, MemoryCategory category, size_t bytes) {
+    track(bufferTable(), s_bytes, s_objects, buffer, category, bytes);
+}
+
+void MemoryStats::UntrackBuffer(GLuint buffer) {
+    untrack(bufferTable(), s_bytes, s_objects, buffer);
+}
+
+void MemoryStats::TrackTexture(GLuint texture, MemoryCategory category, size_t bytes) {
+    track(textureTable(), s_bytes, s_objects, texture, category, bytes);
+}
+
+void MemoryStats::UntrackTexture(GLuint texture) {
+    untrack(textureTable(), s_bytes, s_objects, texture);
+}
+
+void MemoryStats::AddCpuBytes(MemoryCategory category, size_t bytes) {
+    slot(s_bytes, category).fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void MemoryStats::RemoveCpuBytes(MemoryCategory category, size_t bytes) {
+    slot(s_bytes, category).fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+size_t MemoryStats::GetGpuTotal() {
+    size_t total = 0;
+    for (size_t i = 0; i < static_cast<size_t>(MemoryCategory::MESH_CPU); ++i) total += s_bytes[i].load(std::memory_order_relaxed);
+    return total;
+}
+
+size_t MemoryStats::GetCpuTotal() {
+    size_t total = 0;
+    for (size_t i = static_cast<size_t>(MemoryCategory::MESH_CPU); i < static_cast<size_t>(MemoryCategory::COUNT); ++i) {
+        total += s_bytes[i].load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+const char* MemoryStats::GetCategoryName(MemoryCategory category) {
+    switch (category) {
+        case MemoryCategory::MESH_BUFFERS:      return "Mesh buffers";
+        case MemoryCategory::STREAMING_BUFFERS: return "Streaming buffers";
+        case MemoryCategory::TEXTURES:          return "Textures";
+        case MemoryCategory::RENDER_TARGETS:    return "Render targets";
+        case MemoryCategory::ENVIRONMENT:       return "Terrain / clouds";
+        case MemoryCategory::MESH_CPU:          return "Mesh data (CPU)";
+        case MemoryCategory::TEXTURE_CPU:       return "Texture data (CPU)";
+        case MemoryCategory::COUNT:             break;
+    }
+    return "?";
+}
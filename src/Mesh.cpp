@@ -1,36 +1,217 @@
 #include "Mesh.h" // Include the header file for the Mesh class definition
+#include "MeshPool.h"
+#include "Log.h"
+#include "MemoryStats.h"
 #include <GL/glew.h>
 // #include <GLFW/glfw3.h> // Not usually needed in Mesh.cpp
 #include <glm/glm.hpp>
 // #include <glm/gtc/matrix_transform.hpp> // Not used here
 #include <vector>   // Included via Mesh.h, but good to be explicit if needed elsewhere
-#include <cstddef>  // Required for offsetof macro
-#include <iostream> // For std::cout in cleanupMesh
+#include <cstddef>
+#include <cstring>  // std::memcpy
+#include <cmath>    // std::abs
+#include <glm/gtc/packing.hpp> // packSnorm3x10_1x2, packUnorm4x8
+#include <algorithm> // std::min
+#include <utility>  // std::move
+
+// Beyond this UV magnitude half floats lose too much precision; such meshes keep float UVs
+static const float HALF_TEXCOORD_LIMIT = 2.0f;
+
+// Generic attribute locations shared with the raster shaders
+static const GLuint POSITION_ATTRIBUTE = 0;
+static const GLuint COLOR_ATTRIBUTE = 1;
+static const GLuint TEXCOORD_ATTRIBUTE = 2;
+static const GLuint NORMAL_ATTRIBUTE = 3;
+
+// --- VertexLayout ---
+
+VertexLayout VertexLayout::Full() {
+    VertexLayout layout;
+    layout.normals = Normals::FLOAT3;
+    layout.texCoords = TexCoords::FLOAT2;
+    layout.color = true;
+    return layout;
+}
+
+VertexLayout VertexLayout::Choose(const std::vector<Vertex>& vertices, bool keepColor) {
+    VertexLayout layout;
+    layout.color = keepColor;
+    for (const Vertex& vertex : vertices) {
+        if (std::abs(vertex.TexCoords.x) > HALF_TEXCOORD_LIMIT || std::abs(vertex.TexCoords.y) > HALF_TEXCOORD_LIMIT) {
+            layout.texCoords = TexCoords::FLOAT2;
+            break;
+        }
+    }
+    return layout;
+}
+
+// Attributes follow the position in a fixed order: normal, texcoords, color (each a multiple of 4 bytes)
+size_t VertexLayout::GetNormalOffset() const { return sizeof(glm::vec3); }
+
+size_t VertexLayout::GetTexCoordOffset() const {
+    switch (normals) {
+        case Normals::FLOAT3:            return GetNormalOffset() + sizeof(glm::vec3);
+        case Normals::PACKED_10_10_10_2: return GetNormalOffset() + sizeof(uint32_t);
+        default:                         return GetNormalOffset();
+    }
+}
+
+size_t VertexLayout::GetColorOffset() const {
+    return GetTexCoordOffset() + (texCoords == TexCoords::HALF2 ? sizeof(uint32_t) : sizeof(glm::vec2));
+}
+
+size_t VertexLayout::GetStride() const { return GetColorOffset() + (color ? sizeof(uint32_t) : 0); }
+
+uint32_t VertexLayout::Encode() const {
+    return static_cast<uint32_t>(normals) | (static_cast<uint32_t>(texCoords) << 4) | (color ? 1u << 8 : 0u);
+}
+
+bool VertexLayout::Decode(uint32_t code, VertexLayout& layout) {
+    uint32_t normalBits = code & 0xF, texCoordBits = (code >> 4) & 0xF;
+    if (normalBits > static_cast<uint32_t>(Normals::PACKED_10_10_10_2) || texCoordBits > static_cast<uint32_t>(TexCoords::HALF2) ||
+        (code >> 9) != 0) return false;
+    layout.normals = static_cast<Normals>(normalBits);
+    layout.texCoords = static_cast<TexCoords>(texCoordBits);
+    layout.color = (code & (1u << 8)) != 0;
+    return true;
+}
+
+void VertexLayout::PackVertices(const Vertex* vertices, size_t count, unsigned char* out) const {
+    const size_t stride = GetStride(), normalOffset = GetNormalOffset(), texCoordOffset = GetTexCoordOffset(), colorOffset = GetColorOffset();
+    for (size_t i = 0; i < count; ++i, out += stride) {
+        const Vertex& vertex = vertices[i];
+        std::memcpy(out, &vertex.Position, sizeof(glm::vec3));
+        if (normals == Normals::FLOAT3) {
+            std::memcpy(out + normalOffset, &vertex.Normal, sizeof(glm::vec3));
+        } else if (normals == Normals::PACKED_10_10_10_2) {
+            uint32_t packed = glm::packSnorm3x10_1x2(glm::vec4(vertex.Normal, 0.0f)); // x in the low bits, as GL_INT_2_10_10_10_REV expects
+            std::memcpy(out + normalOffset, &packed, sizeof(packed));
+        }
+        if (texCoords == TexCoords::HALF2) {
+            uint32_t packed = glm::packHalf2x16(vertex.TexCoords);
+            std::memcpy(out + texCoordOffset, &packed, sizeof(packed));
+        } else {
+            std::memcpy(out + texCoordOffset, &vertex.TexCoords, sizeof(glm::vec2));
+        }
+        if (color) {
+            uint32_t packed = glm::packUnorm4x8(glm::vec4(vertex.Color, 1.0f));
+            std::memcpy(out + colorOffset, &packed, sizeof(packed));
+        }
+    }
+}
+
+void VertexLayout::Apply() const {
+    const GLsizei stride = static_cast<GLsizei>(GetStride());
+    glEnableVertexAttribArray(POSITION_ATTRIBUTE);
+    glVertexAttribPointer(POSITION_ATTRIBUTE, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+
+    if (normals == Normals::NONE) {
+        glDisableVertexAttribArray(NORMAL_ATTRIBUTE);
+    } else {
+        glEnableVertexAttribArray(NORMAL_ATTRIBUTE);
+        if (normals == Normals::FLOAT3) glVertexAttribPointer(NORMAL_ATTRIBUTE, 3, GL_FLOAT, GL_FALSE, stride, (void*)GetNormalOffset());
+        else glVertexAttribPointer(NORMAL_ATTRIBUTE, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, (void*)GetNormalOffset());
+    }
+
+    glEnableVertexAttribArray(TEXCOORD_ATTRIBUTE);
+    glVertexAttribPointer(TEXCOORD_ATTRIBUTE, 2, texCoords == TexCoords::HALF2 ? GL_HALF_FLOAT : GL_FLOAT, GL_FALSE, stride, (void*)GetTexCoordOffset());
+
+    if (color) {
+        glEnableVertexAttribArray(COLOR_ATTRIBUTE);
+        glVertexAttribPointer(COLOR_ATTRIBUTE, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (void*)GetColorOffset());
+    } else {
+        glDisableVertexAttribArray(COLOR_ATTRIBUTE);
+    }
+}
+
+void VertexLayout::ApplyConstants() const {
+    if (!color) glVertexAttrib4f(COLOR_ATTRIBUTE, 1.0f, 1.0f, 1.0f, 1.0f);
+    if (normals == Normals::NONE) glVertexAttrib4f(NORMAL_ATTRIBUTE, 0.0f, 1.0f, 0.0f, 0.0f);
+}
+
+// --- MeshData ---
+
+void MeshData::Pack(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, const VertexLayout& packLayout) {
+    layout = packLayout;
+    vertexCount = vertices.size();
+    indexCount = indices.size();
+    indexType = IndexTypeForVertexCount(vertexCount);
+    vertexBytes.resize(GetVertexByteSize());
+    layout.PackVertices(vertices.data(), vertexCount, vertexBytes.data());
+    indexBytes.resize(GetIndexByteSize());
+    if (indexType == GL_UNSIGNED_SHORT) {
+        uint16_t* out = reinterpret_cast<uint16_t*>(indexBytes.data());
+        for (unsigned int index : indices) *out++ = static_cast<uint16_t>(index);
+    } else if (!indices.empty()) {
+        std::memcpy(indexBytes.data(), indices.data(), indexBytes.size());
+    }
+    mappedVertices = nullptr;
+    mappedIndices = nullptr;
+
+    MeshLod all;
+    all.indexCount = static_cast<uint32_t>(indexCount);
+    lods.assign(1, all);
+
+    // Sphere around the box center: not the tightest, but cheap and stable for distance tests
+    glm::vec3 minimum(0.0f), maximum(0.0f);
+    if (!vertices.empty()) { minimum = maximum = vertices[0].Position; }
+    for (const Vertex& vertex : vertices) { minimum = glm::min(minimum, vertex.Position); maximum = glm::max(maximum, vertex.Position); }
+    boundsCenter = (minimum + maximum) * 0.5f;
+    boundsRadius = 0.0f;
+    for (const Vertex& vertex : vertices) boundsRadius = std::max(boundsRadius, glm::length(vertex.Position - boundsCenter));
+}
 
 // --- Constructor ---
 // Uses member initializer list for efficiency.
-// The assignments in the body were redundant and potentially less efficient.
-Mesh::Mesh(const std::vector<Vertex>& verticesArg, const std::vector<unsigned int>& indicesArg)
+// The authored data stays in the public vectors; the GPU gets the packed copy.
+Mesh::Mesh(const std::vector<Vertex>& verticesArg, const std::vector<unsigned int>& indicesArg, const VertexLayout& layout)
     : vertices(verticesArg), indices(indicesArg), VAO(0), VBO(0), EBO(0) // Initialize buffer IDs to 0
 {
-    // Initializer list handles copying:
-    // this->vertices = verticesArg; // Redundant, handled by initializer list
-    // this->indices = indicesArg;  // Redundant, handled by initializer list
-
+    m_data.Pack(vertices, indices, layout);
     // Now setup the OpenGL buffers
     setupMesh();
-    std::cout << "Mesh created and setup." << std::endl; // Debug message
+    updateCpuBytes();
+    LOG_VERBOSE(ASSETS) << "Mesh created and setup."; // Debug message
+}
+
+// --- Streamed-upload Constructor ---
+// Moves the packed data in (no copy of large imported meshes) and allocates the GPU buffers without filling them.
+// Mapped data is uploaded straight from caller-owned memory.
+Mesh::Mesh(MeshData&& data, bool deferUpload, MeshPool* pool)
+    : VAO(0), VBO(0), EBO(0), m_data(std::move(data))
+{
+    MeshAllocation allocation;
+    if (pool && m_data.vertexCount > 0 && m_data.indexCount > 0 &&
+        pool->Allocate(m_data.layout, m_data.indexType, m_data.vertexCount, m_data.indexCount, allocation)) {
+        m_pool = pool;
+        m_allocation = std::make_unique<MeshAllocation>(allocation);
+        m_baseVertex = static_cast<int32_t>(allocation.firstVertex);
+        m_poolFirstIndex = static_cast<uint32_t>(allocation.firstIndex);
+        VAO = pool->GetVAO(allocation);
+        if (!deferUpload) {
+            pool->UploadVertices(allocation, 0, m_data.GetVertexBytes(), m_data.GetVertexByteSize());
+            pool->UploadIndices(allocation, 0, m_data.GetIndexBytes(), m_data.GetIndexByteSize());
+            m_uploadedVertexBytes = m_data.GetVertexByteSize();
+            m_uploadedIndexBytes = m_data.GetIndexByteSize();
+            m_uploaded = true;
+        }
+        updateCpuBytes();
+        return;
+    }
+    setupMesh(!deferUpload);
+    updateCpuBytes();
 }
 
 // --- Destructor Implementation (ADDED) ---
 Mesh::~Mesh() {
-    std::cout << "Mesh destructor called." << std::endl; // Debug message
+    LOG_VERBOSE(ASSETS) << "Mesh destructor called."; // Debug message
     cleanupMesh(); // Call helper to delete buffers
+    MemoryStats::RemoveCpuBytes(MemoryCategory::MESH_CPU, m_cpuBytes);
 }
 
 // --- setupMesh Implementation ---
 // Initializes VAO, VBO, EBO, and sets up vertex attribute pointers
-void Mesh::setupMesh() {
+void Mesh::setupMesh(bool uploadData) {
     // 1. Create buffers/arrays
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
@@ -41,58 +222,148 @@ void Mesh::setupMesh() {
     glBindVertexArray(VAO);
 
     // 3. Load data into vertex buffer (VBO)
+    const size_t vertexBytes = m_data.GetVertexByteSize();
+    const size_t indexBytes = m_data.GetIndexByteSize();
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW); // Use .data()
+    glBufferData(GL_ARRAY_BUFFER, vertexBytes, uploadData ? m_data.GetVertexBytes() : nullptr, GL_STATIC_DRAW);
 
     // 4. Load data into element buffer (EBO)
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW); // Use .data()
-
-    // 5. Set the vertex attribute pointers
-    // Vertex Positions (location = 0)
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Position)); // Use offsetof for safety
-
-    // Vertex Colors (location = 1)
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Color));
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexBytes, uploadData ? m_data.GetIndexBytes() : nullptr, GL_STATIC_DRAW);
 
-    // Vertex Texture Coords (location = 2)
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
+    // 5. Set the vertex attribute pointers for this mesh's layout
+    m_data.layout.Apply();
 
     // 6. Unbind VAO (important!) - Unbinds VBO and EBO bindings associated with this VAO state
     glBindVertexArray(0);
     // Optional: Unbind buffers explicitly if needed elsewhere, but VAO unbind is key here
     // glBindBuffer(GL_ARRAY_BUFFER, 0);
     // glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0); // Don't unbind EBO while VAO is bound
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    MemoryStats::TrackBuffer(VBO, MemoryCategory::MESH_BUFFERS, vertexBytes);
+    MemoryStats::TrackBuffer(EBO, MemoryCategory::MESH_BUFFERS, indexBytes);
+
+    if (uploadData) {
+        m_uploadedVertexBytes = vertexBytes;
+        m_uploadedIndexBytes = indexBytes;
+        m_uploaded = true;
+    }
+}
+
+// --- UploadChunk Implementation ---
+// Copies the next slice of vertex data, then index data, with glBufferSubData
+bool Mesh::UploadChunk(size_t maxBytes) {
+    if (m_uploaded) return true;
+    const size_t vertexBytes = m_data.GetVertexByteSize();
+    const size_t indexBytes = m_data.GetIndexByteSize();
+
+    if (m_uploadedVertexBytes < vertexBytes && maxBytes > 0) {
+        size_t count = std::min(maxBytes, vertexBytes - m_uploadedVertexBytes);
+        if (m_pool) {
+            m_pool->UploadVertices(*m_allocation, m_uploadedVertexBytes, m_data.GetVertexBytes() + m_uploadedVertexBytes, count);
+        } else {
+            glBindBuffer(GL_ARRAY_BUFFER, VBO);
+            glBufferSubData(GL_ARRAY_BUFFER, m_uploadedVertexBytes, count, m_data.GetVertexBytes() + m_uploadedVertexBytes);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+        m_uploadedVertexBytes += count;
+        maxBytes -= count;
+    }
+    if (m_uploadedIndexBytes < indexBytes && maxBytes > 0) {
+        size_t count = std::min(maxBytes, indexBytes - m_uploadedIndexBytes);
+        if (m_pool) {
+            m_pool->UploadIndices(*m_allocation, m_uploadedIndexBytes, m_data.GetIndexBytes() + m_uploadedIndexBytes, count);
+        } else {
+            // The EBO binding is VAO state, so bind it through the VAO
+            glBindVertexArray(VAO);
+            glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, m_uploadedIndexBytes, count, m_data.GetIndexBytes() + m_uploadedIndexBytes);
+            glBindVertexArray(0);
+        }
+        m_uploadedIndexBytes += count;
+    }
+    m_uploaded = (m_uploadedVertexBytes == vertexBytes && m_uploadedIndexBytes == indexBytes);
+    if (m_uploaded && m_releaseCpuData) releaseCpuData();
+    return m_uploaded;
+}
+
+// --- CPU Data Release ---
+
+void Mesh::SetReleaseCpuDataAfterUpload(bool release) {
+    m_releaseCpuData = release;
+    if (release && m_uploaded) releaseCpuData();
+}
+
+// Counts, LODs, bounds and layout stay: they describe the GPU copy
+void Mesh::releaseCpuData() {
+    std::vector<Vertex>().swap(vertices);
+    std::vector<unsigned int>().swap(indices);
+    std::vector<unsigned char>().swap(m_data.vertexBytes);
+    std::vector<unsigned char>().swap(m_data.indexBytes);
+    // A mapped source may already be unmapped once the upload is done
+    m_data.mappedVertices = nullptr;
+    m_data.mappedIndices = nullptr;
+    updateCpuBytes();
+}
+
+void Mesh::updateCpuBytes() {
+    size_t bytes = vertices.capacity() * sizeof(Vertex) + indices.capacity() * sizeof(unsigned int) +
+                   m_data.vertexBytes.capacity() + m_data.indexBytes.capacity();
+    if (bytes > m_cpuBytes) MemoryStats::AddCpuBytes(MemoryCategory::MESH_CPU, bytes - m_cpuBytes);
+    else MemoryStats::RemoveCpuBytes(MemoryCategory::MESH_CPU, m_cpuBytes - bytes);
+    m_cpuBytes = bytes;
 }
 
 // --- Draw Implementation ---
 // Binds VAO and calls glDrawElements
-void Mesh::Draw() {
+void Mesh::Draw(size_t lod) {
+    if (!m_uploaded || lod >= m_data.lods.size()) return;
+    const MeshLod& range = m_data.lods[lod];
+
     // Bind the VAO containing all the buffer configuration
     glBindVertexArray(VAO);
+    m_data.layout.ApplyConstants();
 
     // Draw the mesh using indices
     // The EBO binding is remembered by the VAO
-    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, 0); // Cast size for safety
+    glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(range.indexCount), m_data.indexType,
+                             (void*)(static_cast<size_t>(range.firstIndex + m_poolFirstIndex) * IndexSize(m_data.indexType)), m_baseVertex);
 
     // Unbind the VAO (good practice, prevents accidental modification)
     glBindVertexArray(0);
 }
 
 
+// --- SelectLod Implementation ---
+// Projects each LOD's object-space error onto the screen at the distance of the nearest bounds point
+size_t Mesh::SelectLod(float distance, float pixelsPerUnit, float maxErrorPixels) const {
+    float surfaceDistance = std::max(distance - m_data.boundsRadius, 0.1f);
+    size_t selected = 0;
+    for (size_t i = 1; i < m_data.lods.size(); ++i) {
+        if (m_data.lods[i].error * pixelsPerUnit / surfaceDistance > maxErrorPixels) break;
+        selected = i;
+    }
+    return selected;
+}
+
 // --- Cleanup Implementation (ADDED) ---
 // Helper function to delete OpenGL buffers
 void Mesh::cleanupMesh() {
-    std::cout << "Cleaning up mesh buffers (VAO: " << VAO << ", VBO: " << VBO << ", EBO: " << EBO << ")" << std::endl;
+    if (m_pool) {
+        // Shared VAO and buffers stay; only the ranges go back to the pool
+        m_pool->Free(*m_allocation);
+        m_pool = nullptr;
+        VAO = 0;
+        return;
+    }
+    LOG_VERBOSE(ASSETS) << "Cleaning up mesh buffers (VAO: " << VAO << ", VBO: " << VBO << ", EBO: " << EBO << ")";
     // Check if buffers/arrays were generated (IDs > 0) before deleting
     if (EBO != 0) {
+        MemoryStats::UntrackBuffer(EBO);
         glDeleteBuffers(1, &EBO);
         EBO = 0; // Reset ID after deletion
     }
     if (VBO != 0) {
+        MemoryStats::UntrackBuffer(VBO);
         glDeleteBuffers(1, &VBO);
         VBO = 0; // Reset ID after deletion
     }
@@ -100,5 +371,5 @@ void Mesh::cleanupMesh() {
         glDeleteVertexArrays(1, &VAO);
         VAO = 0; // Reset ID after deletion
     }
-    std::cout << "Mesh buffers cleanup finished." << std::endl;
+    LOG_VERBOSE(ASSETS) << "Mesh buffers cleanup finished.";
 }
\ No newline at end of file
@@ -0,0 +1,227 @@
+#include "MeshCache.h"
+#include "Log.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+static const char COOKED_MESH_MAGIC[4] = { 'M', 'S', 'H', 'C' };
+static const uint64_t COOKED_MESH_ALIGNMENT = 16;
+static const size_t COOKED_MESH_NAME_LENGTH = 64;
+
+struct CookedMeshHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t meshCount;
+    uint32_t reserved;
+    uint64_t sourceSize;
+    int64_t sourceMtime;   // file_time_type ticks of the source at cook time
+};
+
+struct CookedMeshLod {
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    float error;
+};
+
+struct CookedMeshEntry {
+    uint64_t vertexOffset; // Byte offsets from the start of the file
+    uint64_t vertexCount;
+    uint64_t indexOffset;
+    uint64_t indexCount;
+    uint32_t vertexLayout; // VertexLayout::Encode()
+    uint32_t indexSize;    // 2 or 4 bytes
+    float boundsCenter[3];
+    float boundsRadius;
+    uint32_t lodCount;     // 1..MAX_MESH_LODS
+    CookedMeshLod lods[MAX_MESH_LODS];
+    char name[COOKED_MESH_NAME_LENGTH];
+};
+
+static uint64_t alignUp(uint64_t value) {
+    return (value + COOKED_MESH_ALIGNMENT - 1) & ~(COOKED_MESH_ALIGNMENT - 1);
+}
+
+// FNV-1a, 64 bit
+static uint64_t hashString(const std::string& text) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : text) { hash ^= c; hash *= 1099511628211ull; }
+    return hash;
+}
+
+// True when every index names one of the mesh's vertices (the GPU would otherwise read past the
+// vertex range). One pass over the mapped indices, which the upload reads anyway.
+template <typename Index>
+static bool indicesInRange(const unsigned char* bytes, uint64_t indexCount, uint64_t vertexCount) {
+    const Index* indices = reinterpret_cast<const Index*>(bytes); // Caller checked the alignment
+    Index maxIndex = 0;
+    for (uint64_t i = 0; i < indexCount; ++i) maxIndex = std::max(maxIndex, indices[i]);
+    return indexCount == 0 || maxIndex < vertexCount;
+}
+
+static bool getSourceStamp(const std::string& sourcePath, uint64_t& size, int64_t& mtime) {
+    std::error_code ec;
+    size = static_cast<uint64_t>(std::filesystem::file_size(sourcePath, ec));
+    if (ec) return false;
+    auto time = std::filesystem::last_write_time(sourcePath, ec);
+    if (ec) return false;
+    mtime = static_cast<int64_t>(time.time_since_epoch().count());
+    return true;
+}
+
+MeshCache::MeshCache(std::filesystem::path cacheDirectory) : m_directory(std::move(cacheDirectory)) {}
+
+std::filesystem::path MeshCache::GetCachePath(const std::string& sourcePath) const {
+    std::error_code ec;
+    std::filesystem::path absolute = std::filesystem::absolute(sourcePath, ec);
+    std::string key = ec ? sourcePath : absolute.lexically_normal().string();
+    std::ostringstream name;
+    name << std::filesystem::path(sourcePath).stem().string() << "_" << std::hex << std::setw(16) << std::setfill('0')
+         << hashString(key) << ".meshbin";
+    return m_directory / name.str();
+}
+
+bool MeshCache::Load(const std::string& sourcePath, std::shared_ptr<MappedFile>& mapping, std::vector<MeshData>& meshes) const {
+    uint64_t sourceSize = 0; int64_t sourceMtime = 0;
+    if (!getSourceStamp(sourcePath, sourceSize, sourceMtime)) return false;
+
+    auto file = std::make_shared<MappedFile>();
+    if (!file->Open(GetCachePath(sourcePath))) return false;
+    if (file->GetSize() < sizeof(CookedMeshHeader)) return false;
+
+    CookedMeshHeader header;
+    std::memcpy(&header, file->GetData(), sizeof(header));
+    if (std::memcmp(header.magic, COOKED_MESH_MAGIC, sizeof(COOKED_MESH_MAGIC)) != 0 || header.version != VERSION ||
+        header.sourceSize != sourceSize || header.sourceMtime != sourceMtime) {
+        return false; // Stale or foreign file; the caller re-cooks it
+    }
+    uint64_t entriesEnd = sizeof(CookedMeshHeader) + static_cast<uint64_t>(header.meshCount) * sizeof(CookedMeshEntry);
+    if (entriesEnd > file->GetSize()) return false;
+
+    const CookedMeshEntry* entries = reinterpret_cast<const CookedMeshEntry*>(file->GetData() + sizeof(CookedMeshHeader));
+    std::vector<MeshData> result(header.meshCount);
+    for (uint32_t i = 0; i < header.meshCount; ++i) {
+        const CookedMeshEntry& entry = entries[i];
+        MeshData& data = result[i];
+        if (!VertexLayout::Decode(entry.vertexLayout, data.layout) || (entry.indexSize != 2 && entry.indexSize != 4)) {
+            LOG_ERROR(ASSETS) << "Mesh cache: unknown vertex layout in " << sourcePath;
+            return false;
+        }
+        data.indexType = entry.indexSize == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        if (entry.lodCount == 0 || entry.lodCount > MAX_MESH_LODS) {
+            LOG_ERROR(ASSETS) << "Mesh cache: bad LOD table in " << sourcePath;
+            return false;
+        }
+        for (uint32_t l = 0; l < entry.lodCount; ++l) {
+            const CookedMeshLod& lod = entry.lods[l];
+            if (static_cast<uint64_t>(lod.firstIndex) + lod.indexCount > entry.indexCount) {
+                LOG_ERROR(ASSETS) << "Mesh cache: bad LOD table in " << sourcePath;
+                return false;
+            }
+            MeshLod range;
+            range.firstIndex = lod.firstIndex;
+            range.indexCount = lod.indexCount;
+            range.error = lod.error;
+            data.lods.push_back(range);
+        }
+        data.boundsCenter = glm::vec3(entry.boundsCenter[0], entry.boundsCenter[1], entry.boundsCenter[2]);
+        data.boundsRadius = entry.boundsRadius;
+        // Offsets first, then counts against the room left, so a corrupt entry can't wrap the arithmetic
+        uint64_t fileSize = file->GetSize();
+        if (entry.vertexOffset > fileSize || entry.indexOffset > fileSize ||
+            entry.vertexCount > (fileSize - entry.vertexOffset) / data.layout.GetStride() ||
+            entry.indexCount > (fileSize - entry.indexOffset) / entry.indexSize) {
+            LOG_ERROR(ASSETS) << "Mesh cache: truncated file for " << sourcePath;
+            return false;
+        }
+        const unsigned char* indexBytes = file->GetData() + entry.indexOffset;
+        bool indicesValid = entry.indexOffset % COOKED_MESH_ALIGNMENT == 0 && // Store() aligns it; the scan reads in place
+                            (entry.indexSize == 2 ? indicesInRange<uint16_t>(indexBytes, entry.indexCount, entry.vertexCount)
+                                                  : indicesInRange<uint32_t>(indexBytes, entry.indexCount, entry.vertexCount));
+        if (!indicesValid) {
+            LOG_ERROR(ASSETS) << "Mesh cache: misaligned or out-of-range indices in " << sourcePath;
+            return false;
+        }
+        data.name.assign(entry.name, strnlen(entry.name, COOKED_MESH_NAME_LENGTH));
+        data.vertexCount = static_cast<size_t>(entry.vertexCount);
+        data.indexCount = static_cast<size_t>(entry.indexCount);
+        data.mappedVertices = file->GetData() + entry.vertexOffset;
+        data.mappedIndices = file->GetData() + entry.indexOffset;
+    }
+
+    file->Prefetch();
+    mapping = std::move(file);
+    meshes = std::move(result);
+    return true;
+}
+
+bool MeshCache::Store(const std::string& sourcePath, const std::vector<MeshData>& meshes) const {
+    CookedMeshHeader header = {};
+    std::memcpy(header.magic, COOKED_MESH_MAGIC, sizeof(COOKED_MESH_MAGIC));
+    header.version = VERSION;
+    header.meshCount = static_cast<uint32_t>(meshes.size());
+    if (!getSourceStamp(sourcePath, header.sourceSize, header.sourceMtime)) return false;
+
+    // Lay out the arrays first so the entry table can be written in one go
+    std::vector<CookedMeshEntry> entries(meshes.size());
+    uint64_t offset = sizeof(CookedMeshHeader) + meshes.size() * sizeof(CookedMeshEntry);
+    for (size_t i = 0; i < meshes.size(); ++i) {
+        CookedMeshEntry& entry = entries[i];
+        std::memset(&entry, 0, sizeof(entry));
+        std::strncpy(entry.name, meshes[i].name.c_str(), COOKED_MESH_NAME_LENGTH - 1);
+        entry.vertexLayout = meshes[i].layout.Encode();
+        entry.indexSize = static_cast<uint32_t>(IndexSize(meshes[i].indexType));
+        entry.boundsCenter[0] = meshes[i].boundsCenter.x;
+        entry.boundsCenter[1] = meshes[i].boundsCenter.y;
+        entry.boundsCenter[2] = meshes[i].boundsCenter.z;
+        entry.boundsRadius = meshes[i].boundsRadius;
+        entry.lodCount = static_cast<uint32_t>(std::min(meshes[i].lods.size(), MAX_MESH_LODS));
+        for (uint32_t l = 0; l < entry.lodCount; ++l) {
+            entry.lods[l].firstIndex = meshes[i].lods[l].firstIndex;
+            entry.lods[l].indexCount = meshes[i].lods[l].indexCount;
+            entry.lods[l].error = meshes[i].lods[l].error;
+        }
+        entry.vertexOffset = alignUp(offset);
+        entry.vertexCount = meshes[i].vertexCount;
+        entry.indexOffset = alignUp(entry.vertexOffset + meshes[i].GetVertexByteSize());
+        entry.indexCount = meshes[i].indexCount;
+        offset = entry.indexOffset + meshes[i].GetIndexByteSize();
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(m_directory, ec);
+    std::filesystem::path finalPath = GetCachePath(sourcePath);
+    std::filesystem::path tempPath = MakeTempPath(finalPath);
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) { LOG_ERROR(ASSETS) << "Mesh cache: cannot write " << tempPath.string(); return false; }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(CookedMeshEntry)));
+        static const char padding[COOKED_MESH_ALIGNMENT] = {};
+        auto padTo = [&out](uint64_t target) {
+            uint64_t position = static_cast<uint64_t>(out.tellp());
+            if (target > position) out.write(padding, static_cast<std::streamsize>(target - position));
+        };
+        for (size_t i = 0; i < meshes.size(); ++i) {
+            padTo(entries[i].vertexOffset);
+            out.write(reinterpret_cast<const char*>(meshes[i].GetVertexBytes()), static_cast<std::streamsize>(meshes[i].GetVertexByteSize()));
+            padTo(entries[i].indexOffset);
+            out.write(reinterpret_cast<const char*>(meshes[i].GetIndexBytes()), static_cast<std::streamsize>(meshes[i].GetIndexByteSize()));
+        }
+        if (!out) {
+            LOG_ERROR(ASSETS) << "Mesh cache: write failed for " << tempPath.string();
+            out.close();
+            std::filesystem::remove(tempPath, ec); // Temp names are unique, so nothing else would reuse it
+            return false;
+        }
+    }
+    std::filesystem::rename(tempPath, finalPath, ec);
+    if (ec) {
+        LOG_ERROR(ASSETS) << "Mesh cache: cannot move " << tempPath.string() << " into place: " << ec.message();
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+    LOG_INFO(ASSETS) << "Mesh cache: cooked " << sourcePath << " -> " << finalPath.string();
+    return true;
+}
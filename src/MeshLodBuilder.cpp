@@ -0,0 +1,63 @@
+#include "MeshLodBuilder.h"
+#include <meshoptimizer.h>
+#include <algorithm>
+#include <cstddef>
+
+// Overdraw pass may make the vertex cache hit rate at most this much worse
+static const float OVERDRAW_CACHE_THRESHOLD = 1.05f;
+// Each LOD aims for this fraction of the previous one's triangles
+static const float LOD_REDUCTION = 0.5f;
+// Meshes (and LODs) below this many triangles are not simplified further
+static const size_t LOD_MIN_TRIANGLES = 256;
+// Largest relative error (fraction of the mesh extent) the simplifier may introduce for any LOD
+static const float LOD_MAX_RELATIVE_ERROR = 0.05f;
+// A LOD that keeps more than this fraction of the previous one's triangles is not worth a level
+static const float LOD_MIN_PROGRESS = 0.85f;
+
+void MeshLodBuilder::Optimize(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+    if (vertices.empty() || indices.empty()) return;
+    const float* positions = &vertices[0].Position.x;
+
+    meshopt_optimizeVertexCache(indices.data(), indices.data(), indices.size(), vertices.size());
+    meshopt_optimizeOverdraw(indices.data(), indices.data(), indices.size(), positions, vertices.size(), sizeof(Vertex),
+                             OVERDRAW_CACHE_THRESHOLD);
+
+    std::vector<Vertex> reordered(vertices);
+    size_t used = meshopt_optimizeVertexFetch(reordered.data(), indices.data(), indices.size(), vertices.data(), vertices.size(), sizeof(Vertex));
+    reordered.erase(reordered.begin() + used, reordered.end()); // Vertices no triangle references are dropped
+    vertices = std::move(reordered);
+}
+
+std::vector<MeshLod> MeshLodBuilder::BuildLods(const std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+    std::vector<MeshLod> lods;
+    MeshLod base;
+    base.indexCount = static_cast<uint32_t>(indices.size());
+    lods.push_back(base);
+    if (vertices.empty() || indices.size() < LOD_MIN_TRIANGLES * 3 * 2) return lods;
+
+    const float* positions = &vertices[0].Position.x;
+    const float scale = meshopt_simplifyScale(positions, vertices.size(), sizeof(Vertex));
+    const size_t baseCount = indices.size();
+    std::vector<unsigned int> simplified(baseCount);
+    size_t previousCount = baseCount;
+
+    // Every LOD is simplified from LOD 0, so its error is measured against the full-detail mesh
+    while (lods.size() < MAX_MESH_LODS) {
+        size_t target = static_cast<size_t>(previousCount * LOD_REDUCTION) / 3 * 3;
+        if (target < LOD_MIN_TRIANGLES * 3) break;
+        float error = 0.0f;
+        size_t count = meshopt_simplify(simplified.data(), indices.data(), baseCount, positions, vertices.size(), sizeof(Vertex),
+                                        target, LOD_MAX_RELATIVE_ERROR, 0, &error);
+        if (count == 0 || count > previousCount * LOD_MIN_PROGRESS) break; // Error bound reached
+        meshopt_optimizeVertexCache(simplified.data(), simplified.data(), count, vertices.size());
+
+        MeshLod lod;
+        lod.firstIndex = static_cast<uint32_t>(indices.size());
+        lod.indexCount = static_cast<uint32_t>(count);
+        lod.error = error * scale;
+        indices.insert(indices.end(), simplified.begin(), simplified.begin() + count);
+        lods.push_back(lod);
+        previousCount = count;
+    }
+    return lods;
+}
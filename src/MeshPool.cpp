@@ -0,0 +1,209 @@
+#include "MeshPool.h"
+#include "Log.h"
+#include "MemoryStats.h"
+#include <algorithm>
+
+// Initial bucket capacities; big enough for a few typical imports before the first grow
+static const size_t INITIAL_POOL_VERTICES = 256 * 1024;
+static const size_t INITIAL_POOL_INDICES = 1024 * 1024;
+
+// Discards errors left by earlier calls, so the check after an allocation only sees its own
+// (checkGLError stops draining the queue once debug output is active)
+static void clearGLErrors() {
+    while (glGetError() != GL_NO_ERROR) {}
+}
+
+// --- RangeAllocator ---
+
+bool MeshPool::RangeAllocator::Allocate(size_t size, size_t& offset) {
+    for (size_t i = 0; i < freeRanges.size(); ++i) {
+        Range& range = freeRanges[i];
+        if (range.size < size) continue;
+        offset = range.offset;
+        range.offset += size;
+        range.size -= size;
+        if (range.size == 0) freeRanges.erase(freeRanges.begin() + i);
+        used += size;
+        return true;
+    }
+    return false;
+}
+
+void MeshPool::RangeAllocator::Release(size_t offset, size_t size) {
+    if (size == 0) return;
+    used -= size;
+    auto next = std::lower_bound(freeRanges.begin(), freeRanges.end(), offset,
+                                 [](const Range& range, size_t value) { return range.offset < value; });
+    // Merge with the free range before and / or after
+    bool mergedPrev = false;
+    if (next != freeRanges.begin()) {
+        Range& prev = *(next - 1);
+        if (prev.offset + prev.size == offset) { prev.size += size; mergedPrev = true; }
+    }
+    if (next != freeRanges.end() && offset + size == next->offset) {
+        if (mergedPrev) { (next - 1)->size += next->size; freeRanges.erase(next); }
+        else { next->offset = offset; next->size += size; }
+        return;
+    }
+    if (!mergedPrev) freeRanges.insert(next, { offset, size });
+}
+
+void MeshPool::RangeAllocator::Grow(size_t newCapacity) {
+    if (!freeRanges.empty() && freeRanges.back().offset + freeRanges.back().size == capacity) {
+        freeRanges.back().size += newCapacity - capacity;
+    } else {
+        freeRanges.push_back({ capacity, newCapacity - capacity });
+    }
+    capacity = newCapacity;
+}
+
+// --- MeshPool ---
+
+MeshPool::~MeshPool() {
+    Destroy();
+}
+
+void MeshPool::Destroy() {
+    for (Bucket& bucket : m_buckets) {
+        if (bucket.vao) glDeleteVertexArrays(1, &bucket.vao);
+        if (bucket.vbo) { MemoryStats::UntrackBuffer(bucket.vbo); glDeleteBuffers(1, &bucket.vbo); }
+        if (bucket.ebo) { MemoryStats::UntrackBuffer(bucket.ebo); glDeleteBuffers(1, &bucket.ebo); }
+    }
+    m_buckets.clear();
+}
+
+int MeshPool::findBucket(const VertexLayout& layout, GLenum indexType) {
+    for (size_t i = 0; i < m_buckets.size(); ++i) {
+        if (m_buckets[i].layout == layout && m_buckets[i].indexType == indexType) return static_cast<int>(i);
+    }
+    Bucket bucket;
+    bucket.layout = layout;
+    bucket.indexType = indexType;
+    glGenVertexArrays(1, &bucket.vao);
+    glGenBuffers(1, &bucket.vbo);
+    glGenBuffers(1, &bucket.ebo);
+    clearGLErrors();
+    glBindBuffer(GL_COPY_WRITE_BUFFER, bucket.vbo);
+    glBufferData(GL_COPY_WRITE_BUFFER, INITIAL_POOL_VERTICES * layout.GetStride(), nullptr, GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, bucket.ebo);
+    glBufferData(GL_COPY_WRITE_BUFFER, INITIAL_POOL_INDICES * IndexSize(indexType), nullptr, GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    bucket.vertices.Grow(INITIAL_POOL_VERTICES);
+    bucket.indices.Grow(INITIAL_POOL_INDICES);
+    bindBuffers(bucket);
+    if (glGetError() != GL_NO_ERROR) {
+        LOG_ERROR(ASSETS) << "Failed to create mesh pool buffers.";
+        glDeleteVertexArrays(1, &bucket.vao);
+        glDeleteBuffers(1, &bucket.vbo);
+        glDeleteBuffers(1, &bucket.ebo);
+        return -1;
+    }
+    MemoryStats::TrackBuffer(bucket.vbo, MemoryCategory::MESH_BUFFERS, INITIAL_POOL_VERTICES * layout.GetStride());
+    MemoryStats::TrackBuffer(bucket.ebo, MemoryCategory::MESH_BUFFERS, INITIAL_POOL_INDICES * IndexSize(indexType));
+    m_buckets.push_back(bucket);
+    LOG_INFO(ASSETS) << "Mesh pool bucket " << m_buckets.size() - 1 << " created (stride " << layout.GetStride() << ", "
+                     << (indexType == GL_UNSIGNED_SHORT ? 16 : 32) << "-bit indices)";
+    return static_cast<int>(m_buckets.size() - 1);
+}
+
+// Points the bucket's VAO at its current buffers (again after either was replaced by a grow)
+void MeshPool::bindBuffers(Bucket& bucket) {
+    glBindVertexArray(bucket.vao);
+    glBindBuffer(GL_ARRAY_BUFFER, bucket.vbo);
+    bucket.layout.Apply();
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bucket.ebo);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// Replaces `buffer` with a larger one holding the same first oldBytes
+bool MeshPool::growBuffer(GLuint& buffer, size_t oldBytes, size_t newBytes) {
+    GLuint grown = 0;
+    glGenBuffers(1, &grown);
+    clearGLErrors();
+    glBindBuffer(GL_COPY_WRITE_BUFFER, grown);
+    glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(newBytes), nullptr, GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, static_cast<GLsizeiptr>(oldBytes));
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    if (glGetError() != GL_NO_ERROR) {
+        LOG_ERROR(ASSETS) << "Failed to grow mesh pool buffer to " << newBytes << " bytes.";
+        glDeleteBuffers(1, &grown);
+        return false;
+    }
+    MemoryStats::UntrackBuffer(buffer);
+    glDeleteBuffers(1, &buffer);
+    buffer = grown;
+    MemoryStats::TrackBuffer(buffer, MemoryCategory::MESH_BUFFERS, newBytes);
+    return true;
+}
+
+bool MeshPool::Allocate(const VertexLayout& layout, GLenum indexType, size_t vertexCount, size_t indexCount, MeshAllocation& allocation) {
+    int bucketIndex = findBucket(layout, indexType);
+    if (bucketIndex < 0) return false;
+    Bucket& bucket = m_buckets[bucketIndex];
+    const size_t stride = layout.GetStride(), indexSize = IndexSize(indexType);
+
+    size_t firstVertex = 0, firstIndex = 0;
+    while (!bucket.vertices.Allocate(vertexCount, firstVertex)) {
+        size_t capacity = std::max(bucket.vertices.capacity * 2, bucket.vertices.capacity + vertexCount);
+        if (!growBuffer(bucket.vbo, bucket.vertices.capacity * stride, capacity * stride)) return false;
+        bucket.vertices.Grow(capacity);
+        bindBuffers(bucket);
+    }
+    while (!bucket.indices.Allocate(indexCount, firstIndex)) {
+        size_t capacity = std::max(bucket.indices.capacity * 2, bucket.indices.capacity + indexCount);
+        if (!growBuffer(bucket.ebo, bucket.indices.capacity * indexSize, capacity * indexSize)) {
+            bucket.vertices.Release(firstVertex, vertexCount);
+            return false;
+        }
+        bucket.indices.Grow(capacity);
+        bindBuffers(bucket);
+    }
+    allocation.bucket = bucketIndex;
+    allocation.firstVertex = firstVertex;
+    allocation.vertexCount = vertexCount;
+    allocation.firstIndex = firstIndex;
+    allocation.indexCount = indexCount;
+    return true;
+}
+
+void MeshPool::Free(MeshAllocation& allocation) {
+    if (!allocation.IsValid() || allocation.bucket >= static_cast<int>(m_buckets.size())) return;
+    Bucket& bucket = m_buckets[allocation.bucket];
+    bucket.vertices.Release(allocation.firstVertex, allocation.vertexCount);
+    bucket.indices.Release(allocation.firstIndex, allocation.indexCount);
+    allocation = MeshAllocation();
+}
+
+void MeshPool::UploadVertices(const MeshAllocation& allocation, size_t byteOffset, const void* data, size_t bytes) {
+    const Bucket& bucket = m_buckets[allocation.bucket];
+    glBindBuffer(GL_COPY_WRITE_BUFFER, bucket.vbo);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, allocation.firstVertex * bucket.layout.GetStride() + byteOffset, bytes, data);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+void MeshPool::UploadIndices(const MeshAllocation& allocation, size_t byteOffset, const void* data, size_t bytes) {
+    const Bucket& bucket = m_buckets[allocation.bucket];
+    // Through the copy target: binding GL_ELEMENT_ARRAY_BUFFER would change whichever VAO is bound
+    glBindBuffer(GL_COPY_WRITE_BUFFER, bucket.ebo);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, allocation.firstIndex * IndexSize(bucket.indexType) + byteOffset, bytes, data);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+size_t MeshPool::GetUsedBytes() const {
+    size_t total = 0;
+    for (const Bucket& bucket : m_buckets) {
+        total += bucket.vertices.used * bucket.layout.GetStride() + bucket.indices.used * IndexSize(bucket.indexType);
+    }
+    return total;
+}
+
+size_t MeshPool::GetCapacityBytes() const {
+    size_t total = 0;
+    for (const Bucket& bucket : m_buckets) {
+        total += bucket.vertices.capacity * bucket.layout.GetStride() + bucket.indices.capacity * IndexSize(bucket.indexType);
+    }
+    return total;
+}
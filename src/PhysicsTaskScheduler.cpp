@@ -0,0 +1,96 @@
+#include "PhysicsTaskScheduler.h"
+#include "Log.h"
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+
+static unsigned int chooseWorkerCount(unsigned int requested) {
+    unsigned int count = requested;
+    if (count == 0) {
+        unsigned int hardware = std::thread::hardware_concurrency();
+        count = hardware > 2 ? hardware - 2 : 1;
+    }
+    // Leaves room for the main and physics thread indices
+    return std::min(count, static_cast<unsigned int>(BT_MAX_THREAD_COUNT - 2));
+}
+
+PhysicsTaskScheduler::PhysicsTaskScheduler(unsigned int workerThreads)
+    : btITaskScheduler("PhysicsThreadPool"),
+      m_pool(chooseWorkerCount(workerThreads)),
+      m_threadIndexCount(static_cast<int>(m_pool.GetThreadCount()) + 2) {}
+
+void PhysicsTaskScheduler::ClaimThreadIndices() {
+    const unsigned int workers = m_pool.GetThreadCount();
+    std::mutex mutex;
+    std::condition_variable allArrived;
+    unsigned int arrived = 0;
+    unsigned int highest = 0;
+    for (unsigned int i = 0; i < workers; ++i) {
+        m_pool.Enqueue([&]() {
+            unsigned int index = btGetCurrentThreadIndex();
+            std::unique_lock<std::mutex> lock(mutex);
+            highest = std::max(highest, index);
+            if (++arrived == workers) allArrived.notify_all();
+            // Hold this worker until every worker has one of these tasks, so all of them get an index
+            allArrived.wait(lock, [&]() { return arrived == workers; });
+        });
+    }
+    m_pool.WaitIdle();
+    m_threadIndexCount = std::min(static_cast<int>(highest) + 2, static_cast<int>(BT_MAX_THREAD_COUNT));
+    LOG_INFO(PHYSICS) << "Physics task scheduler: " << workers << " worker threads (" << m_threadIndexCount << " thread slots)";
+}
+
+template <typename ChunkFn>
+void PhysicsTaskScheduler::run(int iBegin, int iEnd, int grainSize, const ChunkFn& chunk) {
+    if (iEnd <= iBegin) return;
+    grainSize = std::max(grainSize, 1);
+    const int chunkCount = (iEnd - iBegin + grainSize - 1) / grainSize;
+    const int helpers = std::min(chunkCount - 1, static_cast<int>(m_pool.GetThreadCount()));
+    bool idle = false;
+    if (helpers <= 0 || !m_running.compare_exchange_strong(idle, true)) {
+        chunk(iBegin, iEnd); // A single chunk, or called from inside a running loop
+        return;
+    }
+
+    std::atomic<int> cursor{iBegin};
+    auto work = [&]() {
+        for (;;) {
+            int begin = cursor.fetch_add(grainSize);
+            if (begin >= iEnd) break;
+            chunk(begin, std::min(begin + grainSize, iEnd));
+        }
+    };
+
+    std::mutex doneMutex;
+    std::condition_variable done;
+    int pending = helpers;
+    for (int i = 0; i < helpers; ++i) {
+        m_pool.Enqueue([&]() {
+            work();
+            std::lock_guard<std::mutex> lock(doneMutex);
+            if (--pending == 0) done.notify_one();
+        });
+    }
+    work();
+    {
+        // Helpers reference this frame: wait for all of them, even those that found no chunk left
+        std::unique_lock<std::mutex> lock(doneMutex);
+        done.wait(lock, [&]() { return pending == 0; });
+    }
+    m_running = false;
+}
+
+void PhysicsTaskScheduler::parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body) {
+    run(iBegin, iEnd, grainSize, [&body](int begin, int end) { body.forLoop(begin, end); });
+}
+
+btScalar PhysicsTaskScheduler::parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body) {
+    std::mutex sumMutex;
+    btScalar sum = btScalar(0);
+    run(iBegin, iEnd, grainSize, [&](int begin, int end) {
+        btScalar partial = body.sumLoop(begin, end);
+        std::lock_guard<std::mutex> lock(sumMutex);
+        sum += partial;
+    });
+    return sum;
+}
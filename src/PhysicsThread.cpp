@@ -0,0 +1,140 @@
+#include "PhysicsThread.h"
+#include "Log.h"
+#include <btBulletDynamicsCommon.h>
+#include <algorithm>
+
+// Ticks allowed to run back-to-back after a stall; anything beyond is dropped instead of spiralling
+static const int PHYSICS_MAX_CATCHUP_STEPS = 5;
+
+PhysicsThread::PhysicsThread(btDiscreteDynamicsWorld* world, float fixedTimeStep)
+    : m_world(world), m_fixedTimeStep(fixedTimeStep) {}
+
+PhysicsThread::~PhysicsThread() {
+    Stop();
+}
+
+void PhysicsThread::Start() {
+    if (m_running.exchange(true)) return;
+    m_thread = std::thread(&PhysicsThread::threadLoop, this);
+    LOG_INFO(PHYSICS) << "Physics thread started (" << 1.0f / m_fixedTimeStep << " Hz fixed step)";
+}
+
+void PhysicsThread::Stop() {
+    if (!m_running.exchange(false)) return;
+    m_wake.notify_all();
+    if (m_thread.joinable()) m_thread.join();
+    LOG_INFO(PHYSICS) << "Physics thread stopped after " << m_tickCount.load() << " ticks";
+}
+
+void PhysicsThread::SetSimulating(bool simulating) {
+    if (m_simulating.exchange(simulating) != simulating) m_wake.notify_one();
+}
+
+const PhysicsSnapshot& PhysicsThread::AcquireSnapshot() {
+    if (m_latest.load(std::memory_order_acquire) & SNAPSHOT_FRESH_BIT) {
+        m_front = m_latest.exchange(m_front, std::memory_order_acq_rel) & ~SNAPSHOT_FRESH_BIT;
+    }
+    return m_snapshots[m_front];
+}
+
+float PhysicsThread::GetInterpolationAlpha(const PhysicsSnapshot& snapshot) const {
+    if (!m_simulating.load()) return 1.0f;
+    float elapsed = std::chrono::duration<float>(std::chrono::steady_clock::now() - snapshot.tickTime).count();
+    return std::clamp(elapsed / m_fixedTimeStep, 0.0f, 1.0f);
+}
+
+void PhysicsThread::publishSnapshot(uint64_t tick) {
+    PhysicsSnapshot& snapshot = m_snapshots[m_back];
+    snapshot.bodies.clear();
+    int numObjects = m_world->getNumCollisionObjects();
+    for (int i = 0; i < numObjects; ++i) {
+        btRigidBody* body = btRigidBody::upcast(m_world->getCollisionObjectArray()[i]);
+        if (!body || body->getInvMass() == 0.0f) continue;
+        PhysicsBodyState state;
+        state.body = body;
+        const btCollisionShape* shape = body->getCollisionShape();
+        if (shape->getShapeType() == SPHERE_SHAPE_PROXYTYPE) {
+            state.shape = PhysicsShape::SPHERE;
+            state.scale = glm::vec3(static_cast<const btSphereShape*>(shape)->getRadius() * 2.0f);
+        } else if (shape->getShapeType() == BOX_SHAPE_PROXYTYPE) {
+            btVector3 halfExtents = static_cast<const btBoxShape*>(shape)->getHalfExtentsWithMargin();
+            state.shape = PhysicsShape::BOX;
+            state.scale = glm::vec3(halfExtents.x(), halfExtents.y(), halfExtents.z()) * 2.0f;
+        }
+        const btTransform& transform = body->getWorldTransform();
+        btVector3 origin = transform.getOrigin();
+        btQuaternion rotation = transform.getRotation();
+        state.position = glm::vec3(origin.x(), origin.y(), origin.z());
+        state.rotation = glm::quat(rotation.w(), rotation.x(), rotation.y(), rotation.z());
+
+        // Previous tick: same slot in the writer's last copy if it is the same body, otherwise no motion
+        size_t slot = snapshot.bodies.size();
+        if (slot < m_lastPublished.size() && m_lastPublished[slot].body == body) {
+            state.prevPosition = m_lastPublished[slot].position;
+            state.prevRotation = m_lastPublished[slot].rotation;
+        } else {
+            state.prevPosition = state.position;
+            state.prevRotation = state.rotation;
+        }
+        snapshot.bodies.push_back(state);
+    }
+    snapshot.tickTime = std::chrono::steady_clock::now();
+    snapshot.tick = tick;
+    m_lastPublished = snapshot.bodies;
+
+    m_back = m_latest.exchange(m_back | SNAPSHOT_FRESH_BIT, std::memory_order_acq_rel) & ~SNAPSHOT_FRESH_BIT;
+}
+
+void PhysicsThread::CopyStepStats(PhysicsStepStats& stats) const {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    stats = m_stepStats;
+}
+
+void PhysicsThread::threadLoop() {
+    using clock = std::chrono::steady_clock;
+    const auto step = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(m_fixedTimeStep));
+    auto nextTick = clock::now();
+    uint64_t tick = 0;
+
+    while (m_running.load()) {
+        if (!m_simulating.load()) {
+            if (m_snapshotRequested.exchange(false)) {
+                std::lock_guard<std::mutex> lock(m_worldMutex);
+                publishSnapshot(tick);
+            }
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            m_wake.wait_for(lock, std::chrono::milliseconds(50), [this]() {
+                return !m_running.load() || m_simulating.load() || m_snapshotRequested.load();
+            });
+            nextTick = clock::now(); // Resume without a burst of catch-up steps
+            continue;
+        }
+
+        int steps = 0;
+        while (clock::now() >= nextTick && steps < PHYSICS_MAX_CATCHUP_STEPS) {
+            auto start = clock::now();
+            {
+                std::lock_guard<std::mutex> lock(m_worldMutex);
+                m_world->stepSimulation(m_fixedTimeStep, 1, m_fixedTimeStep);
+                float stepMs = std::chrono::duration<float, std::milli>(clock::now() - start).count();
+                PhysicsWorld::CaptureStepStats(m_world, stepMs, m_stepStatsScratch);
+                ++tick;
+                publishSnapshot(tick);
+            }
+            m_lastStepMs = std::chrono::duration<float, std::milli>(clock::now() - start).count();
+            m_tickCount = tick;
+            {
+                std::lock_guard<std::mutex> lock(m_statsMutex);
+                std::swap(m_stepStats, m_stepStatsScratch);
+            }
+            nextTick += step;
+            ++steps;
+        }
+        if (steps == PHYSICS_MAX_CATCHUP_STEPS && clock::now() >= nextTick) {
+            nextTick = clock::now(); // Too far behind: drop the backlog (simulation slows down instead of stalling)
+        }
+
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_wake.wait_until(lock, nextTick, [this]() { return !m_running.load() || !m_simulating.load(); });
+    }
+}
@@ -0,0 +1,447 @@
+#include "PhysicsWorld.h"
+#include "Log.h"
+#include "PhysicsTaskScheduler.h"
+#include "SceneFile.h"
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+#include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#include <LinearMath/btQuickprof.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+// Collision pairs per dispatcher task; Bullet's own default
+static const int PHYSICS_DISPATCH_GRAIN_SIZE = 40;
+
+// Stress bodies are unit sized (box extents / sphere diameter 1) and spread around the scene origin
+static const float STRESS_BODY_MASS = 1.0f;
+static const int STRESS_STACK_HEIGHT = 10;     // Boxes per tower
+static const float STRESS_STACK_SPACING = 2.0f; // Distance between towers
+static const float STRESS_RAIN_DENSITY = 0.25f; // Bodies per square unit in each layer of falling bodies
+static const float STRESS_RAIN_BASE_HEIGHT = 15.0f;
+static const float STRESS_PILE_SPACING = 1.1f;
+
+PhysicsWorld::PhysicsWorld() = default;
+
+PhysicsWorld::~PhysicsWorld() { Shutdown(); }
+
+// --- Physics Initialization ---
+bool PhysicsWorld::Initialize(unsigned long seed, const PhysicsThreadingSettings& threading) {
+    LOG_INFO(PHYSICS) << "Initializing Bullet Physics...";
+    m_collisionConfiguration = std::make_unique<btDefaultCollisionConfiguration>();
+    m_overlappingPairCache = std::make_unique<btDbvtBroadphase>();
+    if (threading.multithreaded) {
+#ifndef BT_THREADSAFE
+        LOG_WARN(PHYSICS) << "Bullet was built without BT_THREADSAFE, the multi-threaded world will step on one thread.";
+#endif
+        // The scheduler has to be in place before the Mt classes are built (they size per-thread data from it)
+        m_taskScheduler = std::make_unique<PhysicsTaskScheduler>(threading.workerThreads);
+        btSetTaskScheduler(m_taskScheduler.get());
+        m_taskScheduler->ClaimThreadIndices();
+
+        m_dispatcher = std::make_unique<btCollisionDispatcherMt>(m_collisionConfiguration.get(), PHYSICS_DISPATCH_GRAIN_SIZE);
+        // One island solver per thread slot; the pool takes ownership of them
+        std::vector<btConstraintSolver*> islandSolvers;
+        for (int i = 0; i < m_taskScheduler->getNumThreads(); ++i) {
+            btSequentialImpulseConstraintSolver* islandSolver = new btSequentialImpulseConstraintSolver();
+            islandSolver->setRandSeed(seed + static_cast<unsigned long>(i));
+            islandSolvers.push_back(islandSolver);
+        }
+        m_solverPool = std::make_unique<btConstraintSolverPoolMt>(islandSolvers.data(), static_cast<int>(islandSolvers.size()));
+        m_solver = std::make_unique<btSequentialImpulseConstraintSolverMt>();
+        m_solver->setRandSeed(seed);
+        m_dynamicsWorld = std::make_unique<btDiscreteDynamicsWorldMt>(
+            m_dispatcher.get(), m_overlappingPairCache.get(), m_solverPool.get(), m_solver.get(), m_collisionConfiguration.get()
+        );
+    } else {
+        m_dispatcher = std::make_unique<btCollisionDispatcher>(m_collisionConfiguration.get());
+        m_solver = std::make_unique<btSequentialImpulseConstraintSolver>();
+        m_solver->setRandSeed(seed);
+        m_dynamicsWorld = std::make_unique<btDiscreteDynamicsWorld>(
+            m_dispatcher.get(), m_overlappingPairCache.get(), m_solver.get(), m_collisionConfiguration.get()
+        );
+    }
+    m_dynamicsWorld->setGravity(btVector3(0, -9.81, 0));
+
+    createScene();
+    m_terrainCollider = std::make_unique<TerrainCollider>(m_dynamicsWorld.get());
+    m_dynamicsWorld->setInternalTickCallback(&PhysicsWorld::preTickCallback, this, true);
+
+    LOG_INFO(PHYSICS) << "Bullet Physics Initialized (" << (m_taskScheduler ? "multi-threaded" : "single-threaded") << ", "
+                      << TerrainNoise::GetKernelName(TerrainNoise::GetKernel()) << " terrain noise).";
+    return true;
+}
+
+unsigned int PhysicsWorld::GetWorkerThreadCount() const {
+    return m_taskScheduler ? m_taskScheduler->GetWorkerCount() : 0;
+}
+
+// --- Terrain Collision ---
+void PhysicsWorld::SetTerrainParams(const TerrainParams& params) {
+    std::lock_guard<std::mutex> lock(m_terrainMutex);
+    m_terrainParams = params;
+}
+
+void PhysicsWorld::SetTerrainCollisionEnabled(bool enabled) {
+    std::lock_guard<std::mutex> lock(m_terrainMutex);
+    m_terrainEnabled = enabled;
+}
+
+bool PhysicsWorld::IsTerrainCollisionEnabled() const {
+    std::lock_guard<std::mutex> lock(m_terrainMutex);
+    return m_terrainEnabled;
+}
+
+TerrainColliderStats PhysicsWorld::GetTerrainStats() const {
+    std::lock_guard<std::mutex> lock(m_terrainMutex);
+    return m_terrainStats;
+}
+
+void PhysicsWorld::preTickCallback(btDynamicsWorld* world, btScalar timeStep) {
+    static_cast<PhysicsWorld*>(world->getWorldUserInfo())->updateTerrain(static_cast<float>(timeStep));
+}
+
+// Runs at the start of every internal tick, before motion prediction and collision detection
+void PhysicsWorld::updateTerrain(float timeStep) {
+    TerrainParams params;
+    bool enabled;
+    {
+        std::lock_guard<std::mutex> lock(m_terrainMutex);
+        params = m_terrainParams;
+        enabled = m_terrainEnabled;
+    }
+    // Tiles are built without the lock, so the UI never waits on a rebuild
+    m_terrainCollider->SetParams(params);
+    if (enabled) m_terrainCollider->Update(timeStep);
+    else m_terrainCollider->Clear();
+
+    std::lock_guard<std::mutex> lock(m_terrainMutex);
+    m_terrainStats = m_terrainCollider->GetStats();
+}
+
+void PhysicsWorld::createScene() {
+    // Ground Plane
+    m_collisionShapes.push_back(std::make_unique<btStaticPlaneShape>(btVector3(0, 1, 0), 0));
+    btCollisionShape* groundShape = m_collisionShapes.back().get();
+    btDefaultMotionState* groundMotionState = new btDefaultMotionState(btTransform(btQuaternion(0, 0, 0, 1), btVector3(0, 0, 0)));
+    btRigidBody::btRigidBodyConstructionInfo groundRigidBodyCI(0, groundMotionState, groundShape, btVector3(0, 0, 0));
+    btRigidBody* groundRigidBody = new btRigidBody(groundRigidBodyCI);
+    groundRigidBody->setRestitution(0.3f);
+    m_dynamicsWorld->addRigidBody(groundRigidBody);
+
+    // Falling Cube
+    float cubeHalfExtents = 0.5f;
+    m_collisionShapes.push_back(std::make_unique<btBoxShape>(btVector3(cubeHalfExtents, cubeHalfExtents, cubeHalfExtents)));
+    btCollisionShape* fallShape = m_collisionShapes.back().get();
+    btDefaultMotionState* fallMotionState = new btDefaultMotionState(btTransform(btQuaternion(0, 0, 0, 1), btVector3(0, 20, 0)));
+    btScalar mass = 1.f; btVector3 fallInertia(0, 0, 0);
+    fallShape->calculateLocalInertia(mass, fallInertia);
+    btRigidBody::btRigidBodyConstructionInfo fallRigidBodyCI(mass, fallMotionState, fallShape, fallInertia);
+    btRigidBody* fallRigidBody = new btRigidBody(fallRigidBodyCI);
+    fallRigidBody->setRestitution(0.6f);
+    m_dynamicsWorld->addRigidBody(fallRigidBody);
+    m_bodies.push_back(fallRigidBody);
+
+    // Bouncing Sphere
+    float sphereRadius = 0.6f;
+    m_collisionShapes.push_back(std::make_unique<btSphereShape>(sphereRadius));
+    btCollisionShape* sphereShape = m_collisionShapes.back().get();
+    btDefaultMotionState* sphereMotionState = new btDefaultMotionState(btTransform(btQuaternion(0, 0, 0, 1), btVector3(2, 15, 0)));
+    btScalar sphereMass = 1.5f; btVector3 sphereInertia(0, 0, 0);
+    sphereShape->calculateLocalInertia(sphereMass, sphereInertia);
+    btRigidBody::btRigidBodyConstructionInfo sphereRigidBodyCI(sphereMass, sphereMotionState, sphereShape, sphereInertia);
+    btRigidBody* sphereRigidBody = new btRigidBody(sphereRigidBodyCI);
+    sphereRigidBody->setRestitution(0.9f); sphereRigidBody->setFriction(0.1f);
+    m_dynamicsWorld->addRigidBody(sphereRigidBody);
+    m_bodies.push_back(sphereRigidBody);
+}
+
+// --- Stress Scenes ---
+const char* PhysicsWorld::GetStressLayoutName(StressLayout layout) {
+    switch (layout) {
+        case StressLayout::STACKS: return "Stacks";
+        case StressLayout::RAIN:   return "Rain";
+        default:                   return "Pile";
+    }
+}
+
+btCollisionShape* PhysicsWorld::getSharedShape(uint32_t shape, const btVector3& size) {
+    bool sphere = shape == static_cast<uint32_t>(SceneBodyShape::SPHERE);
+    auto key = std::make_tuple(shape, static_cast<float>(size.x()), sphere ? 0.0f : static_cast<float>(size.y()),
+                               sphere ? 0.0f : static_cast<float>(size.z()));
+    auto found = m_sharedShapes.find(key);
+    if (found != m_sharedShapes.end()) return found->second;
+    if (sphere) m_collisionShapes.push_back(std::make_unique<btSphereShape>(size.x()));
+    else m_collisionShapes.push_back(std::make_unique<btBoxShape>(size));
+    m_sharedShapes.emplace(key, m_collisionShapes.back().get());
+    return m_collisionShapes.back().get();
+}
+
+btRigidBody* PhysicsWorld::addStressBody(bool sphere, const btTransform& transform) {
+    btCollisionShape* shape = getSharedShape(static_cast<uint32_t>(sphere ? SceneBodyShape::SPHERE : SceneBodyShape::BOX),
+                                             btVector3(0.5f, 0.5f, 0.5f));
+    btVector3 inertia(0, 0, 0);
+    shape->calculateLocalInertia(STRESS_BODY_MASS, inertia);
+    btRigidBody::btRigidBodyConstructionInfo info(STRESS_BODY_MASS, new btDefaultMotionState(transform), shape, inertia);
+    btRigidBody* body = new btRigidBody(info);
+    body->setRestitution(0.2f);
+    body->setFriction(0.6f);
+    m_dynamicsWorld->addRigidBody(body);
+    m_stressBodies.push_back(body);
+    return body;
+}
+
+// Highest terrain point under a unit footprint (centre and corners) at each column, 0 without terrain collision.
+// Stress scenes can have thousands of columns, so they go through the batch query.
+static void groundUnderColumns(const TerrainParams& terrain, bool onTerrain, const std::vector<float>& xs, const std::vector<float>& zs,
+                               std::vector<float>& ground) {
+    static const float offsets[5][2] = { { 0.0f, 0.0f }, { -0.5f, -0.5f }, { 0.5f, -0.5f }, { -0.5f, 0.5f }, { 0.5f, 0.5f } };
+    ground.assign(xs.size(), 0.0f);
+    if (!onTerrain) return;
+    std::vector<float> sampleX, sampleZ, heights(xs.size() * 5);
+    sampleX.reserve(heights.size());
+    sampleZ.reserve(heights.size());
+    for (size_t i = 0; i < xs.size(); ++i) {
+        for (const float* offset : offsets) {
+            sampleX.push_back(xs[i] + offset[0]);
+            sampleZ.push_back(zs[i] + offset[1]);
+        }
+    }
+    TerrainNoise::HeightBatch(terrain, sampleX.data(), sampleZ.data(), heights.size(), heights.data());
+    for (size_t i = 0; i < xs.size(); ++i) {
+        ground[i] = *std::max_element(heights.begin() + i * 5, heights.begin() + i * 5 + 5);
+    }
+}
+
+size_t PhysicsWorld::SpawnStressBodies(const StressSceneSettings& settings) {
+    if (!m_dynamicsWorld || settings.bodyCount <= 0) return 0;
+    std::mt19937 rng(settings.seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    auto pickSphere = [&]() { return unit(rng) < settings.sphereFraction; };
+    const int count = settings.bodyCount;
+    size_t before = m_stressBodies.size();
+    // Stacks and piles are placed column by column on the terrain
+    TerrainParams terrain;
+    bool onTerrain;
+    {
+        std::lock_guard<std::mutex> lock(m_terrainMutex);
+        terrain = m_terrainParams;
+        onTerrain = m_terrainEnabled;
+    }
+    std::vector<float> columnX, columnZ, ground;
+
+    switch (settings.layout) {
+        case StressLayout::STACKS: {
+            // Towers of boxes on a square grid: long contact chains for the solver
+            int towers = (count + STRESS_STACK_HEIGHT - 1) / STRESS_STACK_HEIGHT;
+            int side = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(towers))));
+            float offset = (side - 1) * STRESS_STACK_SPACING * 0.5f;
+            for (int tower = 0; tower < towers; ++tower) {
+                columnX.push_back((tower % side) * STRESS_STACK_SPACING - offset);
+                columnZ.push_back((tower / side) * STRESS_STACK_SPACING - offset);
+            }
+            groundUnderColumns(terrain, onTerrain, columnX, columnZ, ground);
+            for (int i = 0; i < count; ++i) {
+                int tower = i / STRESS_STACK_HEIGHT, level = i % STRESS_STACK_HEIGHT;
+                btVector3 position(columnX[tower], ground[tower] + 0.5f + static_cast<float>(level), columnZ[tower]);
+                addStressBody(false, btTransform(btQuaternion(0, 0, 0, 1), position));
+            }
+            break;
+        }
+        case StressLayout::RAIN: {
+            // Randomly rotated bodies scattered over a wide area and height: mostly broadphase work until they land
+            float area = static_cast<float>(count) / STRESS_RAIN_DENSITY;
+            float halfSide = std::sqrt(area) * 0.5f;
+            std::uniform_real_distribution<float> horizontal(-halfSide, halfSide);
+            float layers = std::max(1.0f, std::sqrt(static_cast<float>(count)) * 0.1f);
+            std::uniform_real_distribution<float> height(STRESS_RAIN_BASE_HEIGHT, STRESS_RAIN_BASE_HEIGHT + layers * 4.0f);
+            std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+            for (int i = 0; i < count; ++i) {
+                btQuaternion rotation;
+                rotation.setEulerZYX(angle(rng), angle(rng), angle(rng));
+                addStressBody(pickSphere(), btTransform(rotation, btVector3(horizontal(rng), height(rng), horizontal(rng))));
+            }
+            break;
+        }
+        default: {
+            // Dense lattice dropped as one block: settles into a heap with many simultaneous contacts
+            int side = static_cast<int>(std::ceil(std::cbrt(static_cast<float>(count))));
+            float offset = (side - 1) * STRESS_PILE_SPACING * 0.5f;
+            std::uniform_real_distribution<float> jitter(-0.05f, 0.05f);
+            for (int column = 0; column < side * side; ++column) {
+                columnX.push_back((column % side) * STRESS_PILE_SPACING - offset);
+                columnZ.push_back((column / side) * STRESS_PILE_SPACING - offset);
+            }
+            groundUnderColumns(terrain, onTerrain, columnX, columnZ, ground);
+            for (int i = 0; i < count; ++i) {
+                int column = i % (side * side), y = i / (side * side);
+                btVector3 position(columnX[column] + jitter(rng), ground[column] + 1.0f + y * STRESS_PILE_SPACING,
+                                   columnZ[column] + jitter(rng));
+                addStressBody(pickSphere(), btTransform(btQuaternion(0, 0, 0, 1), position));
+            }
+            break;
+        }
+    }
+    size_t added = m_stressBodies.size() - before;
+    LOG_INFO(PHYSICS) << "Spawned " << added << " stress bodies (" << GetStressLayoutName(settings.layout) << ")";
+    return added;
+}
+
+void PhysicsWorld::ClearStressBodies() {
+    for (btRigidBody* body : m_stressBodies) {
+        m_dynamicsWorld->removeRigidBody(body);
+        delete body->getMotionState();
+        delete body;
+    }
+    m_stressBodies.clear();
+}
+
+// --- Scene Files ---
+void PhysicsWorld::CaptureSceneBodies(std::vector<SceneBodyRecord>& records) const {
+    records.clear();
+    records.reserve(m_bodies.size() + m_stressBodies.size());
+    auto capture = [&records](const btRigidBody* body, uint32_t flags) {
+        const btCollisionShape* shape = body->getCollisionShape();
+        SceneBodyRecord record = {};
+        if (shape->getShapeType() == SPHERE_SHAPE_PROXYTYPE) {
+            record.shape = static_cast<uint32_t>(SceneBodyShape::SPHERE);
+            record.shapeSize[0] = static_cast<const btSphereShape*>(shape)->getRadius();
+        } else if (shape->getShapeType() == BOX_SHAPE_PROXYTYPE) {
+            record.shape = static_cast<uint32_t>(SceneBodyShape::BOX);
+            btVector3 halfExtents = static_cast<const btBoxShape*>(shape)->getHalfExtentsWithMargin();
+            for (int i = 0; i < 3; ++i) record.shapeSize[i] = halfExtents[i];
+        } else {
+            return; // Not representable in the file
+        }
+        btTransform transform = body->getWorldTransform();
+        if (body->getMotionState()) body->getMotionState()->getWorldTransform(transform);
+        btQuaternion rotation = transform.getRotation();
+        record.flags = flags;
+        record.mass = body->getInvMass() > 0.0f ? 1.0f / body->getInvMass() : 0.0f;
+        for (int i = 0; i < 3; ++i) {
+            record.position[i] = transform.getOrigin()[i];
+            record.linearVelocity[i] = body->getLinearVelocity()[i];
+            record.angularVelocity[i] = body->getAngularVelocity()[i];
+        }
+        record.rotation[0] = rotation.x(); record.rotation[1] = rotation.y();
+        record.rotation[2] = rotation.z(); record.rotation[3] = rotation.w();
+        record.restitution = body->getRestitution();
+        record.friction = body->getFriction();
+        records.push_back(record);
+    };
+    for (const btRigidBody* body : m_bodies) capture(body, 0);
+    for (const btRigidBody* body : m_stressBodies) capture(body, SCENE_BODY_STRESS);
+}
+
+void PhysicsWorld::ClearSceneBodies() {
+    ClearStressBodies();
+    for (btRigidBody* body : m_bodies) {
+        m_dynamicsWorld->removeRigidBody(body);
+        delete body->getMotionState();
+        delete body;
+    }
+    m_bodies.clear();
+}
+
+static bool allFinite(const float* values, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        if (!std::isfinite(values[i])) return false;
+    }
+    return true;
+}
+
+// Every float of the record is checked: one NaN handed to Bullet spreads through the broadphase
+static bool isSceneBodyFinite(const SceneBodyRecord& record) {
+    return allFinite(record.shapeSize, 3) && std::isfinite(record.mass) && allFinite(record.position, 3) &&
+           allFinite(record.rotation, 4) && allFinite(record.linearVelocity, 3) && allFinite(record.angularVelocity, 3) &&
+           std::isfinite(record.restitution) && std::isfinite(record.friction);
+}
+
+size_t PhysicsWorld::AddSceneBodies(const SceneBodyRecord* records, size_t count) {
+    size_t added = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const SceneBodyRecord& record = records[i];
+        if (!isSceneBodyFinite(record)) continue;
+        btQuaternion rotation(record.rotation[0], record.rotation[1], record.rotation[2], record.rotation[3]);
+        if (!(rotation.length2() > SIMD_EPSILON)) continue; // No orientation to normalise
+        rotation.normalize();
+        btVector3 size(record.shapeSize[0], record.shapeSize[1], record.shapeSize[2]);
+        bool sphere = record.shape == static_cast<uint32_t>(SceneBodyShape::SPHERE);
+        if ((!sphere && record.shape != static_cast<uint32_t>(SceneBodyShape::BOX)) || !(size.x() > 0.0f) ||
+            (!sphere && !(size.y() > 0.0f && size.z() > 0.0f)) || !(record.mass >= 0.0f)) {
+            continue; // Unknown shape or degenerate size
+        }
+        btCollisionShape* shape = getSharedShape(record.shape, size);
+        btVector3 inertia(0, 0, 0);
+        if (record.mass > 0.0f) shape->calculateLocalInertia(record.mass, inertia);
+        btTransform transform(rotation, btVector3(record.position[0], record.position[1], record.position[2]));
+        btRigidBody::btRigidBodyConstructionInfo info(record.mass, new btDefaultMotionState(transform), shape, inertia);
+        info.m_restitution = std::clamp(record.restitution, 0.0f, 1.0f);
+        info.m_friction = std::max(record.friction, 0.0f);
+        btRigidBody* body = new btRigidBody(info);
+        body->setLinearVelocity(btVector3(record.linearVelocity[0], record.linearVelocity[1], record.linearVelocity[2]));
+        body->setAngularVelocity(btVector3(record.angularVelocity[0], record.angularVelocity[1], record.angularVelocity[2]));
+        m_dynamicsWorld->addRigidBody(body);
+        if (record.flags & SCENE_BODY_STRESS) m_stressBodies.push_back(body);
+        else m_bodies.push_back(body);
+        added++;
+    }
+    return added;
+}
+
+// Children of the iterator's current node, each followed by its own subtree
+static void captureProfileChildren(CProfileIterator* iterator, int depth, std::vector<PhysicsProfileNode>& nodes) {
+    std::vector<PhysicsProfileNode> children;
+    for (iterator->First(); !iterator->Is_Done(); iterator->Next()) {
+        PhysicsProfileNode node;
+        node.name = iterator->Get_Current_Name();
+        node.depth = depth;
+        node.totalMs = iterator->Get_Current_Total_Time();
+        node.calls = iterator->Get_Current_Total_Calls();
+        children.push_back(node);
+    }
+    for (size_t i = 0; i < children.size(); ++i) {
+        nodes.push_back(children[i]);
+        iterator->Enter_Child(static_cast<int>(i));
+        captureProfileChildren(iterator, depth + 1, nodes);
+        iterator->Enter_Parent();
+    }
+}
+
+void PhysicsWorld::CaptureStepStats(btDiscreteDynamicsWorld* world, float stepMs, PhysicsStepStats& stats) {
+    stats.stepMs = stepMs;
+    stats.overlappingPairs = world->getBroadphase()->getOverlappingPairCache()->getNumOverlappingPairs();
+    stats.contactManifolds = world->getDispatcher()->getNumManifolds();
+    stats.collisionObjects = world->getNumCollisionObjects();
+    stats.profile.clear();
+    CProfileIterator* iterator = CProfileManager::Get_Iterator();
+    if (!iterator) return; // Thread index outside the profiler's range
+    captureProfileChildren(iterator, 0, stats.profile);
+    CProfileManager::Release_Iterator(iterator);
+}
+
+// --- Physics Cleanup ---
+void PhysicsWorld::Shutdown() {
+    if (!m_dynamicsWorld) return;
+    LOG_INFO(PHYSICS) << "Cleaning up Bullet Physics...";
+    m_dynamicsWorld->setInternalTickCallback(nullptr, nullptr, true);
+    m_terrainCollider.reset(); // Removes its tile bodies, which it owns
+    for (int i = m_dynamicsWorld->getNumCollisionObjects() - 1; i >= 0; i--) {
+        btCollisionObject* obj = m_dynamicsWorld->getCollisionObjectArray()[i];
+        btRigidBody* body = btRigidBody::upcast(obj);
+        if (body && body->getMotionState()) { delete body->getMotionState(); }
+        m_dynamicsWorld->removeCollisionObject(obj);
+        delete obj;
+    }
+    m_bodies.clear();
+    m_stressBodies.clear();
+    m_sharedShapes.clear();
+    m_collisionShapes.clear();
+    m_dynamicsWorld.reset(); m_solver.reset(); m_solverPool.reset(); m_overlappingPairCache.reset();
+    m_dispatcher.reset(); m_collisionConfiguration.reset();
+    if (m_taskScheduler) {
+        btSetTaskScheduler(btGetSequentialTaskScheduler());
+        m_taskScheduler.reset();
+    }
+    LOG_INFO(PHYSICS) << "Bullet Physics Cleaned up.";
+}
@@ -0,0 +1,157 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <cstring>
+
+// Samples kept per section (about 4 s at 60 FPS) for the averages, percentiles and the graph
+static const size_t PROFILER_HISTORY_FRAMES = 240;
+
+// --- SampleHistory ---
+
+SampleHistory::SampleHistory(size_t capacity) : m_samples(capacity, 0.0f) {}
+
+void SampleHistory::Push(float value) {
+    m_samples[m_head] = value;
+    m_head = (m_head + 1) % m_samples.size();
+    if (m_count < m_samples.size()) m_count++;
+    m_pushCount++;
+}
+
+ProfileStats SampleHistory::ComputeStats() const {
+    ProfileStats stats;
+    stats.sampleCount = m_count;
+    if (m_count == 0) return stats;
+
+    stats.lastMs = m_samples[(m_head + m_samples.size() - 1) % m_samples.size()];
+    // Until the ring has wrapped the valid samples are [0, m_count); afterwards all of it
+    std::vector<float> sorted(m_samples.begin(), m_samples.begin() + m_count);
+    double sum = 0.0;
+    for (float v : sorted) sum += v;
+    stats.averageMs = static_cast<float>(sum / static_cast<double>(m_count));
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&](float p) { return sorted[std::min(m_count - 1, static_cast<size_t>(p * static_cast<float>(m_count)))]; };
+    stats.p95Ms = percentile(0.95f);
+    stats.p99Ms = percentile(0.99f);
+    return stats;
+}
+
+// --- Profiler ---
+
+Profiler::Section::Section(const char* sectionName, size_t historyFrames)
+    : key(sectionName), name(sectionName), cpu(historyFrames), gpu(historyFrames) {}
+
+Profiler::Profiler(size_t historyFrames)
+    : m_historyFrames(historyFrames > 0 ? historyFrames : PROFILER_HISTORY_FRAMES), m_frameHistory(m_historyFrames) {}
+
+Profiler::~Profiler() {
+    for (FrameQueries& frame : m_frames) {
+        for (TimerQuery& query : frame.queries) {
+            glDeleteQueries(1, &query.begin);
+            glDeleteQueries(1, &query.end);
+        }
+    }
+}
+
+int Profiler::findSection(const char* name) {
+    for (size_t i = 0; i < m_sections.size(); ++i) {
+        if (m_sections[i].key == name) return static_cast<int>(i);
+    }
+    for (size_t i = 0; i < m_sections.size(); ++i) {
+        if (m_sections[i].name == name) return static_cast<int>(i);
+    }
+    m_sections.emplace_back(name, m_historyFrames);
+    return static_cast<int>(m_sections.size() - 1);
+}
+
+int Profiler::FindSection(const char* name) const {
+    for (size_t i = 0; i < m_sections.size(); ++i) {
+        if (m_sections[i].key == name || m_sections[i].name == name) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+void Profiler::BeginFrame() {
+    Clock::time_point now = Clock::now();
+    if (m_hasLastFrame) {
+        m_frameHistory.Push(std::chrono::duration<float, std::milli>(now - m_lastFrameStart).count());
+    }
+    m_lastFrameStart = now;
+    m_hasLastFrame = true;
+
+    // This slot was filled PROFILER_QUERY_FRAMES frames ago; collect it before reusing its queries
+    readBack(m_frames[m_frameSlot]);
+}
+
+void Profiler::EndFrame() {
+    m_frameSlot = (m_frameSlot + 1) % PROFILER_QUERY_FRAMES;
+}
+
+void Profiler::Reset() {
+    for (FrameQueries& frame : m_frames) frame.used = 0;
+    for (Section& section : m_sections) {
+        section.cpu = SampleHistory(m_historyFrames);
+        section.gpu = SampleHistory(m_historyFrames);
+    }
+    m_frameHistory = SampleHistory(m_historyFrames);
+    m_hasLastFrame = false;
+    m_droppedQueries = 0;
+}
+
+void Profiler::Flush() {
+    glFinish();
+    // Oldest slot first so the GPU samples stay in frame order
+    for (size_t i = 0; i < PROFILER_QUERY_FRAMES; ++i) {
+        readBack(m_frames[(m_frameSlot + i) % PROFILER_QUERY_FRAMES]);
+    }
+}
+
+void Profiler::readBack(FrameQueries& frame) {
+    for (size_t i = 0; i < frame.used; ++i) {
+        TimerQuery& query = frame.queries[i];
+        GLint available = 0;
+        glGetQueryObjectiv(query.end, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) { m_droppedQueries++; continue; } // Never block on the GPU
+        GLuint64 begin = 0, end = 0;
+        glGetQueryObjectui64v(query.begin, GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(query.end, GL_QUERY_RESULT, &end);
+        m_sections[query.section].gpu.Push(static_cast<float>(static_cast<double>(end - begin) / 1.0e6));
+    }
+    frame.used = 0;
+}
+
+int Profiler::BeginSection(const char* name, bool gpu) {
+    if (!m_enabled) return -1;
+    int index = findSection(name);
+    Section& section = m_sections[index];
+    section.cpuStart = Clock::now();
+    section.openQuery = -1;
+    if (gpu) {
+        FrameQueries& frame = m_frames[m_frameSlot];
+        if (frame.used == frame.queries.size()) {
+            TimerQuery query;
+            glGenQueries(1, &query.begin);
+            glGenQueries(1, &query.end);
+            frame.queries.push_back(query);
+        }
+        TimerQuery& query = frame.queries[frame.used];
+        query.section = index;
+        glQueryCounter(query.begin, GL_TIMESTAMP);
+        section.openQuery = static_cast<int>(frame.used++);
+        section.hasGpu = true;
+    }
+    return index;
+}
+
+void Profiler::EndSection(int index) {
+    if (index < 0 || index >= static_cast<int>(m_sections.size())) return;
+    Section& section = m_sections[index];
+    if (section.openQuery >= 0) {
+        glQueryCounter(m_frames[m_frameSlot].queries[section.openQuery].end, GL_TIMESTAMP);
+        section.openQuery = -1;
+    }
+    section.cpu.Push(std::chrono::duration<float, std::milli>(Clock::now() - section.cpuStart).count());
+}
+
+void Profiler::AddCpuSample(const char* name, float ms) {
+    if (!m_enabled) return;
+    m_sections[findSection(name)].cpu.Push(ms);
+}
@@ -0,0 +1,98 @@
+#include "QualityGovernor.h"
+#include "Log.h"
+#include <algorithm>
+
+// Frame samples averaged per decision (half a second at 60 FPS)
+static const size_t GOVERNOR_WINDOW_FRAMES = 30;
+// A step up needs the average below this fraction of the budget (the next tier up costs more)
+static const float GOVERNOR_UPGRADE_HEADROOM = 0.75f;
+// Consecutive windows of headroom before stepping up; doubled (up to the maximum) after a bounce
+static const size_t GOVERNOR_UPGRADE_WINDOWS = 3;
+static const size_t GOVERNOR_MAX_UPGRADE_WINDOWS = 24;
+// Dropping out of a tier within this many windows of stepping up into it counts as a bounce
+static const size_t GOVERNOR_BOUNCE_WINDOWS = 4;
+// Windows ignored after a change
+static const size_t GOVERNOR_SETTLE_WINDOWS = 1;
+
+struct QualityTier {
+    const char* name;
+    QualitySettings settings;
+};
+
+// Tier 0 matches the renderer's defaults; each step gives up roughly a similar share of GPU time
+static const QualityTier QUALITY_TIERS[] = {
+    { "High",     { 1, 8, 100, 80, 32, 2 } },
+    { "Medium",   { 1, 8,  80, 64, 24, 2 } },
+    { "Low",      { 2, 8,  80, 48, 16, 2 } },
+    { "Very Low", { 2, 4,  64, 32, 12, 4 } },
+    { "Minimum",  { 4, 3,  48, 24,  8, 4 } },
+};
+static const size_t QUALITY_TIER_COUNT = sizeof(QUALITY_TIERS) / sizeof(QUALITY_TIERS[0]);
+
+QualityGovernor::QualityGovernor() : m_upgradeWindows(GOVERNOR_UPGRADE_WINDOWS) {}
+
+void QualityGovernor::SetEnabled(bool enabled) {
+    if (enabled == m_enabled) return;
+    m_enabled = enabled;
+    // Start every run from the top with fresh measurements
+    m_tier = 0;
+    m_windowSum = 0.0;
+    m_windowSamples = 0;
+    m_measuredMs = 0.0f;
+    m_settleWindows = 0;
+    m_underBudgetWindows = 0;
+    m_upgradeWindows = GOVERNOR_UPGRADE_WINDOWS;
+    m_windowsInTier = 0;
+    m_enteredByUpgrade = false;
+}
+
+size_t QualityGovernor::GetTierCount() { return QUALITY_TIER_COUNT; }
+
+const char* QualityGovernor::GetTierName(size_t tier) { return tier < QUALITY_TIER_COUNT ? QUALITY_TIERS[tier].name : "?"; }
+
+const QualitySettings& QualityGovernor::GetSettings() const { return QUALITY_TIERS[m_tier].settings; }
+
+bool QualityGovernor::AddFrameSample(float gpuMs) {
+    if (!m_enabled) return false;
+    m_windowSum += gpuMs;
+    if (++m_windowSamples < GOVERNOR_WINDOW_FRAMES) return false;
+
+    m_measuredMs = static_cast<float>(m_windowSum / static_cast<double>(m_windowSamples));
+    m_windowSum = 0.0;
+    m_windowSamples = 0;
+    m_windowsInTier++;
+    if (m_settleWindows > 0) { m_settleWindows--; return false; }
+
+    if (m_measuredMs > m_budgetMs) {
+        m_underBudgetWindows = 0;
+        if (m_tier + 1 >= QUALITY_TIER_COUNT) return false;
+        // Stepped up into this tier and could not hold it: be slower to try again
+        if (m_enteredByUpgrade && m_windowsInTier <= GOVERNOR_BOUNCE_WINDOWS) {
+            m_upgradeWindows = std::min(m_upgradeWindows * 2, GOVERNOR_MAX_UPGRADE_WINDOWS);
+        }
+        setTier(m_tier + 1, false);
+        return true;
+    }
+
+    if (m_measuredMs < m_budgetMs * GOVERNOR_UPGRADE_HEADROOM) {
+        if (++m_underBudgetWindows >= m_upgradeWindows && m_tier > 0) {
+            setTier(m_tier - 1, true);
+            return true;
+        }
+    } else {
+        m_underBudgetWindows = 0;
+    }
+    // Holding a tier for a long stretch earns back the quick step up
+    if (m_windowsInTier > GOVERNOR_MAX_UPGRADE_WINDOWS * 2) m_upgradeWindows = GOVERNOR_UPGRADE_WINDOWS;
+    return false;
+}
+
+void QualityGovernor::setTier(size_t tier, bool upgrade) {
+    LOG_INFO(RENDER) << "Quality governor: " << QUALITY_TIERS[m_tier].name << " -> " << QUALITY_TIERS[tier].name
+                     << " (" << m_measuredMs << " ms, budget " << m_budgetMs << " ms)";
+    m_tier = tier;
+    m_settleWindows = GOVERNOR_SETTLE_WINDOWS;
+    m_underBudgetWindows = 0;
+    m_windowsInTier = 0;
+    m_enteredByUpgrade = upgrade;
+}
@@ -0,0 +1,42 @@
+#include "RaymarchParams.h"
+#include "Log.h"
+#include "MemoryStats.h"
+#include <cstring>
+
+RaymarchParamsBuffer::~RaymarchParamsBuffer() {
+    Destroy();
+}
+
+bool RaymarchParamsBuffer::Create() {
+    Destroy();
+    glGenBuffers(1, &m_ubo);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_ubo);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(RaymarchParamsBlock), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, RAYMARCH_PARAMS_BINDING, m_ubo);
+    if (glGetError() != GL_NO_ERROR) {
+        LOG_ERROR(RENDER) << "Failed to create RaymarchParams uniform buffer.";
+        Destroy();
+        return false;
+    }
+    MemoryStats::TrackBuffer(m_ubo, MemoryCategory::STREAMING_BUFFERS, sizeof(RaymarchParamsBlock));
+    m_hasData = false;
+    return true;
+}
+
+void RaymarchParamsBuffer::Destroy() {
+    if (m_ubo != 0) { MemoryStats::UntrackBuffer(m_ubo); glDeleteBuffers(1, &m_ubo); m_ubo = 0; }
+    m_hasData = false;
+}
+
+bool RaymarchParamsBuffer::Update(const RaymarchParamsBlock& params) {
+    if (!IsValid()) return false;
+    if (m_hasData && std::memcmp(&params, &m_uploaded, sizeof(RaymarchParamsBlock)) == 0) return false;
+    glBindBuffer(GL_UNIFORM_BUFFER, m_ubo);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(RaymarchParamsBlock), &params);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    m_uploaded = params;
+    m_hasData = true;
+    m_uploadCount++;
+    return true;
+}
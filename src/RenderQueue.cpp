@@ -0,0 +1,184 @@
+#include "RenderQueue.h"
+#include "Log.h"
+#include "MemoryStats.h"
+#include "InstanceBuffer.h"
+#include "Shader.h"
+#include <algorithm>
+#include <memory>
+#include <new>
+
+// Arena commands reserved on the first submit of a frame
+static const size_t INITIAL_COMMAND_CAPACITY = 256;
+// Shorter runs are cheaper as plain draws than filling two buffers for them
+static const size_t MIN_MULTI_DRAW_RUN = 2;
+
+RenderQueue::~RenderQueue() {
+    Destroy();
+}
+
+void RenderQueue::Destroy() {
+    if (m_indirectBuffer) { MemoryStats::UntrackBuffer(m_indirectBuffer); glDeleteBuffers(1, &m_indirectBuffer); m_indirectBuffer = 0; }
+    if (m_transformBuffer) { MemoryStats::UntrackBuffer(m_transformBuffer); glDeleteBuffers(1, &m_transformBuffer); m_transformBuffer = 0; }
+}
+
+bool RenderQueue::SupportsMultiDraw() {
+    return GLEW_VERSION_4_3 || (GLEW_ARB_multi_draw_indirect && GLEW_ARB_base_instance);
+}
+
+bool RenderQueue::EnableMultiDraw(Shader* shader, Shader* instancedVariant, GLuint instanceAttribute) {
+    if (!SupportsMultiDraw() || !shader || !instancedVariant) return false;
+    Destroy();
+    glGenBuffers(1, &m_indirectBuffer);
+    glGenBuffers(1, &m_transformBuffer);
+    m_multiDrawShader = shader;
+    m_multiDrawVariant = instancedVariant;
+    m_multiDrawAttribute = instanceAttribute;
+    LOG_INFO(RENDER) << "Render queue: multi-draw indirect enabled";
+    return true;
+}
+
+void RenderQueue::BeginFrame() {
+    m_commands = nullptr;
+    m_count = 0;
+    m_capacity = 0;
+}
+
+size_t RenderQueue::multiDrawRun(const SortEntry* entries, size_t first) const {
+    const DrawCommand& head = m_commands[entries[first].index];
+    if (!IsMultiDrawActive() || head.shader != m_multiDrawShader || head.instances) return 1;
+    size_t last = first + 1;
+    while (last < m_count) {
+        const DrawCommand& command = m_commands[entries[last].index];
+        // Same key means same program, texture and VAO
+        if (entries[last].key != entries[first].key || command.instances || command.indexType != head.indexType ||
+            !(command.layout == head.layout)) break;
+        ++last;
+    }
+    return last - first;
+}
+
+// One indirect command and one model matrix per entry; draw i reads matrix i through baseInstance
+void RenderQueue::multiDraw(const SortEntry* entries, size_t first, size_t count) {
+    IndirectCommand* indirect = m_arena.AllocateArray<IndirectCommand>(count);
+    glm::mat4* transforms = m_arena.AllocateArray<glm::mat4>(count);
+    for (size_t i = 0; i < count; ++i) {
+        const DrawCommand& command = m_commands[entries[first + i].index];
+        indirect[i] = { command.indexCount, 1u, command.firstIndex, command.baseVertex, static_cast<GLuint>(i) };
+        transforms[i] = command.model;
+    }
+    // Orphan and refill: the previous batch's contents may still be in flight
+    glBindBuffer(GL_ARRAY_BUFFER, m_transformBuffer);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(count * sizeof(glm::mat4)), transforms, GL_STREAM_DRAW);
+    MemoryStats::TrackBuffer(m_transformBuffer, MemoryCategory::STREAMING_BUFFERS, count * sizeof(glm::mat4));
+    for (GLuint column = 0; column < 4; ++column) {
+        glEnableVertexAttribArray(m_multiDrawAttribute + column);
+        glVertexAttribPointer(m_multiDrawAttribute + column, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+                              reinterpret_cast<void*>(column * 4 * sizeof(float)));
+        glVertexAttribDivisor(m_multiDrawAttribute + column, 1);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_indirectBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, static_cast<GLsizeiptr>(count * sizeof(IndirectCommand)), indirect, GL_STREAM_DRAW);
+    MemoryStats::TrackBuffer(m_indirectBuffer, MemoryCategory::STREAMING_BUFFERS, count * sizeof(IndirectCommand));
+    glMultiDrawElementsIndirect(GL_TRIANGLES, m_commands[entries[first].index].indexType, nullptr, static_cast<GLsizei>(count), 0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    // The bucket VAO is shared with ordinary draws, which must not see the per-instance transform
+    for (GLuint column = 0; column < 4; ++column) {
+        glVertexAttribDivisor(m_multiDrawAttribute + column, 0);
+        glDisableVertexAttribArray(m_multiDrawAttribute + column);
+    }
+}
+
+void RenderQueue::Submit(const DrawCommand& command) {
+    if (m_count == m_capacity) {
+        // The old array stays in the arena until it is reset; only the copy survives
+        size_t capacity = m_capacity ? m_capacity * 2 : INITIAL_COMMAND_CAPACITY;
+        DrawCommand* commands = m_arena.AllocateArray<DrawCommand>(capacity);
+        std::uninitialized_copy(m_commands, m_commands + m_count, commands);
+        m_commands = commands;
+        m_capacity = capacity;
+    }
+    new (&m_commands[m_count++]) DrawCommand(command);
+}
+
+// [63..56] program slot | [55..32] texture name | [31..0] VAO name
+uint64_t RenderQueue::makeKey(const DrawCommand& command) {
+    size_t slot = 0;
+    while (slot < m_shaderSlotCount && m_shaderSlots[slot] != command.shader) ++slot;
+    if (slot == m_shaderSlotCount && m_shaderSlotCount < MAX_KEYED_SHADERS) m_shaderSlots[m_shaderSlotCount++] = command.shader;
+    slot = std::min(slot, MAX_KEYED_SHADERS - 1);
+    return (static_cast<uint64_t>(slot) << 56) | (static_cast<uint64_t>(command.texture & 0xFFFFFFu) << 32) | command.vao;
+}
+
+void RenderQueue::Flush(const glm::mat4& view, const glm::mat4& projection) {
+    if (m_count == 0) return;
+    SortEntry* entries = m_arena.AllocateArray<SortEntry>(m_count);
+    for (size_t i = 0; i < m_count; ++i) entries[i] = { makeKey(m_commands[i]), static_cast<uint32_t>(i) };
+    std::sort(entries, entries + m_count, [](const SortEntry& a, const SortEntry& b) {
+        return a.key != b.key ? a.key < b.key : a.index < b.index;
+    });
+
+    Shader* shader = nullptr;
+    GLuint texture = 0, vao = 0;
+    bool textureState = false; // useTexture was set for the current program
+    uint32_t layoutCode = ~0u;
+    for (size_t i = 0; i < m_count;) {
+        const DrawCommand& command = m_commands[entries[i].index];
+        size_t run = multiDrawRun(entries, i);
+        bool batched = run >= MIN_MULTI_DRAW_RUN;
+        if (!batched) run = 1;
+        Shader* program = batched ? m_multiDrawVariant : command.shader;
+        if (program != shader) {
+            shader = program;
+            shader->use();
+            shader->setMat4("view", view);
+            shader->setMat4("projection", projection);
+            shader->setInt("texture1", 0);
+            textureState = false;
+            m_stats.programBinds++;
+        }
+        if (command.texture != texture) {
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, command.texture);
+            texture = command.texture;
+            textureState = false;
+            m_stats.textureBinds++;
+        }
+        if (!textureState) {
+            shader->setBool("useTexture", texture != 0);
+            textureState = true;
+        }
+        if (command.vao != vao) {
+            glBindVertexArray(command.vao);
+            vao = command.vao;
+            m_stats.vaoBinds++;
+        }
+        if (command.layout.Encode() != layoutCode) {
+            command.layout.ApplyConstants();
+            layoutCode = command.layout.Encode();
+        }
+
+        if (batched) {
+            multiDraw(entries, i, run);
+            m_stats.multiDraws++;
+        } else {
+            const void* indexOffset = reinterpret_cast<const void*>(static_cast<size_t>(command.firstIndex) * IndexSize(command.indexType));
+            if (command.instances) {
+                command.instances->BindMat4Attribute(command.instanceAttribute, command.instanceOffset);
+                glDrawElementsInstancedBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(command.indexCount), command.indexType, indexOffset,
+                                                  static_cast<GLsizei>(command.instanceCount), command.baseVertex);
+            } else {
+                shader->setMat4("model", command.model);
+                glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(command.indexCount), command.indexType, indexOffset, command.baseVertex);
+            }
+        }
+        m_stats.draws++;
+        m_stats.commands += run;
+        i += batched ? run : 1;
+    }
+
+    glBindVertexArray(0);
+    if (texture) glBindTexture(GL_TEXTURE_2D, 0);
+    glUseProgram(0);
+    m_count = 0;
+}
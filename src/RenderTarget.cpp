@@ -0,0 +1,97 @@
+#include "RenderTarget.h"
+#include "Log.h"
+#include "MemoryStats.h"
+
+// Storage the attachment formats used in the renderer take per texel (4 bytes for anything else)
+static size_t bytesPerTexel(GLenum internalFormat) {
+    switch (internalFormat) {
+        case GL_R8:      return 1;
+        case GL_R16F:
+        case GL_RG8:     return 2;
+        case GL_RGBA16F:
+        case GL_RG32F:   return 8;
+        case GL_RGBA32F: return 16;
+        default:         return 4;
+    }
+}
+
+RenderTarget::~RenderTarget() {
+    Destroy();
+}
+
+bool RenderTarget::Create(int width, int height, const std::vector<RenderTargetAttachment>& colorAttachments, bool withDepth) {
+    Destroy();
+    if (width <= 0 || height <= 0) return false;
+    m_width = width;
+    m_height = height;
+
+    glGenFramebuffers(1, &m_fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+
+    // Color attachments
+    std::vector<GLenum> drawBuffers;
+    for (size_t i = 0; i < colorAttachments.size(); ++i) {
+        const RenderTargetAttachment& desc = colorAttachments[i];
+        GLuint tex = 0;
+        glGenTextures(1, &tex);
+        glBindTexture(GL_TEXTURE_2D, tex);
+        glTexImage2D(GL_TEXTURE_2D, 0, desc.internalFormat, width, height, 0, desc.format, desc.type, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, desc.filter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, desc.filter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        GLenum attachment = GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(i);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, tex, 0);
+        m_colorTextures.push_back(tex);
+        MemoryStats::TrackTexture(tex, MemoryCategory::RENDER_TARGETS,
+                                  static_cast<size_t>(width) * height * bytesPerTexel(desc.internalFormat));
+        drawBuffers.push_back(attachment);
+    }
+    if (!drawBuffers.empty()) glDrawBuffers(static_cast<GLsizei>(drawBuffers.size()), drawBuffers.data());
+    else glDrawBuffer(GL_NONE);
+
+    // Optional depth attachment (as a texture so later passes can sample it)
+    if (withDepth) {
+        glGenTextures(1, &m_depthTexture);
+        glBindTexture(GL_TEXTURE_2D, m_depthTexture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, width, height, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, m_depthTexture, 0);
+        MemoryStats::TrackTexture(m_depthTexture, MemoryCategory::RENDER_TARGETS, static_cast<size_t>(width) * height * 4); // Padded to 32 bits
+    }
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        LOG_ERROR(RENDER) << "ERROR::RENDER_TARGET: Framebuffer incomplete (status 0x" << std::hex << status << std::dec
+                          << ", " << width << "x" << height << ")";
+        Destroy();
+        return false;
+    }
+    return true;
+}
+
+void RenderTarget::Destroy() {
+    if (!m_colorTextures.empty()) {
+        for (GLuint tex : m_colorTextures) MemoryStats::UntrackTexture(tex);
+        glDeleteTextures(static_cast<GLsizei>(m_colorTextures.size()), m_colorTextures.data());
+        m_colorTextures.clear();
+    }
+    if (m_depthTexture != 0) { MemoryStats::UntrackTexture(m_depthTexture); glDeleteTextures(1, &m_depthTexture); m_depthTexture = 0; }
+    if (m_fbo != 0) { glDeleteFramebuffers(1, &m_fbo); m_fbo = 0; }
+    m_width = m_height = 0;
+}
+
+void RenderTarget::Bind() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+    glViewport(0, 0, m_width, m_height);
+}
+
+void RenderTarget::BindDefault(int width, int height) {
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, width, height);
+}
@@ -1,25 +1,30 @@
 #define GLM_ENABLE_EXPERIMENTAL
 
 #include "Renderer.h"
+#include "Log.h"
+#include "MemoryStats.h"
+#include "GLDebugOutput.h"
 #include "Shader.h"
 #include "Camera.h"
 #include "Mesh.h"
 #include "Textures.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <glm/gtc/constants.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtx/quaternion.hpp>
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include <btBulletDynamicsCommon.h>
-#include <iostream>
 #include <string>
 #include <vector>
 #include <thread>
 #include <filesystem>
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <cstddef>
+#include <cstdio>
 #include <memory>
 #include <imgui.h>
 #include <imgui_impl_glfw.h>
@@ -30,8 +35,10 @@
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
-// Helper function to check for OpenGL errors
+// Helper function to check for OpenGL errors. With debug output active the driver reports errors through
+// the callback as they happen, so the glGetError round trip is skipped.
 void checkGLError(const char* operation) {
+    if (GLDebugOutput::IsActive()) return;
     GLenum error;
     while ((error = glGetError()) != GL_NO_ERROR) {
         std::string errorStr;
@@ -43,12 +50,37 @@ void checkGLError(const char* operation) {
             case GL_STACK_UNDERFLOW: errorStr = "GL_STACK_UNDERFLOW"; break;
             default:                 errorStr = "Unknown GL error";   break;
         }
-        std::cerr << "OpenGL error after " << operation << ": " << errorStr << " (" << error << ")" << std::endl;
+        LOG_ERROR(GL) << "OpenGL error after " << operation << ": " << errorStr << " (" << error << ")";
     }
 }
 
 Camera* callbackCamera = nullptr;
 
+// First attribute location of the per-instance model matrix in vertex_instanced.glsl (occupies 4 locations)
+static const GLuint INSTANCE_MODEL_ATTRIBUTE = 4;
+// Initial instance capacity per frame; the buffer doubles when more bodies are visible
+static const size_t INITIAL_PHYSICS_INSTANCES = 1024;
+
+// GL-thread time per frame spent streaming imported meshes to the GPU
+static const double ASSET_UPLOAD_BUDGET_MS = 2.0;
+// GL-thread time per frame spent streaming texture rows into PBOs
+static const double TEXTURE_UPLOAD_BUDGET_MS = 2.0;
+// Time per frame spent creating the bodies of a scene being opened (the physics world is locked meanwhile),
+// checked after every batch
+static const double SCENE_LOAD_BUDGET_MS = 4.0;
+static const size_t SCENE_LOAD_BATCH_BODIES = 512;
+
+// Lowest the editor camera may sit above the terrain surface
+static const float EDITOR_CAMERA_CLEARANCE = 0.3f;
+
+// Texture units used by the raymarch shader
+static const int TERRAIN_CACHE_TEXTURE_UNIT = 0;
+static const int CLOUD_NOISE_TEXTURE_UNIT = 1;
+static const int CLOUD_BUFFER_TEXTURE_UNIT = 2;
+static const int CLOUD_DISTANCE_TEXTURE_UNIT = 3;
+static const int SCENE_DEPTH_TEXTURE_UNIT = 4;
+static const int TERRAIN_MAX_MIP_TEXTURE_UNIT = 5;
+
 // --- Constructor ---
 Renderer::Renderer(int width, int height, const char* title)
     : width(width), height(height), title(title), window(nullptr),
@@ -66,14 +98,15 @@ Renderer::Renderer(int width, int height, const char* title)
       quadVAO(0), quadVBO(0),
       m_raymarchShader(nullptr),
       m_rasterShader(nullptr),
-      m_cubeVAO(0), m_cubeVBO(0), m_cubeEBO(0), m_cubeIndexCount(0),
+      m_cubeVAO(0), m_cubeVBO(0), m_cubeEBO(0), m_cubeIndexCount(0), m_cubeIndexType(GL_UNSIGNED_INT),
+      m_sphereVAO(0), m_sphereVBO(0), m_sphereEBO(0), m_sphereIndexCount(0), m_sphereIndexType(GL_UNSIGNED_INT),
       m_raymarch_timeLoc(-1), m_raymarch_camPosLoc(-1), m_raymarch_invViewLoc(-1),
-      m_raymarch_invProjLoc(-1), m_raymarch_lightDirLoc(-1), m_raymarch_lightColorLoc(-1),
-      m_raymarch_ambientLoc(-1), m_raymarch_terrain_base_freqLoc(-1), m_raymarch_terrain_base_ampLoc(-1),
-      m_raymarch_terrain_persistenceLoc(-1), m_raymarch_terrain_flatten_powerLoc(-1),
-      m_raymarch_terrain_final_scaleLoc(-1), m_raymarch_terrain_octavesLoc(-1),
-      m_raymarch_cloud_base_heightLoc(-1), m_raymarch_cloud_thicknessLoc(-1), m_raymarch_cloud_noise_scaleLoc(-1),
-      m_raymarch_cloud_coverage_minLoc(-1), m_raymarch_cloud_coverage_maxLoc(-1), m_raymarch_cloud_density_factorLoc(-1),
+      m_raymarch_invProjLoc(-1), m_raymarch_jitterLoc(-1),
+      m_raymarch_terrainCacheLoc(-1), m_raymarch_terrainCacheRectLoc(-1), m_raymarch_terrainCacheTexelLoc(-1), m_raymarch_useTerrainCacheLoc(-1),
+      m_raymarch_cloudNoiseLoc(-1), m_raymarch_cloudsEnabledLoc(-1), m_raymarch_cloudBufferLoc(-1), m_raymarch_cloudDistanceLoc(-1),
+      m_raymarch_hybridDepthLoc(-1), m_raymarch_sceneDepthLoc(-1), m_raymarch_viewProjLoc(-1),
+      m_raymarch_terrainMaxMipLoc(-1), m_raymarch_terrainMaxMipLevelsLoc(-1), m_raymarch_terrainTraversalLoc(-1),
+      m_raymarch_terrainMaxStepsLoc(-1), m_raymarch_terrainStepViewLoc(-1), m_raymarch_shadowStepsLoc(-1),
       m_lightDirection(glm::normalize(glm::vec3(0.8f, 0.7f, -0.5f))),
       m_lightColor(glm::vec3(1.0f, 0.95f, 0.85f)),
       m_ambientStrength(0.15f),
@@ -89,13 +122,31 @@ Renderer::Renderer(int width, int height, const char* title)
 
 Renderer::~Renderer() {
     ShutdownImGui();
+    m_assetImporter.reset(); // Waits for running parse jobs, then frees staged meshes while GL is alive
+    m_sceneAssets.clear();
+    m_meshPool.reset(); // After every mesh allocated from it
+    m_renderQueue.Destroy();
+    m_framePacer.Destroy();
     if (texture) { delete texture; texture = nullptr; }
-    if (quadVBO != 0) { glDeleteBuffers(1, &quadVBO); quadVBO = 0; }
+    m_textureStreamer.reset(); // Waits for running decodes, deletes the cached textures
+    m_threadPool.reset();
+    m_temporalUpscaler.reset(); // Release GL objects while the context still exists
+    m_terrainCache.reset();
+    m_terrainClipmap.reset();
+    m_cloudRenderer.reset();
+    m_profiler.reset(); // Owns timer queries
+    if (quadVBO != 0) { MemoryStats::UntrackBuffer(quadVBO); glDeleteBuffers(1, &quadVBO); quadVBO = 0; }
     if (quadVAO != 0) { glDeleteVertexArrays(1, &quadVAO); quadVAO = 0; }
-    if (m_cubeEBO != 0) { glDeleteBuffers(1, &m_cubeEBO); m_cubeEBO = 0; }
-    if (m_cubeVBO != 0) { glDeleteBuffers(1, &m_cubeVBO); m_cubeVBO = 0; }
+    if (m_cubeEBO != 0) { MemoryStats::UntrackBuffer(m_cubeEBO); glDeleteBuffers(1, &m_cubeEBO); m_cubeEBO = 0; }
+    if (m_cubeVBO != 0) { MemoryStats::UntrackBuffer(m_cubeVBO); glDeleteBuffers(1, &m_cubeVBO); m_cubeVBO = 0; }
     if (m_cubeVAO != 0) { glDeleteVertexArrays(1, &m_cubeVAO); m_cubeVAO = 0; }
-    std::cout << "Cleaned up screen quad and physics meshes." << std::endl;
+    if (m_sphereEBO != 0) { MemoryStats::UntrackBuffer(m_sphereEBO); glDeleteBuffers(1, &m_sphereEBO); m_sphereEBO = 0; }
+    if (m_sphereVBO != 0) { MemoryStats::UntrackBuffer(m_sphereVBO); glDeleteBuffers(1, &m_sphereVBO); m_sphereVBO = 0; }
+    if (m_sphereVAO != 0) { glDeleteVertexArrays(1, &m_sphereVAO); m_sphereVAO = 0; }
+    m_physicsInstances.Destroy();
+    m_depthPrepass.Destroy();
+    m_raymarchParams.Destroy();
+    LOG_INFO(RENDER) << "Cleaned up screen quad and physics meshes.";
     glfwTerminate();
 }
 
@@ -106,9 +157,9 @@ void Renderer::InitImGui() {
     io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
     io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;
     ImGui::StyleColorsDark();
-    if (!ImGui_ImplGlfw_InitForOpenGL(window, true)) { std::cerr << "Failed to initialize ImGui GLFW backend" << std::endl; return; }
-    if (!ImGui_ImplOpenGL3_Init("#version 330 core")) { std::cerr << "Failed to initialize ImGui OpenGL3 backend" << std::endl; return; }
-    std::cout << "ImGui Initialized Successfully (Docking Enabled)" << std::endl;
+    if (!ImGui_ImplGlfw_InitForOpenGL(window, true)) { LOG_ERROR(RENDER) << "Failed to initialize ImGui GLFW backend"; return; }
+    if (!ImGui_ImplOpenGL3_Init("#version 330 core")) { LOG_ERROR(RENDER) << "Failed to initialize ImGui OpenGL3 backend"; return; }
+    LOG_INFO(RENDER) << "ImGui Initialized Successfully (Docking Enabled)";
 }
 
 void Renderer::ShutdownImGui() {
@@ -116,13 +167,13 @@ void Renderer::ShutdownImGui() {
         ImGui_ImplOpenGL3_Shutdown();
         ImGui_ImplGlfw_Shutdown();
         ImGui::DestroyContext();
-        std::cout << "ImGui Shutdown Successfully" << std::endl;
+        LOG_INFO(RENDER) << "ImGui Shutdown Successfully";
     }
 }
 
-bool Renderer::Initialize() {
-    std::cout << "Initializing GLFW..." << std::endl;
-    if (!glfwInit()) { std::cerr << "Failed to initialize GLFW" << std::endl; return false; }
+bool Renderer::Initialize(const RendererSettings& settings) {
+    LOG_INFO(RENDER) << "Initializing GLFW...";
+    if (!glfwInit()) { LOG_ERROR(RENDER) << "Failed to initialize GLFW"; return false; }
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
@@ -131,30 +182,36 @@ bool Renderer::Initialize() {
     #endif
     glfwWindowHint(GLFW_DOUBLEBUFFER, GLFW_TRUE);
     glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
+    glfwWindowHint(GLFW_VISIBLE, settings.visible ? GLFW_TRUE : GLFW_FALSE);
+#ifndef NDEBUG
+    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE); // Full driver validation in debug builds
+#endif
 
-    std::cout << "Creating window..." << std::endl;
+    LOG_INFO(RENDER) << "Creating window...";
     window = glfwCreateWindow(width, height, title, NULL, NULL);
-    if (!window) { std::cerr << "Failed to create GLFW window" << std::endl; glfwTerminate(); return false; }
+    if (!window) { LOG_ERROR(RENDER) << "Failed to create GLFW window"; glfwTerminate(); return false; }
 
     glfwSetWindowUserPointer(window, this);
     glfwMakeContextCurrent(window);
-    glfwSwapInterval(1);
+    m_showUI = settings.showUI;
 
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
     glfwSetCursorPosCallback(window, mouse_callback);
     glfwSetScrollCallback(window, scroll_callback);
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
 
-    std::cout << "Initializing GLEW..." << std::endl;
+    LOG_INFO(RENDER) << "Initializing GLEW...";
     glewExperimental = GL_TRUE;
     GLenum err = glewInit();
-    if (err != GLEW_OK) { std::cerr << "Failed to initialize GLEW: " << glewGetErrorString(err) << std::endl; glfwDestroyWindow(window); glfwTerminate(); return false; }
+    if (err != GLEW_OK) { LOG_ERROR(RENDER) << "Failed to initialize GLEW: " << glewGetErrorString(err); glfwDestroyWindow(window); glfwTerminate(); return false; }
     while(glGetError() != GL_NO_ERROR);
+    GLDebugOutput::Enable();
+    m_framePacer.Initialize(window, settings.pacing); // Sets the swap interval, so after the context is current
 
-    std::cout << "OpenGL Version: " << glGetString(GL_VERSION) << std::endl;
-    std::cout << "GLSL Version: " << glGetString(GL_SHADING_LANGUAGE_VERSION) << std::endl;
-    std::cout << "Vendor: " << glGetString(GL_VENDOR) << std::endl;
-    std::cout << "Renderer: " << glGetString(GL_RENDERER) << std::endl;
+    LOG_INFO(RENDER) << "OpenGL Version: " << glGetString(GL_VERSION);
+    LOG_INFO(RENDER) << "GLSL Version: " << glGetString(GL_SHADING_LANGUAGE_VERSION);
+    LOG_INFO(RENDER) << "Vendor: " << glGetString(GL_VENDOR);
+    LOG_INFO(RENDER) << "Renderer: " << glGetString(GL_RENDERER);
 
     glEnable(GL_DEPTH_TEST);
     checkGLError("glEnable(GL_DEPTH_TEST)");
@@ -162,55 +219,101 @@ bool Renderer::Initialize() {
     InitImGui();
 
     // Load Shaders
-    std::cout << "Loading Shaders..." << std::endl;
+    LOG_INFO(RENDER) << "Loading Shaders...";
+    Shader::setHotReloadEnabled(settings.shaderHotReload);
+    Shader::setBinaryCacheEnabled(settings.shaderBinaryCache);
+    // Started first and checked last: with parallel compile the driver builds it while the rest initializes
     m_raymarchShader = std::make_unique<Shader>("shaders/raymarch_vertex.glsl", "shaders/raymarch_fragment.glsl");
-    if (!m_raymarchShader || !m_raymarchShader->isValid()) { std::cerr << "FATAL: Raymarch shader failed to load." << std::endl; m_raymarchShader = nullptr; }
-    else {
-        m_raymarchShader->use();
-        m_raymarch_timeLoc = glGetUniformLocation(m_raymarchShader->ID, "u_time");
-        m_raymarch_camPosLoc = glGetUniformLocation(m_raymarchShader->ID, "u_camPos");
-        m_raymarch_invViewLoc = glGetUniformLocation(m_raymarchShader->ID, "u_invViewMatrix");
-        m_raymarch_invProjLoc = glGetUniformLocation(m_raymarchShader->ID, "u_invProjMatrix");
-        m_raymarch_lightDirLoc = glGetUniformLocation(m_raymarchShader->ID, "u_lightDir");
-        m_raymarch_lightColorLoc = glGetUniformLocation(m_raymarchShader->ID, "u_lightColor");
-        m_raymarch_ambientLoc = glGetUniformLocation(m_raymarchShader->ID, "u_ambientStrength");
-        m_raymarch_terrain_base_freqLoc = glGetUniformLocation(m_raymarchShader->ID, "u_terrain_base_freq");
-        m_raymarch_terrain_base_ampLoc = glGetUniformLocation(m_raymarchShader->ID, "u_terrain_base_amp");
-        m_raymarch_terrain_persistenceLoc = glGetUniformLocation(m_raymarchShader->ID, "u_terrain_persistence");
-        m_raymarch_terrain_flatten_powerLoc = glGetUniformLocation(m_raymarchShader->ID, "u_terrain_flatten_power");
-        m_raymarch_terrain_final_scaleLoc = glGetUniformLocation(m_raymarchShader->ID, "u_terrain_final_scale");
-        m_raymarch_terrain_octavesLoc = glGetUniformLocation(m_raymarchShader->ID, "u_terrain_octaves");
-        m_raymarch_cloud_base_heightLoc = glGetUniformLocation(m_raymarchShader->ID, "u_cloud_base_height");
-        m_raymarch_cloud_thicknessLoc = glGetUniformLocation(m_raymarchShader->ID, "u_cloud_thickness");
-        m_raymarch_cloud_noise_scaleLoc = glGetUniformLocation(m_raymarchShader->ID, "u_cloud_noise_scale");
-        m_raymarch_cloud_coverage_minLoc = glGetUniformLocation(m_raymarchShader->ID, "u_cloud_coverage_min");
-        m_raymarch_cloud_coverage_maxLoc = glGetUniformLocation(m_raymarchShader->ID, "u_cloud_coverage_max");
-        m_raymarch_cloud_density_factorLoc = glGetUniformLocation(m_raymarchShader->ID, "u_cloud_density_factor");
-        glUseProgram(0);
-    }
+    m_skyShader = std::make_unique<Shader>("shaders/raymarch_vertex.glsl", "shaders/raymarch_fragment.glsl", "#define RAYMARCH_SKY_ONLY\n");
     m_rasterShader = std::make_unique<Shader>("shaders/vertex.glsl", "shaders/fragment.glsl");
-    if (!m_rasterShader || !m_rasterShader->isValid()) { std::cerr << "ERROR: Failed to load raster shader!" << std::endl; m_rasterShader = nullptr; }
-
-    if (!LoadTextureFromDirectories()) { std::cerr << "Initialization warning: Failed to load any texture." << std::endl; }
+    if (!m_rasterShader || !m_rasterShader->isValid()) { LOG_ERROR(RENDER) << "Failed to load raster shader!"; m_rasterShader = nullptr; }
+    m_instancedShader = std::make_unique<Shader>("shaders/vertex_instanced.glsl", "shaders/fragment.glsl");
+    if (!m_instancedShader || !m_instancedShader->isValid()) { LOG_ERROR(RENDER) << "Failed to load instanced shader, physics objects drawn one by one."; m_instancedShader = nullptr; }
+    if (!m_raymarchParams.Create()) { LOG_ERROR(RENDER) << "Raymarch parameters unavailable, terrain and clouds will render with zeroed parameters."; }
+    m_temporalUpscaler = std::make_unique<TemporalUpscaler>();
+    if (!m_temporalUpscaler->Initialize()) { m_temporalUpscaler = nullptr; }
+    m_terrainCache = std::make_unique<TerrainCache>();
+    if (!m_terrainCache->Initialize()) { m_terrainCache = nullptr; }
+    m_cloudRenderer = std::make_unique<CloudRenderer>();
+    if (!m_cloudRenderer->Initialize()) { m_cloudRenderer = nullptr; }
+    m_terrainClipmap = std::make_unique<TerrainClipmap>();
+    if (!m_terrainClipmap->Initialize({ CLOUD_NOISE_TEXTURE_UNIT, CLOUD_BUFFER_TEXTURE_UNIT, CLOUD_DISTANCE_TEXTURE_UNIT })) { m_terrainClipmap = nullptr; }
+
+    m_profiler = std::make_unique<Profiler>(settings.profilerHistoryFrames);
+    m_threadPool = std::make_unique<ThreadPool>();
+    m_meshPool = std::make_unique<MeshPool>();
+    m_assetImporter = std::make_unique<AssetImporter>(*m_threadPool, m_meshPool.get());
+    m_textureStreamer = std::make_unique<TextureStreamer>(*m_threadPool);
+    if (!m_textureStreamer->Initialize()) { LOG_WARN(RENDER) << "Texture streaming resources unavailable."; }
+
+    if (!LoadTextureFromDirectories()) { LOG_WARN(RENDER) << "Failed to load any texture."; }
 
     setupScreenQuad();
     setupPhysicsMeshes();
+    if (!m_raymarchShader->isValid()) { LOG_ERROR(RENDER) << "Raymarch shader failed to load."; m_raymarchShader = nullptr; }
+    else {
+        // The locations are re-read at the next draw that uses the reloaded program
+        auto invalidateUniforms = [this](Shader& program) { if (m_raymarchUniformsProgram == &program) m_raymarchUniformsProgram = nullptr; };
+        m_raymarchShader->setReloadCallback(invalidateUniforms);
+        if (!m_skyShader->isValid()) { LOG_ERROR(RENDER) << "Sky-only raymarch shader failed to load, clipmap terrain unavailable."; m_skyShader = nullptr; }
+        else m_skyShader->setReloadCallback(invalidateUniforms);
+    }
+    if (m_rasterShader && m_instancedShader && !m_renderQueue.EnableMultiDraw(m_rasterShader.get(), m_instancedShader.get(), INSTANCE_MODEL_ATTRIBUTE)) {
+        LOG_INFO(RENDER) << "Multi-draw indirect unavailable, pooled meshes drawn one by one.";
+    }
 
     lastFrame = (float)glfwGetTime();
-    std::cout << "Starting in Edit Mode. Cursor Enabled." << std::endl;
+    LOG_INFO(RENDER) << "Starting in Edit Mode. Cursor Enabled.";
 
     return true;
 }
 
+// Uniform locations, sampler units and the parameter block of a raymarch program variant (again when the
+// variant in use changes or was hot reloaded)
+void Renderer::setupRaymarchUniforms(Shader& program) {
+    m_raymarchUniformsProgram = &program;
+    program.use();
+    m_raymarch_timeLoc = glGetUniformLocation(program.ID, "u_time");
+    m_raymarch_camPosLoc = glGetUniformLocation(program.ID, "u_camPos");
+    m_raymarch_invViewLoc = glGetUniformLocation(program.ID, "u_invViewMatrix");
+    m_raymarch_invProjLoc = glGetUniformLocation(program.ID, "u_invProjMatrix");
+    m_raymarch_jitterLoc = glGetUniformLocation(program.ID, "u_jitter");
+    m_raymarch_terrainCacheLoc = glGetUniformLocation(program.ID, "u_terrainCache");
+    m_raymarch_terrainCacheRectLoc = glGetUniformLocation(program.ID, "u_terrainCacheRect");
+    m_raymarch_terrainCacheTexelLoc = glGetUniformLocation(program.ID, "u_terrainCacheTexel");
+    m_raymarch_useTerrainCacheLoc = glGetUniformLocation(program.ID, "u_useTerrainCache");
+    program.bindUniformBlock(RAYMARCH_PARAMS_BLOCK_NAME, RAYMARCH_PARAMS_BINDING);
+    m_raymarch_cloudNoiseLoc = glGetUniformLocation(program.ID, "u_cloudNoise");
+    m_raymarch_cloudsEnabledLoc = glGetUniformLocation(program.ID, "u_cloudsEnabled");
+    m_raymarch_cloudBufferLoc = glGetUniformLocation(program.ID, "u_cloudBuffer");
+    m_raymarch_cloudDistanceLoc = glGetUniformLocation(program.ID, "u_cloudDistance");
+    m_raymarch_hybridDepthLoc = glGetUniformLocation(program.ID, "u_hybridDepth");
+    m_raymarch_sceneDepthLoc = glGetUniformLocation(program.ID, "u_sceneDepth");
+    m_raymarch_viewProjLoc = glGetUniformLocation(program.ID, "u_viewProjMatrix");
+    m_raymarch_terrainMaxMipLoc = glGetUniformLocation(program.ID, "u_terrainMaxMip");
+    m_raymarch_terrainMaxMipLevelsLoc = glGetUniformLocation(program.ID, "u_terrainMaxMipLevels");
+    m_raymarch_terrainTraversalLoc = glGetUniformLocation(program.ID, "u_terrainTraversal");
+    m_raymarch_terrainMaxStepsLoc = glGetUniformLocation(program.ID, "u_terrainMaxSteps");
+    m_raymarch_terrainStepViewLoc = glGetUniformLocation(program.ID, "u_terrainStepView");
+    m_raymarch_shadowStepsLoc = glGetUniformLocation(program.ID, "u_shadowSteps");
+    if (m_raymarch_terrainCacheLoc != -1) glUniform1i(m_raymarch_terrainCacheLoc, TERRAIN_CACHE_TEXTURE_UNIT);
+    if (m_raymarch_cloudNoiseLoc != -1) glUniform1i(m_raymarch_cloudNoiseLoc, CLOUD_NOISE_TEXTURE_UNIT);
+    if (m_raymarch_cloudBufferLoc != -1) glUniform1i(m_raymarch_cloudBufferLoc, CLOUD_BUFFER_TEXTURE_UNIT);
+    if (m_raymarch_cloudDistanceLoc != -1) glUniform1i(m_raymarch_cloudDistanceLoc, CLOUD_DISTANCE_TEXTURE_UNIT);
+    if (m_raymarch_sceneDepthLoc != -1) glUniform1i(m_raymarch_sceneDepthLoc, SCENE_DEPTH_TEXTURE_UNIT);
+    if (m_raymarch_terrainMaxMipLoc != -1) glUniform1i(m_raymarch_terrainMaxMipLoc, TERRAIN_MAX_MIP_TEXTURE_UNIT);
+    glUseProgram(0);
+}
+
 // --- Helper function to find and load the first texture ---
 bool Renderer::LoadTextureFromDirectories() {
-    std::cout << "Searching for texture..." << std::endl;
+    LOG_INFO(RENDER) << "Searching for texture...";
     const std::vector<std::string> textureDirectories = { "textures/cube_textures", "textures", "textures/skybox" };
     const std::vector<std::string> extensions = { ".jpg", ".jpeg", ".png", ".bmp", ".tga" };
     if (texture) { delete texture; texture = nullptr; textureLoaded = false; }
     for (const std::string& dir : textureDirectories) {
         std::error_code ec; if (!std::filesystem::is_directory(dir, ec) || ec) continue;
-        std::cout << "  Searching in directory: " << dir << std::endl;
+        LOG_VERBOSE(RENDER) << "  Searching in directory: " << dir;
         for (const auto& entry : std::filesystem::directory_iterator(dir)) {
             if (entry.is_regular_file()) {
                 std::filesystem::path entryPath = entry.path(); std::string filePath = entryPath.string();
@@ -218,20 +321,20 @@ bool Renderer::LoadTextureFromDirectories() {
                 std::transform(fileExtension.begin(), fileExtension.end(), fileExtension.begin(), [](unsigned char c){ return std::tolower(c); });
                 bool extensionMatch = false; for (const std::string& ext : extensions) { if (fileExtension == ext) { extensionMatch = true; break; } }
                 if (extensionMatch) {
-                    std::cout << "  Found potential texture file: " << filePath << std::endl;
+                    LOG_VERBOSE(RENDER) << "  Found potential texture file: " << filePath;
                     try {
-                        texture = new Texture(filePath.c_str()); textureLoaded = true;
-                        std::cout << ">>> Successfully loaded texture: " << filePath << std::endl;
+                        texture = new Texture(*m_textureStreamer, filePath.c_str()); textureLoaded = true;
+                        LOG_INFO(RENDER) << "Texture queued for streaming: " << filePath;
                         checkGLError("texture loading in LoadTextureFromDirectories"); return true;
                     } catch (const std::exception& e) {
-                        std::cerr << "  Failed to load texture '" << filePath << "': " << e.what() << std::endl;
+                        LOG_ERROR(RENDER) << "  Failed to load texture '" << filePath << "': " << e.what();
                         textureLoaded = false; if (texture) { delete texture; texture = nullptr; }
                     }
                 }
             }
         }
     }
-    std::cerr << "!!! No suitable texture found in specified directories." << std::endl;
+    LOG_ERROR(RENDER) << "No suitable texture found in specified directories.";
     textureLoaded = false; return false;
 }
 
@@ -241,73 +344,160 @@ void Renderer::setupScreenQuad() {
     glGenVertexArrays(1, &quadVAO); glGenBuffers(1, &quadVBO);
     glBindVertexArray(quadVAO); glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), &quadVertices, GL_STATIC_DRAW);
+    MemoryStats::TrackBuffer(quadVBO, MemoryCategory::MESH_BUFFERS, sizeof(quadVertices));
     glEnableVertexAttribArray(0); glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
     glBindBuffer(GL_ARRAY_BUFFER, 0); glBindVertexArray(0);
     checkGLError("setupScreenQuad");
-    std::cout << "Screen quad setup complete (VAO: " << quadVAO << ", VBO: " << quadVBO << ")" << std::endl;
+    LOG_INFO(RENDER) << "Screen quad setup complete (VAO: " << quadVAO << ", VBO: " << quadVBO << ")";
 }
 
 // --- Physics Rendering Setup and Methods ---
 
 void Renderer::setupRasterShader() { /* Handled in Initialize */ }
 
+// Uploads the mesh's authored data again in the compact layout (16-bit indices), into VAO/VBO/EBO owned by the renderer
+void Renderer::uploadPhysicsMesh(const Mesh& mesh, unsigned int& vao, unsigned int& vbo, unsigned int& ebo, GLenum& indexType) {
+    MeshData data;
+    data.Pack(mesh.vertices, mesh.indices, VertexLayout());
+    indexType = data.indexType;
+    glGenVertexArrays(1, &vao); glGenBuffers(1, &vbo); glGenBuffers(1, &ebo);
+    glBindVertexArray(vao); glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, data.GetVertexByteSize(), data.GetVertexBytes(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, data.GetIndexByteSize(), data.GetIndexBytes(), GL_STATIC_DRAW);
+    data.layout.Apply();
+    glBindVertexArray(0); glBindBuffer(GL_ARRAY_BUFFER, 0); glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    MemoryStats::TrackBuffer(vbo, MemoryCategory::MESH_BUFFERS, data.GetVertexByteSize());
+    MemoryStats::TrackBuffer(ebo, MemoryCategory::MESH_BUFFERS, data.GetIndexByteSize());
+}
+
 void Renderer::setupPhysicsMeshes() {
-    std::cout << "Setting up physics meshes..." << std::endl;
+    LOG_INFO(RENDER) << "Setting up physics meshes...";
     Mesh tempCube = CreateCube();
-    if (tempCube.vertices.empty() || tempCube.indices.empty()) { std::cerr << "ERROR: CreateCube returned empty data." << std::endl; return; }
+    if (tempCube.vertices.empty() || tempCube.indices.empty()) { LOG_ERROR(RENDER) << "CreateCube returned empty data."; return; }
     m_cubeIndexCount = tempCube.indices.size();
-    glGenVertexArrays(1, &m_cubeVAO); glGenBuffers(1, &m_cubeVBO); glGenBuffers(1, &m_cubeEBO);
-    glBindVertexArray(m_cubeVAO); glBindBuffer(GL_ARRAY_BUFFER, m_cubeVBO);
-    glBufferData(GL_ARRAY_BUFFER, tempCube.vertices.size() * sizeof(Vertex), tempCube.vertices.data(), GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_cubeEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, tempCube.indices.size() * sizeof(unsigned int), tempCube.indices.data(), GL_STATIC_DRAW);
-    glEnableVertexAttribArray(0); glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Position));
-    glEnableVertexAttribArray(1); glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Color));
-    glEnableVertexAttribArray(2); glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
-    glBindVertexArray(0); glBindBuffer(GL_ARRAY_BUFFER, 0); glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    uploadPhysicsMesh(tempCube, m_cubeVAO, m_cubeVBO, m_cubeEBO, m_cubeIndexType);
     checkGLError("setupPhysicsMeshes (Cube)");
-    std::cout << "Cube physics mesh setup complete (VAO: " << m_cubeVAO << ")" << std::endl;
-}
-
-glm::mat4 Renderer::convertBtTransformToGlm(const btTransform& trans) {
-    btQuaternion rot = trans.getRotation(); btVector3 pos = trans.getOrigin();
-    glm::quat glmRot = glm::quat(rot.w(), rot.x(), rot.y(), rot.z());
-    glm::vec3 glmPos(pos.x(), pos.y(), pos.z());
-    glm::mat4 model = glm::translate(glm::mat4(1.0f), glmPos);
-    model = model * glm::toMat4(glmRot);
-    return model;
-}
-
-void Renderer::renderPhysicsObjects(btDiscreteDynamicsWorld* world, const glm::mat4& view, const glm::mat4& projection) {
-    if (!m_rasterShader || !m_rasterShader->isValid() || !world) return;
-    m_rasterShader->use();
-    m_rasterShader->setMat4("view", view); m_rasterShader->setMat4("projection", projection);
-    bool textureWasBound = false;
-    if (textureLoaded && texture) {
-         glActiveTexture(GL_TEXTURE0); texture->Bind(0);
-         m_rasterShader->setInt("texture1", 0); m_rasterShader->setBool("useTexture", true);
-         textureWasBound = true;
-    } else { m_rasterShader->setBool("useTexture", false); }
+    LOG_INFO(RENDER) << "Cube physics mesh setup complete (VAO: " << m_cubeVAO << ")";
+
+    Mesh tempSphere = CreateSphere(12, 16);
+    m_sphereIndexCount = tempSphere.indices.size();
+    uploadPhysicsMesh(tempSphere, m_sphereVAO, m_sphereVBO, m_sphereEBO, m_sphereIndexType);
+    checkGLError("setupPhysicsMeshes (Sphere)");
+    LOG_INFO(RENDER) << "Sphere physics mesh setup complete (VAO: " << m_sphereVAO << ")";
+
+    if (m_instancedShader && !m_physicsInstances.Create(sizeof(glm::mat4), INITIAL_PHYSICS_INSTANCES)) {
+        LOG_ERROR(RENDER) << "Failed to create physics instance buffer, physics objects drawn one by one.";
+        m_instancedShader = nullptr;
+    }
+}
+
+// Collects the model matrix of every dynamic body in the frustum, split by shape. Both meshes are unit sized (cube side 1, sphere diameter 1).
+// Bodies move every tick, so they are tested one by one rather than through a tree that would need rebuilding each frame.
+void Renderer::gatherPhysicsInstances(btDiscreteDynamicsWorld* world, const Frustum& frustum) {
+    m_boxInstances.clear();
+    m_sphereInstances.clear();
+    m_physicsCulledCount = 0;
+    const Aabb unitCube = { glm::vec3(-0.5f), glm::vec3(0.5f) };
+    if (m_physicsThread) {
+        // Physics runs on its own thread: draw its last snapshot, interpolated between the two newest ticks
+        const PhysicsSnapshot& snapshot = m_physicsThread->AcquireSnapshot();
+        float alpha = m_physicsThread->GetInterpolationAlpha(snapshot);
+        for (const PhysicsBodyState& state : snapshot.bodies) {
+            glm::vec3 position = glm::mix(state.prevPosition, state.position, alpha);
+            glm::quat rotation = glm::slerp(state.prevRotation, state.rotation, alpha);
+            glm::mat4 modelMatrix = glm::translate(glm::mat4(1.0f), position) * glm::toMat4(rotation);
+            modelMatrix = glm::scale(modelMatrix, state.scale);
+            Aabb bounds = state.shape == PhysicsShape::SPHERE ? Aabb::FromSphere(position, state.scale.x * 0.5f) : Aabb::Transform(unitCube, modelMatrix);
+            if (m_frustumCulling && !frustum.IsVisible(bounds)) { m_physicsCulledCount++; continue; }
+            if (state.shape == PhysicsShape::SPHERE) m_sphereInstances.push_back(modelMatrix);
+            else m_boxInstances.push_back(modelMatrix);
+        }
+        return;
+    }
     int numObjects = world->getNumCollisionObjects();
     for (int i = 0; i < numObjects; ++i) {
         btCollisionObject* obj = world->getCollisionObjectArray()[i];
         btRigidBody* body = btRigidBody::upcast(obj);
-        if (body && body->getInvMass() != 0.0f && body->getMotionState()) {
-            btTransform worldTrans; body->getMotionState()->getWorldTransform(worldTrans);
-            glm::mat4 modelMatrix = convertBtTransformToGlm(worldTrans);
-            btCollisionShape* shape = body->getCollisionShape();
-            if (shape->getShapeType() == SPHERE_SHAPE_PROXYTYPE) {
-                float radius = static_cast<const btSphereShape*>(shape)->getRadius();
-                modelMatrix = glm::scale(modelMatrix, glm::vec3(radius * 2.0f));
-            }
-            m_rasterShader->setMat4("model", modelMatrix);
-            glBindVertexArray(m_cubeVAO);
-            glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_cubeIndexCount), GL_UNSIGNED_INT, 0);
-            glBindVertexArray(0);
+        if (!body || body->getInvMass() == 0.0f || !body->getMotionState()) continue;
+        btTransform worldTrans; body->getMotionState()->getWorldTransform(worldTrans);
+        glm::mat4 modelMatrix = convertBtTransformToGlm(worldTrans);
+        btCollisionShape* shape = body->getCollisionShape();
+        if (m_frustumCulling) {
+            btVector3 aabbMin, aabbMax;
+            shape->getAabb(worldTrans, aabbMin, aabbMax);
+            Aabb bounds = { glm::vec3(aabbMin.x(), aabbMin.y(), aabbMin.z()), glm::vec3(aabbMax.x(), aabbMax.y(), aabbMax.z()) };
+            if (!frustum.IsVisible(bounds)) { m_physicsCulledCount++; continue; }
+        }
+        if (shape->getShapeType() == SPHERE_SHAPE_PROXYTYPE) {
+            float radius = static_cast<const btSphereShape*>(shape)->getRadius();
+            m_sphereInstances.push_back(glm::scale(modelMatrix, glm::vec3(radius * 2.0f)));
+        } else if (shape->getShapeType() == BOX_SHAPE_PROXYTYPE) {
+            btVector3 halfExtents = static_cast<const btBoxShape*>(shape)->getHalfExtentsWithMargin();
+            m_boxInstances.push_back(glm::scale(modelMatrix, glm::vec3(halfExtents.x(), halfExtents.y(), halfExtents.z()) * 2.0f));
+        } else {
+            m_boxInstances.push_back(modelMatrix); // Other shapes keep the unit cube placeholder
         }
     }
-     if (textureWasBound && texture) { texture->Unbind(); }
-     glUseProgram(0);
+}
+
+// Gathers the visible bodies and, when instancing, uploads their matrices once for every pass that draws them this frame
+void Renderer::preparePhysicsObjects(btDiscreteDynamicsWorld* world, const Frustum& frustum) {
+    m_physicsDrawCalls = 0; m_physicsInstanceCount = 0; m_physicsInstancesWritten = false; m_physicsCulledCount = 0;
+    m_boxInstances.clear(); m_sphereInstances.clear();
+    if (!world) return;
+    gatherPhysicsInstances(world, frustum);
+    size_t boxCount = m_boxInstances.size(), sphereCount = m_sphereInstances.size();
+    m_physicsInstanceCount = boxCount + sphereCount;
+    if (m_physicsInstanceCount == 0 || !m_instancedShader || !m_physicsInstances.IsValid()) return;
+
+    // --- One contiguous upload for all bodies (boxes first, then spheres) ---
+    glm::mat4* instances = static_cast<glm::mat4*>(m_physicsInstances.BeginWrite(m_physicsInstanceCount));
+    if (!instances) return;
+    std::copy(m_boxInstances.begin(), m_boxInstances.end(), instances);
+    std::copy(m_sphereInstances.begin(), m_sphereInstances.end(), instances + boxCount);
+    m_physicsInstanceOffset = m_physicsInstances.EndWrite();
+    m_physicsInstancesWritten = true;
+}
+
+// depthOnly: hybrid depth pre-pass (no texture, draw calls not counted)
+void Renderer::submitPhysicsObjects(bool depthOnly) {
+    if (m_physicsInstanceCount == 0) return;
+    bool instanced = m_physicsInstancesWritten;
+    Shader* shader = instanced ? m_instancedShader.get() : m_rasterShader.get();
+    if (!shader || !shader->isValid()) return;
+    size_t boxCount = m_boxInstances.size(), sphereCount = m_sphereInstances.size();
+
+    DrawCommand box, sphere;
+    box.shader = sphere.shader = shader;
+    if (!depthOnly && textureLoaded && texture && texture->GetState() != TextureState::FAILED) box.texture = sphere.texture = texture->GetID();
+    box.vao = m_cubeVAO; box.indexType = m_cubeIndexType; box.indexCount = static_cast<uint32_t>(m_cubeIndexCount);
+    sphere.vao = m_sphereVAO; sphere.indexType = m_sphereIndexType; sphere.indexCount = static_cast<uint32_t>(m_sphereIndexCount);
+
+    size_t drawCalls = 0;
+    if (instanced) {
+        // --- One draw per shape type ---
+        box.instances = sphere.instances = &m_physicsInstances;
+        box.instanceAttribute = sphere.instanceAttribute = INSTANCE_MODEL_ATTRIBUTE;
+        if (boxCount > 0) {
+            box.instanceOffset = m_physicsInstanceOffset;
+            box.instanceCount = static_cast<uint32_t>(boxCount);
+            m_renderQueue.Submit(box);
+            drawCalls++;
+        }
+        if (sphereCount > 0) {
+            sphere.instanceOffset = m_physicsInstanceOffset + boxCount * sizeof(glm::mat4);
+            sphere.instanceCount = static_cast<uint32_t>(sphereCount);
+            m_renderQueue.Submit(sphere);
+            drawCalls++;
+        }
+    } else {
+        // --- Fallback: one draw per body ---
+        for (const glm::mat4& model : m_boxInstances) { box.model = model; m_renderQueue.Submit(box); }
+        for (const glm::mat4& model : m_sphereInstances) { sphere.model = model; m_renderQueue.Submit(sphere); }
+        drawCalls = boxCount + sphereCount;
+    }
+    if (!depthOnly) m_physicsDrawCalls += drawCalls;
 }
 
 // --- End Physics Rendering ---
@@ -332,15 +522,29 @@ void Renderer::RenderUIToolbar() {
         char const * lFilterPatterns[2] = { "*.fbx", "*.obj" };
         char const * selectedFilePath = tinyfd_openFileDialog("Import 3D Model", "", 2, lFilterPatterns, "3D Models (.fbx, .obj)", 0);
         if (selectedFilePath) {
-            std::cout << "Import Asset: Selected file: " << selectedFilePath << std::endl;
-            auto mesh = LoadMeshFromFile(selectedFilePath);
-            if (mesh) {
-                m_sceneAssets.push_back({selectedFilePath, glm::vec3(0, 0, 0), std::move(mesh)});
-            } else {
-                std::cerr << "Failed to load mesh for asset: " << selectedFilePath << std::endl;
-            }
+            LOG_INFO(RENDER) << "Import Asset: Selected file: " << selectedFilePath;
+            SceneAsset asset;
+            asset.name = selectedFilePath;
+            asset.position = glm::vec3(0, 0, 0);
+            asset.importId = m_assetImporter->Import(selectedFilePath);
+            m_sceneAssets.push_back(std::move(asset));
+            m_assetBvhDirty = true;
         }
     }
+    ImGui::SameLine();
+    char const* sceneFilterPatterns[1] = { "*.scene" };
+    if (ImGui::Button("Save Scene")) {
+        char const* selectedFilePath = tinyfd_saveFileDialog("Save Scene", "untitled.scene", 1, sceneFilterPatterns, "Scenes (.scene)");
+        if (selectedFilePath) SaveScene(selectedFilePath);
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Open Scene")) {
+        char const* selectedFilePath = tinyfd_openFileDialog("Open Scene", "", 1, sceneFilterPatterns, "Scenes (.scene)", 0);
+        if (selectedFilePath) OpenScene(selectedFilePath);
+    }
+    if (m_loadingScene) {
+        ImGui::SameLine(); ImGui::Text("Opening scene: %zu / %zu bodies", m_sceneBodiesLoaded, m_loadingScene->GetBodyCount());
+    }
 
     ImGui::SameLine(); ImGui::Checkbox("Lock Mouse in Play", &m_lockMouseInPlayMode);
     ImGui::End();
@@ -350,6 +554,7 @@ void Renderer::RenderUIInspector() {
     ImGui::Begin("Inspector");
     ImGui::Text("Scene Assets:");
     ImGui::Separator();
+    int removeAsset = -1;
     for (int i = 0; i < m_sceneAssets.size(); ++i) {
         bool selected = (i == m_selectedAsset);
         if (ImGui::Selectable(m_sceneAssets[i].name.c_str(), selected)) {
@@ -358,24 +563,250 @@ void Renderer::RenderUIInspector() {
         if (selected) {
             ImGui::Indent();
             ImGui::Text("Position: (%.2f, %.2f, %.2f)", m_sceneAssets[i].position.x, m_sceneAssets[i].position.y, m_sceneAssets[i].position.z);
+            const SceneAsset& asset = m_sceneAssets[i];
+            if (asset.state == AssetState::LOADING) ImGui::Text("Loading...");
+            else if (asset.state == AssetState::FAILED) ImGui::Text("Import failed");
+            else {
+                ImGui::Text("Meshes: %zu", asset.meshes.size());
+                for (const auto& mesh : asset.meshes) {
+                    if (mesh->GetLodCount() < 2) continue;
+                    ImGui::Text("  %zu LODs: %u -> %u triangles", mesh->GetLodCount(), mesh->GetLod(0).indexCount / 3,
+                                mesh->GetLod(mesh->GetLodCount() - 1).indexCount / 3);
+                }
+            }
             if (ImGui::Button("Focus Camera")) {
                 camera.Position = m_sceneAssets[i].position + glm::vec3(0, 2, 5);
                 camera.Yaw = -90.0f; camera.Pitch = 0.0f; camera.updateCameraVectors();
             }
+            ImGui::SameLine();
+            if (ImGui::Button("Remove")) removeAsset = i;
             ImGui::Unindent();
         }
     }
+    if (removeAsset >= 0) {
+        // Its meshes return their ranges to the mesh pool; an import still running is dropped when it finishes
+        m_sceneAssets.erase(m_sceneAssets.begin() + removeAsset);
+        m_selectedAsset = -1;
+        m_assetBvhDirty = true;
+    }
+    ImGui::End();
+}
+
+void Renderer::RenderUIPhysics() {
+    ImGui::Begin("Physics");
+    if (m_physicsWorld) {
+        static const char* layouts[] = { "Stacks", "Rain", "Pile" };
+        int layout = static_cast<int>(m_stressSettings.layout);
+        if (ImGui::Combo("Layout", &layout, layouts, 3)) m_stressSettings.layout = static_cast<StressLayout>(layout);
+        ImGui::SliderInt("Bodies", &m_stressSettings.bodyCount, 10, 20000, "%d", ImGuiSliderFlags_Logarithmic);
+        if (m_stressSettings.layout != StressLayout::STACKS) ImGui::SliderFloat("Sphere Fraction", &m_stressSettings.sphereFraction, 0.0f, 1.0f);
+        int seed = static_cast<int>(m_stressSettings.seed);
+        if (ImGui::InputInt("Seed", &seed)) m_stressSettings.seed = static_cast<unsigned int>(std::max(seed, 0));
+
+        bool spawn = ImGui::Button("Spawn"); ImGui::SameLine();
+        bool clear = ImGui::Button("Clear");
+        if (spawn || clear) {
+            std::unique_lock<std::mutex> worldLock;
+            if (m_physicsThread) worldLock = m_physicsThread->LockWorld();
+            if (clear) m_physicsWorld->ClearStressBodies();
+            if (spawn) m_physicsWorld->SpawnStressBodies(m_stressSettings);
+            worldLock = std::unique_lock<std::mutex>();
+            if (m_physicsThread) m_physicsThread->RequestSnapshot(); // Show the change while paused
+        }
+        ImGui::SameLine(); ImGui::Text("%zu stress bodies", m_physicsWorld->GetStressBodyCount());
+
+        bool terrainCollision = m_physicsWorld->IsTerrainCollisionEnabled();
+        if (ImGui::Checkbox("Terrain Collision", &terrainCollision)) m_physicsWorld->SetTerrainCollisionEnabled(terrainCollision);
+        TerrainColliderStats terrainStats = m_physicsWorld->GetTerrainStats();
+        ImGui::Text("Heightfield tiles: %zu loaded (%.0f units), %llu built, %llu evicted, %.3f ms", terrainStats.tilesLoaded,
+                    TerrainCollider::GetTileSize(), static_cast<unsigned long long>(terrainStats.tilesBuilt),
+                    static_cast<unsigned long long>(terrainStats.tilesEvicted), terrainStats.lastUpdateMs);
+        ImGui::Separator();
+    }
+
+    if (m_physicsThread) {
+        m_physicsThread->CopyStepStats(m_physicsStats);
+        ImGui::Text("Step: %.3f ms (%s)", m_physicsStats.stepMs, m_physicsWorld && m_physicsWorld->IsMultithreaded() ? "multithreaded" : "single-threaded");
+        ImGui::Text("Objects: %d, Pairs: %d, Manifolds: %d", m_physicsStats.collisionObjects, m_physicsStats.overlappingPairs, m_physicsStats.contactManifolds);
+        if (m_physicsStats.profile.empty()) {
+            ImGui::Text("No profile yet (press Play)");
+        } else if (ImGui::BeginTable("PhysicsProfile", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV)) {
+            ImGui::TableSetupColumn("Section"); ImGui::TableSetupColumn("ms"); ImGui::TableSetupColumn("Calls");
+            ImGui::TableHeadersRow();
+            for (const PhysicsProfileNode& node : m_physicsStats.profile) {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn(); ImGui::Text("%*s%s", node.depth * 2, "", node.name.c_str());
+                ImGui::TableNextColumn(); ImGui::Text("%.3f", node.totalMs);
+                ImGui::TableNextColumn(); ImGui::Text("%d", node.calls);
+            }
+            ImGui::EndTable();
+        }
+    } else { ImGui::Text("Physics thread not running."); }
     ImGui::End();
 }
 
 void Renderer::RenderUIStats() {
     ImGui::Begin("Stats");
     ImGui::Text("FPS: %.1f", fps); ImGui::Text("Frame Time: %.3f ms", deltaTime * 1000.0f);
+    ImGui::Text("Scene Param Uploads: %u", m_raymarchParams.GetUploadCount());
+    if (m_qualityGovernor.IsEnabled()) ImGui::Text("GPU Frame: %.2f ms / %.2f ms budget (%s)", m_qualityGovernor.GetMeasuredMs(),
+                                                   m_qualityGovernor.GetBudgetMs(), QualityGovernor::GetTierName(m_qualityGovernor.GetTier()));
+    if (m_physicsThread) ImGui::Text("Physics: %.2f ms/step, %llu ticks%s", m_physicsThread->GetLastStepMs(),
+                                     static_cast<unsigned long long>(m_physicsThread->GetTickCount()), m_physicsThread->IsSimulating() ? "" : " (paused)");
+    const ShaderStats& shaderStats = Shader::getStats();
+    ImGui::Text("Shaders: %u from binary cache, %u compiled, %u reloads (%u failed)", shaderStats.binaryHits, shaderStats.compiles,
+                shaderStats.reloads, shaderStats.reloadFailures);
+    if (m_assetImporter) ImGui::Text("Imports Pending: %zu", m_assetImporter->GetPendingCount());
+    if (m_textureStreamer) ImGui::Text("Textures: %zu (%zu streaming), %.1f MB", m_textureStreamer->GetTextureCount(), m_textureStreamer->GetPendingCount(),
+                                        m_textureStreamer->GetGpuBytes() / (1024.0 * 1024.0));
+    ImGui::Text("Asset Triangles: %zu", m_assetTriangles);
+    const RenderQueueStats& queueStats = m_renderQueue.GetStats();
+    ImGui::Text("Raster: %zu commands in %zu draws (%zu multi), %zu program / %zu texture / %zu VAO binds, arena %.1f KB", queueStats.commands,
+                queueStats.draws, queueStats.multiDraws, queueStats.programBinds, queueStats.textureBinds, queueStats.vaoBinds,
+                m_frameArena.GetUsedBytes() / 1024.0);
+    if (m_meshPool) ImGui::Text("Mesh Pool: %.1f / %.1f MB in %zu buckets", m_meshPool->GetUsedBytes() / (1024.0 * 1024.0),
+                                m_meshPool->GetCapacityBytes() / (1024.0 * 1024.0), m_meshPool->GetBucketCount());
+    if (m_frustumCulling) ImGui::Text("Culled: %zu/%zu assets, %zu/%zu bodies", m_assetCulledCount, m_sceneAssets.size(),
+                                      m_physicsCulledCount, m_physicsCulledCount + m_physicsInstanceCount);
+    ImGui::Text("Physics Bodies: %zu (%zu draw calls, %s)", m_physicsInstanceCount, m_physicsDrawCalls,
+                m_instancedShader ? (m_physicsInstances.IsPersistent() ? "instanced, persistent" : "instanced, orphaned") : "per object");
+    if (m_profiler && ImGui::CollapsingHeader("Profiler", ImGuiTreeNodeFlags_DefaultOpen)) RenderUIProfiler();
+    if (ImGui::CollapsingHeader("Logging")) {
+        const char* levels[] = { "Verbose", "Info", "Warning", "Error", "Off" };
+        for (size_t i = 0; i < static_cast<size_t>(LogCategory::COUNT); ++i) {
+            LogCategory category = static_cast<LogCategory>(i);
+            int level = static_cast<int>(Log::GetLevel(category));
+            if (ImGui::Combo(Log::GetCategoryName(category), &level, levels, 5)) Log::SetLevel(category, static_cast<LogLevel>(level));
+        }
+        ImGui::Text("GL errors: %s", GLDebugOutput::IsActive() ? "debug callback" : "glGetError polling");
+        ImGui::Text("Dropped log lines: %llu", static_cast<unsigned long long>(Log::GetDroppedCount()));
+    }
+    ImGui::End();
+}
+
+// Per-pass timings from m_profiler: frame-time graph plus CPU/GPU avg, p95 and p99 per section
+void Renderer::RenderUIProfiler() {
+    bool enabled = m_profiler->IsEnabled();
+    if (ImGui::Checkbox("Enable Profiling", &enabled)) m_profiler->SetEnabled(enabled);
+
+    const SampleHistory& frames = m_profiler->GetFrameHistory();
+    ProfileStats frameStats = frames.ComputeStats();
+    char overlay[64];
+    snprintf(overlay, sizeof(overlay), "avg %.2f  p99 %.2f ms", frameStats.averageMs, frameStats.p99Ms);
+    ImGui::PlotLines("##FrameTimes", frames.GetData(), frames.GetSize(), frames.GetOffset(), overlay,
+                     0.0f, std::max(frameStats.p99Ms * 1.5f, 1.0f), ImVec2(0.0f, 60.0f));
+
+    if (ImGui::BeginTable("ProfilerSections", 7, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit)) {
+        ImGui::TableSetupColumn("Section");
+        ImGui::TableSetupColumn("CPU avg"); ImGui::TableSetupColumn("CPU p95"); ImGui::TableSetupColumn("CPU p99");
+        ImGui::TableSetupColumn("GPU avg"); ImGui::TableSetupColumn("GPU p95"); ImGui::TableSetupColumn("GPU p99");
+        ImGui::TableHeadersRow();
+        for (size_t i = 0; i < m_profiler->GetSectionCount(); ++i) {
+            ProfileStats cpu = m_profiler->GetCpuStats(i);
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(m_profiler->GetSectionName(i).c_str());
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", cpu.averageMs);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", cpu.p95Ms);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", cpu.p99Ms);
+            if (!m_profiler->HasGpuTiming(i)) continue;
+            ProfileStats gpu = m_profiler->GetGpuStats(i);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", gpu.averageMs);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", gpu.p95Ms);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", gpu.p99Ms);
+        }
+        ImGui::EndTable();
+    }
+    if (m_profiler->GetDroppedQueryCount() > 0) ImGui::Text("GPU timings dropped (not ready): %u", m_profiler->GetDroppedQueryCount());
+}
+
+// Totals per MemoryStats category, plus the texture cache and the imported-mesh CPU data options
+void Renderer::RenderUIMemory() {
+    ImGui::Begin("Memory");
+    const double MB = 1024.0 * 1024.0;
+    ImGui::Text("GPU: %.1f MB, CPU: %.1f MB", MemoryStats::GetGpuTotal() / MB, MemoryStats::GetCpuTotal() / MB);
+    if (ImGui::BeginTable("MemoryCategories", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit)) {
+        ImGui::TableSetupColumn("Category"); ImGui::TableSetupColumn("MB"); ImGui::TableSetupColumn("Objects");
+        ImGui::TableHeadersRow();
+        for (size_t i = 0; i < static_cast<size_t>(MemoryCategory::COUNT); ++i) {
+            MemoryCategory category = static_cast<MemoryCategory>(i);
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(MemoryStats::GetCategoryName(category));
+            ImGui::TableNextColumn(); ImGui::Text("%.2f", MemoryStats::GetBytes(category) / MB);
+            ImGui::TableNextColumn();
+            if (MemoryStats::IsGpuCategory(category)) ImGui::Text("%zu", MemoryStats::GetObjectCount(category));
+            else ImGui::TextUnformatted("-");
+        }
+        ImGui::EndTable();
+    }
+    if (m_textureStreamer) {
+        ImGui::Text("Texture cache: %zu textures, %.1f MB unreferenced, %zu evicted", m_textureStreamer->GetTextureCount(),
+                    m_textureStreamer->GetUnusedBytes() / MB, m_textureStreamer->GetEvictedCount());
+        int budgetMb = static_cast<int>(m_textureStreamer->GetUnusedBudget() / (1024 * 1024));
+        if (ImGui::SliderInt("Unused Texture Budget (MB)", &budgetMb, 0, 1024)) {
+            m_textureStreamer->SetUnusedBudget(static_cast<size_t>(budgetMb) * 1024 * 1024); // Evicts at the next Update()
+        }
+    }
+    if (m_assetImporter) {
+        bool release = m_assetImporter->IsReleaseCpuDataEnabled();
+        if (ImGui::Checkbox("Release Mesh Data After Upload", &release)) m_assetImporter->SetReleaseCpuData(release); // Applies to the next import
+    }
     ImGui::End();
 }
 
 void Renderer::RenderUISceneControls() {
     ImGui::Begin("Scene Controls");
+    const bool governed = m_qualityGovernor.IsEnabled();
+    const bool upscaled = getQualitySettings().raymarchScaleDivisor > 1;
+    if (ImGui::CollapsingHeader("Rendering", ImGuiTreeNodeFlags_DefaultOpen)) {
+        bool governor = governed;
+        if (ImGui::Checkbox("Quality Governor", &governor)) m_qualityGovernor.SetEnabled(governor);
+        if (governed) {
+            float budget = m_qualityGovernor.GetBudgetMs();
+            if (ImGui::DragFloat("Frame Budget (ms)", &budget, 0.1f, 2.0f, 50.0f)) m_qualityGovernor.SetBudgetMs(budget);
+            ImGui::Text("Tier: %s (%zu of %zu)", QualityGovernor::GetTierName(m_qualityGovernor.GetTier()),
+                        m_qualityGovernor.GetTier() + 1, QualityGovernor::GetTierCount());
+            if (!m_profiler || !m_profiler->IsEnabled()) { ImGui::SameLine(); ImGui::TextDisabled("(needs profiling)"); }
+        }
+        const char* resolutionModes[] = { "Native", "1/2 (Temporal Upsample)", "1/4 (Temporal Upsample)" };
+        int resolutionMode = static_cast<int>(m_raymarchResolution);
+        ImGui::BeginDisabled(governed); // The governor picks the scale and step counts
+        if (!m_temporalUpscaler) ImGui::Text("Reduced resolution unavailable (resolve shader failed)");
+        else if (ImGui::Combo("Raymarch Resolution", &resolutionMode, resolutionModes, 3)) {
+            m_raymarchResolution = static_cast<RaymarchResolution>(resolutionMode);
+            m_temporalUpscaler->ResetHistory();
+        }
+        ImGui::EndDisabled();
+        if (upscaled && m_temporalUpscaler) {
+            if (ImGui::Checkbox("Temporal Accumulation", &m_temporalAccumulation)) { m_temporalUpscaler->SetTemporalEnabled(m_temporalAccumulation); }
+            ImGui::Text("Raymarch target: %dx%d", m_temporalUpscaler->GetLowResWidth(), m_temporalUpscaler->GetLowResHeight());
+        }
+        ImGui::Checkbox("Frustum Culling", &m_frustumCulling);
+        ImGui::Checkbox("Hybrid Depth (raster first)", &m_hybridDepth);
+        if (m_hybridDepth && upscaled) { ImGui::SameLine(); ImGui::TextDisabled("(native resolution only)"); }
+        ImGui::Checkbox("Mesh LODs", &m_meshLodsEnabled);
+        bool hotReload = Shader::isHotReloadEnabled();
+        if (ImGui::Checkbox("Hot Reload Shaders", &hotReload)) Shader::setHotReloadEnabled(hotReload);
+        ImGui::BeginDisabled(!m_renderQueue.IsMultiDrawAvailable());
+        if (ImGui::Checkbox("Multi-Draw Indirect", &m_multiDraw)) m_renderQueue.SetMultiDrawActive(m_multiDraw);
+        ImGui::EndDisabled();
+        if (m_meshLodsEnabled) ImGui::DragFloat("LOD Error (px)", &m_lodErrorPixels, 0.05f, 0.1f, 16.0f);
+        if (m_textureStreamer) {
+            bool cook = m_textureStreamer->IsCookingEnabled();
+            if (ImGui::Checkbox("Cook Textures to BCn", &cook)) m_textureStreamer->SetCookingEnabled(cook); // Applies to the next load
+        }
+    }
+    if (ImGui::CollapsingHeader("Frame Pacing")) {
+        const FramePacingSettings& pacing = m_framePacer.GetSettings();
+        const char* vsyncModes[] = { "Off", "On", "Adaptive" };
+        int vsync = static_cast<int>(pacing.vsync);
+        if (ImGui::Combo("Vsync", &vsync, vsyncModes, m_framePacer.IsAdaptiveVsyncSupported() ? 3 : 2)) m_framePacer.SetVsyncMode(static_cast<VsyncMode>(vsync));
+        int framesInFlight = pacing.maxFramesInFlight;
+        if (ImGui::SliderInt("Max Frames In Flight", &framesInFlight, 1, FramePacer::MAX_FRAMES_IN_FLIGHT)) m_framePacer.SetMaxFramesInFlight(framesInFlight);
+        float cap = pacing.frameRateCap;
+        if (ImGui::DragFloat("Frame Rate Cap", &cap, 1.0f, 0.0f, 500.0f, cap > 0.0f ? "%.0f fps" : "Off")) m_framePacer.SetFrameRateCap(cap);
+        const FramePacingStats& stats = m_framePacer.GetStats();
+        ImGui::Text("GPU wait %.2f ms, cap sleep %.2f ms, %zu frames queued", stats.fenceWaitMs, stats.capSleepMs, stats.framesInFlight);
+    }
     if (ImGui::CollapsingHeader("Lighting", ImGuiTreeNodeFlags_DefaultOpen)) {
         if (ImGui::DragFloat3("Light Direction", &m_lightDirection.x, 0.01f)) { m_lightDirection = glm::normalize(m_lightDirection); }
         ImGui::ColorEdit3("Light Color", &m_lightColor.x);
@@ -393,6 +824,38 @@ void Renderer::RenderUISceneControls() {
         ImGui::DragFloat("Flatten Power", &m_terrain_flatten_power, 0.05f, 0.5f, 5.0f);
         ImGui::DragFloat("Final Scale", &m_terrain_final_scale, 0.1f, 0.1f, 10.0f);
         ImGui::Text("Octaves: %d (Requires recompile)", m_terrain_octaves);
+        const char* renderModes[] = { "Raymarch", "Clipmap Mesh" };
+        int renderMode = static_cast<int>(m_terrainRenderMode);
+        bool clipmapAvailable = m_terrainClipmap && m_skyShader;
+        ImGui::BeginDisabled(!clipmapAvailable);
+        if (ImGui::Combo("Terrain Rendering", &renderMode, renderModes, 2)) {
+            m_terrainRenderMode = static_cast<TerrainRenderMode>(renderMode);
+            if (m_temporalUpscaler) m_temporalUpscaler->ResetHistory(); // Its history was not updated while the clipmap drew
+        }
+        ImGui::EndDisabled();
+        if (!clipmapAvailable) { ImGui::SameLine(); ImGui::TextDisabled("(clipmap unavailable)"); }
+        if (m_terrainRenderMode == TerrainRenderMode::CLIPMAP && clipmapAvailable) {
+            int levels = m_terrainClipmap->GetLevels();
+            if (ImGui::SliderInt("Clipmap Levels", &levels, 1, TerrainClipmap::MAX_LEVELS)) m_terrainClipmap->SetLevels(levels);
+            float spacing = m_terrainClipmap->GetBaseSpacing();
+            if (ImGui::DragFloat("Finest Spacing", &spacing, 0.005f, 0.03125f, 2.0f, "%.3f units")) m_terrainClipmap->SetBaseSpacing(spacing);
+            const TerrainClipmapStats& clipmapStats = m_terrainClipmap->GetStats();
+            ImGui::Text("Clipmap: %d levels, %zu triangles, %.0f units across", clipmapStats.levelsDrawn, clipmapStats.triangles, clipmapStats.extent);
+        } else if (m_terrainCache) {
+            ImGui::Checkbox("Use Baked Heightfield", &m_useTerrainCache);
+            ImGui::Text("Cache: %dx%d over %.0f units, %u bakes", m_terrainCache->GetResolution(), m_terrainCache->GetResolution(),
+                        m_terrainCache->GetExtent(), m_terrainCache->GetBakeCount());
+            if (m_terrainCache->GetMaxMipLevels() > 0) {
+                const char* traversalModes[] = { "Sphere Trace", "Max-Mip Hierarchy" };
+                int traversalMode = static_cast<int>(m_terrainTraversal);
+                if (ImGui::Combo("Terrain Traversal", &traversalMode, traversalModes, 2)) m_terrainTraversal = static_cast<TerrainTraversal>(traversalMode);
+                if (m_terrainTraversal == TerrainTraversal::MAX_MIP && !m_useTerrainCache) { ImGui::SameLine(); ImGui::TextDisabled("(needs baked heightfield)"); }
+            }
+        } else { ImGui::Text("Heightfield cache unavailable"); }
+        ImGui::BeginDisabled(governed || m_terrainRenderMode == TerrainRenderMode::CLIPMAP);
+        ImGui::SliderInt("Terrain Steps", &m_terrainMaxSteps, 16, 256);
+        ImGui::EndDisabled();
+        ImGui::Checkbox("Show Step Count", &m_terrainStepView);
     }
     // --- ADDED Cloud Controls ---
      if (ImGui::CollapsingHeader("Clouds", ImGuiTreeNodeFlags_DefaultOpen)) {
@@ -406,6 +869,22 @@ void Renderer::RenderUISceneControls() {
         m_cloud_coverage_max = glm::max(m_cloud_coverage_min + 0.01f, m_cloud_coverage_max);
         ImGui::Separator();
         ImGui::DragFloat("Density Factor", &m_cloud_density_factor, 0.05f, 0.0f, 5.0f);
+        ImGui::BeginDisabled(governed);
+        ImGui::SliderInt("Cloud Steps", &m_cloudMaxSteps, 8, 160);
+        ImGui::SliderInt("Shadow Steps", &m_shadowSteps, 1, 64);
+        const char* cloudUpdates[] = { "Every pixel", "1/4 per frame", "1/16 per frame" };
+        int cloudUpdate = (m_cloudUpdateGrid == 4) ? 2 : (m_cloudUpdateGrid == 2) ? 1 : 0;
+        if (ImGui::Combo("Cloud Updates", &cloudUpdate, cloudUpdates, 3)) { m_cloudUpdateGrid = 1 << cloudUpdate; }
+        ImGui::EndDisabled();
+        ImGui::Separator();
+        if (m_cloudRenderer) {
+            ImGui::Checkbox("Enable Clouds", &m_cloudsEnabled);
+            const char* cloudResolutions[] = { "1/2", "1/4" };
+            int cloudResolution = (m_cloudScaleDivisor == 4) ? 1 : 0;
+            if (ImGui::Combo("Cloud Resolution", &cloudResolution, cloudResolutions, 2)) { m_cloudScaleDivisor = (cloudResolution == 1) ? 4 : 2; }
+            ImGui::Text("Cloud buffer: %dx%d, noise volume %d^3", m_cloudRenderer->GetWidth(), m_cloudRenderer->GetHeight(), m_cloudRenderer->GetNoiseResolution());
+            ImGui::Text("Pixels marched last frame: %.1f%%", m_cloudRenderer->GetMarchedFraction() * 100.0f);
+        } else { ImGui::Text("Clouds unavailable (cloud shader or noise volume failed)"); }
      }
      // --- End Cloud Controls ---
     ImGui::End();
@@ -414,6 +893,8 @@ void Renderer::RenderUISceneControls() {
 void Renderer::RenderUIHierarchy(btDiscreteDynamicsWorld* world) {
     ImGui::Begin("Hierarchy");
     ImGui::Text("Scene Objects:"); ImGui::Separator();
+    std::unique_lock<std::mutex> worldLock;
+    if (m_physicsThread) worldLock = m_physicsThread->LockWorld(); // The physics thread may be stepping
     if (world) {
         int numObjects = world->getNumCollisionObjects();
         for (int i = 0; i < numObjects; ++i) {
@@ -423,8 +904,9 @@ void Renderer::RenderUIHierarchy(btDiscreteDynamicsWorld* world) {
             if (body) { objectName += (body->getInvMass() == 0.0f) ? " (Static)" : " (Dynamic)";
                 if (body->getCollisionShape()->getShapeType() == SPHERE_SHAPE_PROXYTYPE) objectName += " - Sphere";
                 else if (body->getCollisionShape()->getShapeType() == BOX_SHAPE_PROXYTYPE) objectName += " - Box";
+                else if (body->getCollisionShape()->getShapeType() == TERRAIN_SHAPE_PROXYTYPE) objectName += " - Terrain Tile";
             } else { objectName += " (CollisionObject)"; }
-            if (ImGui::Selectable(objectName.c_str())) { std::cout << "Selected: " << objectName << std::endl; }
+            if (ImGui::Selectable(objectName.c_str())) { LOG_VERBOSE(RENDER) << "Selected: " << objectName; }
         }
     } else { ImGui::Text("Physics world not available."); }
     ImGui::End();
@@ -454,13 +936,95 @@ void Renderer::RenderUI() {
 
     RenderUIToolbar();
     RenderUIStats();
+    RenderUIMemory();
     RenderUISceneControls();
     RenderUIInspector(); // Inspector panel
+    RenderUIPhysics();
 
     ImGui::End();
     ImGui::Render(); ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 }
 
+int Renderer::getRaymarchScaleDivisor() const {
+    switch (m_raymarchResolution) {
+        case RaymarchResolution::HALF:    return 2;
+        case RaymarchResolution::QUARTER: return 4;
+        default:                          return 1;
+    }
+}
+
+RaymarchParamsBlock Renderer::getRaymarchParams() const {
+    RaymarchParamsBlock params = {};
+    params.lightDir = m_lightDirection;
+    params.ambientStrength = m_ambientStrength;
+    params.lightColor = m_lightColor;
+    params.terrainBaseFreq = m_terrain_base_freq;
+    params.terrainBaseAmp = m_terrain_base_amp;
+    params.terrainPersistence = m_terrain_persistence;
+    params.terrainFlattenPower = m_terrain_flatten_power;
+    params.terrainFinalScale = m_terrain_final_scale;
+    params.terrainOctaves = std::min(m_terrain_octaves, getQualitySettings().maxTerrainOctaves);
+    params.cloudBaseHeight = m_cloud_base_height;
+    params.cloudThickness = m_cloud_thickness;
+    params.cloudNoiseScale = m_cloud_noise_scale;
+    params.cloudCoverageMin = m_cloud_coverage_min;
+    params.cloudCoverageMax = m_cloud_coverage_max;
+    params.cloudDensityFactor = m_cloud_density_factor;
+    params.cloudNoisePeriod = m_cloudRenderer ? m_cloudRenderer->GetNoisePeriod() : 1.0f;
+    return params;
+}
+
+// The physics heightfield follows the panel values. It keeps every octave even when the governor drops some
+// from the rendered terrain: those only add small detail, and a tier change would otherwise rebuild every tile.
+void Renderer::updatePhysicsTerrain() {
+    if (!m_physicsWorld) return;
+    TerrainParams params = getTerrainParams();
+    params.octaves = m_terrain_octaves;
+    if (m_physicsTerrainParamsSent && params == m_physicsTerrainParams) return;
+    m_physicsWorld->SetTerrainParams(params);
+    m_physicsTerrainParams = params;
+    m_physicsTerrainParamsSent = true;
+}
+
+TerrainParams Renderer::getTerrainParams() const {
+    TerrainParams params;
+    params.baseFreq = m_terrain_base_freq;
+    params.baseAmp = m_terrain_base_amp;
+    params.persistence = m_terrain_persistence;
+    params.flattenPower = m_terrain_flatten_power;
+    params.finalScale = m_terrain_final_scale;
+    params.octaves = std::min(m_terrain_octaves, getQualitySettings().maxTerrainOctaves);
+    return params;
+}
+
+// The panel values, or the governor's current tier (which also caps the terrain octaves)
+QualitySettings Renderer::getQualitySettings() const {
+    QualitySettings quality;
+    if (m_qualityGovernor.IsEnabled()) {
+        quality = m_qualityGovernor.GetSettings();
+    } else {
+        quality.raymarchScaleDivisor = getRaymarchScaleDivisor();
+        quality.terrainSteps = m_terrainMaxSteps;
+        quality.cloudSteps = m_cloudMaxSteps;
+        quality.shadowSteps = m_shadowSteps;
+        quality.cloudUpdateGrid = m_cloudUpdateGrid;
+    }
+    if (!m_temporalUpscaler) quality.raymarchScaleDivisor = 1;
+    return quality;
+}
+
+// Feeds the governor each new GPU "Frame" timing (the profiler reads them back a few frames late)
+void Renderer::updateQualityGovernor() {
+    if (!m_profiler || !m_qualityGovernor.IsEnabled()) return;
+    int frameSection = m_profiler->FindSection("Frame");
+    if (frameSection < 0) return;
+    const SampleHistory& history = m_profiler->GetGpuHistory(static_cast<size_t>(frameSection));
+    if (history.GetPushCount() < m_governorSamplesSeen) m_governorSamplesSeen = 0; // Profiler was reset
+    if (history.GetPushCount() == m_governorSamplesSeen) return;
+    m_governorSamplesSeen = history.GetPushCount();
+    if (m_qualityGovernor.AddFrameSample(history.GetLast()) && m_temporalUpscaler) m_temporalUpscaler->ResetHistory();
+}
+
 // --- Update Method ---
 void Renderer::Update(float dt) {
     this->deltaTime = dt; // Store delta time from main loop
@@ -477,72 +1041,249 @@ void Renderer::Update(float dt) {
 void Renderer::Render(btDiscreteDynamicsWorld* dynamicsWorld) {
     if (!m_raymarchShader || !m_raymarchShader->isValid()) {
         glClearColor(1.0f, 0.0f, 1.0f, 1.0f); glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        RenderUI(); glfwSwapBuffers(window); return;
+        RenderUI(); glfwSwapBuffers(window); m_framePacer.EndFrame(); return;
     }
 
-    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-    // --- 1. Render Raymarched Terrain ---
-    m_raymarchShader->use();
-    if (m_raymarch_timeLoc != -1) glUniform1f(m_raymarch_timeLoc, (float)glfwGetTime());
-    if (m_raymarch_camPosLoc != -1) glUniform3fv(m_raymarch_camPosLoc, 1, glm::value_ptr(camera.Position));
-    if (m_raymarch_lightDirLoc != -1) glUniform3fv(m_raymarch_lightDirLoc, 1, glm::value_ptr(m_lightDirection));
-    if (m_raymarch_lightColorLoc != -1) glUniform3fv(m_raymarch_lightColorLoc, 1, glm::value_ptr(m_lightColor));
-    if (m_raymarch_ambientLoc != -1) glUniform1f(m_raymarch_ambientLoc, m_ambientStrength);
-    if (m_raymarch_terrain_base_freqLoc != -1) glUniform1f(m_raymarch_terrain_base_freqLoc, m_terrain_base_freq);
-    if (m_raymarch_terrain_base_ampLoc != -1) glUniform1f(m_raymarch_terrain_base_ampLoc, m_terrain_base_amp);
-    if (m_raymarch_terrain_persistenceLoc != -1) glUniform1f(m_raymarch_terrain_persistenceLoc, m_terrain_persistence);
-    if (m_raymarch_terrain_flatten_powerLoc != -1) glUniform1f(m_raymarch_terrain_flatten_powerLoc, m_terrain_flatten_power);
-    if (m_raymarch_terrain_final_scaleLoc != -1) glUniform1f(m_raymarch_terrain_final_scaleLoc, m_terrain_final_scale);
-    if (m_raymarch_terrain_octavesLoc != -1) glUniform1i(m_raymarch_terrain_octavesLoc, m_terrain_octaves);
-    if (m_raymarch_cloud_base_heightLoc != -1) glUniform1f(m_raymarch_cloud_base_heightLoc, m_cloud_base_height);
-    if (m_raymarch_cloud_thicknessLoc != -1) glUniform1f(m_raymarch_cloud_thicknessLoc, m_cloud_thickness);
-    if (m_raymarch_cloud_noise_scaleLoc != -1) glUniform1f(m_raymarch_cloud_noise_scaleLoc, m_cloud_noise_scale);
-    if (m_raymarch_cloud_coverage_minLoc != -1) glUniform1f(m_raymarch_cloud_coverage_minLoc, m_cloud_coverage_min);
-    if (m_raymarch_cloud_coverage_maxLoc != -1) glUniform1f(m_raymarch_cloud_coverage_maxLoc, m_cloud_coverage_max);
-    if (m_raymarch_cloud_density_factorLoc != -1) glUniform1f(m_raymarch_cloud_density_factorLoc, m_cloud_density_factor);
+    Profiler* profiler = m_profiler.get();
+    if (profiler) {
+        profiler->BeginFrame();
+        // Physics steps on its own thread; pick up the step time once per new tick
+        if (m_physicsThread && m_physicsThread->GetTickCount() != m_profiledPhysicsTick) {
+            m_profiledPhysicsTick = m_physicsThread->GetTickCount();
+            profiler->AddCpuSample("Physics Step", m_physicsThread->GetLastStepMs());
+        }
+        const FramePacingStats& pacing = m_framePacer.GetStats();
+        profiler->AddCpuSample("Frame Pacing", pacing.fenceWaitMs + pacing.capSleepMs); // Spent in BeginFrame before this frame
+        updateQualityGovernor();
+    }
+    Shader::pollHotReload();
+    const QualitySettings quality = getQualitySettings();
+    m_frameArena.Reset(); // Last frame's draw commands are gone
+    m_renderQueue.BeginFrame();
+    m_renderQueue.ResetStats();
+    int frameSection = profiler ? profiler->BeginSection("Frame") : -1;
+
+    // --- 0. Scene parameters: re-uploaded only when a slider changed something ---
+    // Reprojected clouds would keep the old shape for a whole update cycle
+    if (m_raymarchParams.Update(getRaymarchParams()) && m_cloudRenderer) m_cloudRenderer->ResetHistory();
+    updatePhysicsTerrain();
+    // The clipmap replaces the terrain march, so the march's cache, upsampling and depth pre-pass go unused
+    bool clipmapActive = m_terrainRenderMode == TerrainRenderMode::CLIPMAP && m_terrainClipmap && m_skyShader;
+
+    // --- 0a. Refresh the baked heightfield (no-op unless terrain params changed or the camera left the region) ---
+    bool terrainCacheActive = m_terrainCache && m_useTerrainCache && !clipmapActive;
+    if (terrainCacheActive) {
+        ProfileScope scope(profiler, "Terrain Bake");
+        m_terrainCache->Update(getTerrainParams(), camera.Position, quadVAO);
+        RenderTarget::BindDefault(width, height);
+    }
 
     glm::mat4 view = camera.GetViewMatrix();
     glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), static_cast<float>(width) / static_cast<float>(height), 0.1f, 200.0f);
     glm::mat4 invView = glm::inverse(view);
     glm::mat4 invProj = glm::inverse(projection);
+    const glm::mat4 viewProj = projection * view;
+    float time = m_useSceneTime ? m_sceneTime : (float)glfwGetTime();
+
+    // --- 0b. Clouds into their own low-res buffer (composited by the raymarch pass) ---
+    bool cloudsActive = m_cloudRenderer && m_cloudsEnabled;
+    if (cloudsActive) {
+        ProfileScope scope(profiler, "Clouds");
+        m_cloudRenderer->Resize(width, height, m_cloudScaleDivisor);
+        m_cloudRenderer->Render(quadVAO, time, camera.Position, viewProj, invView, invProj, quality.cloudSteps, quality.cloudUpdateGrid);
+        RenderTarget::BindDefault(width, height);
+    } else if (m_cloudRenderer) {
+        m_cloudRenderer->ResetHistory();
+    }
+
+    // --- 0c. Finish imports/streaming, then decide what is visible (shared by the depth pre-pass and the color passes) ---
+    {
+        ProfileScope scope(profiler, "Asset Uploads", false);
+        updateAssetImports();
+    }
+    if (m_loadingScene) {
+        ProfileScope scope(profiler, "Scene Load", false);
+        updateSceneLoad();
+    }
+    if (m_textureStreamer) {
+        ProfileScope scope(profiler, "Texture Uploads", false);
+        m_textureStreamer->Update(TEXTURE_UPLOAD_BUDGET_MS);
+    }
+    const Frustum frustum(viewProj);
+    // Pixels covered by one world unit at distance 1, for screen-space LOD errors
+    const float pixelsPerUnit = static_cast<float>(height) / (2.0f * std::tan(glm::radians(camera.Zoom) * 0.5f));
+    cullSceneAssets(frustum);
+    {
+        ProfileScope scope(profiler, "Physics Gather", false);
+        preparePhysicsObjects(dynamicsWorld, frustum);
+    }
+
+    // --- 0d. Hybrid: opaque raster depth first, so the raymarch can stop at it (native resolution only) ---
+    bool upscale = quality.raymarchScaleDivisor > 1 && !clipmapActive;
+    bool hybrid = m_hybridDepth && !upscale && !clipmapActive && m_rasterShader;
+    if (hybrid && (m_depthPrepass.GetWidth() != width || m_depthPrepass.GetHeight() != height)) {
+        if (!m_depthPrepass.Create(width, height, {}, true)) {
+            LOG_ERROR(RENDER) << "Depth pre-pass target unavailable, hybrid rendering disabled.";
+            m_hybridDepth = hybrid = false;
+        }
+    }
+    if (hybrid) {
+        ProfileScope scope(profiler, "Depth Prepass");
+        m_depthPrepass.Bind();
+        glEnable(GL_DEPTH_TEST);
+        glClear(GL_DEPTH_BUFFER_BIT);
+        submitPhysicsObjects(true);
+        submitSceneAssets(frustum, pixelsPerUnit, true);
+        m_renderQueue.Flush(view, projection);
+        RenderTarget::BindDefault(width, height);
+    }
+
+    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    // --- 1a. Clipmap terrain: a depth-tested mesh; the raymarch quad below then only fills the sky ---
+    if (clipmapActive) {
+        ProfileScope scope(profiler, "Terrain Clipmap");
+        if (cloudsActive) {
+            glActiveTexture(GL_TEXTURE0 + CLOUD_NOISE_TEXTURE_UNIT); glBindTexture(GL_TEXTURE_3D, m_cloudRenderer->GetNoiseTexture());
+            glActiveTexture(GL_TEXTURE0 + CLOUD_BUFFER_TEXTURE_UNIT); glBindTexture(GL_TEXTURE_2D, m_cloudRenderer->GetCloudTexture());
+            glActiveTexture(GL_TEXTURE0 + CLOUD_DISTANCE_TEXTURE_UNIT); glBindTexture(GL_TEXTURE_2D, m_cloudRenderer->GetDistanceTexture());
+            glActiveTexture(GL_TEXTURE0);
+        }
+        glEnable(GL_DEPTH_TEST);
+        glDepthFunc(GL_LESS);
+        m_terrainClipmap->Render(viewProj, camera.Position, time, glm::vec2(static_cast<float>(width), static_cast<float>(height)),
+                                 quality.shadowSteps, cloudsActive);
+    }
+
+    // --- 1. Render Raymarched Terrain (native, or reduced resolution + temporal upsample) ---
+    int raymarchSection = profiler ? profiler->BeginSection("Raymarch") : -1;
+    glm::vec2 jitter(0.0f);
+    if (upscale) {
+        m_temporalUpscaler->Resize(width, height, quality.raymarchScaleDivisor);
+        jitter = m_temporalUpscaler->BeginRaymarch();
+    }
+
+    // Clipmap mode draws the sky-only variant, which leaves gl_FragDepth alone so early depth testing stays on
+    Shader& raymarch = clipmapActive ? *m_skyShader : *m_raymarchShader;
+    if (m_raymarchUniformsProgram != &raymarch) setupRaymarchUniforms(raymarch);
+    raymarch.use();
+    if (m_raymarch_jitterLoc != -1) glUniform2f(m_raymarch_jitterLoc, jitter.x, jitter.y);
+    if (m_raymarch_timeLoc != -1) glUniform1f(m_raymarch_timeLoc, time);
+    if (m_raymarch_camPosLoc != -1) glUniform3fv(m_raymarch_camPosLoc, 1, glm::value_ptr(camera.Position));
     if (m_raymarch_invViewLoc != -1) glUniformMatrix4fv(m_raymarch_invViewLoc, 1, GL_FALSE, glm::value_ptr(invView));
     if (m_raymarch_invProjLoc != -1) glUniformMatrix4fv(m_raymarch_invProjLoc, 1, GL_FALSE, glm::value_ptr(invProj));
+    if (m_raymarch_useTerrainCacheLoc != -1) glUniform1i(m_raymarch_useTerrainCacheLoc, terrainCacheActive ? 1 : 0);
+    if (terrainCacheActive) {
+        glm::vec2 origin = m_terrainCache->GetOrigin();
+        float extent = m_terrainCache->GetExtent();
+        if (m_raymarch_terrainCacheRectLoc != -1) glUniform4f(m_raymarch_terrainCacheRectLoc, origin.x, origin.y, 1.0f / extent, 1.0f / extent);
+        if (m_raymarch_terrainCacheTexelLoc != -1) {
+            float halfTexel = 0.5f / static_cast<float>(m_terrainCache->GetResolution());
+            glUniform2f(m_raymarch_terrainCacheTexelLoc, halfTexel, halfTexel);
+        }
+        glActiveTexture(GL_TEXTURE0 + TERRAIN_CACHE_TEXTURE_UNIT);
+        glBindTexture(GL_TEXTURE_2D, m_terrainCache->GetTexture());
+        glActiveTexture(GL_TEXTURE0 + TERRAIN_MAX_MIP_TEXTURE_UNIT);
+        glBindTexture(GL_TEXTURE_2D, m_terrainCache->GetMaxMipTexture());
+        glActiveTexture(GL_TEXTURE0);
+    }
+    // The hierarchy only exists inside the baked area; the shader sphere traces everywhere else
+    bool maxMipTraversal = terrainCacheActive && m_terrainTraversal == TerrainTraversal::MAX_MIP && m_terrainCache->GetMaxMipLevels() > 0;
+    if (m_raymarch_terrainTraversalLoc != -1) glUniform1i(m_raymarch_terrainTraversalLoc, maxMipTraversal ? 1 : 0);
+    if (m_raymarch_terrainMaxMipLevelsLoc != -1) glUniform1i(m_raymarch_terrainMaxMipLevelsLoc, maxMipTraversal ? m_terrainCache->GetMaxMipLevels() : 0);
+    if (m_raymarch_terrainMaxStepsLoc != -1) glUniform1i(m_raymarch_terrainMaxStepsLoc, quality.terrainSteps);
+    if (m_raymarch_shadowStepsLoc != -1) glUniform1i(m_raymarch_shadowStepsLoc, quality.shadowSteps);
+    if (m_raymarch_terrainStepViewLoc != -1) glUniform1i(m_raymarch_terrainStepViewLoc, m_terrainStepView ? 1 : 0);
+    if (m_raymarch_hybridDepthLoc != -1) glUniform1i(m_raymarch_hybridDepthLoc, hybrid ? 1 : 0);
+    if (clipmapActive) {
+        // The quad lies on the far plane, so it only passes where the clipmap left the cleared depth
+        glEnable(GL_DEPTH_TEST);
+        glDepthFunc(GL_LEQUAL);
+        glDepthMask(GL_FALSE);
+    } else if (hybrid) {
+        // The quad writes terrain depth through gl_FragDepth; GL_ALWAYS because it is the first thing in the depth buffer
+        if (m_raymarch_viewProjLoc != -1) glUniformMatrix4fv(m_raymarch_viewProjLoc, 1, GL_FALSE, glm::value_ptr(viewProj));
+        glActiveTexture(GL_TEXTURE0 + SCENE_DEPTH_TEXTURE_UNIT); glBindTexture(GL_TEXTURE_2D, m_depthPrepass.GetDepthTexture());
+        glEnable(GL_DEPTH_TEST);
+        glDepthFunc(GL_ALWAYS);
+    } else {
+        glDisable(GL_DEPTH_TEST); // Meshes are simply drawn on top
+    }
+    if (m_raymarch_cloudsEnabledLoc != -1) glUniform1i(m_raymarch_cloudsEnabledLoc, cloudsActive ? 1 : 0);
+    if (cloudsActive) {
+        glActiveTexture(GL_TEXTURE0 + CLOUD_NOISE_TEXTURE_UNIT); glBindTexture(GL_TEXTURE_3D, m_cloudRenderer->GetNoiseTexture());
+        glActiveTexture(GL_TEXTURE0 + CLOUD_BUFFER_TEXTURE_UNIT); glBindTexture(GL_TEXTURE_2D, m_cloudRenderer->GetCloudTexture());
+        glActiveTexture(GL_TEXTURE0 + CLOUD_DISTANCE_TEXTURE_UNIT); glBindTexture(GL_TEXTURE_2D, m_cloudRenderer->GetDistanceTexture());
+    }
 
     glBindVertexArray(quadVAO);
     glDrawArrays(GL_TRIANGLES, 0, 6);
     glBindVertexArray(0);
+    if (terrainCacheActive) {
+        glActiveTexture(GL_TEXTURE0 + TERRAIN_MAX_MIP_TEXTURE_UNIT);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glActiveTexture(GL_TEXTURE0 + TERRAIN_CACHE_TEXTURE_UNIT);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    if (cloudsActive) {
+        glActiveTexture(GL_TEXTURE0 + CLOUD_DISTANCE_TEXTURE_UNIT); glBindTexture(GL_TEXTURE_2D, 0);
+        glActiveTexture(GL_TEXTURE0 + CLOUD_BUFFER_TEXTURE_UNIT); glBindTexture(GL_TEXTURE_2D, 0);
+        glActiveTexture(GL_TEXTURE0 + CLOUD_NOISE_TEXTURE_UNIT); glBindTexture(GL_TEXTURE_3D, 0);
+        glActiveTexture(GL_TEXTURE0);
+    }
+    if (clipmapActive) {
+        glDepthFunc(GL_LESS);
+        glDepthMask(GL_TRUE);
+    }
+    if (hybrid) {
+        glDepthFunc(GL_LESS);
+        glActiveTexture(GL_TEXTURE0 + SCENE_DEPTH_TEXTURE_UNIT); glBindTexture(GL_TEXTURE_2D, 0);
+        glActiveTexture(GL_TEXTURE0);
+    }
     glUseProgram(0);
+    if (profiler) profiler->EndSection(raymarchSection);
+
+    if (upscale) {
+        ProfileScope scope(profiler, "Temporal Resolve");
+        m_temporalUpscaler->Resolve(quadVAO, invView, invProj, camera.Position, m_prevViewProj);
+    }
+    m_prevViewProj = viewProj;
     // --- End Terrain Rendering ---
 
-    // --- 2. Render Physics Objects ---
+    // --- 2. Render Physics Objects (depth tested against the terrain in hybrid and clipmap modes) ---
     glEnable(GL_DEPTH_TEST);
-    renderPhysicsObjects(dynamicsWorld, view, projection);
+    {
+        ProfileScope scope(profiler, "Physics Objects");
+        submitPhysicsObjects(false);
+        m_renderQueue.Flush(view, projection);
+        if (m_physicsInstancesWritten) m_physicsInstances.EndFrame();
+    }
 
     // --- Render Imported Assets ---
-    for (const auto& asset : m_sceneAssets) {
-        if (!asset.mesh) {
-            std::cerr << "Asset mesh is null!" << std::endl;
-            continue;
-        }
-        glm::mat4 model = glm::translate(glm::mat4(1.0f), asset.position);
-        m_rasterShader->use();
-        m_rasterShader->setMat4("model", model);
-        m_rasterShader->setMat4("view", view);
-        m_rasterShader->setMat4("projection", projection);
-        std::cout << "Rendering asset: " << asset.name << " at position: " << asset.position.x << ", " << asset.position.y << ", " << asset.position.z << std::endl;
-        asset.mesh->Draw();
-    }
+    int assetSection = profiler ? profiler->BeginSection("Assets") : -1;
+    m_assetTriangles = 0;
+    submitSceneAssets(frustum, pixelsPerUnit, false);
+    m_renderQueue.Flush(view, projection);
+    if (profiler) profiler->EndSection(assetSection);
 
     // --- End Physics Object Rendering ---
 
     // --- 3. Render UI ---
     glUseProgram(0);
-    RenderUI();
+    if (m_showUI) {
+        ProfileScope scope(profiler, "UI");
+        RenderUI();
+    }
     // --- End UI ---
 
-    glfwSwapBuffers(window);
+    if (profiler) profiler->EndSection(frameSection);
+    {
+        ProfileScope scope(profiler, "Swap", false); // Includes the vsync wait
+        glfwSwapBuffers(window);
+    }
+    m_framePacer.EndFrame();
+    if (profiler) profiler->EndFrame();
 }
 
 
@@ -556,7 +1297,7 @@ void Renderer::ProcessInput() {
         m_editorState = EditorState::EDITING;
         glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
         firstMouse = true;
-        std::cout << "Game Stopped (Escape). Cursor Enabled." << std::endl;
+        LOG_INFO(RENDER) << "Game Stopped (Escape). Cursor Enabled.";
     }
     escapePressedLastFrame = escapePressedThisFrame;
     // --- End Escape Key Logic ---
@@ -614,6 +1355,11 @@ void Renderer::ProcessInput() {
         else {
             glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
         }
+
+        // Keep the editor camera out of the ground (the same noise the terrain draws, one point per frame)
+        TerrainParams terrain = getTerrainParams();
+        float ground = TerrainNoise::Height(terrain, camera.Position.x, camera.Position.z) + EDITOR_CAMERA_CLEARANCE;
+        if (camera.Position.y < ground) camera.Position.y = ground;
     }
     // --- PLAYING MODE ---
     else if (m_editorState == EditorState::PLAYING) {
@@ -622,11 +1368,11 @@ void Renderer::ProcessInput() {
         if (tabPressedThisFrame && !tabPressedLastFrame) {
             if (glfwGetInputMode(window, GLFW_CURSOR) == GLFW_CURSOR_DISABLED) {
                 glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL); firstMouse = true;
-                std::cout << "Mouse Cursor Enabled (Tab)" << std::endl;
+                LOG_INFO(RENDER) << "Mouse Cursor Enabled (Tab)";
             } else {
                 if (m_lockMouseInPlayMode) {
                     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-                    std::cout << "Mouse Cursor Disabled (Tab)" << std::endl;
+                    LOG_INFO(RENDER) << "Mouse Cursor Disabled (Tab)";
                 }
             }
         }
@@ -642,9 +1388,9 @@ void Renderer::ProcessInput() {
         static bool rPressedLastFrame = false;
         bool rPressedThisFrame = glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS;
         if (rPressedThisFrame && !rPressedLastFrame) {
-            std::cout << "Reload key pressed, attempting texture reload..." << std::endl;
-            if (LoadTextureFromDirectories()) { std::cout << "Texture reloaded/found successfully via keypress." << std::endl; }
-            else { std::cout << "Texture reload/find via keypress failed." << std::endl; }
+            LOG_INFO(RENDER) << "Reload key pressed, attempting texture reload...";
+            if (LoadTextureFromDirectories()) { LOG_INFO(RENDER) << "Texture reloaded/found successfully via keypress."; }
+            else { LOG_INFO(RENDER) << "Texture reload/find via keypress failed."; }
         }
         rPressedLastFrame = rPressedThisFrame;
     }
@@ -687,35 +1433,233 @@ Mesh Renderer::CreateCube() {
         Vertex(glm::vec3(-0.5f,-0.5f,-0.5f), glm::vec3(1.f,1.f,1.f), glm::vec2(1.f,0.f)), Vertex(glm::vec3( 0.5f,-0.5f,-0.5f), glm::vec3(1.f,1.f,1.f), glm::vec2(0.f,0.f)),
         Vertex(glm::vec3( 0.5f, 0.5f,-0.5f), glm::vec3(1.f,1.f,1.f), glm::vec2(0.f,1.f)), Vertex(glm::vec3(-0.5f, 0.5f,-0.5f), glm::vec3(1.f,1.f,1.f), glm::vec2(1.f,1.f))
     };
+    // Corners are shared between faces, so each normal is the averaged corner direction
+    for (Vertex& vertex : vertices) vertex.Normal = glm::normalize(vertex.Position);
     std::vector<unsigned int> indices = {
         0,1,2, 2,3,0, 4,5,6, 6,7,4, 7,3,0, 0,4,7, 6,5,1, 1,2,6, 3,7,6, 6,2,3, 0,5,4, 0,1,5
     };
     return Mesh(vertices, indices);
 }
 
-// --- Helper function to load a mesh from file (very basic, only loads first mesh) ---
-std::unique_ptr<Mesh> Renderer::LoadMeshFromFile(const std::string& path) {
-    Assimp::Importer importer;
-    const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_GenNormals | aiProcess_JoinIdenticalVertices);
-    if (!scene || !scene->HasMeshes()) {
-        std::cerr << "Assimp failed to load mesh: " << path << std::endl;
-        return nullptr;
-    }
-    const aiMesh* mesh = scene->mMeshes[0];
+// --- CreateSphere Method (UV sphere, diameter 1 to match the unit cube) ---
+Mesh Renderer::CreateSphere(int latitudeSegments, int longitudeSegments) {
     std::vector<Vertex> vertices;
     std::vector<unsigned int> indices;
-    for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
-        glm::vec3 pos(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z);
-        glm::vec3 color(1.0f, 1.0f, 1.0f);
-        glm::vec2 uv(0.0f, 0.0f);
-        if (mesh->HasTextureCoords(0))
-            uv = glm::vec2(mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y);
-        vertices.emplace_back(pos, color, uv);
-    }
-    for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
-        for (unsigned int j = 0; j < mesh->mFaces[i].mNumIndices; ++j)
-            indices.push_back(mesh->mFaces[i].mIndices[j]);
-    }
-    std::cout << "Loaded mesh: " << path << std::endl;
-    return std::make_unique<Mesh>(vertices, indices);
-}
\ No newline at end of file
+    const float radius = 0.5f;
+    for (int lat = 0; lat <= latitudeSegments; ++lat) {
+        float v = static_cast<float>(lat) / static_cast<float>(latitudeSegments);
+        float theta = v * glm::pi<float>();
+        for (int lon = 0; lon <= longitudeSegments; ++lon) {
+            float u = static_cast<float>(lon) / static_cast<float>(longitudeSegments);
+            float phi = u * 2.0f * glm::pi<float>();
+            glm::vec3 pos(radius * std::sin(theta) * std::cos(phi), radius * std::cos(theta), radius * std::sin(theta) * std::sin(phi));
+            vertices.emplace_back(pos, glm::vec3(1.f, 1.f, 1.f), glm::vec2(u, 1.0f - v), pos / radius);
+        }
+    }
+    for (int lat = 0; lat < latitudeSegments; ++lat) {
+        for (int lon = 0; lon < longitudeSegments; ++lon) {
+            unsigned int first = static_cast<unsigned int>(lat * (longitudeSegments + 1) + lon);
+            unsigned int second = first + static_cast<unsigned int>(longitudeSegments + 1);
+            indices.insert(indices.end(), { first, second, first + 1, second, second + 1, first + 1 });
+        }
+    }
+    return Mesh(vertices, indices);
+}
+
+// --- Visible scene assets, with the LOD picked per mesh. depthOnly: hybrid depth pre-pass (triangles not counted) ---
+void Renderer::submitSceneAssets(const Frustum& frustum, float pixelsPerUnit, bool depthOnly) {
+    if (!m_rasterShader) return;
+    DrawCommand command;
+    command.shader = m_rasterShader.get();
+    for (uint32_t assetIndex : m_visibleAssets) {
+        const SceneAsset& asset = m_sceneAssets[assetIndex];
+        if (asset.state == AssetState::FAILED) continue;
+        command.model = glm::translate(glm::mat4(1.0f), asset.position);
+        if (asset.state == AssetState::LOADING) {
+            // Placeholder until the import finishes
+            command.vao = m_cubeVAO; command.layout = VertexLayout(); command.baseVertex = 0;
+            command.indexType = m_cubeIndexType; command.firstIndex = 0; command.indexCount = static_cast<uint32_t>(m_cubeIndexCount);
+            m_renderQueue.Submit(command);
+            continue;
+        }
+        for (const auto& mesh : asset.meshes) {
+            if (!mesh->IsUploaded()) continue;
+            // The asset as a whole survived; with several meshes each is tested on its own as well
+            if (m_frustumCulling && asset.meshes.size() > 1 &&
+                !frustum.IsVisible(Aabb::FromSphere(asset.position + mesh->GetBoundsCenter(), mesh->GetBoundsRadius()))) continue;
+            float distance = glm::length(asset.position + mesh->GetBoundsCenter() - camera.Position);
+            size_t lod = m_meshLodsEnabled ? mesh->SelectLod(distance, pixelsPerUnit, m_lodErrorPixels) : 0;
+            const MeshLod& range = mesh->GetLod(lod);
+            command.vao = mesh->VAO; command.layout = mesh->GetLayout(); command.baseVertex = mesh->GetBaseVertex();
+            command.indexType = mesh->GetIndexType(); command.firstIndex = mesh->GetFirstIndex(lod); command.indexCount = range.indexCount;
+            m_renderQueue.Submit(command);
+            if (!depthOnly) m_assetTriangles += range.indexCount / 3;
+        }
+    }
+}
+
+// --- Asset culling: BVH over world-space asset bounds, rebuilt only when assets are added or finish loading ---
+Aabb Renderer::getAssetBounds(const SceneAsset& asset) const {
+    if (asset.state != AssetState::READY || asset.meshes.empty()) {
+        return { asset.position - glm::vec3(0.5f), asset.position + glm::vec3(0.5f) }; // Placeholder cube
+    }
+    Aabb bounds = Aabb::FromSphere(asset.position + asset.meshes[0]->GetBoundsCenter(), asset.meshes[0]->GetBoundsRadius());
+    for (const auto& mesh : asset.meshes) bounds.Expand(Aabb::FromSphere(asset.position + mesh->GetBoundsCenter(), mesh->GetBoundsRadius()));
+    return bounds;
+}
+
+void Renderer::cullSceneAssets(const Frustum& frustum) {
+    m_visibleAssets.clear();
+    if (!m_frustumCulling) {
+        for (uint32_t i = 0; i < m_sceneAssets.size(); ++i) m_visibleAssets.push_back(i);
+        m_assetCulledCount = 0;
+        return;
+    }
+    if (m_assetBvhDirty) {
+        std::vector<Aabb> bounds;
+        bounds.reserve(m_sceneAssets.size());
+        for (const SceneAsset& asset : m_sceneAssets) bounds.push_back(getAssetBounds(asset));
+        m_assetBvh.Build(bounds);
+        m_assetBvhDirty = false;
+    }
+    m_assetBvh.QueryFrustum(frustum, m_visibleAssets);
+    std::sort(m_visibleAssets.begin(), m_visibleAssets.end()); // Keep the draw order stable
+    m_assetCulledCount = m_sceneAssets.size() - m_visibleAssets.size();
+}
+
+// --- Finish background imports: budgeted GPU upload, then hand the meshes to their SceneAsset ---
+void Renderer::updateAssetImports() {
+    if (!m_assetImporter) return;
+    for (ImportedAsset& imported : m_assetImporter->Update(ASSET_UPLOAD_BUDGET_MS)) {
+        for (SceneAsset& asset : m_sceneAssets) {
+            if (asset.importId != imported.id) continue;
+            asset.state = imported.success ? AssetState::READY : AssetState::FAILED;
+            asset.meshes = std::move(imported.meshes);
+            m_assetBvhDirty = true;
+            break;
+        }
+    }
+}
+
+// --- Scene Files ---
+// Clamps a value read from a scene file into the range its panel control allows; non-finite ones keep `current`
+static float sceneValue(float value, float minimum, float maximum, float current) {
+    return std::isfinite(value) ? std::clamp(value, minimum, maximum) : current;
+}
+
+bool Renderer::SaveScene(const std::string& path) {
+    if (m_loadingScene) {
+        LOG_WARN(ASSETS) << "Scene: still opening the previous scene, not saving " << path;
+        return false;
+    }
+    SceneDescription scene;
+    scene.environment.params = getRaymarchParams();
+    scene.environment.params.terrainOctaves = m_terrain_octaves;
+    scene.environment.cameraPosition[0] = camera.Position.x;
+    scene.environment.cameraPosition[1] = camera.Position.y;
+    scene.environment.cameraPosition[2] = camera.Position.z;
+    scene.environment.cameraYaw = camera.Yaw;
+    scene.environment.cameraPitch = camera.Pitch;
+    for (const SceneAsset& asset : m_sceneAssets) {
+        if (asset.state == AssetState::FAILED) continue;
+        SceneFileAsset entry;
+        entry.sourcePath = asset.name;
+        if (m_assetImporter) entry.cookedPath = m_assetImporter->GetMeshCache().GetCachePath(asset.name).string();
+        entry.position = asset.position;
+        scene.assets.push_back(std::move(entry));
+    }
+    if (m_physicsWorld) {
+        std::unique_lock<std::mutex> worldLock;
+        if (m_physicsThread) worldLock = m_physicsThread->LockWorld();
+        m_physicsWorld->CaptureSceneBodies(scene.bodies);
+    }
+    return SceneFile::Save(path, scene);
+}
+
+bool Renderer::OpenScene(const std::string& path) {
+    auto scene = std::make_unique<SceneFile>();
+    if (!scene->Open(path)) return false;
+    m_sceneLoadStart = glfwGetTime();
+
+    // Values go through the panel ranges: the shaders, the physics terrain and the height query assume them
+    const SceneEnvironment& environment = scene->GetEnvironment();
+    const RaymarchParamsBlock& params = environment.params;
+    glm::vec3 lightDirection = params.lightDir;
+    if (std::isfinite(lightDirection.x) && std::isfinite(lightDirection.y) && std::isfinite(lightDirection.z) &&
+        glm::length(lightDirection) > 1e-4f) {
+        m_lightDirection = glm::normalize(lightDirection);
+    }
+    m_ambientStrength = sceneValue(params.ambientStrength, 0.0f, 1.0f, m_ambientStrength);
+    m_lightColor = glm::vec3(sceneValue(params.lightColor.x, 0.0f, 1.0f, m_lightColor.x), sceneValue(params.lightColor.y, 0.0f, 1.0f, m_lightColor.y),
+                             sceneValue(params.lightColor.z, 0.0f, 1.0f, m_lightColor.z));
+    m_terrain_base_freq = sceneValue(params.terrainBaseFreq, 0.01f, 2.0f, m_terrain_base_freq);
+    m_terrain_base_amp = sceneValue(params.terrainBaseAmp, 0.1f, 10.0f, m_terrain_base_amp);
+    m_terrain_persistence = sceneValue(params.terrainPersistence, 0.1f, 1.0f, m_terrain_persistence);
+    m_terrain_flatten_power = sceneValue(params.terrainFlattenPower, 0.5f, 5.0f, m_terrain_flatten_power);
+    m_terrain_final_scale = sceneValue(params.terrainFinalScale, 0.1f, 10.0f, m_terrain_final_scale);
+    m_terrain_octaves = std::clamp(params.terrainOctaves, 1, QualitySettings().maxTerrainOctaves);
+    m_cloud_base_height = sceneValue(params.cloudBaseHeight, 0.0f, 50.0f, m_cloud_base_height);
+    m_cloud_thickness = sceneValue(params.cloudThickness, 1.0f, 50.0f, m_cloud_thickness);
+    m_cloud_noise_scale = sceneValue(params.cloudNoiseScale, 0.01f, 1.0f, m_cloud_noise_scale);
+    m_cloud_coverage_min = sceneValue(params.cloudCoverageMin, 0.0f, 1.0f, m_cloud_coverage_min);
+    m_cloud_coverage_max = std::max(m_cloud_coverage_min + 0.01f, sceneValue(params.cloudCoverageMax, 0.0f, 1.0f, m_cloud_coverage_max));
+    m_cloud_density_factor = sceneValue(params.cloudDensityFactor, 0.0f, 5.0f, m_cloud_density_factor);
+    const float* position = environment.cameraPosition;
+    if (std::isfinite(position[0]) && std::isfinite(position[1]) && std::isfinite(position[2])) camera.Position = glm::vec3(position[0], position[1], position[2]);
+    if (std::isfinite(environment.cameraYaw)) camera.Yaw = environment.cameraYaw;
+    camera.Pitch = sceneValue(environment.cameraPitch, -89.0f, 89.0f, camera.Pitch);
+    camera.updateCameraVectors();
+
+    // Imports of the previous assets still running are dropped when they finish
+    m_sceneAssets.clear();
+    m_selectedAsset = -1;
+    m_assetBvhDirty = true;
+    size_t uncooked = 0;
+    for (const SceneFileAsset& entry : scene->GetAssets()) {
+        std::error_code ec;
+        if (entry.cookedPath.empty() || !std::filesystem::exists(entry.cookedPath, ec)) uncooked++;
+        SceneAsset asset;
+        asset.name = entry.sourcePath;
+        asset.position = entry.position;
+        if (m_assetImporter) asset.importId = m_assetImporter->Import(entry.sourcePath);
+        else asset.state = AssetState::FAILED;
+        m_sceneAssets.push_back(std::move(asset));
+    }
+    LOG_INFO(ASSETS) << "Scene: opening " << path << " (" << m_sceneAssets.size() << " assets, " << uncooked
+                     << " without a cooked mesh file, " << scene->GetBodyCount() << " bodies)";
+
+    m_loadingScene.reset();
+    if (m_physicsWorld) {
+        {
+            std::unique_lock<std::mutex> worldLock;
+            if (m_physicsThread) worldLock = m_physicsThread->LockWorld();
+            m_physicsWorld->ClearSceneBodies();
+        }
+        if (m_physicsThread) m_physicsThread->RequestSnapshot();
+        m_loadingScene = std::move(scene);
+        m_sceneBodiesLoaded = 0;
+    }
+    return true;
+}
+
+// Bodies are read straight from the mapped file, a batch at a time, until this frame's budget is spent
+void Renderer::updateSceneLoad() {
+    if (!m_loadingScene || !m_physicsWorld) return;
+    const SceneBodyRecord* bodies = m_loadingScene->GetBodies();
+    size_t bodyCount = m_loadingScene->GetBodyCount();
+    double start = glfwGetTime();
+    {
+        std::unique_lock<std::mutex> worldLock;
+        if (m_physicsThread) worldLock = m_physicsThread->LockWorld();
+        while (m_sceneBodiesLoaded < bodyCount && (glfwGetTime() - start) * 1000.0 < SCENE_LOAD_BUDGET_MS) {
+            size_t batch = std::min(SCENE_LOAD_BATCH_BODIES, bodyCount - m_sceneBodiesLoaded);
+            m_physicsWorld->AddSceneBodies(bodies + m_sceneBodiesLoaded, batch);
+            m_sceneBodiesLoaded += batch;
+        }
+    }
+    if (m_physicsThread) m_physicsThread->RequestSnapshot(); // Show the bodies while paused
+    if (m_sceneBodiesLoaded < bodyCount) return;
+    LOG_INFO(ASSETS) << "Scene: all " << bodyCount << " bodies created, " << (glfwGetTime() - m_sceneLoadStart) * 1000.0
+                     << " ms after opening";
+    m_loadingScene.reset();
+}
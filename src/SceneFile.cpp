@@ -0,0 +1,151 @@
+#include "SceneFile.h"
+#include "Log.h"
+#include <cstring>
+#include <fstream>
+
+static const char SCENE_FILE_MAGIC[4] = { 'S', 'C', 'N', 'F' };
+static const uint64_t SCENE_FILE_ALIGNMENT = 16;
+
+struct SceneFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t assetCount;
+    uint32_t reserved;
+    uint64_t bodyCount;
+    uint64_t bodyOffset;   // Byte offsets from the start of the file
+    uint64_t stringOffset;
+    uint64_t stringBytes;
+};
+
+struct SceneAssetRecord {
+    uint64_t sourceOffset; // Into the string table
+    uint32_t sourceLength;
+    uint32_t cookedLength; // Stored right after the source path
+    float position[3];
+    uint32_t reserved;
+};
+
+const uint32_t SceneFile::VERSION; // Streamed by reference into log lines, so it needs a definition
+
+static uint64_t alignUp(uint64_t value) {
+    return (value + SCENE_FILE_ALIGNMENT - 1) & ~(SCENE_FILE_ALIGNMENT - 1);
+}
+
+bool SceneFile::Open(const std::filesystem::path& path) {
+    Close();
+    if (!m_file.Open(path)) {
+        LOG_ERROR(ASSETS) << "Scene: cannot open " << path.string();
+        return false;
+    }
+    const unsigned char* data = m_file.GetData();
+    const uint64_t size = m_file.GetSize();
+    SceneFileHeader header;
+    if (size < sizeof(SceneFileHeader) + sizeof(SceneEnvironment)) {
+        LOG_ERROR(ASSETS) << "Scene: truncated file " << path.string();
+        Close();
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, SCENE_FILE_MAGIC, sizeof(SCENE_FILE_MAGIC)) != 0 || header.version != VERSION) {
+        LOG_ERROR(ASSETS) << "Scene: " << path.string() << " is not a version " << VERSION << " scene file";
+        Close();
+        return false;
+    }
+    uint64_t assetsOffset = sizeof(SceneFileHeader) + sizeof(SceneEnvironment);
+    uint64_t assetsEnd = assetsOffset + static_cast<uint64_t>(header.assetCount) * sizeof(SceneAssetRecord);
+    if (assetsEnd > size || header.bodyOffset > size || header.bodyOffset < assetsEnd || header.bodyOffset % SCENE_FILE_ALIGNMENT != 0 ||
+        header.bodyCount > (size - header.bodyOffset) / sizeof(SceneBodyRecord) ||
+        header.stringOffset > size || header.stringBytes > size - header.stringOffset) {
+        LOG_ERROR(ASSETS) << "Scene: truncated file " << path.string();
+        Close();
+        return false;
+    }
+
+    std::memcpy(&m_environment, data + sizeof(SceneFileHeader), sizeof(SceneEnvironment));
+    const char* strings = reinterpret_cast<const char*>(data + header.stringOffset);
+    m_assets.resize(header.assetCount);
+    for (uint32_t i = 0; i < header.assetCount; ++i) {
+        SceneAssetRecord record;
+        std::memcpy(&record, data + assetsOffset + i * sizeof(SceneAssetRecord), sizeof(record));
+        // Each term checked on its own: the offset comes from the file and a sum could wrap
+        uint64_t pathBytes = static_cast<uint64_t>(record.sourceLength) + record.cookedLength;
+        if (record.sourceOffset > header.stringBytes || pathBytes > header.stringBytes - record.sourceOffset) {
+            LOG_ERROR(ASSETS) << "Scene: bad asset table in " << path.string();
+            Close();
+            return false;
+        }
+        SceneFileAsset& asset = m_assets[i];
+        asset.sourcePath.assign(strings + record.sourceOffset, record.sourceLength);
+        asset.cookedPath.assign(strings + record.sourceOffset + record.sourceLength, record.cookedLength);
+        asset.position = glm::vec3(record.position[0], record.position[1], record.position[2]);
+    }
+    m_bodies = reinterpret_cast<const SceneBodyRecord*>(data + header.bodyOffset);
+    m_bodyCount = static_cast<size_t>(header.bodyCount);
+    m_file.Prefetch(); // The body table is read front to back by the batched instantiation
+    return true;
+}
+
+void SceneFile::Close() {
+    m_file.Close();
+    m_environment = {};
+    m_assets.clear();
+    m_bodies = nullptr;
+    m_bodyCount = 0;
+}
+
+bool SceneFile::Save(const std::filesystem::path& path, const SceneDescription& scene) {
+    // Lay out the string table first so the asset records can be written in one go
+    std::string strings;
+    std::vector<SceneAssetRecord> assets(scene.assets.size());
+    for (size_t i = 0; i < scene.assets.size(); ++i) {
+        SceneAssetRecord& record = assets[i];
+        std::memset(&record, 0, sizeof(record));
+        record.sourceOffset = strings.size();
+        record.sourceLength = static_cast<uint32_t>(scene.assets[i].sourcePath.size());
+        record.cookedLength = static_cast<uint32_t>(scene.assets[i].cookedPath.size());
+        record.position[0] = scene.assets[i].position.x;
+        record.position[1] = scene.assets[i].position.y;
+        record.position[2] = scene.assets[i].position.z;
+        strings += scene.assets[i].sourcePath;
+        strings += scene.assets[i].cookedPath;
+    }
+
+    SceneFileHeader header = {};
+    std::memcpy(header.magic, SCENE_FILE_MAGIC, sizeof(SCENE_FILE_MAGIC));
+    header.version = VERSION;
+    header.assetCount = static_cast<uint32_t>(assets.size());
+    header.bodyCount = scene.bodies.size();
+    header.bodyOffset = alignUp(sizeof(SceneFileHeader) + sizeof(SceneEnvironment) + assets.size() * sizeof(SceneAssetRecord));
+    header.stringOffset = header.bodyOffset + scene.bodies.size() * sizeof(SceneBodyRecord);
+    header.stringBytes = strings.size();
+
+    std::error_code ec;
+    if (path.has_parent_path()) std::filesystem::create_directories(path.parent_path(), ec);
+    std::filesystem::path tempPath = path; tempPath += ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) { LOG_ERROR(ASSETS) << "Scene: cannot write " << tempPath.string(); return false; }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(&scene.environment), sizeof(SceneEnvironment));
+        out.write(reinterpret_cast<const char*>(assets.data()), static_cast<std::streamsize>(assets.size() * sizeof(SceneAssetRecord)));
+        static const char padding[SCENE_FILE_ALIGNMENT] = {};
+        uint64_t position = static_cast<uint64_t>(out.tellp());
+        if (header.bodyOffset > position) out.write(padding, static_cast<std::streamsize>(header.bodyOffset - position));
+        out.write(reinterpret_cast<const char*>(scene.bodies.data()), static_cast<std::streamsize>(scene.bodies.size() * sizeof(SceneBodyRecord)));
+        out.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+        if (!out) {
+            LOG_ERROR(ASSETS) << "Scene: write failed for " << tempPath.string();
+            out.close();
+            std::filesystem::remove(tempPath, ec); // Don't leave a partial file next to the scene
+            return false;
+        }
+    }
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        LOG_ERROR(ASSETS) << "Scene: cannot move " << tempPath.string() << " into place: " << ec.message();
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+    LOG_INFO(ASSETS) << "Scene saved to " << path.string() << " (" << scene.assets.size() << " assets, " << scene.bodies.size() << " bodies)";
+    return true;
+}
@@ -3,98 +3,317 @@
 #include <GL/glew.h> // Include GLEW for OpenGL types/functions
 #include <glm/gtc/type_ptr.hpp> // For glm::value_ptr
 
+#include "ShaderBinaryCache.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <sstream>
-#include <iostream>
+#include <memory>
 #include <string>   // Included via Shader.h, but good practice
 #include <vector>   // For dynamic info log buffer
 
-// Constructor
-Shader::Shader(const char* vertexPath, const char* fragmentPath)
-    : ID(0), m_isValid(false) // Initialize ID to 0 and validity flag to false
+// Maximum nesting of #include "file" directives (guards against include cycles)
+static const int MAX_INCLUDE_DEPTH = 8;
+// How often pollHotReload() looks at file modification times
+static const std::chrono::milliseconds HOT_RELOAD_POLL_INTERVAL(250);
+
+// --- Shared state (GL thread only) ---
+static std::vector<Shader*>& liveShaders() { static std::vector<Shader*> shaders; return shaders; }
+static ShaderStats g_shaderStats;
+static bool g_hotReloadEnabled = true;
+static bool g_binaryCacheEnabled = true;
+
+// Info logs run to many lines (longer than one log slot), so they are logged line by line
+static void logInfoLog(const char* text) {
+    while (*text) {
+        const char* end = std::strchr(text, '\n');
+        size_t length = end ? static_cast<size_t>(end - text) : std::strlen(text);
+        if (length > 0) LOG_ERROR(SHADER) << "  " << std::string(text, length);
+        text += end ? length + 1 : length;
+    }
+}
+
+// Created with the first shader: the support queries need a current context
+static ShaderBinaryCache* binaryCache() {
+    static bool initialized = false;
+    static std::unique_ptr<ShaderBinaryCache> cache;
+    if (!initialized) {
+        initialized = true;
+        if (g_binaryCacheEnabled && ShaderBinaryCache::IsSupported()) {
+            cache = std::make_unique<ShaderBinaryCache>();
+            LOG_INFO(SHADER) << "Shader binary cache enabled";
+        }
+    }
+    return cache.get();
+}
+
+static bool parallelCompile() {
+    static bool initialized = false, supported = false;
+    if (!initialized) {
+        initialized = true;
+        if (GLEW_KHR_parallel_shader_compile) {
+            glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu); // Let the driver pick
+            supported = true;
+            LOG_INFO(SHADER) << "Parallel shader compile enabled";
+        }
+    }
+    return supported;
+}
+
+void Shader::setHotReloadEnabled(bool enabled) { g_hotReloadEnabled = enabled; }
+bool Shader::isHotReloadEnabled() { return g_hotReloadEnabled; }
+void Shader::setBinaryCacheEnabled(bool enabled) { g_binaryCacheEnabled = enabled; }
+const ShaderStats& Shader::getStats() { return g_shaderStats; }
+
+// Reads a shader file into `source`, replacing each `#include "file"` line with the contents of that
+// file (resolved relative to the including file). A #line directive keeps compiler error line numbers
+// pointing at the including file after each expansion.
+// Every file read is appended to `sources` (for hot reload), when given.
+bool Shader::loadShaderSource(const std::filesystem::path& path, std::string& source, int depth, std::vector<SourceFile>* sources) {
+    if (depth > MAX_INCLUDE_DEPTH) {
+        LOG_ERROR(SHADER) << "ERROR::SHADER::INCLUDE_DEPTH_EXCEEDED: " << path.string();
+        return false;
+    }
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        LOG_ERROR(SHADER) << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << path.string();
+        return false;
+    }
+    if (sources) {
+        std::error_code ec;
+        sources->push_back({ path, std::filesystem::last_write_time(path, ec) });
+    }
+
+    std::stringstream out;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        size_t start = line.find_first_not_of(" \t");
+        if (start == std::string::npos || line.compare(start, 8, "#include") != 0) {
+            out << line << '\n';
+            continue;
+        }
+        size_t open = line.find('"', start);
+        size_t close = (open == std::string::npos) ? std::string::npos : line.find('"', open + 1);
+        if (close == std::string::npos) {
+            LOG_ERROR(SHADER) << "ERROR::SHADER::MALFORMED_INCLUDE: " << path.string() << ":" << lineNumber;
+            return false;
+        }
+        std::string included;
+        if (!loadShaderSource(path.parent_path() / line.substr(open + 1, close - open - 1), included, depth + 1, sources)) {
+            return false;
+        }
+        out << included << "#line " << (lineNumber + 1) << '\n';
+    }
+    source = out.str();
+    return true;
+}
+
+// Inserts the variant's #defines after the #version line (which must stay first), then a #line so
+// compiler errors keep the file's own line numbers
+static void insertDefines(std::string& source, const std::string& defines) {
+    if (defines.empty()) return;
+    size_t version = source.find("#version");
+    size_t lineEnd = version == std::string::npos ? std::string::npos : source.find('\n', version);
+    if (lineEnd == std::string::npos) { source.insert(0, defines + "#line 1\n"); return; }
+    int nextLine = 2 + static_cast<int>(std::count(source.begin(), source.begin() + lineEnd, '\n'));
+    source.insert(lineEnd + 1, defines + "#line " + std::to_string(nextLine) + "\n");
+}
+
+bool Shader::loadSources(std::string& vertexCode, std::string& fragmentCode, std::vector<SourceFile>& sources) const {
+    sources.clear();
+    if (!loadShaderSource(m_vertexPath, vertexCode, 0, &sources) || !loadShaderSource(m_fragmentPath, fragmentCode, 0, &sources)) return false;
+    insertDefines(vertexCode, m_defines);
+    insertDefines(fragmentCode, m_defines);
+    return true;
+}
+
+// Constructor: starts the build; the result is picked up by resolve()
+Shader::Shader(const char* vertexPath, const char* fragmentPath, const char* defines)
+    : ID(0), m_vertexPath(vertexPath ? vertexPath : ""), m_fragmentPath(fragmentPath ? fragmentPath : ""),
+      m_defines(defines ? defines : "")
 {
-    // 1. Retrieve the vertex/fragment source code from filePath
+    liveShaders().push_back(this);
+    // 1. Retrieve the vertex/fragment source code from filePath (expanding #include directives)
     std::string vertexCode;
     std::string fragmentCode;
-    std::ifstream vShaderFile;
-    std::ifstream fShaderFile;
-    // Ensure ifstream objects can throw exceptions:
-    vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    try {
-        // Open files
-        vShaderFile.open(vertexPath);
-        fShaderFile.open(fragmentPath);
-        std::stringstream vShaderStream, fShaderStream;
-        // Read file's buffer contents into streams
-        vShaderStream << vShaderFile.rdbuf();
-        fShaderStream << fShaderFile.rdbuf();
-        // Close file handlers
-        vShaderFile.close();
-        fShaderFile.close();
-        // Convert stream into string
-        vertexCode = vShaderStream.str();
-        fragmentCode = fShaderStream.str();
-    } catch (std::ifstream::failure& e) {
-        std::cerr << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << e.what() << std::endl;
-        std::cerr << "  Vertex Path: " << (vertexPath ? vertexPath : "NULL") << std::endl;
-        std::cerr << "  Fragment Path: " << (fragmentPath ? fragmentPath : "NULL") << std::endl;
+    if (!loadSources(vertexCode, fragmentCode, m_sources)) {
+        LOG_ERROR(SHADER) << "  Vertex Path: " << (vertexPath ? vertexPath : "NULL");
+        LOG_ERROR(SHADER) << "  Fragment Path: " << (fragmentPath ? fragmentPath : "NULL");
         // m_isValid remains false, ID remains 0
         return; // Exit constructor on file read failure
     }
+    // 2. Binary cache hit, or compile + link (not waited for)
+    m_buildPending = startBuild(vertexCode, fragmentCode, m_build);
+}
+
+// Destructor
+Shader::~Shader() {
+    liveShaders().erase(std::remove(liveShaders().begin(), liveShaders().end(), this), liveShaders().end());
+    destroyBuild(m_build);
+    destroyBuild(m_reload);
+    if (this->ID != 0) { // Check if ID is valid before deleting
+        glDeleteProgram(this->ID);
+    }
+}
+
+// --- Building ---
+
+bool Shader::startBuild(const std::string& vertexCode, const std::string& fragmentCode, Build& build) {
+    build = Build();
+    build.start = std::chrono::steady_clock::now();
+    ShaderBinaryCache* cache = binaryCache();
+    if (cache) {
+        build.key = ShaderBinaryCache::MakeKey(vertexCode, fragmentCode);
+        GLenum format = 0;
+        std::vector<unsigned char> binary;
+        if (cache->Load(build.key, format, binary)) {
+            build.program = glCreateProgram();
+            glProgramBinary(build.program, format, binary.data(), static_cast<GLsizei>(binary.size()));
+            GLint linked = GL_FALSE;
+            glGetProgramiv(build.program, GL_LINK_STATUS, &linked);
+            if (linked) { build.fromBinary = true; return true; }
+            glDeleteProgram(build.program); // Rejected by the driver after all: compile below
+            build.program = 0;
+        }
+    }
+
+    parallelCompile();
     const char* vShaderCode = vertexCode.c_str();
     const char* fShaderCode = fragmentCode.c_str();
+    build.vertex = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(build.vertex, 1, &vShaderCode, NULL);
+    glCompileShader(build.vertex);
+    build.fragment = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(build.fragment, 1, &fShaderCode, NULL);
+    glCompileShader(build.fragment);
+    build.program = glCreateProgram();
+    glAttachShader(build.program, build.vertex);
+    glAttachShader(build.program, build.fragment);
+    if (cache) glProgramParameteri(build.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glLinkProgram(build.program); // Compile errors surface as a failed link, read back in finishBuild()
+    return true;
+}
 
-    // 2. Compile shaders
-    unsigned int vertex, fragment;
+bool Shader::isBuildDone(const Build& build) {
+    if (build.fromBinary || !parallelCompile()) return true; // Without the extension the status query simply blocks
+    GLint done = GL_FALSE;
+    glGetProgramiv(build.program, GL_COMPLETION_STATUS_KHR, &done);
+    return done == GL_TRUE;
+}
 
-    // Vertex shader
-    vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vShaderCode, NULL);
-    glCompileShader(vertex);
-    if (!checkCompileErrors(vertex, "VERTEX")) { // Use the bool returning function
-        glDeleteShader(vertex); // Clean up failed shader
-        return; // Exit constructor
+// Reads the build's status (blocking if it is still running). On success build.program is the result and
+// the caller owns it; on failure everything is deleted.
+bool Shader::finishBuild(Build& build, const std::string& name) {
+    if (build.fromBinary) {
+        g_shaderStats.binaryHits++;
+        LOG_INFO(SHADER) << "Shader Program (" << build.program << ") loaded from binary cache: " << name;
+        return true;
+    }
+    g_shaderStats.compiles++;
+    bool ok = checkLinkErrors(build.program);
+    if (!ok) {
+        checkCompileErrors(build.vertex, "VERTEX");
+        checkCompileErrors(build.fragment, "FRAGMENT");
+    }
+    glDetachShader(build.program, build.vertex);
+    glDetachShader(build.program, build.fragment);
+    glDeleteShader(build.vertex);
+    glDeleteShader(build.fragment);
+    build.vertex = build.fragment = 0;
+    if (!ok) {
+        glDeleteProgram(build.program);
+        build.program = 0;
+        return false;
     }
 
-    // Fragment Shader
-    fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fShaderCode, NULL);
-    glCompileShader(fragment);
-    if (!checkCompileErrors(fragment, "FRAGMENT")) { // Use the bool returning function
-        glDeleteShader(vertex); // Clean up vertex shader too
-        glDeleteShader(fragment);
-        return; // Exit constructor
+    ShaderBinaryCache* cache = binaryCache();
+    if (cache) {
+        GLint length = 0;
+        glGetProgramiv(build.program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length > 0) {
+            std::vector<unsigned char> binary(static_cast<size_t>(length));
+            GLenum format = 0;
+            glGetProgramBinary(build.program, length, nullptr, &format, binary.data());
+            cache->Store(build.key, format, binary);
+        }
     }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - build.start).count();
+    LOG_INFO(SHADER) << "Shader Program (" << build.program << ") created successfully from: " << name << " (" << ms << " ms)";
+    return true;
+}
 
-    // Shader Program Linking
-    this->ID = glCreateProgram(); // Assign the member ID
-    glAttachShader(this->ID, vertex);
-    glAttachShader(this->ID, fragment);
-    glLinkProgram(this->ID);
-    if (!checkLinkErrors(this->ID)) { // Use the new linking check function
-        glDeleteShader(vertex); // Clean up shaders
-        glDeleteShader(fragment);
-        glDeleteProgram(this->ID); // Clean up program
-        this->ID = 0; // Reset ID
-        return; // Exit constructor
+void Shader::destroyBuild(Build& build) {
+    if (build.vertex) glDeleteShader(build.vertex);
+    if (build.fragment) glDeleteShader(build.fragment);
+    if (build.program) glDeleteProgram(build.program);
+    build = Build();
+}
+
+void Shader::resolve() const {
+    if (!m_buildPending) return;
+    m_buildPending = false;
+    if (finishBuild(m_build, m_vertexPath + ", " + m_fragmentPath)) {
+        const_cast<Shader*>(this)->ID = m_build.program;
+        m_isValid = true;
     }
+    m_build = Build();
+}
 
-    // Delete the shaders as they're linked into our program now and no longer necessary
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
+// --- Hot reload ---
 
-    // If all steps succeeded, mark the shader as valid
-    this->m_isValid = true;
-    std::cout << "Shader Program (" << this->ID << ") created successfully from: "
-              << vertexPath << ", " << fragmentPath << std::endl;
+bool Shader::sourcesChanged() const {
+    for (const SourceFile& source : m_sources) {
+        std::error_code ec;
+        auto writeTime = std::filesystem::last_write_time(source.path, ec);
+        if (!ec && writeTime != source.writeTime) return true;
+    }
+    return false;
 }
 
-// Destructor (Implementation ADDED)
-Shader::~Shader() {
-    if (this->ID != 0) { // Check if ID is valid before deleting
-        glDeleteProgram(this->ID);
-        // std::cout << "Deleted Shader Program (" << this->ID << ")" << std::endl; // Optional debug message
+void Shader::pollReload() {
+    if (m_reload.program) {
+        if (!isBuildDone(m_reload)) return; // Keep drawing with the old program
+        std::string name = m_vertexPath + ", " + m_fragmentPath;
+        if (!finishBuild(m_reload, name)) {
+            g_shaderStats.reloadFailures++;
+            LOG_ERROR(SHADER) << "Shader reload failed, keeping the previous program: " << name;
+            m_reload = Build();
+            return;
+        }
+        if (ID != 0) glDeleteProgram(ID);
+        ID = m_reload.program;
+        m_reload = Build();
+        m_isValid = true;
+        m_uniformLocations.clear();
+        g_shaderStats.reloads++;
+        if (m_onReload) m_onReload(*this);
+        glUseProgram(0);
+        return;
+    }
+    if (m_buildPending || m_sources.empty() || !sourcesChanged()) return;
+
+    std::string vertexCode, fragmentCode;
+    std::vector<SourceFile> sources;
+    bool loaded = loadSources(vertexCode, fragmentCode, sources);
+    if (!sources.empty()) m_sources = sources; // New times (and includes) even if a file is mid-save; the next write retries
+    if (!loaded) return;
+    LOG_INFO(SHADER) << "Shader sources changed, rebuilding: " << m_vertexPath << ", " << m_fragmentPath;
+    startBuild(vertexCode, fragmentCode, m_reload);
+}
+
+void Shader::pollHotReload() {
+    if (!g_hotReloadEnabled) return;
+    static std::chrono::steady_clock::time_point lastPoll;
+    auto now = std::chrono::steady_clock::now();
+    bool checkFiles = now - lastPoll >= HOT_RELOAD_POLL_INTERVAL;
+    if (checkFiles) lastPoll = now;
+    for (Shader* shader : liveShaders()) {
+        // Running rebuilds are checked every frame, file times only every poll interval
+        if (shader->m_reload.program || checkFiles) shader->pollReload();
     }
 }
 
@@ -102,20 +321,20 @@ Shader::~Shader() {
 // Use/activate the shader
 void Shader::use() {
     // Only use if valid (prevents using program 0 accidentally if creation failed)
-    if (m_isValid) {
+    if (isValid()) {
         glUseProgram(ID);
     }
 }
 
-// Method to check validity (Implementation ADDED)
 bool Shader::isValid() const {
+    resolve();
     return m_isValid;
 }
 
 
 // Utility function for checking shader compilation errors.
-// Returns true if compilation succeeded, false otherwise. (MODIFIED)
-bool Shader::checkCompileErrors(GLuint shader, std::string type) {
+// Returns true if compilation succeeded, false otherwise.
+bool Shader::checkCompileErrors(GLuint shader, const std::string& type) {
     GLint success;
     glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
     if (!success) {
@@ -123,15 +342,14 @@ bool Shader::checkCompileErrors(GLuint shader, std::string type) {
         glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &logLength);
         std::vector<GLchar> infoLog(logLength > 0 ? logLength : 1); // Ensure buffer is not zero-size
         glGetShaderInfoLog(shader, logLength, NULL, infoLog.data());
-        std::cerr << "ERROR::SHADER_COMPILATION_ERROR of type: " << type << "\n"
-                  << (logLength > 0 ? infoLog.data() : "(No info log available)")
-                  << "\n -- --------------------------------------------------- -- " << std::endl;
+        LOG_ERROR(SHADER) << "ERROR::SHADER_COMPILATION_ERROR of type: " << type;
+        logInfoLog(logLength > 0 ? infoLog.data() : "(No info log available)");
     }
     return success; // Return the success status (true or false)
 }
 
 // Utility function for checking shader linking errors.
-// Returns true if linking succeeded, false otherwise. (ADDED)
+// Returns true if linking succeeded, false otherwise.
 bool Shader::checkLinkErrors(GLuint program) {
     GLint success;
     glGetProgramiv(program, GL_LINK_STATUS, &success);
@@ -140,36 +358,57 @@ bool Shader::checkLinkErrors(GLuint program) {
         glGetProgramiv(program, GL_INFO_LOG_LENGTH, &logLength);
         std::vector<GLchar> infoLog(logLength > 0 ? logLength : 1); // Ensure buffer is not zero-size
         glGetProgramInfoLog(program, logLength, NULL, infoLog.data());
-        std::cerr << "ERROR::PROGRAM_LINKING_ERROR of type: PROGRAM\n"
-                  << (logLength > 0 ? infoLog.data() : "(No info log available)")
-                  << "\n -- --------------------------------------------------- -- " << std::endl;
+        LOG_ERROR(SHADER) << "ERROR::PROGRAM_LINKING_ERROR of type: PROGRAM";
+        logInfoLog(logLength > 0 ? infoLog.data() : "(No info log available)");
     }
     return success; // Return the success status (true or false)
 }
 
 
+// --- Uniform location cache ---
+GLint Shader::getUniformLocation(UniformName name) const {
+    resolve();
+    auto range = m_uniformLocations.equal_range(name.hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second.name == name.name) return it->second.location;
+    }
+    GLint location = glGetUniformLocation(ID, name.name);
+    m_uniformLocations.emplace(name.hash, CachedUniform{ name.name, location }); // -1 is cached too (uniform optimised out / absent)
+    return location;
+}
+
+bool Shader::bindUniformBlock(const char* blockName, GLuint binding) const {
+    if (!isValid()) return false;
+    GLuint blockIndex = glGetUniformBlockIndex(ID, blockName);
+    if (blockIndex == GL_INVALID_INDEX) return false;
+    glUniformBlockBinding(ID, blockIndex, binding);
+    return true;
+}
+
 // --- Implementations for your uniform setters ---
-// Added the m_isValid check to prevent errors if shader failed to build
-void Shader::setBool(const std::string &name, bool value) const {
-    if(m_isValid) glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+// isValid() also picks up a pending build, so setters work straight after construction
+void Shader::setBool(UniformName name, bool value) const {
+    if(isValid()) glUniform1i(getUniformLocation(name), (int)value);
+}
+
+void Shader::setInt(UniformName name, int value) const {
+    if(isValid()) glUniform1i(getUniformLocation(name), value);
 }
 
-void Shader::setInt(const std::string &name, int value) const {
-    if(m_isValid) glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+void Shader::setFloat(UniformName name, float value) const {
+    if(isValid()) glUniform1f(getUniformLocation(name), value);
 }
 
-void Shader::setFloat(const std::string &name, float value) const {
-    if(m_isValid) glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+void Shader::setVec2(UniformName name, const glm::vec2 &value) const {
+    if(isValid()) glUniform2fv(getUniformLocation(name), 1, glm::value_ptr(value));
 }
 
-void Shader::setVec3(const std::string &name, const glm::vec3 &value) const {
-    // Check m_isValid before calling glGetUniformLocation and glUniform3fv
-    if(m_isValid) glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, glm::value_ptr(value));
+void Shader::setVec3(UniformName name, const glm::vec3 &value) const {
+    if(isValid()) glUniform3fv(getUniformLocation(name), 1, glm::value_ptr(value));
 }
 
-void Shader::setMat4(const std::string &name, const glm::mat4 &value) const {
-    // Check m_isValid before calling glGetUniformLocation and glUniformMatrix4fv
-    if(m_isValid) glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(value));
+void Shader::setMat4(UniformName name, const glm::mat4 &value) const {
+    if(isValid()) glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, glm::value_ptr(value));
 }
 
-// Add implementations for any other setters you have, including the if(m_isValid) check
+// Add implementations for any other setters you have, including the if(isValid()) check
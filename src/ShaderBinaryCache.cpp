@@ -0,0 +1,105 @@
+#include "ShaderBinaryCache.h"
+#include "Log.h"
+#include "MappedFile.h"
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+static const char SHADER_BINARY_MAGIC[4] = { 'S', 'P', 'B', 'N' };
+static const uint32_t SHADER_BINARY_VERSION = 1;
+
+struct ShaderBinaryHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t key;
+    uint32_t format;
+    uint32_t length;
+};
+
+// FNV-1a, 64 bit, continued from `hash`
+static uint64_t hashBytes(const char* data, size_t size, uint64_t hash = 14695981039346656037ull) {
+    for (size_t i = 0; i < size; ++i) { hash ^= static_cast<unsigned char>(data[i]); hash *= 1099511628211ull; }
+    return hash;
+}
+
+static uint64_t hashGLString(GLenum name, uint64_t hash) {
+    const char* value = reinterpret_cast<const char*>(glGetString(name));
+    if (!value) value = "";
+    return hashBytes(value, std::strlen(value) + 1, hash); // Terminator included: keeps the fields apart
+}
+
+ShaderBinaryCache::ShaderBinaryCache(std::filesystem::path cacheDirectory) : m_directory(std::move(cacheDirectory)) {}
+
+bool ShaderBinaryCache::IsSupported() {
+    if (!GLEW_VERSION_4_1 && !GLEW_ARB_get_program_binary) return false;
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+}
+
+uint64_t ShaderBinaryCache::MakeKey(const std::string& vertexSource, const std::string& fragmentSource) {
+    uint64_t hash = hashBytes(vertexSource.c_str(), vertexSource.size() + 1);
+    hash = hashBytes(fragmentSource.c_str(), fragmentSource.size() + 1, hash);
+    hash = hashGLString(GL_VENDOR, hash);
+    hash = hashGLString(GL_RENDERER, hash);
+    return hashGLString(GL_VERSION, hash);
+}
+
+std::filesystem::path ShaderBinaryCache::GetCachePath(uint64_t key) const {
+    std::ostringstream name;
+    name << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+    return m_directory / name.str();
+}
+
+bool ShaderBinaryCache::Load(uint64_t key, GLenum& format, std::vector<unsigned char>& binary) const {
+    std::ifstream in(GetCachePath(key), std::ios::binary);
+    if (!in) return false;
+    ShaderBinaryHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+    if (std::memcmp(header.magic, SHADER_BINARY_MAGIC, sizeof(SHADER_BINARY_MAGIC)) != 0 ||
+        header.version != SHADER_BINARY_VERSION || header.key != key || header.length == 0) return false;
+    // A corrupt length must not size the allocation: it has to fit in what is left of the file
+    std::streamoff position = in.tellg();
+    in.seekg(0, std::ios::end);
+    std::streamoff end = in.tellg();
+    if (position < 0 || end < position || header.length > static_cast<uint64_t>(end - position)) return false;
+    in.seekg(position);
+    binary.resize(header.length);
+    if (!in.read(reinterpret_cast<char*>(binary.data()), header.length)) return false;
+    format = header.format;
+    return true;
+}
+
+bool ShaderBinaryCache::Store(uint64_t key, GLenum format, const std::vector<unsigned char>& binary) const {
+    ShaderBinaryHeader header = {};
+    std::memcpy(header.magic, SHADER_BINARY_MAGIC, sizeof(SHADER_BINARY_MAGIC));
+    header.version = SHADER_BINARY_VERSION;
+    header.key = key;
+    header.format = format;
+    header.length = static_cast<uint32_t>(binary.size());
+
+    std::error_code ec;
+    std::filesystem::create_directories(m_directory, ec);
+    std::filesystem::path finalPath = GetCachePath(key);
+    std::filesystem::path tempPath = MakeTempPath(finalPath);
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) { LOG_ERROR(SHADER) << "Shader cache: cannot write " << tempPath.string(); return false; }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(binary.data()), static_cast<std::streamsize>(binary.size()));
+        if (!out) {
+            LOG_ERROR(SHADER) << "Shader cache: write failed for " << tempPath.string();
+            out.close();
+            std::filesystem::remove(tempPath, ec); // Temp names are unique, so nothing else would reuse it
+            return false;
+        }
+    }
+    std::filesystem::rename(tempPath, finalPath, ec);
+    if (ec) {
+        LOG_ERROR(SHADER) << "Shader cache: cannot rename " << tempPath.string() << ": " << ec.message();
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,125 @@
+#include "TemporalUpscaler.h"
+#include "Log.h"
+
+// Number of distinct sub-pixel jitter positions before the sequence repeats
+static const unsigned int JITTER_SEQUENCE_LENGTH = 16;
+// Maximum weight given to a new sample whose centre lands exactly on the output pixel
+static const float TEMPORAL_FEEDBACK = 0.5f;
+
+TemporalUpscaler::TemporalUpscaler() = default;
+
+TemporalUpscaler::~TemporalUpscaler() = default;
+
+bool TemporalUpscaler::Initialize() {
+    m_resolveShader = std::make_unique<Shader>("shaders/raymarch_vertex.glsl", "shaders/temporal_resolve_fragment.glsl");
+    if (!m_resolveShader->isValid()) {
+        LOG_ERROR(RENDER) << "Temporal resolve shader failed to load, reduced-resolution raymarching disabled.";
+        m_resolveShader = nullptr;
+        return false;
+    }
+    auto setupSamplers = [](Shader& shader) {
+        shader.use();
+        shader.setInt("u_currentColor", 0);
+        shader.setInt("u_currentDistance", 1);
+        shader.setInt("u_history", 2);
+        glUseProgram(0);
+    };
+    setupSamplers(*m_resolveShader);
+    m_resolveShader->setReloadCallback(setupSamplers);
+    return true;
+}
+
+void TemporalUpscaler::Resize(int nativeWidth, int nativeHeight, int scaleDivisor) {
+    if (scaleDivisor < 1) scaleDivisor = 1;
+    if (nativeWidth == m_nativeWidth && nativeHeight == m_nativeHeight && scaleDivisor == m_scaleDivisor && m_lowRes.IsValid()) return;
+
+    m_nativeWidth = nativeWidth;
+    m_nativeHeight = nativeHeight;
+    m_scaleDivisor = scaleDivisor;
+
+    int lowWidth = (nativeWidth + scaleDivisor - 1) / scaleDivisor;
+    int lowHeight = (nativeHeight + scaleDivisor - 1) / scaleDivisor;
+    m_lowRes.Create(lowWidth, lowHeight, {
+        { GL_RGBA16F, GL_RGBA, GL_FLOAT, GL_LINEAR },
+        { GL_R32F,    GL_RED,  GL_FLOAT, GL_NEAREST }
+    });
+    for (RenderTarget& history : m_history) {
+        history.Create(nativeWidth, nativeHeight, { { GL_RGBA16F, GL_RGBA, GL_FLOAT, GL_LINEAR } });
+    }
+    m_historyValid = false;
+    LOG_INFO(RENDER) << "Temporal upscaler: raymarching at " << lowWidth << "x" << lowHeight
+                     << " for " << nativeWidth << "x" << nativeHeight << " output";
+}
+
+void TemporalUpscaler::SetTemporalEnabled(bool enabled) {
+    if (enabled != m_temporalEnabled) m_historyValid = false;
+    m_temporalEnabled = enabled;
+}
+
+float TemporalUpscaler::halton(unsigned int index, unsigned int base) {
+    float f = 1.0f, result = 0.0f;
+    while (index > 0) {
+        f /= static_cast<float>(base);
+        result += f * static_cast<float>(index % base);
+        index /= base;
+    }
+    return result;
+}
+
+glm::vec2 TemporalUpscaler::BeginRaymarch() {
+    m_lowRes.Bind();
+    glDisable(GL_DEPTH_TEST);
+
+    if (m_temporalEnabled) {
+        // Halton(2,3) offset in [-0.5, 0.5) low-res pixels, converted to UV units
+        unsigned int i = (m_frameIndex % JITTER_SEQUENCE_LENGTH) + 1;
+        glm::vec2 offset(halton(i, 2) - 0.5f, halton(i, 3) - 0.5f);
+        m_jitter = glm::vec2(offset.x / static_cast<float>(m_lowRes.GetWidth()),
+                             offset.y / static_cast<float>(m_lowRes.GetHeight()));
+    } else {
+        m_jitter = glm::vec2(0.0f);
+    }
+    return m_jitter;
+}
+
+void TemporalUpscaler::Resolve(unsigned int quadVAO, const glm::mat4& invView, const glm::mat4& invProj,
+                               const glm::vec3& camPos, const glm::mat4& prevViewProj) {
+    const RenderTarget& previous = m_history[m_historyIndex];
+    const RenderTarget& target = m_history[m_historyIndex ^ 1];
+    target.Bind();
+
+    m_resolveShader->use();
+    m_resolveShader->setMat4("u_invViewMatrix", invView);
+    m_resolveShader->setMat4("u_invProjMatrix", invProj);
+    m_resolveShader->setMat4("u_prevViewProj", prevViewProj);
+    m_resolveShader->setVec3("u_camPos", camPos);
+    m_resolveShader->setVec2("u_jitter", m_jitter);
+    m_resolveShader->setVec2("u_lowResSize", glm::vec2(m_lowRes.GetWidth(), m_lowRes.GetHeight()));
+    m_resolveShader->setVec2("u_nativeSize", glm::vec2(m_nativeWidth, m_nativeHeight));
+    m_resolveShader->setBool("u_historyValid", m_temporalEnabled && m_historyValid);
+    m_resolveShader->setFloat("u_feedback", TEMPORAL_FEEDBACK);
+
+    glActiveTexture(GL_TEXTURE0); glBindTexture(GL_TEXTURE_2D, m_lowRes.GetColorTexture(0));
+    glActiveTexture(GL_TEXTURE1); glBindTexture(GL_TEXTURE_2D, m_lowRes.GetColorTexture(1));
+    glActiveTexture(GL_TEXTURE2); glBindTexture(GL_TEXTURE_2D, previous.GetColorTexture(0));
+
+    glBindVertexArray(quadVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    glBindVertexArray(0);
+
+    glActiveTexture(GL_TEXTURE2); glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE1); glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0); glBindTexture(GL_TEXTURE_2D, 0);
+    glUseProgram(0);
+
+    // Present the accumulated result
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, target.GetFBO());
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, m_nativeWidth, m_nativeHeight, 0, 0, m_nativeWidth, m_nativeHeight, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    RenderTarget::BindDefault(m_nativeWidth, m_nativeHeight);
+    glEnable(GL_DEPTH_TEST);
+
+    m_historyIndex ^= 1;
+    m_historyValid = true;
+    m_frameIndex++;
+}
@@ -0,0 +1,174 @@
+#include "TerrainCache.h"
+#include "Log.h"
+#include "MemoryStats.h"
+#include "RaymarchParams.h"
+#include <cmath>
+
+// World size of the baked square. Covers MAX_TRACE_DISTANCE (100) in every direction with some margin.
+static const float TERRAIN_CACHE_EXTENT = 256.0f;
+// Texels per side; 8 texels per world unit resolves the highest default octave (0.2 * 2^4 = 3.2 cycles/unit)
+static const int TERRAIN_CACHE_RESOLUTION = 2048;
+// Rebake once the camera is this far (in world units, per axis) from the region centre
+static const float TERRAIN_CACHE_RECENTER_DISTANCE = TERRAIN_CACHE_EXTENT * 0.25f;
+// Region centres are snapped to this grid so small camera moves never shift the baked texels
+static const float TERRAIN_CACHE_SNAP = TERRAIN_CACHE_EXTENT / 16.0f;
+
+TerrainCache::TerrainCache() = default;
+
+TerrainCache::~TerrainCache() {
+    destroyMaxMips();
+}
+
+bool TerrainCache::Initialize() {
+    m_bakeShader = std::make_unique<Shader>("shaders/raymarch_vertex.glsl", "shaders/terrain_bake_fragment.glsl");
+    if (!m_bakeShader->isValid()) {
+        LOG_ERROR(RENDER) << "Terrain bake shader failed to load, terrain cache disabled.";
+        m_bakeShader = nullptr;
+        return false;
+    }
+    m_bakeShader->bindUniformBlock(RAYMARCH_PARAMS_BLOCK_NAME, RAYMARCH_PARAMS_BINDING);
+    // An edited terrain function needs a re-bake (which rebuilds the pyramid as well)
+    m_bakeShader->setReloadCallback([this](Shader& shader) {
+        shader.bindUniformBlock(RAYMARCH_PARAMS_BLOCK_NAME, RAYMARCH_PARAMS_BINDING);
+        Invalidate();
+    });
+    if (!m_target.Create(TERRAIN_CACHE_RESOLUTION, TERRAIN_CACHE_RESOLUTION, { { GL_RGBA32F, GL_RGBA, GL_FLOAT, GL_LINEAR } })) {
+        LOG_ERROR(RENDER) << "Failed to allocate terrain cache texture, terrain cache disabled.";
+        m_bakeShader = nullptr;
+        return false;
+    }
+    LOG_INFO(RENDER) << "Terrain cache created (" << TERRAIN_CACHE_RESOLUTION << "x" << TERRAIN_CACHE_RESOLUTION
+                     << " texels over " << TERRAIN_CACHE_EXTENT << " units)";
+
+    // The pyramid is optional: without it the raymarcher keeps sphere tracing the cache
+    if (!createMaxMips()) {
+        LOG_WARN(RENDER) << "Terrain max-height pyramid unavailable, hierarchical traversal disabled.";
+    }
+    return true;
+}
+
+bool TerrainCache::createMaxMips() {
+    m_maxMipShader = std::make_unique<Shader>("shaders/raymarch_vertex.glsl", "shaders/terrain_maxmip_fragment.glsl");
+    if (!m_maxMipShader->isValid()) {
+        m_maxMipShader = nullptr;
+        return false;
+    }
+
+    int levels = 0;
+    for (int size = TERRAIN_CACHE_RESOLUTION; size > 0; size >>= 1) levels++;
+
+    glGenTextures(1, &m_maxMipTexture);
+    glBindTexture(GL_TEXTURE_2D, m_maxMipTexture);
+    for (int level = 0; level < levels; ++level) {
+        int size = TERRAIN_CACHE_RESOLUTION >> level;
+        glTexImage2D(GL_TEXTURE_2D, level, GL_R32F, size, size, 0, GL_RED, GL_FLOAT, nullptr);
+    }
+    // Only read with texelFetch, but the chain must be mipmap-complete
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+
+    glGenFramebuffers(1, &m_maxMipFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_maxMipFBO);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_maxMipTexture, 0);
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        LOG_ERROR(RENDER) << "ERROR::TERRAIN_CACHE: Max-height framebuffer incomplete (status 0x" << std::hex << status << std::dec << ")";
+        destroyMaxMips();
+        return false;
+    }
+    m_maxMipLevels = levels;
+    // R32F; the chain below level 0 adds a third
+    MemoryStats::TrackTexture(m_maxMipTexture, MemoryCategory::ENVIRONMENT,
+                              static_cast<size_t>(TERRAIN_CACHE_RESOLUTION) * TERRAIN_CACHE_RESOLUTION * sizeof(float) * 4 / 3);
+    return true;
+}
+
+void TerrainCache::destroyMaxMips() {
+    if (m_maxMipFBO != 0) { glDeleteFramebuffers(1, &m_maxMipFBO); m_maxMipFBO = 0; }
+    if (m_maxMipTexture != 0) { MemoryStats::UntrackTexture(m_maxMipTexture); glDeleteTextures(1, &m_maxMipTexture); m_maxMipTexture = 0; }
+    m_maxMipShader = nullptr;
+    m_maxMipLevels = 0;
+}
+
+float TerrainCache::GetExtent() const { return TERRAIN_CACHE_EXTENT; }
+
+int TerrainCache::GetResolution() const { return TERRAIN_CACHE_RESOLUTION; }
+
+bool TerrainCache::Update(const TerrainParams& params, const glm::vec3& cameraPos, unsigned int quadVAO) {
+    if (!IsValid()) return false;
+
+    glm::vec2 cam(cameraPos.x, cameraPos.z);
+    bool leftRegion = std::fabs(cam.x - m_center.x) > TERRAIN_CACHE_RECENTER_DISTANCE ||
+                      std::fabs(cam.y - m_center.y) > TERRAIN_CACHE_RECENTER_DISTANCE;
+    if (m_valid && !leftRegion && params == m_bakedParams) return false;
+
+    m_center = glm::vec2(std::round(cam.x / TERRAIN_CACHE_SNAP) * TERRAIN_CACHE_SNAP,
+                         std::round(cam.y / TERRAIN_CACHE_SNAP) * TERRAIN_CACHE_SNAP);
+    m_origin = m_center - glm::vec2(TERRAIN_CACHE_EXTENT * 0.5f);
+    bake(params, quadVAO);
+    return true;
+}
+
+void TerrainCache::bake(const TerrainParams& params, unsigned int quadVAO) {
+    m_target.Bind();
+    glDisable(GL_DEPTH_TEST);
+
+    m_bakeShader->use();
+    m_bakeShader->setVec2("u_cacheOrigin", m_origin);
+    m_bakeShader->setFloat("u_cacheExtent", TERRAIN_CACHE_EXTENT);
+    // u_terrain_* come from the RaymarchParams block, already holding `params`
+
+    glBindVertexArray(quadVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    glBindVertexArray(0);
+    glUseProgram(0);
+
+    if (m_maxMipLevels > 0) buildMaxMips(quadVAO);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glEnable(GL_DEPTH_TEST);
+
+    m_bakedParams = params;
+    m_valid = true;
+    m_bakeCount++;
+}
+
+// One reduction pass per level. While level n is rendered the texture's base/max level are clamped to
+// n - 1, so the pass never samples the level it writes (no feedback loop).
+void TerrainCache::buildMaxMips(unsigned int quadVAO) {
+    glBindFramebuffer(GL_FRAMEBUFFER, m_maxMipFBO);
+    m_maxMipShader->use();
+    m_maxMipShader->setInt("u_source", 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindVertexArray(quadVAO);
+
+    for (int level = 0; level < m_maxMipLevels; ++level) {
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_maxMipTexture, level);
+        int size = TERRAIN_CACHE_RESOLUTION >> level;
+        glViewport(0, 0, size, size);
+        if (level == 0) {
+            glBindTexture(GL_TEXTURE_2D, GetTexture());
+            m_maxMipShader->setBool("u_fromHeights", true);
+        } else {
+            glBindTexture(GL_TEXTURE_2D, m_maxMipTexture);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level - 1);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, level - 1);
+            m_maxMipShader->setBool("u_fromHeights", false);
+        }
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, m_maxMipTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, m_maxMipLevels - 1);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_maxMipTexture, 0);
+    glBindVertexArray(0);
+    glUseProgram(0);
+}
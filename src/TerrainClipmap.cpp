@@ -0,0 +1,143 @@
+#include "TerrainClipmap.h"
+#include "Log.h"
+#include "MemoryStats.h"
+#include "RaymarchParams.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Spacing range offered by the panel (level 0 vertex distance in world units)
+static const float CLIPMAP_MIN_SPACING = 0.03125f;
+static const float CLIPMAP_MAX_SPACING = 2.0f;
+
+// Two triangles per quad with a fixed diagonal (the vertex shader's edge averaging assumes nothing more)
+static void appendQuad(std::vector<uint32_t>& indices, int x, int z) {
+    const uint32_t row = TerrainClipmap::GRID_QUADS + 1;
+    uint32_t i00 = static_cast<uint32_t>(z) * row + static_cast<uint32_t>(x);
+    uint32_t i10 = i00 + 1, i01 = i00 + row, i11 = i01 + 1;
+    indices.insert(indices.end(), { i00, i01, i10, i10, i01, i11 });
+}
+
+TerrainClipmap::TerrainClipmap() = default;
+
+TerrainClipmap::~TerrainClipmap() {
+    if (m_ebo != 0) { MemoryStats::UntrackBuffer(m_ebo); glDeleteBuffers(1, &m_ebo); }
+    if (m_vbo != 0) { MemoryStats::UntrackBuffer(m_vbo); glDeleteBuffers(1, &m_vbo); }
+    if (m_vao != 0) glDeleteVertexArrays(1, &m_vao);
+}
+
+bool TerrainClipmap::Initialize(const TerrainClipmapTextureUnits& units) {
+    m_units = units;
+    m_shader = std::make_unique<Shader>("shaders/terrain_clipmap_vertex.glsl", "shaders/terrain_clipmap_fragment.glsl");
+    if (!m_shader->isValid()) {
+        LOG_ERROR(RENDER) << "Terrain clipmap shader failed to load, clipmap terrain disabled.";
+        m_shader = nullptr;
+        return false;
+    }
+    setSamplerUnits();
+    m_shader->setReloadCallback([this](Shader&) { setSamplerUnits(); });
+
+    std::vector<glm::vec2> vertices;
+    vertices.reserve(static_cast<size_t>(GRID_QUADS + 1) * (GRID_QUADS + 1));
+    for (int z = 0; z <= GRID_QUADS; ++z) {
+        for (int x = 0; x <= GRID_QUADS; ++x) vertices.emplace_back(static_cast<float>(x), static_cast<float>(z));
+    }
+
+    // Full grid first, then the four rings: the hole covers quads [GRID_QUADS / 4 + d, 3 * GRID_QUADS / 4 + d)
+    std::vector<uint32_t> indices;
+    for (int z = 0; z < GRID_QUADS; ++z) {
+        for (int x = 0; x < GRID_QUADS; ++x) appendQuad(indices, x, z);
+    }
+    m_fullGrid.count = static_cast<GLsizei>(indices.size());
+    for (int variant = 0; variant < 4; ++variant) {
+        int holeX = GRID_QUADS / 4 + (variant & 1), holeZ = GRID_QUADS / 4 + (variant >> 1);
+        m_rings[variant].offset = indices.size() * sizeof(uint32_t);
+        for (int z = 0; z < GRID_QUADS; ++z) {
+            for (int x = 0; x < GRID_QUADS; ++x) {
+                bool inHole = x >= holeX && x < holeX + GRID_QUADS / 2 && z >= holeZ && z < holeZ + GRID_QUADS / 2;
+                if (!inHole) appendQuad(indices, x, z);
+            }
+        }
+        m_rings[variant].count = static_cast<GLsizei>(indices.size() - m_rings[variant].offset / sizeof(uint32_t));
+    }
+
+    glGenVertexArrays(1, &m_vao);
+    glGenBuffers(1, &m_vbo);
+    glGenBuffers(1, &m_ebo);
+    glBindVertexArray(m_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(glm::vec2), vertices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)0);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    MemoryStats::TrackBuffer(m_vbo, MemoryCategory::ENVIRONMENT, vertices.size() * sizeof(glm::vec2));
+    MemoryStats::TrackBuffer(m_ebo, MemoryCategory::ENVIRONMENT, indices.size() * sizeof(uint32_t));
+
+    LOG_INFO(RENDER) << "Terrain clipmap created (" << GRID_QUADS << "x" << GRID_QUADS << " quads per level, "
+                     << indices.size() / 3 << " triangles over the index variants)";
+    return true;
+}
+
+void TerrainClipmap::setSamplerUnits() {
+    m_shader->use();
+    m_shader->bindUniformBlock(RAYMARCH_PARAMS_BLOCK_NAME, RAYMARCH_PARAMS_BINDING);
+    m_shader->setInt("u_cloudNoise", m_units.cloudNoise);
+    m_shader->setInt("u_cloudBuffer", m_units.cloudBuffer);
+    m_shader->setInt("u_cloudDistance", m_units.cloudDistance);
+    m_shader->setFloat("u_gridQuads", static_cast<float>(GRID_QUADS));
+    glUseProgram(0);
+}
+
+void TerrainClipmap::SetLevels(int levels) {
+    m_levels = std::clamp(levels, 1, MAX_LEVELS);
+}
+
+void TerrainClipmap::SetBaseSpacing(float spacing) {
+    m_baseSpacing = std::clamp(spacing, CLIPMAP_MIN_SPACING, CLIPMAP_MAX_SPACING);
+}
+
+void TerrainClipmap::Render(const glm::mat4& viewProj, const glm::vec3& camPos, float time, const glm::vec2& screenSize,
+                            int shadowSteps, bool cloudsEnabled) {
+    m_stats = TerrainClipmapStats();
+    if (!IsValid()) return;
+
+    m_shader->use();
+    m_shader->setMat4("u_viewProj", viewProj);
+    m_shader->setVec3("u_camPos", camPos);
+    m_shader->setVec2("u_screenSize", screenSize);
+    m_shader->setFloat("u_time", time);
+    m_shader->setInt("u_shadowSteps", shadowSteps);
+    m_shader->setBool("u_cloudsEnabled", cloudsEnabled);
+    glBindVertexArray(m_vao);
+
+    const glm::vec2 cam(camPos.x, camPos.z);
+    const float halfGrid = static_cast<float>(GRID_QUADS / 2);
+    for (int level = 0; level < m_levels; ++level) {
+        float spacing = m_baseSpacing * static_cast<float>(1 << level);
+        // Snapped to twice the spacing, so the next coarser level (snapped to its own double) shares every even vertex
+        glm::vec2 snapped = glm::floor(cam / (2.0f * spacing)) * (2.0f * spacing);
+        glm::vec2 origin = snapped - glm::vec2(halfGrid * spacing);
+
+        const IndexRange* range = &m_fullGrid;
+        if (level > 0) {
+            // Where the finer level (snapped to this spacing) starts within this grid: GRID_QUADS / 4 + {0, 1}
+            glm::vec2 fineSnapped = glm::floor(cam / spacing) * spacing;
+            int offsetX = std::clamp(static_cast<int>(std::lround((fineSnapped.x - snapped.x) / spacing)), 0, 1);
+            int offsetZ = std::clamp(static_cast<int>(std::lround((fineSnapped.y - snapped.y) / spacing)), 0, 1);
+            range = &m_rings[offsetX + 2 * offsetZ];
+        }
+
+        m_shader->setVec2("u_levelOrigin", origin);
+        m_shader->setFloat("u_levelSpacing", spacing);
+        m_shader->setBool("u_stitchEdges", level + 1 < m_levels);
+        glDrawElements(GL_TRIANGLES, range->count, GL_UNSIGNED_INT, (void*)range->offset);
+
+        m_stats.levelsDrawn++;
+        m_stats.triangles += static_cast<size_t>(range->count) / 3;
+        m_stats.extent = static_cast<float>(GRID_QUADS) * spacing;
+    }
+    glBindVertexArray(0);
+}
@@ -0,0 +1,150 @@
+#include "TerrainCollider.h"
+#include <BulletCollision/CollisionShapes/btHeightfieldTerrainShape.h>
+#include <LinearMath/btThreads.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+// Seconds of motion the request box is swept over, so fast bodies find their tile already built
+static const float TERRAIN_TILE_LOOKAHEAD = 0.5f;
+// Extra distance around every request box (covers contact margins and bodies settling onto an edge)
+static const float TERRAIN_TILE_PADDING = 1.0f;
+// Ticks a tile survives without a request (2 s at 60 Hz)
+static const uint64_t TERRAIN_TILE_IDLE_TICKS = 120;
+// Same surface response as the flat ground plane
+static const float TERRAIN_RESTITUTION = 0.3f;
+static const float TERRAIN_FRICTION = 0.5f;
+
+TerrainCollider::TerrainCollider(btDiscreteDynamicsWorld* world) : m_world(world) {}
+
+TerrainCollider::~TerrainCollider() {
+    Clear();
+}
+
+uint64_t TerrainCollider::tileKey(int tileX, int tileZ) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(tileX)) << 32) | static_cast<uint32_t>(tileZ);
+}
+
+void TerrainCollider::SetParams(const TerrainParams& params) {
+    if (params == m_params) return;
+    m_params = params;
+    Clear();
+    // Resting bodies have to fall (or be pushed) onto the new surface
+    for (int i = 0; i < m_world->getNumCollisionObjects(); ++i) {
+        btRigidBody* body = btRigidBody::upcast(m_world->getCollisionObjectArray()[i]);
+        if (body && body->getInvMass() != 0.0f) body->activate(true);
+    }
+}
+
+void TerrainCollider::Clear() {
+    for (auto& entry : m_tiles) removeTile(*entry.second);
+    m_stats.tilesEvicted += m_tiles.size();
+    m_tiles.clear();
+    m_stats.tilesLoaded = 0;
+}
+
+void TerrainCollider::removeTile(Tile& tile) {
+    m_world->removeRigidBody(tile.body.get());
+}
+
+void TerrainCollider::sampleTile(Tile& tile) const {
+    float originX = static_cast<float>(tile.tileX) * GetTileSize(), originZ = static_cast<float>(tile.tileZ) * GetTileSize();
+    tile.heights.resize(static_cast<size_t>(TILE_SAMPLES) * TILE_SAMPLES);
+    TerrainNoise::HeightGrid(m_params, originX, originZ, TILE_SPACING, TILE_SAMPLES, TILE_SAMPLES, tile.heights.data());
+}
+
+void TerrainCollider::addTile(Tile& tile) {
+    auto range = std::minmax_element(tile.heights.begin(), tile.heights.end());
+    float minHeight = *range.first, maxHeight = *range.second;
+    tile.shape = std::make_unique<btHeightfieldTerrainShape>(TILE_SAMPLES, TILE_SAMPLES, tile.heights.data(),
+                                                             minHeight, maxHeight, 1, false);
+    tile.shape->setLocalScaling(btVector3(TILE_SPACING, 1.0f, TILE_SPACING));
+
+    // Bullet centres the heightfield on its bounds: the body sits in the middle of the tile at mid height
+    float originX = static_cast<float>(tile.tileX) * GetTileSize(), originZ = static_cast<float>(tile.tileZ) * GetTileSize();
+    btVector3 center(originX + GetTileSize() * 0.5f, (minHeight + maxHeight) * 0.5f, originZ + GetTileSize() * 0.5f);
+    btRigidBody::btRigidBodyConstructionInfo info(0.0f, nullptr, tile.shape.get());
+    info.m_startWorldTransform = btTransform(btQuaternion(0, 0, 0, 1), center);
+    info.m_restitution = TERRAIN_RESTITUTION;
+    info.m_friction = TERRAIN_FRICTION;
+    tile.body = std::make_unique<btRigidBody>(info);
+    m_world->addRigidBody(tile.body.get());
+    m_stats.tilesBuilt++;
+}
+
+void TerrainCollider::requestTiles(const btVector3& aabbMin, const btVector3& aabbMax) {
+    float tileSize = GetTileSize();
+    int minX = static_cast<int>(std::floor((aabbMin.x() - TERRAIN_TILE_PADDING) / tileSize));
+    int maxX = static_cast<int>(std::floor((aabbMax.x() + TERRAIN_TILE_PADDING) / tileSize));
+    int minZ = static_cast<int>(std::floor((aabbMin.z() - TERRAIN_TILE_PADDING) / tileSize));
+    int maxZ = static_cast<int>(std::floor((aabbMax.z() + TERRAIN_TILE_PADDING) / tileSize));
+    for (int z = minZ; z <= maxZ; ++z) {
+        for (int x = minX; x <= maxX; ++x) {
+            std::unique_ptr<Tile>& tile = m_tiles[tileKey(x, z)];
+            if (!tile) {
+                tile = std::make_unique<Tile>();
+                tile->tileX = x;
+                tile->tileZ = z;
+                m_pendingTiles.push_back(tile.get());
+            }
+            tile->lastUsedTick = m_tick;
+        }
+    }
+}
+
+// Sampling is the expensive part and independent per tile: it is spread over Bullet's task scheduler
+// (the physics worker pool when multithreaded). Shapes and bodies are created afterwards on this thread.
+void TerrainCollider::buildPendingTiles() {
+    struct SampleTiles : public btIParallelForBody {
+        const TerrainCollider* collider;
+        Tile* const* tiles;
+        void forLoop(int begin, int end) const override {
+            for (int i = begin; i < end; ++i) collider->sampleTile(*tiles[i]);
+        }
+    } body;
+    body.collider = this;
+    body.tiles = m_pendingTiles.data();
+    btParallelFor(0, static_cast<int>(m_pendingTiles.size()), 1, body);
+    for (Tile* tile : m_pendingTiles) addTile(*tile);
+    m_pendingTiles.clear();
+}
+
+void TerrainCollider::Update(float timeStep) {
+    auto start = std::chrono::steady_clock::now();
+    m_tick++;
+
+    // Collect the bodies first: adding tiles appends to the collision object array being walked
+    std::vector<btRigidBody*> bodies;
+    for (int i = 0; i < m_world->getNumCollisionObjects(); ++i) {
+        btRigidBody* body = btRigidBody::upcast(m_world->getCollisionObjectArray()[i]);
+        if (body && body->getInvMass() != 0.0f) bodies.push_back(body);
+    }
+    float lookahead = std::max(timeStep, TERRAIN_TILE_LOOKAHEAD);
+    for (btRigidBody* body : bodies) {
+        btVector3 aabbMin, aabbMax;
+        body->getAabb(aabbMin, aabbMax);
+        // Well above the highest terrain point nothing can touch it yet
+        if (aabbMin.y() > TerrainNoise::MaxHeight(m_params) + body->getLinearVelocity().length() * lookahead) {
+            continue;
+        }
+        if (body->isActive()) {
+            btVector3 sweep = body->getLinearVelocity() * lookahead;
+            aabbMin.setMin(aabbMin + sweep);
+            aabbMax.setMax(aabbMax + sweep);
+        }
+        requestTiles(aabbMin, aabbMax);
+    }
+    if (!m_pendingTiles.empty()) buildPendingTiles();
+
+    for (auto it = m_tiles.begin(); it != m_tiles.end();) {
+        if (m_tick - it->second->lastUsedTick > TERRAIN_TILE_IDLE_TICKS) {
+            removeTile(*it->second);
+            it = m_tiles.erase(it);
+            m_stats.tilesEvicted++;
+        } else {
+            ++it;
+        }
+    }
+    m_stats.tilesLoaded = m_tiles.size();
+    m_stats.lastUpdateMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,283 @@
+#include "TerrainNoise.h"
+#include "TerrainNoiseKernel.h"
+#include <atomic>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TERRAIN_NOISE_SSE2 1
+#include <emmintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define TERRAIN_NOISE_NEON 1
+#include <arm_neon.h>
+#endif
+
+// Points per kernel call (stack buffers), a multiple of every kernel width
+static const size_t TERRAIN_NOISE_CHUNK = 256;
+
+// GLSL mix(): x * (1 - a) + y * a
+static float mix(float x, float y, float a) { return x * (1.0f - a) + y * a; }
+
+float TerrainNoise::Hash(int32_t x, int32_t z) {
+    uint32_t h = (static_cast<uint32_t>(x) * 0x8da6b343u) ^ (static_cast<uint32_t>(z) * 0xd8163841u);
+    h ^= h >> 16; h *= 0x7feb352du; h ^= h >> 15; h *= 0x846ca68bu; h ^= h >> 16;
+    return static_cast<float>(h >> 8) * (1.0f / 16777216.0f);
+}
+
+float TerrainNoise::ValueNoise(float x, float z) {
+    float ix = std::floor(x), iz = std::floor(z);
+    float fx = x - ix, fz = z - iz;
+    float ux = fx * fx * (3.0f - 2.0f * fx), uz = fz * fz * (3.0f - 2.0f * fz);
+    int32_t cx = static_cast<int32_t>(ix), cz = static_cast<int32_t>(iz);
+    return mix(mix(Hash(cx, cz), Hash(cx + 1, cz), ux), mix(Hash(cx, cz + 1), Hash(cx + 1, cz + 1), ux), uz);
+}
+
+float TerrainNoise::Height(const TerrainParams& params, float x, float z) {
+    float freq = params.baseFreq, amp = params.baseAmp;
+    float value = 0.0f, maxAmp = 0.0f;
+    for (int i = 0; i < params.octaves; i++) {
+        if (amp < 0.01f) break;
+        value += ValueNoise(x * freq, z * freq) * amp;
+        maxAmp += amp;
+        freq *= 2.0f;
+        amp *= params.persistence;
+    }
+    float normalized = maxAmp > 0.0f ? value / maxAmp : 0.0f;
+    return std::pow(normalized, params.flattenPower) * params.finalScale;
+}
+
+// --- Kernel lanes (see TerrainNoiseKernel.h) ---
+namespace {
+
+struct TerrainLanesScalar {
+    static const size_t WIDTH = 1;
+    using F = float;
+    using I = uint32_t;
+    static F Load(const float* p) { return *p; }
+    static void Store(float* p, F v) { *p = v; }
+    static F Set(float v) { return v; }
+    static I SetI(uint32_t v) { return v; }
+    static F Add(F a, F b) { return a + b; }
+    static F Sub(F a, F b) { return a - b; }
+    static F Mul(F a, F b) { return a * b; }
+    static F Floor(F v) { return std::floor(v); }
+    static I ToInt(F v) { return static_cast<uint32_t>(static_cast<int32_t>(v)); }
+    static F ToFloat(I v) { return static_cast<float>(static_cast<int32_t>(v)); }
+    static I AddI(I a, I b) { return a + b; }
+    static I MulLo(I a, I b) { return a * b; }
+    static I Xor(I a, I b) { return a ^ b; }
+    static I ShiftRight(I v, int bits) { return v >> bits; }
+};
+
+#if defined(TERRAIN_NOISE_SSE2)
+struct TerrainLanesSse2 {
+    static const size_t WIDTH = 4;
+    using F = __m128;
+    using I = __m128i;
+    static F Load(const float* p) { return _mm_loadu_ps(p); }
+    static void Store(float* p, F v) { _mm_storeu_ps(p, v); }
+    static F Set(float v) { return _mm_set1_ps(v); }
+    static I SetI(uint32_t v) { return _mm_set1_epi32(static_cast<int>(v)); }
+    static F Add(F a, F b) { return _mm_add_ps(a, b); }
+    static F Sub(F a, F b) { return _mm_sub_ps(a, b); }
+    static F Mul(F a, F b) { return _mm_mul_ps(a, b); }
+    // No roundps before SSE4.1: truncate, then step down where that rounded up (exact below 2^31)
+    static F Floor(F v) {
+        F truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(v));
+        return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, v), _mm_set1_ps(1.0f)));
+    }
+    static I ToInt(F v) { return _mm_cvttps_epi32(v); }
+    static F ToFloat(I v) { return _mm_cvtepi32_ps(v); }
+    static I AddI(I a, I b) { return _mm_add_epi32(a, b); }
+    // No pmulld before SSE4.1: two 32x32->64 multiplies on the even and odd lanes, low halves recombined
+    static I MulLo(I a, I b) {
+        I even = _mm_mul_epu32(a, b);
+        I odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+        return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+    }
+    static I Xor(I a, I b) { return _mm_xor_si128(a, b); }
+    static I ShiftRight(I v, int bits) { return _mm_srl_epi32(v, _mm_cvtsi32_si128(bits)); }
+};
+#endif
+
+#if defined(TERRAIN_NOISE_NEON)
+struct TerrainLanesNeon {
+    static const size_t WIDTH = 4;
+    using F = float32x4_t;
+    using I = uint32x4_t;
+    static F Load(const float* p) { return vld1q_f32(p); }
+    static void Store(float* p, F v) { vst1q_f32(p, v); }
+    static F Set(float v) { return vdupq_n_f32(v); }
+    static I SetI(uint32_t v) { return vdupq_n_u32(v); }
+    static F Add(F a, F b) { return vaddq_f32(a, b); }
+    static F Sub(F a, F b) { return vsubq_f32(a, b); }
+    static F Mul(F a, F b) { return vmulq_f32(a, b); } // Separate multiply and add: no fused rounding
+    static F Floor(F v) { return vrndmq_f32(v); }
+    static I ToInt(F v) { return vreinterpretq_u32_s32(vcvtq_s32_f32(v)); }
+    static F ToFloat(I v) { return vcvtq_f32_s32(vreinterpretq_s32_u32(v)); }
+    static I AddI(I a, I b) { return vaddq_u32(a, b); }
+    static I MulLo(I a, I b) { return vmulq_u32(a, b); }
+    static I Xor(I a, I b) { return veorq_u32(a, b); }
+    static I ShiftRight(I v, int bits) { return vshlq_u32(v, vdupq_n_s32(-bits)); }
+};
+#endif
+
+} // namespace
+// --- End Kernel Lanes ---
+
+static bool cpuHasAvx2() {
+#if defined(TERRAIN_NOISE_SSE2)
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0, avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false; // The OS must save the ymm registers
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+#else
+    return false;
+#endif
+}
+
+bool TerrainNoise::IsKernelSupported(TerrainNoiseKernel kernel) {
+    switch (kernel) {
+        case TerrainNoiseKernel::AUTO:
+        case TerrainNoiseKernel::SCALAR: return true;
+#if defined(TERRAIN_NOISE_SSE2)
+        case TerrainNoiseKernel::SSE2:   return true;
+#endif
+        case TerrainNoiseKernel::AVX2: {
+            static const bool supported = terrainFbmAvx2(nullptr, nullptr, 0, 0.0f, 0.0f, 0.0f, 0, nullptr) && cpuHasAvx2();
+            return supported;
+        }
+#if defined(TERRAIN_NOISE_NEON)
+        case TerrainNoiseKernel::NEON:   return true;
+#endif
+        default: return false;
+    }
+}
+
+static TerrainNoiseKernel pickKernel() {
+    const TerrainNoiseKernel preference[] = { TerrainNoiseKernel::AVX2, TerrainNoiseKernel::SSE2, TerrainNoiseKernel::NEON };
+    for (TerrainNoiseKernel kernel : preference) {
+        if (TerrainNoise::IsKernelSupported(kernel)) return kernel;
+    }
+    return TerrainNoiseKernel::SCALAR;
+}
+
+static std::atomic<TerrainNoiseKernel> s_kernel{TerrainNoiseKernel::AUTO};
+
+void TerrainNoise::SetKernel(TerrainNoiseKernel kernel) {
+    s_kernel.store(kernel == TerrainNoiseKernel::AUTO || !IsKernelSupported(kernel) ? pickKernel() : kernel, std::memory_order_relaxed);
+}
+
+TerrainNoiseKernel TerrainNoise::GetKernel() {
+    TerrainNoiseKernel kernel = s_kernel.load(std::memory_order_relaxed);
+    if (kernel == TerrainNoiseKernel::AUTO) {
+        kernel = pickKernel();
+        s_kernel.store(kernel, std::memory_order_relaxed);
+    }
+    return kernel;
+}
+
+const char* TerrainNoise::GetKernelName(TerrainNoiseKernel kernel) {
+    switch (kernel) {
+        case TerrainNoiseKernel::AUTO:   return "auto";
+        case TerrainNoiseKernel::SCALAR: return "scalar";
+        case TerrainNoiseKernel::SSE2:   return "SSE2";
+        case TerrainNoiseKernel::AVX2:   return "AVX2";
+        case TerrainNoiseKernel::NEON:   return "NEON";
+    }
+    return "?";
+}
+
+// Heights of up to TERRAIN_NOISE_CHUNK points: the kernel sums the octaves, normalisation and pow() stay
+// scalar so every kernel ends in the same float ops as Height()
+static void heightChunk(const TerrainParams& params, TerrainNoiseKernel kernel, const float* xs, const float* zs, size_t count, float* heights) {
+    alignas(32) float x[TERRAIN_NOISE_CHUNK], z[TERRAIN_NOISE_CHUNK], raw[TERRAIN_NOISE_CHUNK];
+    size_t padded = (count + 7) & ~static_cast<size_t>(7);
+    for (size_t i = 0; i < padded; i++) {
+        x[i] = i < count ? xs[i] : 0.0f;
+        z[i] = i < count ? zs[i] : 0.0f;
+    }
+
+    switch (kernel) {
+        case TerrainNoiseKernel::AVX2:
+            terrainFbmAvx2(x, z, padded, params.baseFreq, params.baseAmp, params.persistence, params.octaves, raw);
+            break;
+#if defined(TERRAIN_NOISE_SSE2)
+        case TerrainNoiseKernel::SSE2:
+            terrainFbmKernel<TerrainLanesSse2>(x, z, padded, params.baseFreq, params.baseAmp, params.persistence, params.octaves, raw);
+            break;
+#endif
+#if defined(TERRAIN_NOISE_NEON)
+        case TerrainNoiseKernel::NEON:
+            terrainFbmKernel<TerrainLanesNeon>(x, z, padded, params.baseFreq, params.baseAmp, params.persistence, params.octaves, raw);
+            break;
+#endif
+        default:
+            terrainFbmKernel<TerrainLanesScalar>(x, z, padded, params.baseFreq, params.baseAmp, params.persistence, params.octaves, raw);
+            break;
+    }
+
+    float amp = params.baseAmp, maxAmp = 0.0f;
+    for (int i = 0; i < params.octaves; i++) {
+        if (amp < 0.01f) break;
+        maxAmp += amp;
+        amp *= params.persistence;
+    }
+    for (size_t i = 0; i < count; i++) {
+        float normalized = maxAmp > 0.0f ? raw[i] / maxAmp : 0.0f;
+        heights[i] = std::pow(normalized, params.flattenPower) * params.finalScale;
+    }
+}
+
+void TerrainNoise::HeightBatch(const TerrainParams& params, const float* xs, const float* zs, size_t count, float* heights, float* normals) {
+    const TerrainNoiseKernel kernel = GetKernel();
+    for (size_t begin = 0; begin < count; begin += TERRAIN_NOISE_CHUNK) {
+        size_t n = count - begin < TERRAIN_NOISE_CHUNK ? count - begin : TERRAIN_NOISE_CHUNK;
+        heightChunk(params, kernel, xs + begin, zs + begin, n, heights + begin);
+        if (!normals) continue;
+
+        // Same offsets and order as terrainNormalNoise(): (h(x - e) - h(x + e), 2e, h(z - e) - h(z + e))
+        float offsetX[TERRAIN_NOISE_CHUNK], offsetZ[TERRAIN_NOISE_CHUNK];
+        float left[TERRAIN_NOISE_CHUNK], right[TERRAIN_NOISE_CHUNK], back[TERRAIN_NOISE_CHUNK], front[TERRAIN_NOISE_CHUNK];
+        for (size_t i = 0; i < n; i++) offsetX[i] = xs[begin + i] - NORMAL_EPSILON;
+        heightChunk(params, kernel, offsetX, zs + begin, n, left);
+        for (size_t i = 0; i < n; i++) offsetX[i] = xs[begin + i] + NORMAL_EPSILON;
+        heightChunk(params, kernel, offsetX, zs + begin, n, right);
+        for (size_t i = 0; i < n; i++) offsetZ[i] = zs[begin + i] - NORMAL_EPSILON;
+        heightChunk(params, kernel, xs + begin, offsetZ, n, back);
+        for (size_t i = 0; i < n; i++) offsetZ[i] = zs[begin + i] + NORMAL_EPSILON;
+        heightChunk(params, kernel, xs + begin, offsetZ, n, front);
+        for (size_t i = 0; i < n; i++) {
+            float nx = left[i] - right[i], ny = 2.0f * NORMAL_EPSILON, nz = back[i] - front[i];
+            float invLength = 1.0f / std::sqrt(nx * nx + ny * ny + nz * nz);
+            float* normal = normals + (begin + i) * 3;
+            normal[0] = nx * invLength; normal[1] = ny * invLength; normal[2] = nz * invLength;
+        }
+    }
+}
+
+void TerrainNoise::HeightGrid(const TerrainParams& params, float originX, float originZ, float spacing, int cols, int rows, float* heights) {
+    const TerrainNoiseKernel kernel = GetKernel();
+    const size_t count = static_cast<size_t>(cols) * static_cast<size_t>(rows);
+    float xs[TERRAIN_NOISE_CHUNK], zs[TERRAIN_NOISE_CHUNK];
+    for (size_t begin = 0; begin < count; begin += TERRAIN_NOISE_CHUNK) {
+        size_t n = count - begin < TERRAIN_NOISE_CHUNK ? count - begin : TERRAIN_NOISE_CHUNK;
+        for (size_t i = 0; i < n; i++) {
+            size_t index = begin + i;
+            xs[i] = originX + static_cast<float>(index % static_cast<size_t>(cols)) * spacing;
+            zs[i] = originZ + static_cast<float>(index / static_cast<size_t>(cols)) * spacing;
+        }
+        heightChunk(params, kernel, xs, zs, n, heights + begin);
+    }
+}
@@ -0,0 +1,43 @@
+// Built with AVX2 enabled (see CMakeLists.txt); only entered after TerrainNoise has checked the CPU
+#include "TerrainNoiseKernel.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+
+namespace {
+
+struct TerrainLanesAvx2 {
+    static const size_t WIDTH = 8;
+    using F = __m256;
+    using I = __m256i;
+    static F Load(const float* p) { return _mm256_loadu_ps(p); }
+    static void Store(float* p, F v) { _mm256_storeu_ps(p, v); }
+    static F Set(float v) { return _mm256_set1_ps(v); }
+    static I SetI(uint32_t v) { return _mm256_set1_epi32(static_cast<int>(v)); }
+    static F Add(F a, F b) { return _mm256_add_ps(a, b); }
+    static F Sub(F a, F b) { return _mm256_sub_ps(a, b); }
+    static F Mul(F a, F b) { return _mm256_mul_ps(a, b); }
+    static F Floor(F v) { return _mm256_floor_ps(v); }
+    static I ToInt(F v) { return _mm256_cvttps_epi32(v); }
+    static F ToFloat(I v) { return _mm256_cvtepi32_ps(v); }
+    static I AddI(I a, I b) { return _mm256_add_epi32(a, b); }
+    static I MulLo(I a, I b) { return _mm256_mullo_epi32(a, b); }
+    static I Xor(I a, I b) { return _mm256_xor_si256(a, b); }
+    static I ShiftRight(I v, int bits) { return _mm256_srl_epi32(v, _mm_cvtsi32_si128(bits)); }
+};
+
+} // namespace
+
+bool terrainFbmAvx2(const float* xs, const float* zs, size_t count, float baseFreq, float baseAmp, float persistence,
+                    int octaves, float* out) {
+    terrainFbmKernel<TerrainLanesAvx2>(xs, zs, count, baseFreq, baseAmp, persistence, octaves, out);
+    return true;
+}
+
+#else
+
+bool terrainFbmAvx2(const float*, const float*, size_t, float, float, float, int, float*) {
+    return false;
+}
+
+#endif
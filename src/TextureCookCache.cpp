@@ -0,0 +1,254 @@
+#include "TextureCookCache.h"
+#include "Log.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+
+// FNV-1a, 64 bit
+static uint64_t hashString(const std::string& text) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : text) { hash ^= c; hash *= 1099511628211ull; }
+    return hash;
+}
+
+// Source size and mtime split into the four 32-bit words kept in the cooked DDS header
+static bool getSourceStamp(const std::string& sourcePath, uint32_t stamp[4]) {
+    std::error_code ec;
+    uint64_t size = static_cast<uint64_t>(std::filesystem::file_size(sourcePath, ec));
+    if (ec) return false;
+    auto time = std::filesystem::last_write_time(sourcePath, ec);
+    if (ec) return false;
+    uint64_t mtime = static_cast<uint64_t>(time.time_since_epoch().count());
+    stamp[0] = static_cast<uint32_t>(size); stamp[1] = static_cast<uint32_t>(size >> 32);
+    stamp[2] = static_cast<uint32_t>(mtime); stamp[3] = static_cast<uint32_t>(mtime >> 32);
+    return true;
+}
+
+TextureCookCache::TextureCookCache(std::filesystem::path cacheDirectory) : m_directory(std::move(cacheDirectory)) {}
+
+std::filesystem::path TextureCookCache::GetCachePath(const std::string& sourcePath) const {
+    std::error_code ec;
+    std::filesystem::path absolute = std::filesystem::absolute(sourcePath, ec);
+    std::string key = ec ? sourcePath : absolute.lexically_normal().string();
+    std::ostringstream name;
+    name << std::filesystem::path(sourcePath).stem().string() << "_" << std::hex << std::setw(16) << std::setfill('0')
+         << hashString(key) << ".dds";
+    return m_directory / name.str();
+}
+
+bool TextureCookCache::Load(const std::string& sourcePath, CompressedImage& image) const {
+    uint32_t sourceStamp[4], cookedStamp[4];
+    if (!getSourceStamp(sourcePath, sourceStamp)) return false;
+    std::string cookedPath = GetCachePath(sourcePath).string();
+    if (!CompressedTextureFile::ReadDDSStamp(cookedPath, cookedStamp)) return false;
+    if (!std::equal(sourceStamp, sourceStamp + 4, cookedStamp)) return false; // Stale; the caller re-cooks it
+    std::string error;
+    return CompressedTextureFile::Load(cookedPath, image, error);
+}
+
+bool TextureCookCache::Store(const std::string& sourcePath, const CompressedImage& image) const {
+    uint32_t stamp[4];
+    if (!getSourceStamp(sourcePath, stamp)) return false;
+    std::filesystem::path cookedPath = GetCachePath(sourcePath);
+    if (!CompressedTextureFile::SaveDDS(cookedPath.string(), image, stamp)) {
+        LOG_WARN(TEXTURES) << "Could not write cooked texture " << cookedPath;
+        return false;
+    }
+    return true;
+}
+
+// --- BCn encoding ---
+
+static uint16_t packRGB565(int r, int g, int b) {
+    return static_cast<uint16_t>((((r * 31 + 127) / 255) << 11) | (((g * 63 + 127) / 255) << 5) | ((b * 31 + 127) / 255));
+}
+
+static void unpackRGB565(uint16_t color, int rgb[3]) {
+    int r = color >> 11, g = (color >> 5) & 63, b = color & 31;
+    rgb[0] = (r << 3) | (r >> 2);
+    rgb[1] = (g << 2) | (g >> 4);
+    rgb[2] = (b << 3) | (b >> 2);
+}
+
+static void writeLE16(unsigned char* out, uint16_t value) {
+    out[0] = static_cast<unsigned char>(value);
+    out[1] = static_cast<unsigned char>(value >> 8);
+}
+
+// BC1 color block for 16 RGB texels (row-major). Endpoints are the inset bounding box of the colors, with the
+// diagonal flipped per channel when red or blue fall as green rises, so the line follows the actual gradient.
+static void encodeColorBlock(const unsigned char texels[16][4], unsigned char* out) {
+    int minC[3] = { 255, 255, 255 }, maxC[3] = { 0, 0, 0 };
+    int mean[3] = { 0, 0, 0 };
+    for (int i = 0; i < 16; ++i) {
+        for (int c = 0; c < 3; ++c) {
+            minC[c] = std::min(minC[c], static_cast<int>(texels[i][c]));
+            maxC[c] = std::max(maxC[c], static_cast<int>(texels[i][c]));
+            mean[c] += texels[i][c];
+        }
+    }
+    for (int c = 0; c < 3; ++c) mean[c] /= 16;
+    int covRG = 0, covBG = 0;
+    for (int i = 0; i < 16; ++i) {
+        int g = texels[i][1] - mean[1];
+        covRG += (texels[i][0] - mean[0]) * g;
+        covBG += (texels[i][2] - mean[2]) * g;
+    }
+    if (covRG < 0) std::swap(minC[0], maxC[0]);
+    if (covBG < 0) std::swap(minC[2], maxC[2]);
+    for (int c = 0; c < 3; ++c) {
+        int inset = (maxC[c] - minC[c]) / 16;
+        maxC[c] = std::clamp(maxC[c] - inset, 0, 255);
+        minC[c] = std::clamp(minC[c] + inset, 0, 255);
+    }
+
+    uint16_t c0 = packRGB565(maxC[0], maxC[1], maxC[2]);
+    uint16_t c1 = packRGB565(minC[0], minC[1], minC[2]);
+    if (c0 < c1) std::swap(c0, c1); // c0 > c1 selects the 4-color mode
+    writeLE16(out, c0);
+    writeLE16(out + 2, c1);
+    uint32_t indices = 0;
+    if (c0 != c1) {
+        int palette[4][3];
+        unpackRGB565(c0, palette[0]);
+        unpackRGB565(c1, palette[1]);
+        for (int c = 0; c < 3; ++c) {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+        for (int i = 0; i < 16; ++i) {
+            int best = 0, bestError = INT32_MAX;
+            for (int p = 0; p < 4; ++p) {
+                int dr = texels[i][0] - palette[p][0], dg = texels[i][1] - palette[p][1], db = texels[i][2] - palette[p][2];
+                int error = dr * dr + dg * dg + db * db;
+                if (error < bestError) { bestError = error; best = p; }
+            }
+            indices |= static_cast<uint32_t>(best) << (2 * i);
+        }
+    }
+    for (int i = 0; i < 4; ++i) out[4 + i] = static_cast<unsigned char>(indices >> (8 * i));
+}
+
+// BC4 block for 16 single-channel values (BC3 alpha, each BC5 channel), 8-value mode
+static void encodeAlphaBlock(const unsigned char values[16], unsigned char* out) {
+    int a0 = 0, a1 = 255;
+    for (int i = 0; i < 16; ++i) { a0 = std::max(a0, static_cast<int>(values[i])); a1 = std::min(a1, static_cast<int>(values[i])); }
+    out[0] = static_cast<unsigned char>(a0);
+    out[1] = static_cast<unsigned char>(a1);
+    uint64_t indices = 0;
+    if (a0 != a1) {
+        int palette[8] = { a0, a1 };
+        for (int k = 1; k <= 6; ++k) palette[1 + k] = ((7 - k) * a0 + k * a1) / 7;
+        for (int i = 0; i < 16; ++i) {
+            int best = 0, bestError = INT32_MAX;
+            for (int p = 0; p < 8; ++p) {
+                int error = std::abs(values[i] - palette[p]);
+                if (error < bestError) { bestError = error; best = p; }
+            }
+            indices |= static_cast<uint64_t>(best) << (3 * i);
+        }
+    }
+    for (int i = 0; i < 6; ++i) out[2 + i] = static_cast<unsigned char>(indices >> (8 * i));
+}
+
+// 2x2 box filter, clamping at odd edges
+static void downsample(const std::vector<unsigned char>& source, int width, int height, int channels,
+                       std::vector<unsigned char>& target, int& targetWidth, int& targetHeight) {
+    targetWidth = std::max(1, width / 2);
+    targetHeight = std::max(1, height / 2);
+    target.resize(static_cast<size_t>(targetWidth) * targetHeight * channels);
+    for (int y = 0; y < targetHeight; ++y) {
+        int y0 = std::min(2 * y, height - 1), y1 = std::min(2 * y + 1, height - 1);
+        for (int x = 0; x < targetWidth; ++x) {
+            int x0 = std::min(2 * x, width - 1), x1 = std::min(2 * x + 1, width - 1);
+            for (int c = 0; c < channels; ++c) {
+                int sum = source[(static_cast<size_t>(y0) * width + x0) * channels + c] + source[(static_cast<size_t>(y0) * width + x1) * channels + c] +
+                          source[(static_cast<size_t>(y1) * width + x0) * channels + c] + source[(static_cast<size_t>(y1) * width + x1) * channels + c];
+                target[(static_cast<size_t>(y) * targetWidth + x) * channels + c] = static_cast<unsigned char>((sum + 2) / 4);
+            }
+        }
+    }
+}
+
+bool TextureCookCache::Cook(const unsigned char* pixels, int width, int height, int channels, CompressedImage& image) {
+    if (!pixels || width <= 0 || height <= 0 || channels < 1 || channels > 4) return false;
+    auto start = std::chrono::high_resolution_clock::now();
+
+    switch (channels) {
+        case 1:  image.internalFormat = GL_COMPRESSED_RED_RGTC1; image.blockBytes = 8; break;
+        case 2:  image.internalFormat = GL_COMPRESSED_RG_RGTC2; image.blockBytes = 16; break;
+        case 3:  image.internalFormat = GL_COMPRESSED_RGB_S3TC_DXT1_EXT; image.blockBytes = 8; break;
+        default: image.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT; image.blockBytes = 16; break;
+    }
+    image.width = width;
+    image.height = height;
+    image.levels.clear();
+    image.data.clear();
+
+    std::vector<unsigned char> level(pixels, pixels + static_cast<size_t>(width) * height * channels), next;
+    int levelWidth = width, levelHeight = height;
+    while (true) {
+        CompressedMipLevel mip;
+        mip.offset = image.data.size();
+        mip.width = levelWidth;
+        mip.height = levelHeight;
+        int blocksX = (levelWidth + 3) / 4, blocksY = (levelHeight + 3) / 4;
+        mip.size = static_cast<size_t>(blocksX) * blocksY * image.blockBytes;
+        image.data.resize(mip.offset + mip.size);
+        unsigned char* out = image.data.data() + mip.offset;
+
+        for (int by = 0; by < blocksY; ++by) {
+            for (int bx = 0; bx < blocksX; ++bx) {
+                // Gather the 4x4 block, repeating the last row / column for partial blocks
+                unsigned char texels[16][4] = {};
+                for (int y = 0; y < 4; ++y) {
+                    int sy = std::min(by * 4 + y, levelHeight - 1);
+                    for (int x = 0; x < 4; ++x) {
+                        int sx = std::min(bx * 4 + x, levelWidth - 1);
+                        const unsigned char* texel = &level[(static_cast<size_t>(sy) * levelWidth + sx) * channels];
+                        for (int c = 0; c < channels; ++c) texels[y * 4 + x][c] = texel[c];
+                    }
+                }
+                unsigned char channel[16];
+                switch (channels) {
+                    case 1:
+                        for (int i = 0; i < 16; ++i) channel[i] = texels[i][0];
+                        encodeAlphaBlock(channel, out);
+                        break;
+                    case 2:
+                        for (int c = 0; c < 2; ++c) {
+                            for (int i = 0; i < 16; ++i) channel[i] = texels[i][c];
+                            encodeAlphaBlock(channel, out + 8 * c);
+                        }
+                        break;
+                    case 3:
+                        encodeColorBlock(texels, out);
+                        break;
+                    default:
+                        for (int i = 0; i < 16; ++i) channel[i] = texels[i][3];
+                        encodeAlphaBlock(channel, out);
+                        encodeColorBlock(texels, out + 8);
+                        break;
+                }
+                out += image.blockBytes;
+            }
+        }
+        image.levels.push_back(mip);
+
+        if (levelWidth == 1 && levelHeight == 1) break;
+        int nextWidth, nextHeight;
+        downsample(level, levelWidth, levelHeight, channels, next, nextWidth, nextHeight);
+        level.swap(next);
+        levelWidth = nextWidth;
+        levelHeight = nextHeight;
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    LOG_INFO(TEXTURES) << "Cooked " << width << "x" << height << " texture to " << (channels == 1 ? "BC4" : channels == 2 ? "BC5" : channels == 3 ? "BC1" : "BC3")
+                       << " (" << image.levels.size() << " levels, " << image.data.size() / 1024 << " KB) in "
+                       << std::chrono::duration<double, std::milli>(end - start).count() << " ms";
+    return true;
+}
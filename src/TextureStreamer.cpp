@@ -0,0 +1,545 @@
+#include "TextureStreamer.h"
+#include "Log.h"
+#include "MemoryStats.h"
+#include "stb_image.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+// Rows per chunk are chosen so one PBO transfer stays around this size
+static const size_t TEXTURE_UPLOAD_CHUNK_BYTES = 4 * 1024 * 1024;
+// Cap per Update() on top of the time budget; a 4K RGBA texture (64 MB) lands over four frames
+static const size_t TEXTURE_UPLOAD_MAX_BYTES_PER_FRAME = 16 * 1024 * 1024;
+// Longest side of the preview uploaded as soon as a decode finishes
+static const int TEXTURE_PREVIEW_SIZE = 64;
+// Side of the checker placeholder, in texels
+static const int TEXTURE_PLACEHOLDER_SIZE = 8;
+// VRAM unreferenced textures may keep before Update() evicts the longest-unused ones
+static const size_t TEXTURE_UNUSED_BUDGET_BYTES = 64 * 1024 * 1024;
+
+static void formatForChannels(int channels, GLenum& internalFormat, GLenum& format) {
+    switch (channels) {
+        case 1:  internalFormat = GL_R8;    format = GL_RED;  break;
+        case 2:  internalFormat = GL_RG8;   format = GL_RG;   break;
+        case 3:  internalFormat = GL_RGB8;  format = GL_RGB;  break;
+        default: internalFormat = GL_RGBA8; format = GL_RGBA; break;
+    }
+}
+
+// RGB8 is usually padded to 4 bytes per texel
+static size_t texelBytesForChannels(int channels) {
+    return channels == 3 ? 4 : static_cast<size_t>(channels);
+}
+
+TextureStreamer::TextureStreamer(ThreadPool& pool) : m_pool(pool), m_unusedBudget(TEXTURE_UNUSED_BUDGET_BYTES) {}
+
+TextureStreamer::~TextureStreamer() {
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_jobsDone.wait(lock, [this]() { return m_jobsInFlight == 0; });
+    }
+    Clear();
+    deleteTexture(m_placeholder);
+    if (m_pbos[0] != 0) glDeleteBuffers(UPLOAD_PBO_COUNT, m_pbos);
+}
+
+bool TextureStreamer::Initialize() {
+    std::vector<unsigned char> checker(TEXTURE_PLACEHOLDER_SIZE * TEXTURE_PLACEHOLDER_SIZE * 4);
+    for (int y = 0; y < TEXTURE_PLACEHOLDER_SIZE; ++y) {
+        for (int x = 0; x < TEXTURE_PLACEHOLDER_SIZE; ++x) {
+            unsigned char shade = ((x / 2 + y / 2) % 2) ? 160 : 96;
+            unsigned char* texel = &checker[(y * TEXTURE_PLACEHOLDER_SIZE + x) * 4];
+            texel[0] = texel[1] = texel[2] = shade; texel[3] = 255;
+        }
+    }
+    glGenTextures(1, &m_placeholder);
+    glBindTexture(GL_TEXTURE_2D, m_placeholder);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, TEXTURE_PLACEHOLDER_SIZE, TEXTURE_PLACEHOLDER_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, checker.data());
+    glBindTexture(GL_TEXTURE_2D, 0);
+    MemoryStats::TrackTexture(m_placeholder, MemoryCategory::TEXTURES, checker.size());
+
+    glGenBuffers(UPLOAD_PBO_COUNT, m_pbos);
+    m_formatSupport = CompressedFormatSupport::Query();
+    if (m_placeholder == 0 || m_pbos[0] == 0) {
+        LOG_ERROR(TEXTURES) << "Failed to create texture streaming resources.";
+        return false;
+    }
+    return true;
+}
+
+// --- Cache ---
+
+TextureHandle TextureStreamer::Request(const std::string& path, bool forceReload) {
+    std::error_code ec;
+    std::filesystem::file_time_type timestamp = std::filesystem::last_write_time(path, ec);
+
+    auto it = m_handles.find(path);
+    if (it != m_handles.end()) {
+        Entry& entry = m_entries[it->second - 1];
+        entry.refCount++;
+        if (!forceReload && !ec && timestamp == entry.timestamp) return it->second;
+        LOG_INFO(TEXTURES) << "Texture file modified, reloading: " << path;
+        entry.timestamp = timestamp;
+        if (entry.texture == 0) entry.state = TextureState::LOADING; // Otherwise the old image stays up until replaced
+        startDecode(it->second);
+        return it->second;
+    }
+
+    Entry entry;
+    entry.path = path;
+    entry.timestamp = timestamp;
+    entry.refCount = 1;
+    TextureHandle handle;
+    if (!m_freeSlots.empty()) {
+        handle = m_freeSlots.back();
+        m_freeSlots.pop_back();
+        m_entries[handle - 1] = std::move(entry);
+    } else {
+        m_entries.push_back(std::move(entry));
+        handle = static_cast<TextureHandle>(m_entries.size());
+    }
+    m_handles[path] = handle;
+    startDecode(handle);
+    return handle;
+}
+
+void TextureStreamer::Release(TextureHandle handle) {
+    if (handle == INVALID_TEXTURE_HANDLE || handle > m_entries.size()) return; // Cleared since
+    Entry& entry = m_entries[handle - 1];
+    if (!entry.live || entry.refCount == 0) return;
+    if (--entry.refCount == 0) entry.releasedAt = ++m_releaseTick;
+}
+
+// Oldest release first, until the unreferenced textures fit the budget. Entries still loading hold no VRAM
+// yet and wait until their upload lands.
+void TextureStreamer::evictUnused() {
+    size_t unused = GetUnusedBytes();
+    while (unused > m_unusedBudget) {
+        Entry* oldest = nullptr;
+        for (Entry& entry : m_entries) {
+            if (entry.live && entry.refCount == 0 && entry.gpuBytes > 0 && (!oldest || entry.releasedAt < oldest->releasedAt)) oldest = &entry;
+        }
+        if (!oldest) break;
+        LOG_INFO(TEXTURES) << "Evicted unused texture " << oldest->path << " (" << oldest->gpuBytes / 1024 << " KB)";
+        unused -= oldest->gpuBytes;
+        deleteTexture(oldest->texture);
+        m_handles.erase(oldest->path);
+        TextureHandle handle = static_cast<TextureHandle>(oldest - m_entries.data()) + 1;
+        *oldest = Entry();
+        oldest->live = false;
+        oldest->state = TextureState::FAILED;
+        oldest->generation = m_nextGeneration++; // Decodes and uploads still in flight for it are dropped
+        m_freeSlots.push_back(handle);
+        m_evictedCount++;
+    }
+}
+
+TextureStreamer::Entry* TextureStreamer::findEntry(TextureHandle handle, uint32_t generation) {
+    if (handle == INVALID_TEXTURE_HANDLE || handle > m_entries.size()) return nullptr;
+    Entry& entry = m_entries[handle - 1];
+    return entry.generation == generation ? &entry : nullptr;
+}
+
+GLuint TextureStreamer::GetTextureId(TextureHandle handle) const {
+    if (handle == INVALID_TEXTURE_HANDLE || handle > m_entries.size()) return m_placeholder;
+    GLuint texture = m_entries[handle - 1].texture;
+    return texture != 0 ? texture : m_placeholder;
+}
+
+TextureState TextureStreamer::GetState(TextureHandle handle) const {
+    if (handle == INVALID_TEXTURE_HANDLE || handle > m_entries.size()) return TextureState::FAILED;
+    return m_entries[handle - 1].state;
+}
+
+const std::string& TextureStreamer::GetPath(TextureHandle handle) const {
+    static const std::string empty;
+    if (handle == INVALID_TEXTURE_HANDLE || handle > m_entries.size()) return empty;
+    return m_entries[handle - 1].path;
+}
+
+size_t TextureStreamer::GetGpuBytes() const {
+    size_t total = 0;
+    for (const Entry& entry : m_entries) total += entry.gpuBytes;
+    return total;
+}
+
+size_t TextureStreamer::GetUnusedBytes() const {
+    size_t total = 0;
+    for (const Entry& entry : m_entries) {
+        if (entry.live && entry.refCount == 0) total += entry.gpuBytes;
+    }
+    return total;
+}
+
+size_t TextureStreamer::GetPendingCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_jobsInFlight + m_decoded.size() + m_staged.size();
+}
+
+void TextureStreamer::Clear() {
+    while (!m_staged.empty()) popStaged();
+    for (Entry& entry : m_entries) deleteTexture(entry.texture);
+    // Decodes still running carry generations that no longer match anything and are dropped
+    m_entries.clear();
+    m_handles.clear();
+    m_freeSlots.clear();
+}
+
+void TextureStreamer::deleteTexture(GLuint& texture) {
+    if (texture == 0) return;
+    MemoryStats::UntrackTexture(texture);
+    glDeleteTextures(1, &texture);
+    texture = 0;
+}
+
+// --- Decode (thread pool) ---
+
+void TextureStreamer::startDecode(TextureHandle handle) {
+    Entry& entry = m_entries[handle - 1];
+    entry.generation = m_nextGeneration++;
+    uint32_t generation = entry.generation;
+    std::string path = entry.path;
+    bool cook = m_cookingEnabled;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobsInFlight++;
+    }
+    m_pool.Enqueue([this, handle, generation, path, cook]() {
+        DecodedImage image;
+        image.handle = handle;
+        image.generation = generation;
+        // A throwing decode or cook (bad_alloc, filesystem errors) is reported like any failed load: Update()
+        // marks the entry FAILED, and the job is still counted off
+        try {
+            decodeImage(path, cook, image);
+        } catch (const std::exception& e) {
+            image.error = e.what();
+        } catch (...) {
+            image.error = "unknown exception while decoding";
+        }
+        if (!image.error.empty()) {
+            image.pixels.reset();
+            image.preview.clear();
+            image.compressed = false;
+            image.compressedImage = CompressedImage();
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobsInFlight--; // Before the push, which can throw too
+        m_jobsDone.notify_all();
+        m_decoded.push_back(std::move(image));
+    });
+}
+
+// Worker thread: pre-compressed files are read as is; other sources come from the cook cache when possible,
+// otherwise they are decoded with stb_image (and cooked for next time if cooking is enabled)
+void TextureStreamer::decodeImage(const std::string& path, bool cook, DecodedImage& image) const {
+    auto start = std::chrono::high_resolution_clock::now();
+    auto elapsedMs = [&start]() {
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    };
+
+    if (CompressedTextureFile::IsCompressedPath(path)) {
+        if (!CompressedTextureFile::Load(path, image.compressedImage, image.error)) return;
+        if (!m_formatSupport.Supports(image.compressedImage.internalFormat)) { image.error = "compressed format not supported by this GL context"; return; }
+        image.compressed = true;
+        LOG_INFO(TEXTURES) << "Read compressed texture " << path << " (" << image.compressedImage.width << "x" << image.compressedImage.height
+                           << ", " << image.compressedImage.levels.size() << " levels) in " << elapsedMs() << " ms";
+        return;
+    }
+
+    if (cook && m_cookCache.Load(path, image.compressedImage) && m_formatSupport.Supports(image.compressedImage.internalFormat)) {
+        image.compressed = true;
+        LOG_INFO(TEXTURES) << "Cooked texture cache hit for " << path << " in " << elapsedMs() << " ms";
+        return;
+    }
+
+    stbi_set_flip_vertically_on_load_thread(1); // Per-thread flag; the global one would race between workers
+    int width = 0, height = 0, channels = 0;
+    unsigned char* data = stbi_load(path.c_str(), &width, &height, &channels, 0);
+    if (!data) {
+        const char* reason = stbi_failure_reason();
+        image.error = reason ? reason : "unknown stb_image error";
+        return;
+    }
+    image.width = width;
+    image.height = height;
+    image.channels = channels;
+    image.pixels = PixelBuffer(data, stbi_image_free);
+    LOG_INFO(TEXTURES) << "Decoded texture " << path << " (" << width << "x" << height << ", " << channels << " channels) in "
+                       << elapsedMs() << " ms";
+
+    if (cook) {
+        CompressedImage cooked;
+        if (TextureCookCache::Cook(data, width, height, channels, cooked) && m_formatSupport.Supports(cooked.internalFormat)) {
+            m_cookCache.Store(path, cooked); // Failure only costs the next load another cook
+            image.compressedImage = std::move(cooked);
+            image.compressed = true;
+            image.pixels.reset();
+            return;
+        }
+    }
+    buildPreview(image);
+}
+
+// Box-filtered preview of the raw pixels, longest side <= TEXTURE_PREVIEW_SIZE
+void TextureStreamer::buildPreview(DecodedImage& image) {
+    const unsigned char* data = image.pixels.get();
+    int width = image.width, height = image.height, channels = image.channels;
+    int factor = std::max(1, (std::max(width, height) + TEXTURE_PREVIEW_SIZE - 1) / TEXTURE_PREVIEW_SIZE);
+    image.previewWidth = std::max(1, width / factor);
+    image.previewHeight = std::max(1, height / factor);
+    image.preview.resize(static_cast<size_t>(image.previewWidth) * image.previewHeight * channels);
+    for (int py = 0; py < image.previewHeight; ++py) {
+        for (int px = 0; px < image.previewWidth; ++px) {
+            for (int c = 0; c < channels; ++c) {
+                unsigned int sum = 0, count = 0;
+                for (int y = py * factor; y < std::min(height, (py + 1) * factor); ++y) {
+                    const unsigned char* row = data + static_cast<size_t>(y) * width * channels;
+                    for (int x = px * factor; x < std::min(width, (px + 1) * factor); ++x) {
+                        sum += row[x * channels + c];
+                        count++;
+                    }
+                }
+                image.preview[(static_cast<size_t>(py) * image.previewWidth + px) * channels + c] =
+                    static_cast<unsigned char>(count ? sum / count : 0);
+            }
+        }
+    }
+}
+
+// --- Upload (GL thread) ---
+
+void TextureStreamer::Update(double budgetMs) {
+    std::deque<DecodedImage> decoded;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        decoded.swap(m_decoded);
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // Rows of 1- and 3-channel images are not 4-byte aligned
+    for (DecodedImage& image : decoded) {
+        Entry* entry = findEntry(image.handle, image.generation);
+        if (!entry) continue; // Reloaded or cleared since the decode started
+        if (!image.error.empty()) {
+            LOG_ERROR(TEXTURES) << "Failed to load texture " << entry->path << ": " << image.error;
+            if (entry->texture == 0) entry->state = TextureState::FAILED;
+            continue;
+        }
+        if (image.compressed) beginCompressedUpload(image);
+        else beginUpload(image);
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto elapsedMs = [&start]() {
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    };
+    size_t uploadedBytes = 0;
+    while (!m_staged.empty() && uploadedBytes < TEXTURE_UPLOAD_MAX_BYTES_PER_FRAME && elapsedMs() < budgetMs) {
+        StagedUpload& upload = m_staged.front();
+        if (!findEntry(upload.image.handle, upload.image.generation)) {
+            popStaged();
+            continue;
+        }
+        size_t maxBytes = std::min(TEXTURE_UPLOAD_CHUNK_BYTES, TEXTURE_UPLOAD_MAX_BYTES_PER_FRAME - uploadedBytes);
+        bool done;
+        if (upload.image.compressed) {
+            uploadedBytes += uploadCompressedRows(upload, maxBytes);
+            done = upload.nextLevel >= upload.image.compressedImage.levels.size();
+        } else {
+            uploadedBytes += uploadRows(upload, maxBytes);
+            done = upload.nextRow >= upload.image.height;
+        }
+        if (done) {
+            finishUpload(upload);
+            popStaged();
+        }
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    evictUnused();
+}
+
+void TextureStreamer::pushStaged(StagedUpload&& upload) {
+    const DecodedImage& image = upload.image;
+    upload.cpuBytes = image.compressed ? image.compressedImage.data.size()
+                                       : static_cast<size_t>(image.width) * image.height * image.channels;
+    MemoryStats::AddCpuBytes(MemoryCategory::TEXTURE_CPU, upload.cpuBytes);
+    m_staged.push_back(std::move(upload));
+}
+
+void TextureStreamer::popStaged() {
+    StagedUpload& upload = m_staged.front();
+    deleteTexture(upload.texture);
+    MemoryStats::RemoveCpuBytes(MemoryCategory::TEXTURE_CPU, upload.cpuBytes);
+    m_staged.pop_front();
+}
+
+void TextureStreamer::beginUpload(DecodedImage& image) {
+    Entry& entry = m_entries[image.handle - 1];
+    GLenum internalFormat, format;
+    formatForChannels(image.channels, internalFormat, format);
+
+    // The preview is tiny; upload it straight away so something recognisable shows next frame.
+    // On a reload the previous full-resolution image stays bound instead.
+    if (entry.texture == 0) {
+        glGenTextures(1, &entry.texture);
+        glBindTexture(GL_TEXTURE_2D, entry.texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, image.previewWidth, image.previewHeight, 0, format, GL_UNSIGNED_BYTE, image.preview.data());
+        MemoryStats::TrackTexture(entry.texture, MemoryCategory::TEXTURES,
+                                  static_cast<size_t>(image.previewWidth) * image.previewHeight * texelBytesForChannels(image.channels));
+        entry.state = TextureState::PREVIEW;
+    }
+    image.preview.clear();
+    image.preview.shrink_to_fit();
+
+    StagedUpload upload;
+    glGenTextures(1, &upload.texture);
+    glBindTexture(GL_TEXTURE_2D, upload.texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, nullptr);
+    // Level 0 only for now; finishUpload() counts the generated mip chain
+    MemoryStats::TrackTexture(upload.texture, MemoryCategory::TEXTURES,
+                              static_cast<size_t>(image.width) * image.height * texelBytesForChannels(image.channels));
+    upload.image = std::move(image);
+    pushStaged(std::move(upload));
+}
+
+void TextureStreamer::beginCompressedUpload(DecodedImage& image) {
+    Entry& entry = m_entries[image.handle - 1];
+    const CompressedImage& compressed = image.compressedImage;
+    GLint maxLevel = static_cast<GLint>(compressed.levels.size()) - 1;
+
+    // The tail of the mip chain (levels up to TEXTURE_PREVIEW_SIZE) is the preview; upload it straight away
+    if (entry.texture == 0) {
+        size_t first = 0;
+        while (first < compressed.levels.size() &&
+               std::max(compressed.levels[first].width, compressed.levels[first].height) > TEXTURE_PREVIEW_SIZE) first++;
+        if (first < compressed.levels.size()) {
+            glGenTextures(1, &entry.texture);
+            glBindTexture(GL_TEXTURE_2D, entry.texture);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, maxLevel - static_cast<GLint>(first));
+            size_t previewBytes = 0;
+            for (size_t i = first; i < compressed.levels.size(); ++i) {
+                const CompressedMipLevel& level = compressed.levels[i];
+                glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(i - first), compressed.internalFormat, level.width, level.height, 0,
+                                       static_cast<GLsizei>(level.size), compressed.data.data() + level.offset);
+                previewBytes += level.size;
+            }
+            MemoryStats::TrackTexture(entry.texture, MemoryCategory::TEXTURES, previewBytes);
+            entry.state = TextureState::PREVIEW;
+        }
+    }
+
+    // Full chain: allocate every level now, fill them chunk by chunk in Update()
+    StagedUpload upload;
+    glGenTextures(1, &upload.texture);
+    glBindTexture(GL_TEXTURE_2D, upload.texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, maxLevel > 0 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, maxLevel); // Chains need not reach 1x1
+    for (size_t i = 0; i < compressed.levels.size(); ++i) {
+        const CompressedMipLevel& level = compressed.levels[i];
+        glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(i), compressed.internalFormat, level.width, level.height, 0,
+                               static_cast<GLsizei>(level.size), nullptr);
+    }
+    MemoryStats::TrackTexture(upload.texture, MemoryCategory::TEXTURES, compressed.data.size());
+    upload.image = std::move(image);
+    pushStaged(std::move(upload));
+}
+
+size_t TextureStreamer::uploadRows(StagedUpload& upload, size_t maxBytes) {
+    const DecodedImage& image = upload.image;
+    GLenum internalFormat, format;
+    formatForChannels(image.channels, internalFormat, format);
+    size_t rowBytes = static_cast<size_t>(image.width) * image.channels;
+    int rows = static_cast<int>(std::max<size_t>(1, maxBytes / rowBytes));
+    rows = std::min(rows, image.height - upload.nextRow);
+    size_t bytes = rowBytes * rows;
+    const unsigned char* source = image.pixels.get() + rowBytes * upload.nextRow;
+
+    const void* pixels = stageThroughPbo(source, bytes);
+    glBindTexture(GL_TEXTURE_2D, upload.texture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, upload.nextRow, image.width, rows, format, GL_UNSIGNED_BYTE, pixels);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    upload.nextRow += rows;
+    return bytes;
+}
+
+size_t TextureStreamer::uploadCompressedRows(StagedUpload& upload, size_t maxBytes) {
+    const CompressedImage& compressed = upload.image.compressedImage;
+    const CompressedMipLevel& level = compressed.levels[upload.nextLevel];
+    size_t rowBytes = compressed.BlockRowBytes(level);
+    int blockRows = std::max(1, (level.height + 3) / 4);
+    int rows = static_cast<int>(std::max<size_t>(1, maxBytes / rowBytes));
+    rows = std::min(rows, blockRows - upload.nextRow);
+    size_t bytes = rowBytes * rows;
+
+    // Sub-images must cover whole blocks, except where they reach the edge of the level
+    int y = upload.nextRow * 4;
+    int height = std::min(rows * 4, level.height - y);
+    const void* data = stageThroughPbo(compressed.data.data() + level.offset + rowBytes * upload.nextRow, bytes);
+    glBindTexture(GL_TEXTURE_2D, upload.texture);
+    glCompressedTexSubImage2D(GL_TEXTURE_2D, static_cast<GLint>(upload.nextLevel), 0, y, level.width, height,
+                              compressed.internalFormat, static_cast<GLsizei>(bytes), data);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    upload.nextRow += rows;
+    if (upload.nextRow >= blockRows) {
+        upload.nextRow = 0;
+        upload.nextLevel++;
+    }
+    return bytes;
+}
+
+const void* TextureStreamer::stageThroughPbo(const unsigned char* source, size_t bytes) {
+    // Round-robin PBOs, each orphaned before mapping, so a chunk never waits on the previous transfer
+    GLuint pbo = m_pbos[m_nextPbo];
+    m_nextPbo = (m_nextPbo + 1) % UPLOAD_PBO_COUNT;
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_STREAM_DRAW);
+    void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(bytes), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (!mapped) {
+        // Mapping failed: upload this chunk straight from client memory
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        return source;
+    }
+    std::memcpy(mapped, source, bytes);
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    return nullptr;
+}
+
+void TextureStreamer::finishUpload(StagedUpload& upload) {
+    Entry& entry = m_entries[upload.image.handle - 1];
+    glBindTexture(GL_TEXTURE_2D, upload.texture);
+    if (upload.image.compressed) {
+        entry.gpuBytes = upload.image.compressedImage.data.size();
+    } else {
+        glGenerateMipmap(GL_TEXTURE_2D);
+        // The mip chain adds a third
+        entry.gpuBytes = static_cast<size_t>(upload.image.width) * upload.image.height * texelBytesForChannels(upload.image.channels) * 4 / 3;
+    }
+    MemoryStats::TrackTexture(upload.texture, MemoryCategory::TEXTURES, entry.gpuBytes);
+    deleteTexture(entry.texture); // Preview, or the previous version on reload
+    entry.texture = upload.texture;
+    entry.state = TextureState::READY;
+    upload.texture = 0;
+    LOG_INFO(TEXTURES) << "Streamed texture " << entry.path << " (" << (upload.image.compressed ? "block-compressed, " : "")
+                       << entry.gpuBytes / 1024 << " KB, texture ID " << entry.texture << ")";
+}
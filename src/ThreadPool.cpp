@@ -0,0 +1,70 @@
+#include "ThreadPool.h"
+#include "Log.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned int threadCount) {
+    if (threadCount == 0) {
+        unsigned int hardware = std::thread::hardware_concurrency();
+        threadCount = std::max(1u, hardware > 1 ? hardware - 1 : 1u);
+    }
+    m_workers.reserve(threadCount);
+    for (unsigned int i = 0; i < threadCount; ++i) {
+        m_workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+    LOG_INFO(GENERAL) << "Thread pool started with " << threadCount << " workers";
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_taskAvailable.notify_all();
+    for (std::thread& worker : m_workers) {
+        if (worker.joinable()) worker.join();
+    }
+}
+
+void ThreadPool::Enqueue(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push_back(std::move(task));
+    }
+    m_taskAvailable.notify_one();
+}
+
+void ThreadPool::WaitIdle() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this]() { return m_tasks.empty() && m_activeTasks == 0; });
+}
+
+size_t ThreadPool::GetQueuedCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_tasks.size();
+}
+
+void ThreadPool::workerLoop() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_taskAvailable.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+            if (m_stopping && m_tasks.empty()) return; // Drain the queue before exiting
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+            m_activeTasks++;
+        }
+        try {
+            task();
+        } catch (const std::exception& e) {
+            LOG_ERROR(GENERAL) << "Unhandled exception in thread pool task: " << e.what();
+        } catch (...) {
+            LOG_ERROR(GENERAL) << "Unhandled unknown exception in thread pool task";
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_activeTasks--;
+            if (m_tasks.empty() && m_activeTasks == 0) m_idle.notify_all();
+        }
+    }
+}
@@ -3,116 +3,102 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <string>
 #include <vector>
 #include <memory>
 
 #include "Renderer.h" // Your renderer class
-#include <btBulletDynamicsCommon.h> // Bullet includes
-
-// --- Physics Globals ---
-std::unique_ptr<btDefaultCollisionConfiguration> g_collisionConfiguration;
-std::unique_ptr<btCollisionDispatcher> g_dispatcher;
-std::unique_ptr<btBroadphaseInterface> g_overlappingPairCache;
-std::unique_ptr<btSequentialImpulseConstraintSolver> g_solver;
-std::unique_ptr<btDiscreteDynamicsWorld> g_dynamicsWorld;
-std::vector<std::unique_ptr<btCollisionShape>> g_collisionShapes;
-std::vector<btRigidBody*> g_physicsBodies;
-// --- End Physics Globals ---
-
-// --- Physics Initialization ---
-void initPhysics() {
-    std::cout << "Initializing Bullet Physics..." << std::endl;
-    g_collisionConfiguration = std::make_unique<btDefaultCollisionConfiguration>();
-    g_dispatcher = std::make_unique<btCollisionDispatcher>(g_collisionConfiguration.get());
-    g_overlappingPairCache = std::make_unique<btDbvtBroadphase>();
-    g_solver = std::make_unique<btSequentialImpulseConstraintSolver>();
-    g_dynamicsWorld = std::make_unique<btDiscreteDynamicsWorld>(
-        g_dispatcher.get(), g_overlappingPairCache.get(), g_solver.get(), g_collisionConfiguration.get()
-    );
-    g_dynamicsWorld->setGravity(btVector3(0, -9.81, 0));
-
-    // Ground Plane
-    g_collisionShapes.push_back(std::make_unique<btStaticPlaneShape>(btVector3(0, 1, 0), 0));
-    btCollisionShape* groundShape = g_collisionShapes.back().get();
-    btDefaultMotionState* groundMotionState = new btDefaultMotionState(btTransform(btQuaternion(0, 0, 0, 1), btVector3(0, 0, 0)));
-    btRigidBody::btRigidBodyConstructionInfo groundRigidBodyCI(0, groundMotionState, groundShape, btVector3(0, 0, 0));
-    btRigidBody* groundRigidBody = new btRigidBody(groundRigidBodyCI);
-    groundRigidBody->setRestitution(0.3f);
-    g_dynamicsWorld->addRigidBody(groundRigidBody);
-
-    // Falling Cube
-    float cubeHalfExtents = 0.5f;
-    g_collisionShapes.push_back(std::make_unique<btBoxShape>(btVector3(cubeHalfExtents, cubeHalfExtents, cubeHalfExtents)));
-    btCollisionShape* fallShape = g_collisionShapes.back().get();
-    btDefaultMotionState* fallMotionState = new btDefaultMotionState(btTransform(btQuaternion(0, 0, 0, 1), btVector3(0, 20, 0)));
-    btScalar mass = 1.f; btVector3 fallInertia(0, 0, 0);
-    fallShape->calculateLocalInertia(mass, fallInertia);
-    btRigidBody::btRigidBodyConstructionInfo fallRigidBodyCI(mass, fallMotionState, fallShape, fallInertia);
-    btRigidBody* fallRigidBody = new btRigidBody(fallRigidBodyCI);
-    fallRigidBody->setRestitution(0.6f);
-    g_dynamicsWorld->addRigidBody(fallRigidBody);
-    g_physicsBodies.push_back(fallRigidBody);
-
-    // Bouncing Sphere
-    float sphereRadius = 0.6f;
-    g_collisionShapes.push_back(std::make_unique<btSphereShape>(sphereRadius));
-    btCollisionShape* sphereShape = g_collisionShapes.back().get();
-    btDefaultMotionState* sphereMotionState = new btDefaultMotionState(btTransform(btQuaternion(0, 0, 0, 1), btVector3(2, 15, 0)));
-    btScalar sphereMass = 1.5f; btVector3 sphereInertia(0, 0, 0);
-    sphereShape->calculateLocalInertia(sphereMass, sphereInertia);
-    btRigidBody::btRigidBodyConstructionInfo sphereRigidBodyCI(sphereMass, sphereMotionState, sphereShape, sphereInertia);
-    btRigidBody* sphereRigidBody = new btRigidBody(sphereRigidBodyCI);
-    sphereRigidBody->setRestitution(0.9f); sphereRigidBody->setFriction(0.1f);
-    g_dynamicsWorld->addRigidBody(sphereRigidBody);
-    g_physicsBodies.push_back(sphereRigidBody);
-
-    std::cout << "Bullet Physics Initialized." << std::endl;
-}
-
-// --- Physics Cleanup ---
-void cleanupPhysics() {
-    std::cout << "Cleaning up Bullet Physics..." << std::endl;
-    for (int i = g_dynamicsWorld->getNumCollisionObjects() - 1; i >= 0; i--) {
-        btCollisionObject* obj = g_dynamicsWorld->getCollisionObjectArray()[i];
-        btRigidBody* body = btRigidBody::upcast(obj);
-        if (body && body->getMotionState()) { delete body->getMotionState(); }
-        g_dynamicsWorld->removeCollisionObject(obj);
+#include "PhysicsThread.h"
+#include "PhysicsWorld.h"
+#include "Log.h"
+
+// --physics-threads N        multi-threaded Bullet world with N scheduler threads ("auto" = one per spare core)
+// --physics-threads 0        single-threaded world (default)
+// --vsync off|on|adaptive    swap interval (default on)
+// --frames-in-flight N       frames the CPU may run ahead of the GPU, 1-3 (default 2)
+// --fps-cap N                frame-rate cap, 0 = uncapped (default)
+// --scene FILE               open a saved scene instead of the built-in demo bodies
+// --shader-cache off|on      program binary cache (default on; off forces every shader to compile)
+static bool parseArguments(int argc, char** argv, PhysicsThreadingSettings& threading, RendererSettings& settings,
+                           std::string& scenePath) {
+    FramePacingSettings& pacing = settings.pacing;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (i + 1 >= argc) { std::cerr << "Missing value for " << arg << std::endl; return false; }
+        const char* value = argv[++i];
+        if (std::strcmp(arg, "--physics-threads") == 0) {
+            threading.multithreaded = std::strcmp(value, "auto") == 0 || std::atoi(value) > 0;
+            threading.workerThreads = std::strcmp(value, "auto") == 0 ? 0u : static_cast<unsigned int>(std::max(std::atoi(value), 0));
+        } else if (std::strcmp(arg, "--vsync") == 0) {
+            if (std::strcmp(value, "off") == 0) pacing.vsync = VsyncMode::OFF;
+            else if (std::strcmp(value, "on") == 0) pacing.vsync = VsyncMode::ON;
+            else if (std::strcmp(value, "adaptive") == 0) pacing.vsync = VsyncMode::ADAPTIVE;
+            else { std::cerr << "Unknown vsync mode " << value << std::endl; return false; }
+        } else if (std::strcmp(arg, "--frames-in-flight") == 0) {
+            pacing.maxFramesInFlight = std::atoi(value);
+        } else if (std::strcmp(arg, "--fps-cap") == 0) {
+            pacing.frameRateCap = static_cast<float>(std::atof(value));
+        } else if (std::strcmp(arg, "--scene") == 0) {
+            scenePath = value;
+        } else if (std::strcmp(arg, "--shader-cache") == 0) {
+            if (std::strcmp(value, "off") == 0) settings.shaderBinaryCache = false;
+            else if (std::strcmp(value, "on") == 0) settings.shaderBinaryCache = true;
+            else { std::cerr << "Unknown shader cache mode " << value << std::endl; return false; }
+        } else {
+            std::cerr << "Unknown argument " << arg << std::endl;
+            return false;
+        }
     }
-    g_physicsBodies.clear();
-    g_collisionShapes.clear();
-    g_dynamicsWorld.reset(); g_solver.reset(); g_overlappingPairCache.reset();
-    g_dispatcher.reset(); g_collisionConfiguration.reset();
-    std::cout << "Bullet Physics Cleaned up." << std::endl;
+    return true;
 }
 
+int main(int argc, char** argv) {
+    LOG_INFO(GENERAL) << "Starting application...";
 
-int main() {
-    std::cout << "Starting application..." << std::endl;
+    PhysicsThreadingSettings threading;
+    RendererSettings settings;
+    std::string scenePath;
+    if (!parseArguments(argc, argv, threading, settings, scenePath)) {
+        std::cout << "Usage: OpenGLCube [--physics-threads N|auto] [--vsync off|on|adaptive] [--frames-in-flight N] [--fps-cap N]"
+                     " [--scene FILE] [--shader-cache off|on]" << std::endl;
+        return 1;
+    }
 
-    initPhysics();
+    PhysicsWorld physics;
+    physics.Initialize(0, threading);
 
     Renderer renderer(1280, 720, "Raymarching + Physics Editor"); // Updated Title
-    std::cout << "Renderer created, initializing..." << std::endl;
+    LOG_INFO(GENERAL) << "Renderer created, initializing...";
 
-    if (!renderer.Initialize()) {
-        std::cerr << "Failed to initialize renderer!" << std::endl;
-        cleanupPhysics();
+    if (!renderer.Initialize(settings)) {
+        LOG_ERROR(GENERAL) << "Failed to initialize renderer!";
+        physics.Shutdown();
         glfwTerminate();
         return -1;
     }
 
-    std::cout << "Initialization successful, starting main loop..." << std::endl;
+    // Physics steps on its own thread at a fixed 60 Hz; the renderer interpolates its snapshots
+    PhysicsThread physicsThread(physics.GetWorld(), 1.0f / 60.0f);
+    renderer.SetPhysicsThread(&physicsThread);
+    renderer.SetPhysicsWorld(&physics);
+    physicsThread.Start();
+    if (!scenePath.empty()) renderer.OpenScene(scenePath); // Keeps the demo scene if the file cannot be opened
+
+    LOG_INFO(GENERAL) << "Initialization successful, starting main loop...";
 
     // --- Main Loop ---
-    float lastFrameTime = (float)glfwGetTime();
+    FramePacer& framePacer = renderer.GetFramePacer();
 
     while (!glfwWindowShouldClose(renderer.getWindow())) {
 
-        // --- Calculate Delta Time ---
-        float currentFrameTime = (float)glfwGetTime();
-        float deltaTime = currentFrameTime - lastFrameTime;
-        lastFrameTime = currentFrameTime;
+        // --- Pacing and Delta Time ---
+        // Waits for the GPU (frames-in-flight limit) and the frame-rate cap before input is sampled,
+        // so the frame reacts to the newest input
+        float deltaTime = static_cast<float>(framePacer.BeginFrame());
         if (deltaTime > 0.1f) { deltaTime = 0.1f; } // Clamp dt
         if (deltaTime <= 0.0f) { deltaTime = 1.0f / 60.0f; }
 
@@ -120,23 +106,23 @@ int main() {
         glfwPollEvents();
         renderer.ProcessInput(); // Handles mode switching and game input
 
-        // --- Physics Update (conditional) ---
-        if (renderer.GetEditorState() == EditorState::PLAYING) { // Use getter
-             g_dynamicsWorld->stepSimulation(deltaTime, 10, 1.0f/60.0f);
-        }
+        // --- Physics Update (conditional, runs on the physics thread) ---
+        physicsThread.SetSimulating(renderer.GetEditorState() == EditorState::PLAYING); // Use getter
 
         // --- Game Logic Update ---
         renderer.Update(deltaTime); // Update renderer internals (FPS, etc.)
 
         // --- Rendering ---
-        renderer.Render(g_dynamicsWorld.get()); // Pass physics world
+        renderer.Render(physics.GetWorld()); // Pass physics world
 
     }
     // --- End Main Loop ---
 
-    std::cout << "Main loop finished, exiting..." << std::endl;
+    LOG_INFO(GENERAL) << "Main loop finished, exiting...";
 
-    cleanupPhysics();
+    physicsThread.Stop();
+    renderer.SetPhysicsThread(nullptr);
+    physics.Shutdown();
 
     // Renderer destructor handles its own cleanup
     return 0;